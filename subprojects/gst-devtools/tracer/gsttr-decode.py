@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+'''
+Decode a binary tracer log into the text log format used by the other tracer
+tools.
+
+How to run:
+1) generate a binary log
+GST_TRACERS="stats;rusage;latency" GST_TRACER_BINARY_FILE=trace.bin <application>
+
+2) decode it
+python3 gsttr-decode.py trace.bin >trace.log
+
+3) use the other tools on the result
+python3 gsttr-stats.py trace.log
+'''
+
+import argparse
+import logging
+import struct
+import sys
+
+logging.basicConfig(level=logging.WARNING)
+logger = logging.getLogger('gsttr-decode')
+
+_MAGIC = b'GSTTRBIN'
+_VERSION = 1
+_BOM = 0x01020304
+
+_BLOCK_RECORD = 1
+_BLOCK_EVENTS = 2
+
+# value codes, see gst/gsttracerbinlog.h
+_FIXED = {
+    'i': ('i', 4),
+    'u': ('I', 4),
+    'I': ('q', 8),
+    'U': ('Q', 8),
+    'd': ('d', 8),
+    'p': ('Q', 8),
+}
+
+
+def _format_time(ts):
+    secs, nsecs = divmod(ts, 1000000000)
+    mins, secs = divmod(secs, 60)
+    hours, mins = divmod(mins, 60)
+    return '%u:%02u:%02u.%09u' % (hours, mins, secs, nsecs)
+
+
+class Record(object):
+
+    def __init__(self, name, spec, fields, layout):
+        self.name = name
+        self.spec = spec
+        self.fields = fields.split(',') if fields else []
+        self.layout = layout
+        if len(self.fields) != len(self.layout):
+            raise ValueError('inconsistent record %s' % name)
+
+
+class Decoder(object):
+    """
+    Reads a binary tracer log and writes it out in text form.
+    """
+
+    def __init__(self, infile, outfile, pid):
+        self.infile = infile
+        self.outfile = outfile
+        self.pid = pid
+        self.endian = '<'
+        self.records = {}
+        self.dropped = 0
+
+    def _unpack(self, fmt, data, offset):
+        return struct.unpack_from(self.endian + fmt, data, offset)
+
+    def _line(self, ts, thread, filename, function, message):
+        self.outfile.write('%s %5d 0x%x TRACE %20s %s:0:%s: %s\n' % (
+            _format_time(ts), self.pid, thread, 'GST_TRACER', filename,
+            function, message))
+
+    def _read_header(self, data):
+        if data[:8] != _MAGIC:
+            raise ValueError('not a binary tracer log')
+        for endian in ('<', '>'):
+            version, bom = struct.unpack_from(endian + 'II', data, 8)
+            if bom == _BOM:
+                self.endian = endian
+                break
+        else:
+            raise ValueError('unknown byte order')
+        if version != _VERSION:
+            raise ValueError('unsupported version %d' % version)
+        return 16
+
+    def _handle_record(self, data):
+        (record_id,) = self._unpack('I', data, 0)
+        strings = data[4:].split(b'\0')
+        name, spec, fields, layout = [s.decode('utf-8') for s in strings[:4]]
+        record = Record(name, spec, fields, layout)
+        self.records[record_id] = record
+        # the class description, like in the text log
+        self._line(0, 0, 'gsttracerrecord.c', 'gst_tracer_record_build_format',
+                   spec)
+
+    def _decode_values(self, record, data, offset):
+        values = []
+        for code in record.layout:
+            if code in _FIXED:
+                fmt, size = _FIXED[code]
+                (v,) = self._unpack(fmt, data, offset)
+                offset += size
+                if code == 'p':
+                    v = '0x%x' % v
+                elif code == 'd':
+                    v = '%f' % v
+                values.append(str(v))
+            else:
+                (length,) = self._unpack('I', data, offset)
+                offset += 4
+                values.append(data[offset:offset + length].decode(
+                    'utf-8', errors='replace'))
+                offset += length
+        return values
+
+    def _handle_events(self, data):
+        thread, dropped = self._unpack('QI', data, 0)
+        if dropped:
+            logger.warning('%d events dropped in thread 0x%x', dropped, thread)
+            self.dropped += dropped
+        offset = 12
+        while offset + 16 <= len(data):
+            record_id, length, ts = self._unpack('IIQ', data, offset)
+            offset += 16
+            record = self.records.get(record_id)
+            if record is None:
+                logger.warning('skipping event of unknown record %d',
+                               record_id)
+            else:
+                values = self._decode_values(record, data[offset:offset + length],
+                                             0)
+                message = record.name
+                for field, value in zip(record.fields, values):
+                    message += ', %s%s' % (field, value)
+                self._line(ts, thread, '', '', message + ';')
+            offset += length
+
+    def run(self):
+        data = self.infile.read()
+        offset = self._read_header(data)
+        while offset + 8 <= len(data):
+            block_type, length = self._unpack('II', data, offset)
+            offset += 8
+            block = data[offset:offset + length]
+            offset += length
+            if block_type == _BLOCK_RECORD:
+                self._handle_record(block)
+            elif block_type == _BLOCK_EVENTS:
+                self._handle_events(block)
+            else:
+                logger.warning('skipping unknown block type %d', block_type)
+        if self.dropped:
+            logger.warning('%d events dropped in total', self.dropped)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('file', nargs='?', default='-')
+    parser.add_argument('-p', '--pid', default=0, type=int,
+                        help='process id to put into the log lines')
+    args = parser.parse_args()
+
+    if args.file == '-':
+        infile = sys.stdin.buffer
+        Decoder(infile, sys.stdout, args.pid).run()
+    else:
+        with open(args.file, 'rb') as infile:
+            Decoder(infile, sys.stdout, args.pid).run()
@@ -921,6 +921,10 @@ gst_openh264enc_handle_frame (GstVideoEncoder * encoder,
 
   GST_OBJECT_UNLOCK (openh264enc);
 
+  /* The ROI and skip hints of gst_video_encoder_get_block_hints() are not
+   * used: openh264 has no API for per-macroblock QP offsets or skips. The
+   * unchanged areas are found by its own background detection instead, see
+   * the background-detection property. */
   if (frame) {
     src_pic = g_new0 (SSourcePicture, 1);
 
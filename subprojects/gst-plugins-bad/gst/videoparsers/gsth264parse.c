@@ -239,6 +239,8 @@ gst_h264_parse_reset_frame (GstH264Parse * h264parse)
   h264parse->keyframe = FALSE;
   h264parse->predicted = FALSE;
   h264parse->bidirectional = FALSE;
+  h264parse->non_reference = FALSE;
+  h264parse->reference = FALSE;
   h264parse->header = FALSE;
   h264parse->frame_start = FALSE;
   h264parse->have_sps_in_frame = FALSE;
@@ -1116,6 +1118,11 @@ gst_h264_parse_process_nal (GstH264Parse * h264parse, GstH264NalUnit * nalu)
        * AU is complete. This is used to keep track of AU */
       h264parse->picture_start = TRUE;
 
+      if (nalu->ref_idc == 0)
+        h264parse->non_reference = TRUE;
+      else
+        h264parse->reference = TRUE;
+
       /* don't need to parse the whole slice (header) here */
       if (nalu->size > nalu->header_bytes &&
           *(nalu->data + nalu->offset + nalu->header_bytes) & 0x80) {
@@ -2916,6 +2923,12 @@ gst_h264_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (h264parse->discard_bidirectional && h264parse->bidirectional)
     goto discard;
 
+  /* no other picture refers to it, decoders can skip it under load */
+  if (h264parse->non_reference && !h264parse->reference)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DROPPABLE);
+  else
+    GST_BUFFER_FLAG_UNSET (buffer, GST_BUFFER_FLAG_DROPPABLE);
+
   if (h264parse->header)
     GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_HEADER);
   else
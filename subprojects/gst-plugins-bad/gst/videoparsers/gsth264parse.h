@@ -141,6 +141,9 @@ struct _GstH264Parse
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
+  /* slices with nal_ref_idc equal to or different from 0 */
+  gboolean non_reference;
+  gboolean reference;
   gboolean header;
   gboolean frame_start;
   /* AU state */
@@ -204,6 +204,8 @@ gst_h265_parse_reset_frame (GstH265Parse * h265parse)
   h265parse->keyframe = FALSE;
   h265parse->predicted = FALSE;
   h265parse->bidirectional = FALSE;
+  h265parse->non_reference = FALSE;
+  h265parse->reference = FALSE;
   h265parse->header = FALSE;
   h265parse->have_vps_in_frame = FALSE;
   h265parse->have_sps_in_frame = FALSE;
@@ -918,7 +920,18 @@ gst_h265_parse_process_nal (GstH265Parse * h265parse, GstH265NalUnit * nalu)
         else if (GST_H265_IS_B_SLICE (&slice))
           h265parse->bidirectional = TRUE;
 
+        /* only pictures of the highest temporal sub-layer are guaranteed
+         * not to be referenced by pictures of higher sub-layers */
+        if (nal_type <= GST_H265_NAL_SLICE_RASL_N && nal_type % 2 == 0
+            && nalu->temporal_id_plus1 - 1 ==
+            slice.pps->sps->max_sub_layers_minus1)
+          h265parse->non_reference = TRUE;
+        else
+          h265parse->reference = TRUE;
+
         h265parse->state |= GST_H265_PARSE_STATE_GOT_SLICE;
+      } else {
+        h265parse->reference = TRUE;
       }
       if (slice.first_slice_segment_in_pic_flag == 1)
         GST_DEBUG_OBJECT (h265parse,
@@ -2689,6 +2702,11 @@ gst_h265_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (h265parse->discard_bidirectional && h265parse->bidirectional)
     goto discard;
 
+  /* no other picture refers to it, decoders can skip it under load */
+  if (h265parse->non_reference && !h265parse->reference)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DROPPABLE);
+  else
+    GST_BUFFER_FLAG_UNSET (buffer, GST_BUFFER_FLAG_DROPPABLE);
 
   if (h265parse->header)
     GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_HEADER);
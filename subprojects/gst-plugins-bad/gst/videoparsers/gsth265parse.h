@@ -110,6 +110,9 @@ struct _GstH265Parse
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
+  /* sub-layer non-reference slices of the highest sub-layer, or others */
+  gboolean non_reference;
+  gboolean reference;
   gboolean header;
   gboolean framerate_from_caps;
   /* AU state */
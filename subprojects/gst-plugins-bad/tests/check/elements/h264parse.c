@@ -873,6 +873,18 @@ static guint8 h264_slice_2[] = {
   0x10, 0x00, 0x27, 0x20, 0x8f, 0x04, 0x30
 };
 
+/* P Slice 1, with nal_ref_idc 0 */
+static guint8 h264_non_ref_slice_1[] = {
+  0x00, 0x00, 0x00, 0x01, 0x01, 0xe0, 0x00, 0x40,
+  0x00, 0x9c, 0x82, 0x3c, 0x10, 0xc0
+};
+
+/* P Slice 2, with nal_ref_idc 0 */
+static guint8 h264_non_ref_slice_2[] = {
+  0x00, 0x00, 0x00, 0x01, 0x01, 0x04, 0x38, 0x00,
+  0x10, 0x00, 0x27, 0x20, 0x8f, 0x04, 0x30
+};
+
 static inline GstBuffer *
 wrap_buffer (const guint8 * buf, gsize size, GstClockTime pts,
     GstBufferFlags flags)
@@ -1183,6 +1195,54 @@ GST_START_TEST (test_parse_sliced_sps_pps_sps)
 
 GST_END_TEST;
 
+/* only AUs whose slices all have nal_ref_idc 0 can be dropped */
+GST_START_TEST (test_parse_sliced_droppable)
+{
+  GstHarness *h = gst_harness_new ("h264parse");
+  GstBuffer *buf;
+
+  gst_harness_set_caps_str (h,
+      "video/x-h264,stream-format=byte-stream,alignment=au,parsed=false,framerate=30/1",
+      "video/x-h264,stream-format=byte-stream,alignment=au,parsed=true");
+
+  buf = composite_buffer (100, 0, 4,
+      h264_slicing_sps, sizeof (h264_slicing_sps),
+      h264_slicing_pps, sizeof (h264_slicing_pps),
+      h264_idr_slice_1, sizeof (h264_idr_slice_1),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2));
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+
+  buf = composite_buffer (200, 0, 2,
+      h264_slice_1, sizeof (h264_slice_1),
+      h264_slice_2, sizeof (h264_slice_2));
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+
+  buf = composite_buffer (300, 0, 2,
+      h264_non_ref_slice_1, sizeof (h264_non_ref_slice_1),
+      h264_non_ref_slice_2, sizeof (h264_non_ref_slice_2));
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+
+  gst_harness_push_event (h, gst_event_new_eos ());
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 3);
+
+  buf = gst_harness_pull (h);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DROPPABLE));
+  gst_buffer_unref (buf);
+
+  buf = gst_harness_pull (h);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DROPPABLE));
+  gst_buffer_unref (buf);
+
+  buf = gst_harness_pull (h);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DROPPABLE));
+  gst_buffer_unref (buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+
 
 static Suite *
 h264parse_sliced_suite (void)
@@ -1195,6 +1255,7 @@ h264parse_sliced_suite (void)
   tcase_add_test (tc_chain, test_parse_sliced_au_nal);
   tcase_add_test (tc_chain, test_parse_sliced_nal_au);
   tcase_add_test (tc_chain, test_parse_sliced_sps_pps_sps);
+  tcase_add_test (tc_chain, test_parse_sliced_droppable);
 
   return s;
 }
@@ -201,6 +201,19 @@ static const guint8 h265_128x128_slice_2_idr_n_lp[] = {
   0xbf, 0x80
 };
 
+/* P slice following the single-sliced IDR above, as a reference (TRAIL_R)
+ * and as a sub-layer non-reference (TRAIL_N) picture. The stream has a
+ * single temporal sub-layer. */
+static const guint8 h265_128x128_slice_trail_r[] = {
+  0x00, 0x00, 0x00, 0x01, 0x02, 0x01, 0xd0, 0x09,
+  0x70, 0xcd, 0xf8, 0x80
+};
+
+static const guint8 h265_128x128_slice_trail_n[] = {
+  0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0xd0, 0x09,
+  0x70, 0xcd, 0xf8, 0x80
+};
+
 static const gchar *ctx_suite;
 static gboolean ctx_codec_data;
 
@@ -968,6 +981,45 @@ GST_START_TEST (test_sliced_au_au)
 
 GST_END_TEST;
 
+static void
+pull_and_check_droppable (GstHarness * h, gboolean droppable)
+{
+  GstBuffer *b = gst_harness_pull (h);
+
+  fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (b,
+          GST_BUFFER_FLAG_DROPPABLE), droppable);
+  gst_buffer_unref (b);
+}
+
+/* only non-reference pictures of the highest temporal sub-layer can be
+ * dropped */
+GST_START_TEST (test_droppable_au_au)
+{
+  GstHarness *h = gst_harness_new ("h265parse");
+  GstBuffer *buf;
+
+  bytestream_set_caps (h, "au", "au");
+  bytestream_push_first_au_inalign_au (h, FALSE);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 1);
+  pull_and_check_droppable (h, FALSE);
+
+  buf = wrap_buffer (h265_128x128_slice_trail_r,
+      sizeof (h265_128x128_slice_trail_r), 100, 0);
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 1);
+  pull_and_check_droppable (h, FALSE);
+
+  buf = wrap_buffer (h265_128x128_slice_trail_n,
+      sizeof (h265_128x128_slice_trail_n), 200, 0);
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), 1);
+  pull_and_check_droppable (h, TRUE);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_parse_skip_to_4bytes_sc)
 {
   GstHarness *h;
@@ -1424,6 +1476,8 @@ h265parse_harnessed_suite (void)
   tcase_add_test (tc_chain, test_sliced_nal_au);
   tcase_add_test (tc_chain, test_sliced_au_au);
 
+  tcase_add_test (tc_chain, test_droppable_au_au);
+
   tcase_add_test (tc_chain, test_parse_skip_to_4bytes_sc);
   tcase_add_test (tc_chain, test_parse_sc_with_half_header);
 
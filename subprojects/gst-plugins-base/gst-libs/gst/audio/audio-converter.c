@@ -145,6 +145,10 @@ struct _GstAudioConverter
   /* endian swap */
   AudioConvertEndianFunc swap_endian;
 
+  /* fused fast path */
+  AudioConvertFunc fast_convert;
+  gint fast_inc;
+
   AudioConvertSamplesFunc convert;
 };
 
@@ -1277,6 +1281,203 @@ converter_endian (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* Fused conversions for the common trivial cases. They go straight from the
+ * input to the output format without unpacking to the intermediate format,
+ * but produce exactly the same samples as the generic chain would:
+ *
+ *  - S16 is mixed as S16 with the channel mixer integer matrix (1.0 and 0.5
+ *    for mono <-> stereo), which is a copy and a rounded average.
+ *  - F32 -> S16 goes through F64 -> S32 (truncating and saturating like
+ *    audio_orc_double_to_s32) and is then rounded to 16 bits with the
+ *    saturating bias of the dither-less quantizer.
+ *  - S16 -> F32 is exact, scaling by 2^-15 is what the S32 -> F64 -> F32
+ *    path ends up doing.
+ *
+ * All of them read a complete input frame before writing the output frame,
+ * so they can run in place when the output frame is not bigger than the
+ * input frame.
+ */
+static inline gint16
+fast_f64_to_s16 (gdouble val)
+{
+  gint64 tmp;
+
+  val *= 2147483648.0;
+  if (val >= 2147483647.0)
+    tmp = G_MAXINT32;
+  else if (val <= -2147483648.0)
+    tmp = G_MININT32;
+  else
+    tmp = (gint32) val;
+
+  tmp = MIN (tmp + (1 << 15), G_MAXINT32);
+
+  return (gint16) (tmp >> 16);
+}
+
+static void
+converter_fast_s16_mono_to_stereo (gpointer dst, const gpointer src,
+    gint count)
+{
+  gint16 *out = dst;
+  const gint16 *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gint16 val = in[i];
+
+    out[2 * i + 0] = val;
+    out[2 * i + 1] = val;
+  }
+}
+
+static void
+converter_fast_s16_stereo_to_mono (gpointer dst, const gpointer src,
+    gint count)
+{
+  gint16 *out = dst;
+  const gint16 *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++)
+    out[i] = ((gint32) in[2 * i + 0] + (gint32) in[2 * i + 1] + 1) >> 1;
+}
+
+static void
+converter_fast_f32_mono_to_stereo (gpointer dst, const gpointer src,
+    gint count)
+{
+  gfloat *out = dst;
+  const gfloat *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gfloat val = in[i];
+
+    out[2 * i + 0] = val;
+    out[2 * i + 1] = val;
+  }
+}
+
+static void
+converter_fast_f32_stereo_to_mono (gpointer dst, const gpointer src,
+    gint count)
+{
+  gfloat *out = dst;
+  const gfloat *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gfloat res = 0.0;
+
+    res += in[2 * i + 0] * 0.5f;
+    res += in[2 * i + 1] * 0.5f;
+    out[i] = res;
+  }
+}
+
+static void
+converter_fast_f32_to_s16 (gpointer dst, const gpointer src, gint count)
+{
+  gint16 *out = dst;
+  const gfloat *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++)
+    out[i] = fast_f64_to_s16 (in[i]);
+}
+
+static void
+converter_fast_f32_mono_to_s16_stereo (gpointer dst, const gpointer src,
+    gint count)
+{
+  gint16 *out = dst;
+  const gfloat *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gint16 val = fast_f64_to_s16 (in[i]);
+
+    out[2 * i + 0] = val;
+    out[2 * i + 1] = val;
+  }
+}
+
+static void
+converter_fast_f32_stereo_to_s16_mono (gpointer dst, const gpointer src,
+    gint count)
+{
+  gint16 *out = dst;
+  const gfloat *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gdouble res = 0.0;
+
+    res += (gdouble) in[2 * i + 0] * 0.5f;
+    res += (gdouble) in[2 * i + 1] * 0.5f;
+    out[i] = fast_f64_to_s16 (res);
+  }
+}
+
+static void
+converter_fast_s16_to_f32 (gpointer dst, const gpointer src, gint count)
+{
+  gfloat *out = dst;
+  const gint16 *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++)
+    out[i] = in[i] * (1.0f / 32768.0f);
+}
+
+static void
+converter_fast_s16_mono_to_f32_stereo (gpointer dst, const gpointer src,
+    gint count)
+{
+  gfloat *out = dst;
+  const gint16 *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++) {
+    gfloat val = in[i] * (1.0f / 32768.0f);
+
+    out[2 * i + 0] = val;
+    out[2 * i + 1] = val;
+  }
+}
+
+static void
+converter_fast_s16_stereo_to_f32_mono (gpointer dst, const gpointer src,
+    gint count)
+{
+  gfloat *out = dst;
+  const gint16 *in = src;
+  gint i;
+
+  for (i = 0; i < count; i++)
+    out[i] = ((gint32) in[2 * i + 0] + (gint32) in[2 * i + 1]) *
+        (1.0f / 65536.0f);
+}
+
+/* the worker function for the fused conversions, only used for interleaved
+ * samples */
+static gboolean
+converter_fast (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  GST_LOG ("fast convert: %" G_GSIZE_FORMAT " frames", in_frames);
+
+  if (in) {
+    convert->fast_convert (out[0], in[0], in_frames * convert->fast_inc);
+  } else {
+    gst_audio_format_info_fill_silence (convert->out.finfo, out[0],
+        out_frames * convert->out.bpf);
+  }
+  return TRUE;
+}
+
 static gboolean
 converter_generic (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -1319,6 +1520,91 @@ converter_resample (GstAudioConverter * convert,
   return TRUE;
 }
 
+static gboolean
+is_mono (GstAudioInfo * info)
+{
+  return info->channels == 1 && !GST_AUDIO_INFO_IS_UNPOSITIONED (info) &&
+      info->position[0] == GST_AUDIO_CHANNEL_POSITION_MONO;
+}
+
+static gboolean
+is_stereo (GstAudioInfo * info)
+{
+  return info->channels == 2 && !GST_AUDIO_INFO_IS_UNPOSITIONED (info) &&
+      ((info->position[0] == GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT &&
+          info->position[1] == GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT) ||
+      (info->position[0] == GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT &&
+          info->position[1] == GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT));
+}
+
+/* check if one of the fused conversions can replace the generic chain */
+static gboolean
+setup_fast_convert (GstAudioConverter * convert)
+{
+  GstAudioInfo *in = &convert->in;
+  GstAudioInfo *out = &convert->out;
+  GstAudioFormat in_format = GST_AUDIO_INFO_FORMAT (in);
+  GstAudioFormat out_format = GST_AUDIO_INFO_FORMAT (out);
+  gboolean up, down;
+
+  if (convert->resampler)
+    return FALSE;
+  if (in->layout != GST_AUDIO_LAYOUT_INTERLEAVED ||
+      out->layout != GST_AUDIO_LAYOUT_INTERLEAVED)
+    return FALSE;
+  /* we only know how to do the default mono <-> stereo matrix */
+  if (GET_OPT_MIX_MATRIX (convert))
+    return FALSE;
+
+  up = is_mono (in) && is_stereo (out);
+  down = is_stereo (in) && is_mono (out);
+  if (!convert->mix_passthrough && !up && !down)
+    return FALSE;
+
+  /* the quantizer must not add dither or noise, which it also does for
+   * S16 -> S16 because the channel mixing is done in S32 */
+  if (GET_OPT_DITHER_METHOD (convert) != GST_AUDIO_DITHER_NONE ||
+      GET_OPT_NOISE_SHAPING_METHOD (convert) != GST_AUDIO_NOISE_SHAPING_NONE)
+    return FALSE;
+
+  convert->fast_inc = 1;
+
+  if (in_format == GST_AUDIO_FORMAT_S16 && out_format == GST_AUDIO_FORMAT_S16) {
+    if (up)
+      convert->fast_convert = converter_fast_s16_mono_to_stereo;
+    else if (down)
+      convert->fast_convert = converter_fast_s16_stereo_to_mono;
+  } else if (in_format == GST_AUDIO_FORMAT_F32
+      && out_format == GST_AUDIO_FORMAT_F32) {
+    if (up)
+      convert->fast_convert = converter_fast_f32_mono_to_stereo;
+    else if (down)
+      convert->fast_convert = converter_fast_f32_stereo_to_mono;
+  } else if (in_format == GST_AUDIO_FORMAT_F32
+      && out_format == GST_AUDIO_FORMAT_S16) {
+    if (up)
+      convert->fast_convert = converter_fast_f32_mono_to_s16_stereo;
+    else if (down)
+      convert->fast_convert = converter_fast_f32_stereo_to_s16_mono;
+    else {
+      convert->fast_convert = converter_fast_f32_to_s16;
+      convert->fast_inc = in->channels;
+    }
+  } else if (in_format == GST_AUDIO_FORMAT_S16
+      && out_format == GST_AUDIO_FORMAT_F32) {
+    if (up)
+      convert->fast_convert = converter_fast_s16_mono_to_f32_stereo;
+    else if (down)
+      convert->fast_convert = converter_fast_s16_stereo_to_f32_mono;
+    else {
+      convert->fast_convert = converter_fast_s16_to_f32;
+      convert->fast_inc = in->channels;
+    }
+  }
+
+  return convert->fast_convert != NULL;
+}
+
 #define GST_AUDIO_FORMAT_IS_ENDIAN_CONVERSION(info1, info2) \
 		( \
 			!(((info1)->flags ^ (info2)->flags) & (~GST_AUDIO_FORMAT_FLAG_UNPACK)) && \
@@ -1450,6 +1736,17 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
     }
   }
 
+  if (convert->convert == converter_generic && setup_fast_convert (convert)) {
+    GST_INFO ("using fused conversion %s -> %s, %d -> %d channels",
+        gst_audio_format_to_string (in_info->finfo->format),
+        gst_audio_format_to_string (out_info->finfo->format),
+        in_info->channels, out_info->channels);
+    convert->convert = converter_fast;
+    /* the fused conversions can work in place when the frames keep
+     * their size */
+    convert->in_place = in_info->bpf == out_info->bpf;
+  }
+
   setup_allocators (convert);
 
   return convert;
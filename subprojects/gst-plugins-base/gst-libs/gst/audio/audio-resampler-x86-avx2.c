@@ -0,0 +1,430 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX2__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* The taps are only guaranteed to be 16 byte aligned so all loads are
+ * unaligned. Like the SSE variants, the loops may read past @len into the
+ * TAPS_OVERREAD zero padding of the taps.
+ *
+ * The integer variants accumulate exactly like the C versions and do the
+ * final interpolation and rounding on the reduced sums, so they produce
+ * bit-identical output. */
+
+static inline gint32
+hsum_epi32_avx2 (__m256i v)
+{
+  __m128i s = _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (1, 0, 3, 2)));
+  s = _mm_add_epi32 (s, _mm_shuffle_epi32 (s, _MM_SHUFFLE (2, 3, 0, 1)));
+
+  return _mm_cvtsi128_si32 (s);
+}
+
+static inline gint64
+hsum_epi64_avx2 (__m256i v)
+{
+  __m128i s = _mm_add_epi64 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+
+  s = _mm_add_epi64 (s, _mm_unpackhi_epi64 (s, s));
+
+  return _mm_cvtsi128_si64 (s);
+}
+
+static inline gfloat
+hsum_ps_avx2 (__m256 v)
+{
+  __m128 s = _mm_add_ps (_mm256_castps256_ps128 (v),
+      _mm256_extractf128_ps (v, 1));
+
+  s = _mm_add_ps (s, _mm_movehl_ps (s, s));
+  s = _mm_add_ss (s, _mm_shuffle_ps (s, s, 0x55));
+
+  return _mm_cvtss_f32 (s);
+}
+
+static inline gdouble
+hsum_pd_avx2 (__m256d v)
+{
+  __m128d s = _mm_add_pd (_mm256_castpd256_pd128 (v),
+      _mm256_extractf128_pd (v, 1));
+
+  s = _mm_add_sd (s, _mm_unpackhi_pd (s, s));
+
+  return _mm_cvtsd_f64 (s);
+}
+
+/* multiply the signed 32 bits lanes of @a and @b and add the 64 bits
+ * products to @sum */
+static inline __m256i
+mul_add_epi32_avx2 (__m256i sum, __m256i a, __m256i b)
+{
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (a, b));
+  sum = _mm256_add_epi64 (sum, _mm256_mul_epi32 (_mm256_srli_epi64 (a, 32),
+          _mm256_srli_epi64 (b, 32)));
+
+  return sum;
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum, ta, tb;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    tb = _mm256_loadu_si256 ((__m256i *) (b + i));
+
+    sum = _mm256_add_epi32 (sum, _mm256_madd_epi16 (ta, tb));
+  }
+  res = hsum_epi32_avx2 (sum);
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res, r0, r1;
+  __m256i sum[2], ta;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  r0 = (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16);
+  r1 = (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16);
+
+  res = (r0 - r1) * (gint32) icoeff[0] + (r1 << PRECISION_S16);
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __m256i sum[4], ta;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    sum[0] = _mm256_add_epi32 (sum[0], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum[1] = _mm256_add_epi32 (sum[1], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum[2] = _mm256_add_epi32 (sum[2], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum[3] = _mm256_add_epi32 (sum[3], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  res = (gint32) (gint16) (hsum_epi32_avx2 (sum[0]) >> PRECISION_S16) *
+      (gint32) icoeff[0] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[1]) >> PRECISION_S16) *
+      (gint32) icoeff[1] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[2]) >> PRECISION_S16) *
+      (gint32) icoeff[2] +
+      (gint32) (gint16) (hsum_epi32_avx2 (sum[3]) >> PRECISION_S16) *
+      (gint32) icoeff[3];
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum;
+
+  sum = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    sum = mul_add_epi32_avx2 (sum,
+        _mm256_loadu_si256 ((__m256i *) (a + i)),
+        _mm256_loadu_si256 ((__m256i *) (b + i)));
+  }
+  res = hsum_epi64_avx2 (sum);
+
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res, r0, r1;
+  __m256i sum[2], ta;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    sum[0] = mul_add_epi32_avx2 (sum[0], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum[1] = mul_add_epi32_avx2 (sum[1], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+  }
+  r0 = (gint32) (hsum_epi64_avx2 (sum[0]) >> PRECISION_S32);
+  r1 = (gint32) (hsum_epi64_avx2 (sum[1]) >> PRECISION_S32);
+
+  res = (r0 - r1) * (gint64) icoeff[0] + (r1 << PRECISION_S32);
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum[4], ta;
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+
+    sum[0] = mul_add_epi32_avx2 (sum[0], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum[1] = mul_add_epi32_avx2 (sum[1], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+    sum[2] = mul_add_epi32_avx2 (sum[2], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[2] + i)));
+    sum[3] = mul_add_epi32_avx2 (sum[3], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[3] + i)));
+  }
+  res = (gint64) (gint32) (hsum_epi64_avx2 (sum[0]) >> PRECISION_S32) *
+      (gint64) icoeff[0] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[1]) >> PRECISION_S32) *
+      (gint64) icoeff[1] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[2]) >> PRECISION_S32) *
+      (gint64) icoeff[2] +
+      (gint64) (gint32) (hsum_epi64_avx2 (sum[3]) >> PRECISION_S32) *
+      (gint64) icoeff[3];
+
+  res = (res + ((gint64) 1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8)
+    sum = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        sum);
+
+  *o = hsum_ps_avx2 (sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_set1_ps (icoeff[0]), sum[1]);
+
+  *o = hsum_ps_avx2 (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_set1_ps (icoeff[0]));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_set1_ps (icoeff[3]), sum[0]);
+
+  *o = hsum_ps_avx2 (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2];
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    sum[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum[0]);
+    sum[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum[1]);
+  }
+  *o = hsum_pd_avx2 (_mm256_add_pd (sum[0], sum[1]));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_set1_pd (icoeff[0]), sum[1]);
+
+  *o = hsum_pd_avx2 (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_set1_pd (icoeff[0]));
+  sum[0] = _mm256_fmadd_pd (sum[1], _mm256_set1_pd (icoeff[1]), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[2], _mm256_set1_pd (icoeff[2]), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[3], _mm256_set1_pd (icoeff[3]), sum[0]);
+
+  *o = hsum_pd_avx2 (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+#endif
@@ -21,6 +21,7 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
 
 static void
 audio_resampler_check_x86 (const gchar *option)
@@ -69,3 +70,44 @@ audio_resampler_check_x86 (const gchar *option)
 #endif
   }
 }
+
+/* orc has no AVX2 target flags, ask the CPU directly. This is called after
+ * the SSE checks so that the wider variants take precedence. Setting
+ * GST_AUDIO_RESAMPLER_DISABLE_AVX2 keeps the C/SSE versions, which the
+ * tests use to compare both. */
+static void
+audio_resampler_check_x86_avx2 (void)
+{
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && \
+    defined (__GNUC__)
+  if (g_getenv ("GST_AUDIO_RESAMPLER_DISABLE_AVX2")) {
+    GST_DEBUG ("AVX2 optimisations disabled by the environment");
+    return;
+  }
+
+  __builtin_cpu_init ();
+  if (!__builtin_cpu_supports ("avx2") || !__builtin_cpu_supports ("fma")) {
+    GST_DEBUG ("AVX2/FMA not supported by the CPU");
+    return;
+  }
+
+  GST_DEBUG ("enable AVX2 optimisations");
+  resample_gint16_full_1 = resample_gint16_full_1_avx2;
+  resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+  resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+  resample_gint32_full_1 = resample_gint32_full_1_avx2;
+  resample_gint32_linear_1 = resample_gint32_linear_1_avx2;
+  resample_gint32_cubic_1 = resample_gint32_cubic_1_avx2;
+
+  resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+  resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+  resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+  resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+  resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+  resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+}
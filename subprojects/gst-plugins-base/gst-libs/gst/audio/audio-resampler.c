@@ -874,6 +874,9 @@ audio_resampler_init (void)
         }
       }
     }
+#ifdef CHECK_X86
+    audio_resampler_check_x86_avx2 ();
+#endif
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
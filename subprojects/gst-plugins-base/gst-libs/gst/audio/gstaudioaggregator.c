@@ -74,6 +74,13 @@
  *   buffer would be placed
  * - "position"  G_TYPE_UINT   current position in the input buffer in samples
  * - "size"  G_TYPE_UINT   size of the input buffer in samples
+ *
+ * When #GstAudioAggregator:max-active-pads is set, only the pads carrying the
+ * loudest input are mixed. The level of each input buffer is taken from its
+ * #GstAudioLevelMeta if there is one, e.g. as added by the depayloaders for
+ * the RTP client-to-mixer audio level header extension, and is calculated
+ * from the RMS of the samples otherwise. Input buffers of pads that are not
+ * selected are neither converted nor mixed and are handled like gap buffers.
  */
 
 
@@ -84,6 +91,7 @@
 #include "gstaudioaggregator.h"
 
 #include <string.h>
+#include <math.h>
 
 GST_DEBUG_CATEGORY_STATIC (audio_aggregator_debug);
 #define GST_CAT_DEFAULT audio_aggregator_debug
@@ -124,6 +132,14 @@ struct _GstAudioAggregatorPadPrivate
   guint64 dropped;              /* Number of sampels dropped since the element came out of READY */
 
   gboolean qos_messages;        /* Property to decide to send QoS messages or not */
+
+  guint8 level;                 /* Audio level of the most recent input buffer
+                                   in -dBov, 127 being silence. Only used when
+                                   max-active-pads is set. */
+
+  GstBuffer *prepared_input;    /* input buffer that was already converted
+                                   while preparing the pads, and */
+  GstBuffer *prepared_buffer;   /* the result of that conversion */
 };
 
 
@@ -143,6 +159,8 @@ gst_audio_aggregator_pad_finalize (GObject * object)
   GstAudioAggregatorPad *pad = (GstAudioAggregatorPad *) object;
 
   gst_buffer_replace (&pad->priv->buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_input, NULL);
+  gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
 
   G_OBJECT_CLASS (gst_audio_aggregator_pad_parent_class)->finalize (object);
 }
@@ -221,6 +239,7 @@ gst_audio_aggregator_pad_init (GstAudioAggregatorPad * pad)
   pad->priv->output_offset = -1;
   pad->priv->next_offset = -1;
   pad->priv->discont_time = GST_CLOCK_TIME_NONE;
+  pad->priv->level = 127;
 }
 
 /* Must be called from srcpad thread or when it is stopped */
@@ -242,7 +261,10 @@ gst_audio_aggregator_pad_flush_pad (GstAggregatorPad * aggpad,
   pad->priv->output_offset = pad->priv->next_offset = -1;
   pad->priv->discont_time = GST_CLOCK_TIME_NONE;
   gst_buffer_replace (&pad->priv->buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_input, NULL);
+  gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
   gst_audio_aggregator_pad_reset_qos (pad);
+  pad->priv->level = 127;
   GST_OBJECT_UNLOCK (aggpad);
 
   return GST_FLOW_OK;
@@ -316,28 +338,36 @@ gst_audio_aggregator_pad_update_conversion_info (GstAudioAggregatorPad *
       TRUE;
 }
 
+/* Returns the number of frames in @buffer. Non-interleaved buffers carry
+ * a GstAudioMeta that can describe fewer samples than the memory holds. */
+static gsize
+gst_audio_aggregator_buffer_get_frames (GstBuffer * buffer, gint bpf)
+{
+  GstAudioMeta *meta = gst_buffer_get_audio_meta (buffer);
+
+  if (meta && meta->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    return meta->samples;
+
+  return gst_buffer_get_size (buffer) / bpf;
+}
+
+/* Converts @input_buffer with @converter, or returns a new reference to it
+ * if @converter is %NULL */
 static GstBuffer *
-gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
-    aaggpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
-    GstBuffer * input_buffer)
+gst_audio_aggregator_convert_pad_convert_samples (GstAudioAggregatorPad *
+    aaggpad, GstAudioConverter * converter, GstAudioInfo * in_info,
+    GstAudioInfo * out_info, GstBuffer * input_buffer)
 {
   GstBuffer *res;
-  GstAudioAggregatorConvertPad *aaggcpad =
-      GST_AUDIO_AGGREGATOR_CONVERT_PAD (aaggpad);
-
-  if (!gst_audio_aggregator_convert_pad_update_converter (aaggcpad, in_info,
-          out_info)) {
-    return NULL;
-  }
 
-  if (aaggcpad->priv->converter) {
-    gint insize = gst_buffer_get_size (input_buffer);
-    gsize insamples = insize / in_info->bpf;
-    gsize outsamples =
-        gst_audio_converter_get_out_frames (aaggcpad->priv->converter,
+  if (converter) {
+    gsize insamples =
+        gst_audio_aggregator_buffer_get_frames (input_buffer, in_info->bpf);
+    gsize outsamples = gst_audio_converter_get_out_frames (converter,
         insamples);
     gint outsize = outsamples * out_info->bpf;
-    GstMapInfo inmap, outmap;
+    GstAudioMeta *meta;
+    GstAudioBuffer inabuf, outabuf;
 
     res = gst_buffer_new_allocate (NULL, outsize, NULL);
 
@@ -347,16 +377,29 @@ gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
         GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
         GST_BUFFER_COPY_META, 0, -1);
 
-    gst_buffer_map (input_buffer, &inmap, GST_MAP_READ);
-    gst_buffer_map (res, &outmap, GST_MAP_WRITE);
+    /* ... and for the audio meta describing the old layout */
+    while ((meta = gst_buffer_get_audio_meta (res)))
+      gst_buffer_remove_meta (res, (GstMeta *) meta);
+    if (GST_AUDIO_INFO_LAYOUT (out_info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+      gst_buffer_add_audio_meta (res, out_info, outsamples, NULL);
 
-    gst_audio_converter_samples (aaggcpad->priv->converter,
-        GST_AUDIO_CONVERTER_FLAG_NONE,
-        (gpointer *) & inmap.data, insamples,
-        (gpointer *) & outmap.data, outsamples);
+    if (!gst_audio_buffer_map (&inabuf, in_info, input_buffer, GST_MAP_READ)) {
+      GST_ERROR_OBJECT (aaggpad, "Failed to map input buffer");
+      gst_buffer_unref (res);
+      return NULL;
+    }
+    if (!gst_audio_buffer_map (&outabuf, out_info, res, GST_MAP_WRITE)) {
+      GST_ERROR_OBJECT (aaggpad, "Failed to map output buffer");
+      gst_audio_buffer_unmap (&inabuf);
+      gst_buffer_unref (res);
+      return NULL;
+    }
+
+    gst_audio_converter_samples (converter, GST_AUDIO_CONVERTER_FLAG_NONE,
+        inabuf.planes, insamples, outabuf.planes, outsamples);
 
-    gst_buffer_unmap (input_buffer, &inmap);
-    gst_buffer_unmap (res, &outmap);
+    gst_audio_buffer_unmap (&inabuf);
+    gst_audio_buffer_unmap (&outabuf);
   } else {
     res = gst_buffer_ref (input_buffer);
   }
@@ -364,6 +407,90 @@ gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
   return res;
 }
 
+static GstBuffer *
+gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
+    aaggpad, GstAudioInfo * in_info, GstAudioInfo * out_info,
+    GstBuffer * input_buffer)
+{
+  GstAudioAggregatorConvertPad *aaggcpad =
+      GST_AUDIO_AGGREGATOR_CONVERT_PAD (aaggpad);
+
+  if (!gst_audio_aggregator_convert_pad_update_converter (aaggcpad, in_info,
+          out_info)) {
+    return NULL;
+  }
+
+  return gst_audio_aggregator_convert_pad_convert_samples (aaggpad,
+      aaggcpad->priv->converter, in_info, out_info, input_buffer);
+}
+
+/* Converts the next input buffer ahead of the mixing. This is run in parallel
+ * for all pads, so only the pad's own state is used.
+ *
+ * The conversion itself is done without holding the pad's object lock. The
+ * converter is only ever replaced from the srcpad thread, which waits for
+ * all pads to be prepared before it continues. */
+static GstFlowReturn
+gst_audio_aggregator_convert_pad_prepare (GstAggregatorPad * aggpad,
+    GstAggregator * agg, GstBuffer * input_buffer)
+{
+  GstAudioAggregator *aagg = GST_AUDIO_AGGREGATOR (agg);
+  GstAudioAggregatorPad *pad = GST_AUDIO_AGGREGATOR_PAD (aggpad);
+  GstAudioAggregatorConvertPad *cpad = GST_AUDIO_AGGREGATOR_CONVERT_PAD (pad);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioConverter *converter;
+  GstAudioInfo in_info, out_info;
+  GstBuffer *converted;
+  guint max_active_pads;
+
+  /* Pads might not be mixed at all, only convert the selected ones later */
+  GST_OBJECT_LOCK (aagg);
+  max_active_pads = aagg->priv->max_active_pads;
+  GST_OBJECT_UNLOCK (aagg);
+  if (max_active_pads > 0)
+    return GST_FLOW_OK;
+
+  GST_OBJECT_LOCK (pad);
+  if (pad->priv->buffer || pad->priv->prepared_input == input_buffer ||
+      !GST_AUDIO_INFO_IS_VALID (&pad->info) ||
+      !GST_AUDIO_INFO_IS_VALID (&srcpad->info)) {
+    GST_OBJECT_UNLOCK (pad);
+    return GST_FLOW_OK;
+  }
+
+  in_info = pad->info;
+  out_info = srcpad->info;
+
+  /* Failures are reported when the buffer is converted again for mixing */
+  if (!gst_audio_aggregator_convert_pad_update_converter (cpad, &in_info,
+          &out_info)) {
+    GST_OBJECT_UNLOCK (pad);
+    return GST_FLOW_OK;
+  }
+  converter = cpad->priv->converter;
+  input_buffer = gst_buffer_ref (input_buffer);
+  GST_OBJECT_UNLOCK (pad);
+
+  converted = gst_audio_aggregator_convert_pad_convert_samples (pad, converter,
+      &in_info, &out_info, input_buffer);
+
+  GST_OBJECT_LOCK (pad);
+  /* Only keep the result if it is still what mixing would produce */
+  if (converted && !pad->priv->buffer &&
+      !cpad->priv->converter_config_changed &&
+      gst_audio_info_is_equal (&pad->info, &in_info) &&
+      gst_audio_info_is_equal (&srcpad->info, &out_info)) {
+    gst_buffer_replace (&pad->priv->prepared_input, input_buffer);
+    gst_buffer_replace (&pad->priv->prepared_buffer, converted);
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  gst_clear_buffer (&converted);
+  gst_buffer_unref (input_buffer);
+
+  return GST_FLOW_OK;
+}
+
 static void
 gst_audio_aggregator_convert_pad_finalize (GObject * object)
 {
@@ -411,6 +538,10 @@ gst_audio_aggregator_convert_pad_set_property (GObject * object, guint prop_id,
         gst_structure_free (pad->priv->converter_config);
       pad->priv->converter_config = g_value_dup_boxed (value);
       pad->priv->converter_config_changed = TRUE;
+      gst_buffer_replace (&GST_AUDIO_AGGREGATOR_PAD (pad)->priv->prepared_input,
+          NULL);
+      gst_buffer_replace (&GST_AUDIO_AGGREGATOR_PAD (pad)->
+          priv->prepared_buffer, NULL);
       GST_OBJECT_UNLOCK (pad);
       break;
     default:
@@ -424,6 +555,7 @@ gst_audio_aggregator_convert_pad_class_init (GstAudioAggregatorConvertPadClass *
     klass)
 {
   GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAggregatorPadClass *aggpad_class = (GstAggregatorPadClass *) klass;
   GstAudioAggregatorPadClass *aaggpad_class =
       (GstAudioAggregatorPadClass *) klass;
 
@@ -443,6 +575,9 @@ gst_audio_aggregator_convert_pad_class_init (GstAudioAggregatorConvertPadClass *
   aaggpad_class->update_conversion_info =
       gst_audio_aggregator_pad_update_conversion_info;
 
+  aggpad_class->prepare =
+      GST_DEBUG_FUNCPTR (gst_audio_aggregator_convert_pad_prepare);
+
   gobject_class->finalize = gst_audio_aggregator_convert_pad_finalize;
 }
 
@@ -484,6 +619,9 @@ struct _GstAudioAggregatorPrivate
   /* Sample offset starting from 0 at aggregator.segment.start */
   gint64 offset;
 
+  /* Protected by the object lock */
+  guint max_active_pads;
+
   /* info structure passed to selected-samples signal, must only be accessed
    * from the aggregate thread */
   GstStructure *selected_samples_info;
@@ -537,6 +675,7 @@ static GstSample *gst_audio_aggregator_peek_next_sample (GstAggregator * agg,
 #define DEFAULT_OUTPUT_BUFFER_DURATION_N (1)
 #define DEFAULT_OUTPUT_BUFFER_DURATION_D (100)
 #define DEFAULT_FORCE_LIVE FALSE
+#define DEFAULT_MAX_ACTIVE_PADS 0
 
 enum
 {
@@ -547,6 +686,7 @@ enum
   PROP_OUTPUT_BUFFER_DURATION_FRACTION,
   PROP_IGNORE_INACTIVE_PADS,
   PROP_FORCE_LIVE,
+  PROP_MAX_ACTIVE_PADS,
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioAggregator, gst_audio_aggregator,
@@ -760,6 +900,25 @@ gst_audio_aggregator_class_init (GstAudioAggregatorClass * klass)
           "whether any live sources are linked upstream",
           DEFAULT_FORCE_LIVE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT_ONLY));
+
+  /**
+   * GstAudioAggregator:max-active-pads:
+   *
+   * Maximum number of pads that are mixed at the same time, 0 for all pads.
+   *
+   * If set, only the pads with the loudest input are mixed, based on the
+   * #GstAudioLevelMeta of their buffers or on the RMS of their samples if
+   * there is none. Pads with the same level are treated the same, so more
+   * pads can be mixed if several of them are equally loud. Silent input is
+   * never mixed. The input of all other pads is dropped before conversion.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_ACTIVE_PADS,
+      g_param_spec_uint ("max-active-pads", "Max active pads",
+          "Maximum number of pads with the loudest input to mix (0 = all)",
+          0, G_MAXUINT, DEFAULT_MAX_ACTIVE_PADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -771,6 +930,7 @@ gst_audio_aggregator_init (GstAudioAggregator * aagg)
 
   aagg->priv->alignment_threshold = DEFAULT_ALIGNMENT_THRESHOLD;
   aagg->priv->discont_wait = DEFAULT_DISCONT_WAIT;
+  aagg->priv->max_active_pads = DEFAULT_MAX_ACTIVE_PADS;
 
   aagg->current_caps = NULL;
 
@@ -830,6 +990,11 @@ gst_audio_aggregator_set_property (GObject * object, guint prop_id,
       gst_aggregator_set_force_live (GST_AGGREGATOR (object),
           g_value_get_boolean (value));
       break;
+    case PROP_MAX_ACTIVE_PADS:
+      GST_OBJECT_LOCK (aagg);
+      aagg->priv->max_active_pads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (aagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -866,6 +1031,11 @@ gst_audio_aggregator_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value,
           gst_aggregator_get_force_live (GST_AGGREGATOR (object)));
       break;
+    case PROP_MAX_ACTIVE_PADS:
+      GST_OBJECT_LOCK (aagg);
+      g_value_set_uint (value, aagg->priv->max_active_pads);
+      GST_OBJECT_UNLOCK (aagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1101,6 +1271,8 @@ gst_audio_aggregator_sink_setcaps (GstAudioAggregatorPad * aaggpad,
     aaggpad->info = info;
     if (klass->update_conversion_info)
       klass->update_conversion_info (aaggpad);
+    gst_buffer_replace (&aaggpad->priv->prepared_input, NULL);
+    gst_buffer_replace (&aaggpad->priv->prepared_buffer, NULL);
     GST_OBJECT_UNLOCK (aaggpad);
   }
 
@@ -1221,6 +1393,8 @@ gst_audio_aggregator_update_converters (GstAudioAggregator * aagg,
 
     if (klass->update_conversion_info)
       klass->update_conversion_info (aaggpad);
+    gst_buffer_replace (&aaggpad->priv->prepared_input, NULL);
+    gst_buffer_replace (&aaggpad->priv->prepared_buffer, NULL);
 
     /* If we currently were mixing a buffer, we need to convert it to the new
      * format */
@@ -1812,6 +1986,147 @@ gst_audio_aggregator_post_messages (GstAudioAggregator * aagg)
  * values.
  */
 #define ABSDIFF(a, b) ((a) > (b) ? (a) - (b) : (b) - (a))
+#define LEVEL_CHUNK_SAMPLES 256
+
+/* Returns the level of @buffer in -dBov like the RTP audio level header
+ * extension (RFC 6464): 0 is full scale and 127 is silence.
+ *
+ * Called with the pad object lock */
+static guint8
+gst_audio_aggregator_pad_get_level (GstAudioAggregatorPad * pad,
+    GstBuffer * buffer)
+{
+  const GstAudioFormatInfo *finfo = pad->info.finfo;
+  GstAudioLevelMeta *meta;
+  GstMapInfo map;
+  gsize n_samples, done, n, i;
+  gdouble sum = 0.0, rms;
+  guint width;
+  union
+  {
+    gint32 s32[LEVEL_CHUNK_SAMPLES];
+    gdouble f64[LEVEL_CHUNK_SAMPLES];
+  } tmp;
+
+  meta = gst_buffer_get_audio_level_meta (buffer);
+  if (meta)
+    return MIN (meta->level, 127);
+
+  if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP))
+    return 127;
+
+  /* Without a known format never prune the pad */
+  width = finfo ? GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 : 0;
+  if (width == 0 || !finfo->unpack_func)
+    return 0;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return 0;
+
+  /* The channel layout does not matter here, all samples are summed up */
+  n_samples = map.size / width;
+  for (done = 0; done < n_samples; done += n) {
+    n = MIN (n_samples - done, LEVEL_CHUNK_SAMPLES);
+
+    finfo->unpack_func (finfo, GST_AUDIO_PACK_FLAG_NONE, &tmp,
+        map.data + done * width, n);
+
+    if (finfo->unpack_format == GST_AUDIO_FORMAT_F64) {
+      for (i = 0; i < n; i++)
+        sum += tmp.f64[i] * tmp.f64[i];
+    } else {
+      for (i = 0; i < n; i++) {
+        gdouble v = tmp.s32[i] / 2147483648.0;
+        sum += v * v;
+      }
+    }
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  if (n_samples == 0)
+    return 127;
+
+  rms = sqrt (sum / n_samples);
+  if (rms <= 0.0)
+    return 127;
+
+  return (guint8) CLAMP (-20.0 * log10 (rms), 0.0, 127.0);
+}
+
+/* Updates the levels of all pads that take a new input buffer next and
+ * returns the highest level in -dBov at which pads are mixed.
+ *
+ * Called with the aggregator object lock */
+static gint
+gst_audio_aggregator_update_levels (GstAudioAggregator * aagg)
+{
+  GstElement *element = GST_ELEMENT (aagg);
+  guint histogram[128] = { 0, };
+  guint count = 0;
+  GList *iter;
+  gint level;
+
+  for (iter = element->sinkpads; iter; iter = iter->next) {
+    GstAudioAggregatorPad *pad = (GstAudioAggregatorPad *) iter->data;
+    GstAggregatorPad *aggpad = (GstAggregatorPad *) iter->data;
+    GstBuffer *input_buffer;
+
+    if (gst_aggregator_pad_is_inactive (aggpad))
+      continue;
+
+    input_buffer = gst_aggregator_pad_peek_buffer (aggpad);
+
+    GST_OBJECT_LOCK (pad);
+    /* Only look at buffers that are going to be taken next, the current one
+     * keeps its decision until it is completely mixed */
+    if (input_buffer && !pad->priv->buffer)
+      pad->priv->level = gst_audio_aggregator_pad_get_level (pad, input_buffer);
+    else if (!input_buffer && gst_aggregator_pad_is_eos (aggpad))
+      pad->priv->level = 127;
+    histogram[pad->priv->level]++;
+    GST_OBJECT_UNLOCK (pad);
+
+    if (input_buffer)
+      gst_buffer_unref (input_buffer);
+  }
+
+  for (level = 0; level < 127; level++) {
+    count += histogram[level];
+    if (count >= aagg->priv->max_active_pads)
+      return level;
+  }
+
+  /* Fewer pads than allowed are not silent, mix all of them */
+  return 126;
+}
+
+/* Returns an empty gap buffer with the same timestamp and duration as
+ * @input_buffer that replaces it for a pad that is not mixed.
+ *
+ * Called with the pad object lock */
+static GstBuffer *
+gst_audio_aggregator_pad_make_pruned_buffer (GstAudioAggregatorPad * pad,
+    GstBuffer * input_buffer)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+  gsize frames;
+
+  gst_buffer_copy_into (buffer, input_buffer,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_GAP);
+
+  /* Derive the duration from the number of samples, rounded up so that
+   * gst_audio_aggregator_fill_buffer() gets the same number back */
+  frames = gst_audio_aggregator_buffer_get_frames (input_buffer,
+      GST_AUDIO_INFO_BPF (&pad->info));
+  if (frames > 0)
+    GST_BUFFER_DURATION (buffer) =
+        gst_util_uint64_scale_int_ceil (frames, GST_SECOND,
+        GST_AUDIO_INFO_RATE (&pad->info));
+
+  return buffer;
+}
+
 static gboolean
 gst_audio_aggregator_fill_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * pad)
@@ -1834,7 +2149,8 @@ gst_audio_aggregator_fill_buffer (GstAudioAggregator * aagg,
   }
 
   pad->priv->position = 0;
-  pad->priv->size = gst_buffer_get_size (pad->priv->buffer) / bpf;
+  pad->priv->size =
+      gst_audio_aggregator_buffer_get_frames (pad->priv->buffer, bpf);
 
   if (pad->priv->size == 0) {
     if (!GST_BUFFER_DURATION_IS_VALID (pad->priv->buffer) ||
@@ -2152,6 +2468,11 @@ gst_audio_aggregator_create_output_buffer (GstAudioAggregator * aagg,
       outmap.size);
   gst_buffer_unmap (outbuf, &outmap);
 
+  /* Planes are laid out one after another, subclasses find them through
+   * the meta */
+  if (GST_AUDIO_INFO_LAYOUT (&srcpad->info) == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    gst_buffer_add_audio_meta (outbuf, &srcpad->info, num_frames, NULL);
+
   return outbuf;
 }
 
@@ -2227,6 +2548,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
   guint n_sinkpads, i;
   GstFlowReturn ret;
   GstBuffer *outbuf = NULL;
+  gint max_level = 127;
   gint64 next_offset;
   gint64 next_timestamp;
   gint rate, bpf;
@@ -2344,6 +2666,11 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
   outbuf = aagg->priv->current_buffer;
 
+  if (aagg->priv->max_active_pads > 0) {
+    max_level = gst_audio_aggregator_update_levels (aagg);
+    GST_LOG_OBJECT (agg, "Mixing pads with a level up to %d -dBov", max_level);
+  }
+
   GST_LOG_OBJECT (agg,
       "Starting to mix %u samples for offset %" G_GINT64_FORMAT
       " with timestamp %" GST_TIME_FORMAT, blocksize,
@@ -2386,7 +2713,23 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
     /* New buffer? */
     if (!pad->priv->buffer) {
-      if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer) {
+      GstBuffer *prepared = NULL;
+
+      /* Take the conversion result from preparing the pads, if any */
+      if (pad->priv->prepared_input == input_buffer)
+        prepared = g_steal_pointer (&pad->priv->prepared_buffer);
+      gst_buffer_replace (&pad->priv->prepared_input, NULL);
+      gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
+
+      if (pad->priv->level > max_level) {
+        GST_LOG_OBJECT (pad, "Not mixing buffer with level %u -dBov",
+            pad->priv->level);
+        pad->priv->buffer =
+            gst_audio_aggregator_pad_make_pruned_buffer (pad, input_buffer);
+        gst_clear_buffer (&prepared);
+      } else if (prepared) {
+        pad->priv->buffer = prepared;
+      } else if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer) {
         pad->priv->buffer =
             gst_audio_aggregator_convert_buffer
             (aagg, GST_PAD (pad), &pad->info, &srcpad->info, input_buffer);
@@ -2574,8 +2917,18 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
           agg_segment->start + gst_util_uint64_scale (next_offset, GST_SECOND,
           rate);
 
-      if (next_offset > aagg->priv->offset)
-        gst_buffer_resize (outbuf, 0, (next_offset - aagg->priv->offset) * bpf);
+      if (next_offset > aagg->priv->offset) {
+        if (GST_AUDIO_INFO_LAYOUT (&srcpad->info) ==
+            GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+          /* Only the meta is updated, the planes stay where they are */
+          outbuf = gst_audio_buffer_truncate (outbuf, bpf, 0,
+              next_offset - aagg->priv->offset);
+          aagg->priv->current_buffer = outbuf;
+        } else {
+          gst_buffer_resize (outbuf, 0,
+              (next_offset - aagg->priv->offset) * bpf);
+        }
+      }
     }
   }
 
@@ -0,0 +1,213 @@
+/* GStreamer
+ * Copyright (C) 2026 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstvideodamagemeta.h"
+
+/**
+ * SECTION:gstvideodamagemeta
+ * @title: GstVideoDamageMeta
+ * @short_description: GstMeta describing the changed regions of a frame
+ *
+ * Producers that know which parts of a frame changed since the previous
+ * frame, like a compositor that only redraws the inputs that got new
+ * content, can attach a #GstVideoDamageMeta listing those regions. Consumers
+ * such as encoders can use it to skip or cheaply code the unchanged parts.
+ *
+ * Since: 1.28
+ */
+
+/**
+ * gst_video_damage_meta_api_get_type:
+ *
+ * Returns: #GType for the #GstVideoDamageMeta structure.
+ *
+ * Since: 1.28
+ */
+GType
+gst_video_damage_meta_api_get_type (void)
+{
+  static GType type = 0;
+  static const gchar *tags[] = { GST_META_TAG_VIDEO_STR, NULL };
+
+  if (g_once_init_enter (&type)) {
+    GType _type = gst_meta_api_type_register ("GstVideoDamageMetaAPI", tags);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+static gboolean
+gst_video_damage_meta_transform (GstBuffer * dest,
+    GstMeta * meta, GstBuffer * buffer, GQuark type, gpointer data)
+{
+  GstVideoDamageMeta *dmeta, *smeta;
+  guint i;
+
+  smeta = (GstVideoDamageMeta *) meta;
+
+  if (GST_META_TRANSFORM_IS_COPY (type)) {
+    dmeta = gst_buffer_add_video_damage_meta (dest);
+    if (!dmeta)
+      return FALSE;
+
+    for (i = 0; i < smeta->n_regions; i++) {
+      gst_video_damage_meta_add_region (dmeta, smeta->regions[i].x,
+          smeta->regions[i].y, smeta->regions[i].w, smeta->regions[i].h);
+    }
+  } else if (GST_VIDEO_META_TRANSFORM_IS_SCALE (type)) {
+    GstVideoMetaTransform *trans = data;
+    gint ow, oh, nw, nh;
+
+    ow = GST_VIDEO_INFO_WIDTH (trans->in_info);
+    nw = GST_VIDEO_INFO_WIDTH (trans->out_info);
+    oh = GST_VIDEO_INFO_HEIGHT (trans->in_info);
+    nh = GST_VIDEO_INFO_HEIGHT (trans->out_info);
+
+    if (ow <= 0 || oh <= 0)
+      return FALSE;
+
+    dmeta = gst_buffer_add_video_damage_meta (dest);
+    if (!dmeta)
+      return FALSE;
+
+    /* round outwards, the filter taps of the scaler spread a change over
+     * neighbouring pixels anyway */
+    for (i = 0; i < smeta->n_regions; i++) {
+      const GstVideoDamageRegion *r = &smeta->regions[i];
+      gint x0, y0, x1, y1;
+
+      x0 = ((gint64) r->x * nw) / ow;
+      y0 = ((gint64) r->y * nh) / oh;
+      x1 = ((gint64) (r->x + r->w) * nw + ow - 1) / ow;
+      y1 = ((gint64) (r->y + r->h) * nh + oh - 1) / oh;
+
+      gst_video_damage_meta_add_region (dmeta, MAX (x0 - 1, 0),
+          MAX (y0 - 1, 0), MIN (x1 + 1, nw) - MAX (x0 - 1, 0),
+          MIN (y1 + 1, nh) - MAX (y0 - 1, 0));
+    }
+  } else {
+    /* return FALSE, if transform type is not supported */
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean
+gst_video_damage_meta_init (GstMeta * meta, gpointer params,
+    GstBuffer * buffer)
+{
+  GstVideoDamageMeta *dmeta = (GstVideoDamageMeta *) meta;
+
+  dmeta->n_regions = 0;
+  dmeta->regions = NULL;
+
+  return TRUE;
+}
+
+static void
+gst_video_damage_meta_free (GstMeta * meta, GstBuffer * buffer)
+{
+  GstVideoDamageMeta *dmeta = (GstVideoDamageMeta *) meta;
+
+  g_clear_pointer (&dmeta->regions, g_free);
+  dmeta->n_regions = 0;
+}
+
+/**
+ * gst_video_damage_meta_get_info:
+ *
+ * Returns: #GstMetaInfo pointer that describes #GstVideoDamageMeta.
+ *
+ * Since: 1.28
+ */
+const GstMetaInfo *
+gst_video_damage_meta_get_info (void)
+{
+  static const GstMetaInfo *info = NULL;
+
+  if (g_once_init_enter ((GstMetaInfo **) & info)) {
+    const GstMetaInfo *meta =
+        gst_meta_register (GST_VIDEO_DAMAGE_META_API_TYPE,
+        "GstVideoDamageMeta",
+        sizeof (GstVideoDamageMeta),
+        gst_video_damage_meta_init,
+        gst_video_damage_meta_free,
+        gst_video_damage_meta_transform);
+    g_once_init_leave ((GstMetaInfo **) & info, (GstMetaInfo *) meta);
+  }
+
+  return info;
+}
+
+/**
+ * gst_buffer_add_video_damage_meta:
+ * @buffer: (transfer none): a #GstBuffer
+ *
+ * Attaches a #GstVideoDamageMeta without any region to @buffer, marking it as
+ * unchanged compared to the previous frame. Use
+ * gst_video_damage_meta_add_region() to add the regions that changed.
+ *
+ * Returns: (transfer none): the #GstVideoDamageMeta on @buffer.
+ *
+ * Since: 1.28
+ */
+GstVideoDamageMeta *
+gst_buffer_add_video_damage_meta (GstBuffer * buffer)
+{
+  g_return_val_if_fail (buffer != NULL, NULL);
+
+  return (GstVideoDamageMeta *) gst_buffer_add_meta (buffer,
+      GST_VIDEO_DAMAGE_META_INFO, NULL);
+}
+
+/**
+ * gst_video_damage_meta_add_region:
+ * @meta: a #GstVideoDamageMeta
+ * @x: X position of the region
+ * @y: Y position of the region
+ * @w: width of the region
+ * @h: height of the region
+ *
+ * Adds the given rectangle to the changed regions of @meta. Empty rectangles
+ * are ignored.
+ *
+ * Since: 1.28
+ */
+void
+gst_video_damage_meta_add_region (GstVideoDamageMeta * meta, gint x, gint y,
+    gint w, gint h)
+{
+  GstVideoDamageRegion *r;
+
+  g_return_if_fail (meta != NULL);
+
+  if (w <= 0 || h <= 0)
+    return;
+
+  meta->regions = g_renew (GstVideoDamageRegion, meta->regions,
+      meta->n_regions + 1);
+  r = &meta->regions[meta->n_regions++];
+  r->x = x;
+  r->y = y;
+  r->w = w;
+  r->h = h;
+}
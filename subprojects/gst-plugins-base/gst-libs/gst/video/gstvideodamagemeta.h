@@ -0,0 +1,117 @@
+/* GStreamer
+ * Copyright (C) 2026 GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_DAMAGE_META_H__
+#define __GST_VIDEO_DAMAGE_META_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GST_VIDEO_DAMAGE_META_API_TYPE:
+ *
+ * Since: 1.28
+ */
+#define GST_VIDEO_DAMAGE_META_API_TYPE (gst_video_damage_meta_api_get_type())
+
+/**
+ * GST_VIDEO_DAMAGE_META_INFO:
+ *
+ * Since: 1.28
+ */
+#define GST_VIDEO_DAMAGE_META_INFO  (gst_video_damage_meta_get_info())
+
+typedef struct _GstVideoDamageRegion GstVideoDamageRegion;
+typedef struct _GstVideoDamageMeta GstVideoDamageMeta;
+
+/**
+ * GstVideoDamageRegion:
+ * @x: X coordinate of the top-left corner of the region
+ * @y: Y coordinate of the top-left corner of the region
+ * @w: width of the region
+ * @h: height of the region
+ *
+ * A region of a frame that changed.
+ *
+ * Since: 1.28
+ */
+struct _GstVideoDamageRegion
+{
+  gint x;
+  gint y;
+  gint w;
+  gint h;
+};
+
+/**
+ * GstVideoDamageMeta:
+ * @meta: parent #GstMeta
+ * @n_regions: the number of regions in @regions
+ * @regions: (array length=n_regions): the regions of the frame that changed
+ *
+ * Describes which parts of a video frame changed compared to the previous
+ * frame of the same stream. The content outside of @regions is identical to
+ * the previous frame. A meta without any region marks a frame that is a
+ * repeat of the previous one, while a frame without this meta carries no
+ * information about what changed.
+ *
+ * Regions are in the coordinates of the frame and may overlap.
+ *
+ * Since: 1.28
+ */
+struct _GstVideoDamageMeta
+{
+  GstMeta meta;
+
+  guint n_regions;
+  GstVideoDamageRegion *regions;
+};
+
+GST_VIDEO_API
+GType gst_video_damage_meta_api_get_type          (void);
+
+GST_VIDEO_API
+const GstMetaInfo *gst_video_damage_meta_get_info (void);
+
+/**
+ * gst_buffer_get_video_damage_meta:
+ * @b: A #GstBuffer
+ *
+ * Helper macro to get #GstVideoDamageMeta from an existing #GstBuffer.
+ *
+ * Returns: (nullable): the #GstVideoDamageMeta pointer, or %NULL if none.
+ *
+ * Since: 1.28
+ */
+#define gst_buffer_get_video_damage_meta(b) \
+    ((GstVideoDamageMeta *)gst_buffer_get_meta((b),GST_VIDEO_DAMAGE_META_API_TYPE))
+
+GST_VIDEO_API
+GstVideoDamageMeta *gst_buffer_add_video_damage_meta (GstBuffer * buffer);
+
+GST_VIDEO_API
+void                gst_video_damage_meta_add_region (GstVideoDamageMeta * meta,
+                                                      gint x, gint y,
+                                                      gint w, gint h);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_DAMAGE_META_H__ */
@@ -81,6 +81,14 @@
  *     to allow the base class to do timestamp and offset tracking, and possibly
  *     to requeue the frame for a later attempt in the case of reverse playback.
  *
+ *   * Subclasses that decode several frames in parallel on their own worker
+ *     threads can enable asynchronous decoding with
+ *     @gst_video_decoder_set_async_depth. @handle_frame then only has to
+ *     queue the frame, and the worker completes it with
+ *     @gst_video_decoder_finish_frame_async. The base class pushes completed
+ *     frames downstream from the streaming thread in the order they were
+ *     passed to @handle_frame, with the usual timestamp handling and QoS.
+ *
  * ## Shutdown phase
  *
  *   * The GstVideoDecoder class calls @stop to inform the subclass that data
@@ -315,6 +323,7 @@ GST_DEBUG_CATEGORY (videodecoder_debug);
 #define REQUEST_SYNC_POINT_PENDING G_MAXUINT + 1
 #define REQUEST_SYNC_POINT_UNSET G_MAXUINT64
 #define DEFAULT_DETECT_REORDERING         TRUE
+#define DEFAULT_DROP_BEFORE_DECODE        FALSE
 
 enum
 {
@@ -326,6 +335,7 @@ enum
   PROP_AUTOMATIC_REQUEST_SYNC_POINTS,
   PROP_AUTOMATIC_REQUEST_SYNC_POINT_FLAGS,
   PROP_DETECT_REORDERING,
+  PROP_DROP_BEFORE_DECODE,
   PROP_LAST
 };
 
@@ -407,6 +417,7 @@ struct _GstVideoDecoderPrivate
   /* Properties */
   GstClockTime min_force_key_unit_interval;
   gboolean discard_corrupted_frames;
+  gboolean drop_before_decode;
 
   /* Key unit related state */
   gboolean needs_sync_point;
@@ -459,6 +470,16 @@ struct _GstVideoDecoderPrivate
   /* flags */
   gboolean use_default_pad_acceptcaps;
 
+  /* asynchronous decoding, see gst_video_decoder_set_async_depth() */
+  GMutex async_lock;
+  GCond async_cond;
+  guint async_depth;            /* async_lock */
+  gboolean async_flushing;      /* async_lock */
+  /* incremented on every change of the fields above */
+  guint async_cookie;           /* async_lock */
+  /* AsyncFrame in the order they were passed to handle_frame */
+  GQueue async_frames;          /* async_lock */
+
 #ifndef GST_DISABLE_DEBUG
   /* Diagnostic time for reporting the time
    * from flush to first output */
@@ -466,6 +487,15 @@ struct _GstVideoDecoderPrivate
 #endif
 };
 
+/* A frame passed to handle_frame in asynchronous mode. @frame holds a
+ * reference only once @done is set by gst_video_decoder_finish_frame_async() */
+typedef struct _AsyncFrame AsyncFrame;
+struct _AsyncFrame
+{
+  GstVideoCodecFrame *frame;
+  gboolean done;
+};
+
 static GstElementClass *parent_class = NULL;
 static gint private_offset = 0;
 
@@ -547,6 +577,14 @@ static void gst_video_decoder_copy_metas (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame, GstBuffer * src_buffer,
     GstBuffer * dest_buffer);
 
+static GstFlowReturn gst_video_decoder_push_async_frames (GstVideoDecoder *
+    decoder, guint max_pending);
+static void gst_video_decoder_clear_async_frames (GstVideoDecoder * decoder);
+static void gst_video_decoder_remove_async_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame);
+static void gst_video_decoder_set_async_flushing (GstVideoDecoder * decoder,
+    gboolean flushing);
+
 static void gst_video_decoder_request_sync_point_internal (GstVideoDecoder *
     dec, GstClockTime deadline, GstVideoDecoderRequestSyncPointFlags flags);
 
@@ -735,6 +773,26 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
           DEFAULT_DETECT_REORDERING,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoDecoder:drop-before-decode:
+   *
+   * If set to %TRUE and QoS is enabled, the decoder skips frames that no
+   * other frame depends on without decoding them when they would be too
+   * late anyway, instead of dropping them after decoding.
+   *
+   * Frames are known to be droppable from %GST_BUFFER_FLAG_DROPPABLE on the
+   * input buffers, as set by parsers for non-reference pictures, or from
+   * %GST_VIDEO_CODEC_FRAME_FLAG_DROPPABLE set by the subclass.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_BEFORE_DECODE,
+      g_param_spec_boolean ("drop-before-decode",
+          "Drop before decode",
+          "Skip decoding late frames that no other frame depends on",
+          DEFAULT_DROP_BEFORE_DECODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   meta_tag_video_quark = g_quark_from_static_string (GST_META_TAG_VIDEO_STR);
 }
 
@@ -786,10 +844,15 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
   g_queue_init (&decoder->priv->frames);
   g_queue_init (&decoder->priv->timestamps);
 
+  g_mutex_init (&decoder->priv->async_lock);
+  g_cond_init (&decoder->priv->async_cond);
+  g_queue_init (&decoder->priv->async_frames);
+
   /* properties */
   decoder->priv->do_qos = DEFAULT_QOS;
   decoder->priv->max_errors = GST_VIDEO_DECODER_MAX_ERRORS;
   decoder->priv->detect_reordering = DEFAULT_DETECT_REORDERING;
+  decoder->priv->drop_before_decode = DEFAULT_DROP_BEFORE_DECODE;
 
   decoder->priv->min_latency = 0;
   decoder->priv->max_latency = 0;
@@ -961,6 +1024,8 @@ gst_video_decoder_finalize (GObject * object)
   GST_DEBUG_OBJECT (object, "finalize");
 
   g_rec_mutex_clear (&decoder->stream_lock);
+  g_mutex_clear (&decoder->priv->async_lock);
+  g_cond_clear (&decoder->priv->async_cond);
 
   if (decoder->priv->input_adapter) {
     g_object_unref (decoder->priv->input_adapter);
@@ -1018,6 +1083,9 @@ gst_video_decoder_get_property (GObject * object, guint property_id,
     case PROP_DETECT_REORDERING:
       g_value_set_boolean (value, priv->detect_reordering);
       break;
+    case PROP_DROP_BEFORE_DECODE:
+      g_value_set_boolean (value, priv->drop_before_decode);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -1053,6 +1121,9 @@ gst_video_decoder_set_property (GObject * object, guint property_id,
     case PROP_DETECT_REORDERING:
       priv->detect_reordering = g_value_get_boolean (value);
       break;
+    case PROP_DROP_BEFORE_DECODE:
+      priv->drop_before_decode = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -1224,6 +1295,10 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
     ret = gst_video_decoder_flush_parse (dec, TRUE);
   }
 
+  /* wait for all frames that are still decoded asynchronously */
+  if (ret == GST_FLOW_OK)
+    ret = gst_video_decoder_push_async_frames (dec, 0);
+
   return ret;
 }
 
@@ -1718,6 +1793,10 @@ gst_video_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (decoder, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* wake up the streaming thread if it waits for asynchronous frames */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+    gst_video_decoder_set_async_flushing (decoder, TRUE);
+
   if (decoder_class->sink_event)
     ret = decoder_class->sink_event (decoder, event);
 
@@ -2349,6 +2428,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     gst_segment_init (&decoder->input_segment, GST_FORMAT_UNDEFINED);
     gst_segment_init (&decoder->output_segment, GST_FORMAT_UNDEFINED);
     gst_video_decoder_clear_queues (decoder);
+    gst_video_decoder_clear_async_frames (decoder);
     decoder->priv->in_out_segment_sync = TRUE;
 
     if (priv->current_frame) {
@@ -2727,6 +2807,10 @@ gst_video_decoder_flush_parse (GstVideoDecoder * dec, gboolean at_eos)
         res = decoder_class->finish (dec);
       }
 
+      /* and wait for the frames that are decoded asynchronously */
+      if (res == GST_FLOW_OK)
+        res = gst_video_decoder_push_async_frames (dec, 0);
+
       if (res != GST_FLOW_OK)
         goto done;
 
@@ -2854,6 +2938,14 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   else
     ret = gst_video_decoder_chain_reverse (decoder, buf);
 
+  /* make room for the next asynchronously decoded frame */
+  if (ret == GST_FLOW_OK) {
+    guint async_depth = gst_video_decoder_get_async_depth (decoder);
+
+    ret = gst_video_decoder_push_async_frames (decoder,
+        async_depth > 0 ? async_depth - 1 : 0);
+  }
+
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
   return ret;
 
@@ -2892,6 +2984,11 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
       if (decoder_class->start && !decoder_class->start (decoder))
         goto start_failed;
       break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* don't let the streaming thread wait for asynchronous frames while
+       * the pads are deactivated */
+      gst_video_decoder_set_async_flushing (decoder, TRUE);
+      break;
     default:
       break;
   }
@@ -3217,6 +3314,7 @@ gst_video_decoder_release_frame (GstVideoDecoder * dec,
     gst_video_codec_frame_unref (frame);
     g_queue_delete_link (&dec->priv->frames, link);
   }
+  gst_video_decoder_remove_async_frame (dec, frame);
   if (frame->events) {
     dec->priv->pending_events =
         g_list_concat (frame->events, dec->priv->pending_events);
@@ -3621,6 +3719,183 @@ gst_video_decoder_finish_subframe (GstVideoDecoder * decoder,
   return GST_FLOW_OK;
 }
 
+/* With STREAM_LOCK. Pushes the asynchronously finished frames at the head of
+ * the queue downstream, waiting for the oldest one as long as more than
+ * @max_pending frames are queued. The stream lock is released while waiting
+ * so that the workers can allocate output buffers, it must only be held
+ * once by the caller then. */
+static GstFlowReturn
+gst_video_decoder_push_async_frames (GstVideoDecoder * decoder,
+    guint max_pending)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  AsyncFrame *async;
+
+  g_mutex_lock (&priv->async_lock);
+  while ((async = g_queue_peek_head (&priv->async_frames))) {
+    GstVideoCodecFrame *frame;
+
+    if (priv->async_flushing) {
+      ret = GST_FLOW_FLUSHING;
+      break;
+    }
+
+    if (!async->done) {
+      guint cookie = priv->async_cookie;
+
+      if (priv->async_frames.length <= max_pending || ret != GST_FLOW_OK)
+        break;
+
+      GST_LOG_OBJECT (decoder, "waiting for frame #%u, %u frames pending",
+          async->frame->system_frame_number, priv->async_frames.length);
+
+      g_mutex_unlock (&priv->async_lock);
+      GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+      g_mutex_lock (&priv->async_lock);
+      while (cookie == priv->async_cookie)
+        g_cond_wait (&priv->async_cond, &priv->async_lock);
+      g_mutex_unlock (&priv->async_lock);
+
+      GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+      g_mutex_lock (&priv->async_lock);
+      continue;
+    }
+
+    g_queue_pop_head (&priv->async_frames);
+    frame = async->frame;
+    g_free (async);
+    g_mutex_unlock (&priv->async_lock);
+
+    /* after an error only release the remaining finished frames */
+    if (ret == GST_FLOW_OK)
+      ret = gst_video_decoder_finish_frame (decoder, frame);
+    else
+      gst_video_decoder_release_frame (decoder, frame);
+
+    g_mutex_lock (&priv->async_lock);
+  }
+  g_mutex_unlock (&priv->async_lock);
+
+  return ret;
+}
+
+/* With STREAM_LOCK */
+static void
+gst_video_decoder_clear_async_frames (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GQueue done = G_QUEUE_INIT;
+  AsyncFrame *async;
+
+  g_mutex_lock (&priv->async_lock);
+  while ((async = g_queue_pop_head (&priv->async_frames))) {
+    if (async->done)
+      g_queue_push_tail (&done, async->frame);
+    g_free (async);
+  }
+  priv->async_flushing = FALSE;
+  priv->async_cookie++;
+  g_cond_broadcast (&priv->async_cond);
+  g_mutex_unlock (&priv->async_lock);
+
+  g_queue_clear_full (&done, (GDestroyNotify) gst_video_codec_frame_unref);
+}
+
+/* With STREAM_LOCK, for frames that are released without going through
+ * gst_video_decoder_finish_frame_async() */
+static void
+gst_video_decoder_remove_async_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  AsyncFrame *async = NULL;
+  GList *l;
+
+  g_mutex_lock (&priv->async_lock);
+  for (l = priv->async_frames.head; l; l = l->next) {
+    if (((AsyncFrame *) l->data)->frame == frame) {
+      async = l->data;
+      g_queue_delete_link (&priv->async_frames, l);
+      priv->async_cookie++;
+      g_cond_broadcast (&priv->async_cond);
+      break;
+    }
+  }
+  g_mutex_unlock (&priv->async_lock);
+
+  if (async && async->done)
+    gst_video_codec_frame_unref (async->frame);
+  g_free (async);
+}
+
+static void
+gst_video_decoder_set_async_flushing (GstVideoDecoder * decoder,
+    gboolean flushing)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  g_mutex_lock (&priv->async_lock);
+  priv->async_flushing = flushing;
+  priv->async_cookie++;
+  g_cond_broadcast (&priv->async_cond);
+  g_mutex_unlock (&priv->async_lock);
+}
+
+/**
+ * gst_video_decoder_finish_frame_async:
+ * @decoder: a #GstVideoDecoder
+ * @frame: (transfer full): a decoded #GstVideoCodecFrame
+ *
+ * Marks @frame, which was passed to the subclass' @handle_frame while
+ * asynchronous decoding is enabled, as decoded. This can be called from any
+ * thread and doesn't take the stream lock.
+ *
+ * The base class then finishes the frame from the streaming thread as with
+ * gst_video_decoder_finish_frame(), once all frames that were passed to
+ * @handle_frame before it are finished too. A frame without output buffer
+ * is skipped.
+ *
+ * Returns: %GST_FLOW_OK, or %GST_FLOW_FLUSHING if the frame was discarded
+ *     by a flush in the meantime.
+ *
+ * Since: 1.28
+ */
+GstFlowReturn
+gst_video_decoder_finish_frame_async (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv;
+  GList *l;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), GST_FLOW_ERROR);
+  g_return_val_if_fail (frame != NULL, GST_FLOW_ERROR);
+
+  priv = decoder->priv;
+
+  GST_LOG_OBJECT (decoder, "finish frame %p asynchronously", frame);
+
+  g_mutex_lock (&priv->async_lock);
+  for (l = priv->async_frames.head; l; l = l->next) {
+    AsyncFrame *async = l->data;
+
+    if (async->frame == frame && !async->done) {
+      async->done = TRUE;
+      priv->async_cookie++;
+      g_cond_broadcast (&priv->async_cond);
+      g_mutex_unlock (&priv->async_lock);
+      return GST_FLOW_OK;
+    }
+  }
+  g_mutex_unlock (&priv->async_lock);
+
+  GST_DEBUG_OBJECT (decoder, "frame %p is not pending anymore", frame);
+  gst_video_codec_frame_unref (frame);
+
+  return GST_FLOW_FLUSHING;
+}
+
 /* With stream lock, takes the frame reference */
 static GstFlowReturn
 gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
@@ -3936,6 +4211,31 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
   return ret;
 }
 
+/* Like the QoS check in gst_video_decoder_clip_and_push_buf(), based on the
+ * input timestamps as the frame is not decoded yet */
+static gboolean
+gst_video_decoder_frame_is_late (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstClockTime deadline = frame->deadline;
+  GstClockTime earliest_time;
+
+  if (!priv->do_qos || decoder->input_segment.rate < 0.0
+      || !GST_CLOCK_TIME_IS_VALID (deadline))
+    return FALSE;
+
+  /* don't drop a frame which is partially late */
+  if (GST_CLOCK_TIME_IS_VALID (frame->duration))
+    deadline += frame->duration;
+
+  GST_OBJECT_LOCK (decoder);
+  earliest_time = priv->earliest_time;
+  GST_OBJECT_UNLOCK (decoder);
+
+  return GST_CLOCK_TIME_IS_VALID (earliest_time) && deadline < earliest_time;
+}
+
 /* Pass the frame in priv->current_frame through the
  * handle_frame() callback for decoding and passing to gvd_finish_frame(),
  * or dropping by passing to gvd_drop_frame() */
@@ -3946,6 +4246,7 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoDecoderClass *decoder_class;
   GstFlowReturn ret = GST_FLOW_OK;
+  guint async_depth = 0;
 
   decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
 
@@ -3961,6 +4262,9 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  if (GST_BUFFER_FLAG_IS_SET (frame->input_buffer, GST_BUFFER_FLAG_DROPPABLE))
+    GST_VIDEO_CODEC_FRAME_SET_DROPPABLE (frame);
+
   /* For keyframes, PTS = DTS + constant_offset, usually 0 to 3 frame
    * durations. */
   /* FIXME upstream can be quite wrong about the keyframe aspect,
@@ -4036,11 +4340,38 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
         "possible internal leaking?", priv->frames.length);
   }
 
+  /* skip the work for frames that would be dropped after decoding anyway
+   * if nothing depends on them */
+  if (priv->drop_before_decode && GST_VIDEO_CODEC_FRAME_IS_DROPPABLE (frame)
+      && !gst_video_decoder_get_subframe_mode (decoder)
+      && gst_video_decoder_frame_is_late (decoder, frame)) {
+    GST_DEBUG_OBJECT (decoder, "dropping late droppable frame %p before "
+        "decoding, PTS %" GST_TIME_FORMAT, frame, GST_TIME_ARGS (frame->pts));
+    return gst_video_decoder_drop_frame (decoder, frame);
+  }
+
+  if (!gst_video_decoder_get_subframe_mode (decoder)) {
+    g_mutex_lock (&priv->async_lock);
+    async_depth = priv->async_depth;
+    if (async_depth > 0) {
+      AsyncFrame *async = g_new0 (AsyncFrame, 1);
+
+      async->frame = frame;
+      g_queue_push_tail (&priv->async_frames, async);
+    }
+    g_mutex_unlock (&priv->async_lock);
+  }
+
   /* do something with frame */
   ret = decoder_class->handle_frame (decoder, frame);
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
 
+  /* push what is ready, waiting is done in chain() where the stream lock is
+   * only held once */
+  if (async_depth > 0 && ret == GST_FLOW_OK)
+    ret = gst_video_decoder_push_async_frames (decoder, G_MAXUINT);
+
   /* the frame has either been added to parse_gather or sent to
      handle frame so there is no need to unref it */
   return ret;
@@ -5046,6 +5377,65 @@ gst_video_decoder_get_subframe_mode (GstVideoDecoder * decoder)
   return decoder->priv->subframe_mode;
 }
 
+/**
+ * gst_video_decoder_set_async_depth:
+ * @decoder: a #GstVideoDecoder
+ * @depth: the maximum number of frames decoded asynchronously, or 0
+ *
+ * Enables asynchronous decoding for subclasses that decode several frames
+ * in parallel, for example on a pool of worker threads.
+ *
+ * With a non-zero @depth, frames passed to the subclass' @handle_frame are
+ * expected to be completed later with gst_video_decoder_finish_frame_async()
+ * from any thread, instead of with gst_video_decoder_finish_frame(). The base
+ * class pushes them downstream in the order they were passed to
+ * @handle_frame. After each input buffer, it waits for the oldest frames
+ * until less than @depth are pending, and for all of them when draining.
+ * Frames can still be dropped or released with gst_video_decoder_drop_frame()
+ * and gst_video_decoder_release_frame().
+ *
+ * The stream lock is released while waiting, so the workers can allocate
+ * output buffers. The subclass must thus not hold it when chaining up to the
+ * default @sink_event handler. When flushing, the subclass' @flush or @stop
+ * must make sure that its workers don't use the frames anymore.
+ *
+ * Asynchronous decoding is not used in subframe mode.
+ *
+ * Since: 1.28
+ */
+void
+gst_video_decoder_set_async_depth (GstVideoDecoder * decoder, guint depth)
+{
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+
+  g_mutex_lock (&decoder->priv->async_lock);
+  decoder->priv->async_depth = depth;
+  g_mutex_unlock (&decoder->priv->async_lock);
+}
+
+/**
+ * gst_video_decoder_get_async_depth:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Returns: the maximum number of frames decoded asynchronously, 0 if
+ *     asynchronous decoding is disabled.
+ *
+ * Since: 1.28
+ */
+guint
+gst_video_decoder_get_async_depth (GstVideoDecoder * decoder)
+{
+  guint depth;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 0);
+
+  g_mutex_lock (&decoder->priv->async_lock);
+  depth = decoder->priv->async_depth;
+  g_mutex_unlock (&decoder->priv->async_lock);
+
+  return depth;
+}
+
 /**
  * gst_video_decoder_get_input_subframe_index:
  * @decoder: a #GstVideoDecoder
@@ -398,6 +398,13 @@ void     gst_video_decoder_set_subframe_mode (GstVideoDecoder * decoder,
 GST_VIDEO_API
 gboolean gst_video_decoder_get_subframe_mode (GstVideoDecoder * decoder);
 
+GST_VIDEO_API
+void     gst_video_decoder_set_async_depth (GstVideoDecoder * decoder,
+                                            guint depth);
+
+GST_VIDEO_API
+guint    gst_video_decoder_get_async_depth (GstVideoDecoder * decoder);
+
 GST_VIDEO_API
 guint gst_video_decoder_get_input_subframe_index (GstVideoDecoder * decoder, GstVideoCodecFrame * frame);
 
@@ -520,6 +527,10 @@ GST_VIDEO_API
 GstFlowReturn    gst_video_decoder_finish_subframe (GstVideoDecoder *decoder,
                                                  GstVideoCodecFrame *frame);
 
+GST_VIDEO_API
+GstFlowReturn    gst_video_decoder_finish_frame_async (GstVideoDecoder *decoder,
+                                                       GstVideoCodecFrame *frame);
+
 GST_VIDEO_API
 GstFlowReturn    gst_video_decoder_drop_frame (GstVideoDecoder *dec,
 					       GstVideoCodecFrame *frame);
@@ -114,12 +114,16 @@ GST_DEBUG_CATEGORY (videoencoder_debug);
 
 #define DEFAULT_QOS                 FALSE
 #define DEFAULT_MIN_FORCE_KEY_UNIT_INTERVAL 0
+#define DEFAULT_DROP_UNCHANGED      FALSE
+#define DEFAULT_ROI_DELTA_QP        0
 
 enum
 {
   PROP_0,
   PROP_QOS,
   PROP_MIN_FORCE_KEY_UNIT_INTERVAL,
+  PROP_DROP_UNCHANGED,
+  PROP_ROI_DELTA_QP,
   PROP_LAST
 };
 
@@ -187,6 +191,17 @@ struct _GstVideoEncoderPrivate
   /* qos messages: frames dropped/processed */
   guint dropped;
   guint processed;
+
+  gint drop_unchanged;          /* ATOMIC */
+  /* whether a frame was passed to the subclass since the last reset */
+  gboolean have_frame;
+  /* whether the damage of the frame passed to the subclass is relative to
+   * the previous frame it got */
+  gboolean damage_valid;
+
+  gint roi_delta_qp;            /* ATOMIC */
+  /* returned by gst_video_encoder_get_block_hints() */
+  GstVideoEncoderBlockHints block_hints;
 };
 
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
@@ -289,6 +304,8 @@ static void gst_video_encoder_post_qos_drop (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame);
 static void gst_video_encoder_push_pending_unlocked (GstVideoEncoder * encoder,
     GstVideoCodecFrame * frame, gboolean dropping);
+static void gst_video_encoder_release_frame_unlocked (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame);
 
 static gboolean gst_video_encoder_sink_query_default (GstVideoEncoder * encoder,
     GstQuery * query);
@@ -355,6 +372,13 @@ gst_video_encoder_set_property (GObject * object, guint prop_id,
       gst_video_encoder_set_min_force_key_unit_interval (sink,
           g_value_get_uint64 (value));
       break;
+    case PROP_DROP_UNCHANGED:
+      g_atomic_int_set (&sink->priv->drop_unchanged,
+          g_value_get_boolean (value));
+      break;
+    case PROP_ROI_DELTA_QP:
+      g_atomic_int_set (&sink->priv->roi_delta_qp, g_value_get_int (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -375,6 +399,13 @@ gst_video_encoder_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_uint64 (value,
           gst_video_encoder_get_min_force_key_unit_interval (sink));
       break;
+    case PROP_DROP_UNCHANGED:
+      g_value_set_boolean (value,
+          g_atomic_int_get (&sink->priv->drop_unchanged));
+      break;
+    case PROP_ROI_DELTA_QP:
+      g_value_set_int (value, g_atomic_int_get (&sink->priv->roi_delta_qp));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -435,6 +466,41 @@ gst_video_encoder_class_init (GstVideoEncoderClass * klass)
           G_MAXUINT64, DEFAULT_MIN_FORCE_KEY_UNIT_INTERVAL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoEncoder:drop-unchanged:
+   *
+   * Drop input frames that are marked as identical to the previous frame
+   * with a #GstVideoDamageMeta without any region, for example the
+   * duplicates pushed by videorate with #GstVideoRate:mark-duplicates,
+   * instead of passing them to the subclass. Frames that have to be
+   * encoded as keyframe are never dropped.
+   *
+   * Such frames are otherwise passed to the subclass with
+   * %GST_VIDEO_CODEC_FRAME_FLAG_UNCHANGED set.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_DROP_UNCHANGED,
+      g_param_spec_boolean ("drop-unchanged", "Drop unchanged frames",
+          "Drop input frames that are identical to the previous frame",
+          DEFAULT_DROP_UNCHANGED, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoEncoder:roi-delta-qp:
+   *
+   * QP offset reported by gst_video_encoder_get_block_hints() for the
+   * regions of interest that don't specify their own with a `delta-qp`
+   * parameter. Negative values improve the quality of the regions of
+   * interest, 0 ignores them.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_ROI_DELTA_QP,
+      g_param_spec_int ("roi-delta-qp", "ROI delta QP",
+          "QP offset for regions of interest without their own delta-qp",
+          -51, 51, DEFAULT_ROI_DELTA_QP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   meta_tag_video_quark = g_quark_from_static_string (GST_META_TAG_VIDEO_STR);
 }
 
@@ -480,6 +546,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   GST_OBJECT_UNLOCK (encoder);
 
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
+  priv->have_frame = FALSE;
 
   if (hard) {
     gst_segment_init (&encoder->input_segment, GST_FORMAT_TIME);
@@ -612,6 +679,8 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->max_latency = 0;
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
+  priv->drop_unchanged = DEFAULT_DROP_UNCHANGED;
+  priv->roi_delta_qp = DEFAULT_ROI_DELTA_QP;
 
   gst_video_encoder_reset (encoder, TRUE);
 }
@@ -1026,6 +1095,9 @@ gst_video_encoder_finalize (GObject * object)
     encoder->priv->allocator = NULL;
   }
 
+  g_free (encoder->priv->block_hints.qp_delta);
+  g_free (encoder->priv->block_hints.skip);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1547,6 +1619,7 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GstVideoEncoderPrivate *priv;
   GstVideoEncoderClass *klass;
   GstVideoCodecFrame *frame;
+  GstVideoDamageMeta *dmeta;
   GstClockTime pts, duration;
   GstFlowReturn ret = GST_FLOW_OK;
   guint64 start, stop, cstart, cstop;
@@ -1721,8 +1794,31 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   }
   GST_OBJECT_UNLOCK (encoder);
 
+  /* an empty damage meta marks a repeat of the previous frame, unless the
+   * stream was interrupted in between */
+  dmeta = gst_buffer_get_video_damage_meta (buf);
+  if (dmeta && dmeta->n_regions == 0
+      && !GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT))
+    GST_VIDEO_CODEC_FRAME_FLAG_SET (frame,
+        GST_VIDEO_CODEC_FRAME_FLAG_UNCHANGED);
+
   g_queue_push_tail (&priv->frames, gst_video_codec_frame_ref (frame));
 
+  if (GST_VIDEO_CODEC_FRAME_IS_UNCHANGED (frame) && priv->have_frame
+      && !GST_VIDEO_CODEC_FRAME_IS_FORCE_KEYFRAME (frame)
+      && g_atomic_int_get (&priv->drop_unchanged)) {
+    GST_LOG_OBJECT (encoder, "dropping unchanged frame pfn %d",
+        frame->presentation_frame_number);
+
+    /* not a QoS drop, so keep the events but don't post a message */
+    gst_video_encoder_push_pending_unlocked (encoder, frame, TRUE);
+    gst_video_encoder_release_frame_unlocked (encoder, frame);
+    goto done;
+  }
+  priv->damage_valid = priv->have_frame
+      && !GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT);
+  priv->have_frame = TRUE;
+
   /* new data, more finish needed */
   priv->drained = FALSE;
 
@@ -3328,3 +3424,165 @@ gst_video_encoder_get_min_force_key_unit_interval (GstVideoEncoder * encoder)
 
   return interval;
 }
+
+static gint
+gst_video_encoder_get_roi_delta_qp (GstVideoRegionOfInterestMeta * roi,
+    gint default_delta_qp)
+{
+  GList *l;
+
+  for (l = roi->params; l; l = l->next) {
+    gint delta_qp;
+
+    if (gst_structure_get_int (l->data, "delta-qp", &delta_qp))
+      return CLAMP (delta_qp, -51, 51);
+  }
+
+  return default_delta_qp;
+}
+
+/* Gets the blocks [c0, c1[ x [r0, r1[ intersecting a rectangle, returns
+ * FALSE if there are none */
+static gboolean
+gst_video_encoder_get_block_range (const GstVideoEncoderBlockHints * hints,
+    const GstVideoInfo * info, gint x, gint y, gint w, gint h, guint * c0,
+    guint * r0, guint * c1, guint * r1)
+{
+  gint x0 = MAX (x, 0), y0 = MAX (y, 0);
+  gint x1 = MIN ((gint64) x + w, GST_VIDEO_INFO_WIDTH (info));
+  gint y1 = MIN ((gint64) y + h, GST_VIDEO_INFO_HEIGHT (info));
+
+  if (x1 <= x0 || y1 <= y0)
+    return FALSE;
+
+  *c0 = x0 / hints->block_size;
+  *r0 = y0 / hints->block_size;
+  *c1 = (x1 - 1) / hints->block_size + 1;
+  *r1 = (y1 - 1) / hints->block_size + 1;
+
+  return TRUE;
+}
+
+/**
+ * gst_video_encoder_get_block_hints:
+ * @encoder: a #GstVideoEncoder
+ * @frame: the #GstVideoCodecFrame passed to @handle_frame
+ * @block_size: width and height of the blocks in pixels
+ *
+ * Collects the #GstVideoRegionOfInterestMeta and #GstVideoDamageMeta of
+ * the input buffer of @frame into a map of blocks of @block_size pixels,
+ * e.g. macroblocks or coding tree units, that encoders can use for QP
+ * offsets and to skip the blocks that didn't change.
+ *
+ * Regions of interest get the QP offset of the `delta-qp` integer field of
+ * any of their parameter structures, or the #GstVideoEncoder:roi-delta-qp
+ * property. Where several of them overlap, the lowest offset is used.
+ *
+ * Blocks are only marked as skippable if the damage is relative to the
+ * previous frame passed to the subclass, so never after a discontinuity
+ * or for frames that have to be keyframes. Subclasses that did not encode
+ * the previous frame, or that encode @frame as keyframe anyway, must
+ * ignore @skip.
+ *
+ * Must be called from @handle_frame for the frame being handled.
+ *
+ * Returns: (transfer none) (nullable): the hints, valid until the next
+ *     call, or %NULL if the frame doesn't carry any of these metas.
+ *
+ * Since: 1.28
+ */
+const GstVideoEncoderBlockHints *
+gst_video_encoder_get_block_hints (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, guint block_size)
+{
+  GstVideoEncoderPrivate *priv;
+  GstVideoEncoderBlockHints *hints;
+  GstVideoDamageMeta *dmeta = NULL;
+  GstVideoInfo *info;
+  GstBuffer *buf;
+  GstMeta *meta;
+  gpointer state = NULL;
+  gint default_delta_qp;
+  guint c, r, c0, r0, c1, r1, i, n_blocks;
+
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), NULL);
+  g_return_val_if_fail (frame != NULL, NULL);
+  g_return_val_if_fail (block_size > 0, NULL);
+
+  priv = encoder->priv;
+  hints = &priv->block_hints;
+  buf = frame->input_buffer;
+
+  if (!priv->input_state || !buf)
+    return NULL;
+
+  if (priv->damage_valid && !GST_VIDEO_CODEC_FRAME_IS_FORCE_KEYFRAME (frame))
+    dmeta = gst_buffer_get_video_damage_meta (buf);
+
+  if (!dmeta && !gst_buffer_get_video_region_of_interest_meta (buf))
+    return NULL;
+
+  info = &priv->input_state->info;
+
+  hints->block_size = block_size;
+  hints->n_columns = (GST_VIDEO_INFO_WIDTH (info) + block_size - 1) /
+      block_size;
+  hints->n_rows = (GST_VIDEO_INFO_HEIGHT (info) + block_size - 1) /
+      block_size;
+  n_blocks = hints->n_columns * hints->n_rows;
+
+  hints->qp_delta = g_renew (gint8, hints->qp_delta, n_blocks);
+  hints->skip = g_renew (guint8, hints->skip, n_blocks);
+  memset (hints->qp_delta, 0, n_blocks);
+  /* without damage meta, everything may have changed */
+  memset (hints->skip, dmeta ? 1 : 0, n_blocks);
+
+  if (dmeta) {
+    for (i = 0; i < dmeta->n_regions; i++) {
+      GstVideoDamageRegion *rect = &dmeta->regions[i];
+
+      if (!gst_video_encoder_get_block_range (hints, info, rect->x, rect->y,
+              rect->w, rect->h, &c0, &r0, &c1, &r1))
+        continue;
+
+      for (r = r0; r < r1; r++)
+        memset (hints->skip + r * hints->n_columns + c0, 0, c1 - c0);
+    }
+  }
+
+  default_delta_qp = g_atomic_int_get (&priv->roi_delta_qp);
+  while ((meta = gst_buffer_iterate_meta_filtered (buf, &state,
+              GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE))) {
+    GstVideoRegionOfInterestMeta *roi = (GstVideoRegionOfInterestMeta *) meta;
+    gint delta_qp = gst_video_encoder_get_roi_delta_qp (roi, default_delta_qp);
+
+    if (delta_qp == 0 || roi->x > G_MAXINT || roi->y > G_MAXINT
+        || !gst_video_encoder_get_block_range (hints, info, roi->x, roi->y,
+            MIN (roi->w, G_MAXINT), MIN (roi->h, G_MAXINT), &c0, &r0, &c1,
+            &r1))
+      continue;
+
+    for (r = r0; r < r1; r++) {
+      for (c = c0; c < c1; c++) {
+        gint8 *block_qp = &hints->qp_delta[r * hints->n_columns + c];
+
+        if (*block_qp == 0 || delta_qp < *block_qp)
+          *block_qp = delta_qp;
+      }
+    }
+  }
+
+  hints->n_roi = hints->n_skip = 0;
+  for (i = 0; i < n_blocks; i++) {
+    if (hints->qp_delta[i] != 0)
+      hints->n_roi++;
+    if (hints->skip[i])
+      hints->n_skip++;
+  }
+
+  GST_LOG_OBJECT (encoder, "%ux%u blocks of %u pixels, %u ROI, %u skipped",
+      hints->n_columns, hints->n_rows, block_size, hints->n_roi,
+      hints->n_skip);
+
+  return hints;
+}
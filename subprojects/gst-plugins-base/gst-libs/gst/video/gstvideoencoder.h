@@ -299,6 +299,40 @@ struct _GstVideoEncoderClass
   gpointer       _gst_reserved[GST_PADDING_LARGE-4];
 };
 
+/**
+ * GstVideoEncoderBlockHints:
+ * @block_size: width and height of the blocks in pixels, e.g. 16 for
+ *     H.264 macroblocks
+ * @n_columns: the number of blocks in a row
+ * @n_rows: the number of rows of blocks
+ * @qp_delta: (array): for each block in raster order, the QP offset
+ *     requested by the regions of interest covering it. Negative values ask
+ *     for a better quality.
+ * @skip: (array): for each block in raster order, non-zero if its content
+ *     did not change since the previous frame passed to the subclass
+ * @n_roi: the number of blocks with a non-zero @qp_delta
+ * @n_skip: the number of blocks with @skip set
+ *
+ * Per block encoding hints for a frame, see
+ * gst_video_encoder_get_block_hints().
+ *
+ * Since: 1.28
+ */
+typedef struct {
+  guint block_size;
+  guint n_columns;
+  guint n_rows;
+
+  gint8 *qp_delta;
+  guint8 *skip;
+
+  guint n_roi;
+  guint n_skip;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+} GstVideoEncoderBlockHints;
+
 GST_VIDEO_API
 GType                gst_video_encoder_get_type (void);
 
@@ -393,6 +427,11 @@ void                 gst_video_encoder_release_frame (GstVideoEncoder *encoder,
 GST_VIDEO_API
 void                 gst_video_encoder_drop_frame (GstVideoEncoder *encoder, GstVideoCodecFrame *frame);
 
+GST_VIDEO_API
+const GstVideoEncoderBlockHints * gst_video_encoder_get_block_hints (GstVideoEncoder * encoder,
+                                                                    GstVideoCodecFrame * frame,
+                                                                    guint block_size);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoEncoder, gst_object_unref)
 
 G_END_DECLS
@@ -122,6 +122,30 @@ typedef enum
    * Since: 1.20
    */
   GST_VIDEO_CODEC_FRAME_FLAG_CORRUPTED = (1<<4),
+
+  /**
+   * GST_VIDEO_CODEC_FRAME_FLAG_UNCHANGED:
+   *
+   * The frame content is identical to the previous frame, as signalled by
+   * a #GstVideoDamageMeta without any region on the input buffer. Encoders
+   * can encode it as a skip frame. Applies only to frames provided to
+   * encoders.
+   *
+   * Since: 1.28
+   */
+  GST_VIDEO_CODEC_FRAME_FLAG_UNCHANGED = (1<<5),
+
+  /**
+   * GST_VIDEO_CODEC_FRAME_FLAG_DROPPABLE:
+   *
+   * No other frame depends on this frame, so it can be skipped without
+   * decoding it. Set from %GST_BUFFER_FLAG_DROPPABLE on the input buffer,
+   * or by the subclass when parsing. Applies only to frames provided to
+   * decoders.
+   *
+   * Since: 1.28
+   */
+  GST_VIDEO_CODEC_FRAME_FLAG_DROPPABLE = (1<<6),
 } GstVideoCodecFrameFlags;
 
 /**
@@ -230,6 +254,40 @@ typedef enum
 #define GST_VIDEO_CODEC_FRAME_SET_FORCE_KEYFRAME_HEADERS(frame)     (GST_VIDEO_CODEC_FRAME_FLAG_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS))
 #define GST_VIDEO_CODEC_FRAME_UNSET_FORCE_KEYFRAME_HEADERS(frame)   (GST_VIDEO_CODEC_FRAME_FLAG_UNSET(frame, GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS))
 
+/**
+ * GST_VIDEO_CODEC_FRAME_IS_UNCHANGED:
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Tests if the frame content is identical to the previous frame. Applies
+ * only to frames provided to encoders.
+ *
+ * Since: 1.28
+ */
+#define GST_VIDEO_CODEC_FRAME_IS_UNCHANGED(frame)       (GST_VIDEO_CODEC_FRAME_FLAG_IS_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_UNCHANGED))
+
+/**
+ * GST_VIDEO_CODEC_FRAME_IS_DROPPABLE:
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Tests if no other frame depends on the frame. Applies only to frames
+ * provided to decoders.
+ *
+ * Since: 1.28
+ */
+#define GST_VIDEO_CODEC_FRAME_IS_DROPPABLE(frame)       (GST_VIDEO_CODEC_FRAME_FLAG_IS_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_DROPPABLE))
+
+/**
+ * GST_VIDEO_CODEC_FRAME_SET_DROPPABLE:
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Marks the frame as not used as reference by any other frame, e.g. from
+ * the @parse vfunc of a decoder, so that it can be dropped before decoding
+ * when it is late.
+ *
+ * Since: 1.28
+ */
+#define GST_VIDEO_CODEC_FRAME_SET_DROPPABLE(frame)      (GST_VIDEO_CODEC_FRAME_FLAG_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_DROPPABLE))
+
 /**
  * GstVideoCodecFrame:
  * @pts: Presentation timestamp
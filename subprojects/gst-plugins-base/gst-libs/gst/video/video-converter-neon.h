@@ -0,0 +1,150 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <arm_neon.h>
+
+/* Same contract as the AVX2 versions: handle whole blocks of @n, return how
+ * many pixels were done and leave the remainder to the caller. */
+
+static gint
+video_converter_interleave_uv_neon (guint8 * d, const guint8 * u,
+    const guint8 * v, gint n)
+{
+  gint i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    uint8x16x2_t uv;
+
+    uv.val[0] = vld1q_u8 (u + i);
+    uv.val[1] = vld1q_u8 (v + i);
+    vst2q_u8 (d + 2 * i, uv);
+  }
+  return i;
+}
+
+static gint
+video_converter_deinterleave_uv_neon (guint8 * u, guint8 * v,
+    const guint8 * s, gint n)
+{
+  gint i;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    uint8x16x2_t uv = vld2q_u8 (s + 2 * i);
+
+    vst1q_u8 (u + i, uv.val[0]);
+    vst1q_u8 (v + i, uv.val[1]);
+  }
+  return i;
+}
+
+/* see the AVX2 version for how this matches video_orc_convert_I420_BGRA */
+static inline int16x8_t
+splat_samples_neon (uint8x8_t s)
+{
+  s = veor_u8 (s, vdup_n_u8 (0x80));
+  return vreinterpretq_s16_u16 (vmulq_n_u16 (vmovl_u8 (s), 0x0101));
+}
+
+static inline int16x8_t
+mulhi_s16_neon (int16x8_t a, int16x8_t b)
+{
+  int32x4_t lo = vmull_s16 (vget_low_s16 (a), vget_low_s16 (b));
+  int32x4_t hi = vmull_s16 (vget_high_s16 (a), vget_high_s16 (b));
+
+  return vcombine_s16 (vshrn_n_s32 (lo, 16), vshrn_n_s32 (hi, 16));
+}
+
+static inline uint8x8_t
+pack_component_neon (int16x8_t c)
+{
+  return veor_u8 (vreinterpret_u8_s8 (vqmovn_s16 (c)), vdup_n_u8 (0x80));
+}
+
+static inline void
+yuv_to_rgb_8_neon (uint8x8_t sy, uint8x8_t su, uint8x8_t sv,
+    const int16x8_t * p, uint8x8_t * r, uint8x8_t * g, uint8x8_t * b)
+{
+  int16x8_t wy, wu, wv;
+
+  wy = mulhi_s16_neon (splat_samples_neon (sy), p[0]);
+  wu = splat_samples_neon (su);
+  wv = splat_samples_neon (sv);
+
+  *r = pack_component_neon (vaddq_s16 (wy, mulhi_s16_neon (wv, p[1])));
+  *b = pack_component_neon (vaddq_s16 (wy, mulhi_s16_neon (wu, p[2])));
+  *g = pack_component_neon (vaddq_s16 (vaddq_s16 (wy,
+              mulhi_s16_neon (wu, p[3])), mulhi_s16_neon (wv, p[4])));
+}
+
+static inline gint
+convert_I420_neon (guint8 * d, const guint8 * y, const guint8 * u,
+    const guint8 * v, gint p1, gint p2, gint p3, gint p4, gint p5, gint n,
+    gboolean rgba)
+{
+  int16x8_t p[5];
+  gint i;
+
+  p[0] = vdupq_n_s16 ((gint16) p1);
+  p[1] = vdupq_n_s16 ((gint16) p2);
+  p[2] = vdupq_n_s16 ((gint16) p3);
+  p[3] = vdupq_n_s16 ((gint16) p4);
+  p[4] = vdupq_n_s16 ((gint16) p5);
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    uint8x16_t sy = vld1q_u8 (y + i);
+    uint8x8x2_t su = vzip_u8 (vld1_u8 (u + i / 2), vld1_u8 (u + i / 2));
+    uint8x8x2_t sv = vzip_u8 (vld1_u8 (v + i / 2), vld1_u8 (v + i / 2));
+    uint8x8_t r0, g0, b0, r1, g1, b1;
+    uint8x16x4_t px;
+
+    yuv_to_rgb_8_neon (vget_low_u8 (sy), su.val[0], sv.val[0], p,
+        &r0, &g0, &b0);
+    yuv_to_rgb_8_neon (vget_high_u8 (sy), su.val[1], sv.val[1], p,
+        &r1, &g1, &b1);
+
+    if (rgba) {
+      px.val[0] = vcombine_u8 (r0, r1);
+      px.val[2] = vcombine_u8 (b0, b1);
+    } else {
+      px.val[0] = vcombine_u8 (b0, b1);
+      px.val[2] = vcombine_u8 (r0, r1);
+    }
+    px.val[1] = vcombine_u8 (g0, g1);
+    px.val[3] = vdupq_n_u8 (0xff);
+
+    vst4q_u8 (d + 4 * i, px);
+  }
+  return i;
+}
+
+static gint
+video_converter_I420_BGRA_neon (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n)
+{
+  return convert_I420_neon (d, y, u, v, p1, p2, p3, p4, p5, n, FALSE);
+}
+
+static gint
+video_converter_I420_RGBA_neon (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n)
+{
+  return convert_I420_neon (d, y, u, v, p1, p2, p3, p4, p5, n, TRUE);
+}
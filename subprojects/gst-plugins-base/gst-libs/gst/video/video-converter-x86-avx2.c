@@ -0,0 +1,207 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-converter-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* Lines have no particular alignment so all loads and stores are
+ * unaligned. The functions never touch memory beyond the blocks they
+ * report as done. */
+
+gint
+video_converter_interleave_uv_avx2 (guint8 * d, const guint8 * u,
+    const guint8 * v, gint n)
+{
+  gint i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i mu = _mm256_loadu_si256 ((const __m256i *) (u + i));
+    __m256i mv = _mm256_loadu_si256 ((const __m256i *) (v + i));
+    __m256i lo = _mm256_unpacklo_epi8 (mu, mv);
+    __m256i hi = _mm256_unpackhi_epi8 (mu, mv);
+
+    _mm256_storeu_si256 ((__m256i *) (d + 2 * i),
+        _mm256_permute2x128_si256 (lo, hi, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (d + 2 * i + 32),
+        _mm256_permute2x128_si256 (lo, hi, 0x31));
+  }
+  return i;
+}
+
+gint
+video_converter_deinterleave_uv_avx2 (guint8 * u, guint8 * v,
+    const guint8 * s, gint n)
+{
+  const __m256i split = _mm256_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14,
+      1, 3, 5, 7, 9, 11, 13, 15, 0, 2, 4, 6, 8, 10, 12, 14,
+      1, 3, 5, 7, 9, 11, 13, 15);
+  gint i;
+
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i a = _mm256_loadu_si256 ((const __m256i *) (s + 2 * i));
+    __m256i b = _mm256_loadu_si256 ((const __m256i *) (s + 2 * i + 32));
+
+    /* u0-7 v0-7 | u8-15 v8-15 -> u0-15 | v0-15 */
+    a = _mm256_permute4x64_epi64 (_mm256_shuffle_epi8 (a, split), 0xd8);
+    b = _mm256_permute4x64_epi64 (_mm256_shuffle_epi8 (b, split), 0xd8);
+
+    _mm256_storeu_si256 ((__m256i *) (u + i),
+        _mm256_permute2x128_si256 (a, b, 0x20));
+    _mm256_storeu_si256 ((__m256i *) (v + i),
+        _mm256_permute2x128_si256 (a, b, 0x31));
+  }
+  return i;
+}
+
+/* The YUV to RGB conversion does exactly what video_orc_convert_I420_BGRA
+ * does: the samples are made signed and splatted to 16 bits, multiplied
+ * with the high half of a signed 16 bit multiply, added with 16 bit
+ * wraparound and saturated to signed 8 bits before adding back the
+ * offset. */
+static inline __m256i
+splat_samples (__m128i s)
+{
+  s = _mm_xor_si128 (s, _mm_set1_epi8 ((gchar) 0x80));
+  return _mm256_mullo_epi16 (_mm256_cvtepu8_epi16 (s),
+      _mm256_set1_epi16 (0x0101));
+}
+
+static inline void
+yuv_to_rgb_16 (__m128i sy, __m128i su, __m128i sv, const __m256i * p,
+    __m256i * r, __m256i * g, __m256i * b)
+{
+  __m256i wy, wu, wv;
+
+  wy = _mm256_mulhi_epi16 (splat_samples (sy), p[0]);
+  wu = splat_samples (su);
+  wv = splat_samples (sv);
+
+  *r = _mm256_add_epi16 (wy, _mm256_mulhi_epi16 (wv, p[1]));
+  *b = _mm256_add_epi16 (wy, _mm256_mulhi_epi16 (wu, p[2]));
+  *g = _mm256_add_epi16 (_mm256_add_epi16 (wy,
+          _mm256_mulhi_epi16 (wu, p[3])), _mm256_mulhi_epi16 (wv, p[4]));
+}
+
+/* Converts 32 pixels and stores them with the components in memory order
+ * c0 c1 c2 0xff */
+static inline void
+convert_I420_32_avx2 (guint8 * d, const guint8 * y, const guint8 * u,
+    const guint8 * v, const __m256i * p, gboolean rgba)
+{
+  const __m256i offset = _mm256_set1_epi8 ((gchar) 0x80);
+  const __m256i alpha = _mm256_set1_epi8 ((gchar) 0xff);
+  __m128i sy0, sy1, su, sv;
+  __m256i r0, g0, b0, r1, g1, b1, c0, c1, c2;
+  __m256i lo01, hi01, lo2a, hi2a, o0, o1, o2, o3;
+
+  sy0 = _mm_loadu_si128 ((const __m128i *) y);
+  sy1 = _mm_loadu_si128 ((const __m128i *) (y + 16));
+  su = _mm_loadu_si128 ((const __m128i *) u);
+  sv = _mm_loadu_si128 ((const __m128i *) v);
+
+  yuv_to_rgb_16 (sy0, _mm_unpacklo_epi8 (su, su), _mm_unpacklo_epi8 (sv, sv),
+      p, &r0, &g0, &b0);
+  yuv_to_rgb_16 (sy1, _mm_unpackhi_epi8 (su, su), _mm_unpackhi_epi8 (sv, sv),
+      p, &r1, &g1, &b1);
+
+  /* pixels 0-7 16-23 | 8-15 24-31 */
+  r0 = _mm256_xor_si256 (_mm256_packs_epi16 (r0, r1), offset);
+  g0 = _mm256_xor_si256 (_mm256_packs_epi16 (g0, g1), offset);
+  b0 = _mm256_xor_si256 (_mm256_packs_epi16 (b0, b1), offset);
+
+  if (rgba) {
+    c0 = r0;
+    c2 = b0;
+  } else {
+    c0 = b0;
+    c2 = r0;
+  }
+  c1 = g0;
+
+  lo01 = _mm256_unpacklo_epi8 (c0, c1);
+  hi01 = _mm256_unpackhi_epi8 (c0, c1);
+  lo2a = _mm256_unpacklo_epi8 (c2, alpha);
+  hi2a = _mm256_unpackhi_epi8 (c2, alpha);
+
+  /* pixels 0-3 8-11, 4-7 12-15, 16-19 24-27, 20-23 28-31 */
+  o0 = _mm256_unpacklo_epi16 (lo01, lo2a);
+  o1 = _mm256_unpackhi_epi16 (lo01, lo2a);
+  o2 = _mm256_unpacklo_epi16 (hi01, hi2a);
+  o3 = _mm256_unpackhi_epi16 (hi01, hi2a);
+
+  _mm256_storeu_si256 ((__m256i *) d, _mm256_permute2x128_si256 (o0, o1,
+          0x20));
+  _mm256_storeu_si256 ((__m256i *) (d + 32), _mm256_permute2x128_si256 (o0,
+          o1, 0x31));
+  _mm256_storeu_si256 ((__m256i *) (d + 64), _mm256_permute2x128_si256 (o2,
+          o3, 0x20));
+  _mm256_storeu_si256 ((__m256i *) (d + 96), _mm256_permute2x128_si256 (o2,
+          o3, 0x31));
+}
+
+static inline void
+load_matrix (__m256i * p, gint p1, gint p2, gint p3, gint p4, gint p5)
+{
+  p[0] = _mm256_set1_epi16 ((gint16) p1);
+  p[1] = _mm256_set1_epi16 ((gint16) p2);
+  p[2] = _mm256_set1_epi16 ((gint16) p3);
+  p[3] = _mm256_set1_epi16 ((gint16) p4);
+  p[4] = _mm256_set1_epi16 ((gint16) p5);
+}
+
+gint
+video_converter_I420_BGRA_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n)
+{
+  __m256i p[5];
+  gint i;
+
+  load_matrix (p, p1, p2, p3, p4, p5);
+
+  for (i = 0; i + 32 <= n; i += 32)
+    convert_I420_32_avx2 (d + 4 * i, y + i, u + i / 2, v + i / 2, p, FALSE);
+
+  return i;
+}
+
+gint
+video_converter_I420_RGBA_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n)
+{
+  __m256i p[5];
+  gint i;
+
+  load_matrix (p, p1, p2, p3, p4, p5);
+
+  for (i = 0; i + 32 <= n; i += 32)
+    convert_I420_32_avx2 (d + 4 * i, y + i, u + i / 2, v + i / 2, p, TRUE);
+
+  return i;
+}
+
+#endif
@@ -0,0 +1,46 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_CONVERTER_X86_AVX2_H
+#define VIDEO_CONVERTER_X86_AVX2_H
+
+#include <glib.h>
+
+/* All functions handle a multiple of their block size of the @n pixels and
+ * return how many they did, the caller converts the remainder. */
+
+G_GNUC_INTERNAL
+gint video_converter_interleave_uv_avx2 (guint8 * d, const guint8 * u,
+    const guint8 * v, gint n);
+
+G_GNUC_INTERNAL
+gint video_converter_deinterleave_uv_avx2 (guint8 * u, guint8 * v,
+    const guint8 * s, gint n);
+
+G_GNUC_INTERNAL
+gint video_converter_I420_BGRA_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n);
+
+G_GNUC_INTERNAL
+gint video_converter_I420_RGBA_avx2 (guint8 * d, const guint8 * y,
+    const guint8 * u, const guint8 * v, gint p1, gint p2, gint p3, gint p4,
+    gint p5, gint n);
+
+#endif /* VIDEO_CONVERTER_X86_AVX2_H */
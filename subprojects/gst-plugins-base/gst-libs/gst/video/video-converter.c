@@ -37,6 +37,12 @@
 #include <gst/base/base.h>
 
 #include "video-orc.h"
+#include "video-converter-x86-avx2.h"
+
+#if defined (__ARM_NEON) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+#define HAVE_NEON_LINES
+#include "video-converter-neon.h"
+#endif
 
 /**
  * SECTION:videoconverter
@@ -370,6 +376,11 @@ struct _GstVideoConverter
 
   guint16 **tmpline;
 
+  /* deinterleaved chroma for scaling NV12 to planar 4:2:0 */
+  guint8 *planar_uv;
+  gint planar_uv_stride;
+  gint planar_uv_height;
+
   gboolean fill_border;
   gpointer borderline;
   guint64 borders[4];
@@ -2460,6 +2471,8 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   convert->conversion_runner =
       gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
 
+  video_converter_init_simd ();
+
   if (video_converter_lookup_fastpath (convert))
     goto done;
 
@@ -2657,6 +2670,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     g_free (convert->tmpline);
   }
 
+  g_free (convert->planar_uv);
   g_free (convert->borderline);
 
   if (convert->config)
@@ -3390,6 +3404,103 @@ typedef struct
   gpointer tmpline;
 } FConvertTask;
 
+/* Line functions with SIMD versions. These convert as many whole blocks of
+ * pixels as they can and return the number of pixels they did, the
+ * remainder is done with the C and orc functions that the SIMD versions
+ * match exactly. */
+typedef struct
+{
+  gint (*interleave_uv) (guint8 * d, const guint8 * u, const guint8 * v,
+      gint n);
+  gint (*deinterleave_uv) (guint8 * u, guint8 * v, const guint8 * s, gint n);
+  gint (*I420_BGRA) (guint8 * d, const guint8 * y, const guint8 * u,
+      const guint8 * v, gint p1, gint p2, gint p3, gint p4, gint p5, gint n);
+  gint (*I420_RGBA) (guint8 * d, const guint8 * y, const guint8 * u,
+      const guint8 * v, gint p1, gint p2, gint p3, gint p4, gint p5, gint n);
+} SimdLineFuncs;
+
+static SimdLineFuncs simd_funcs;
+
+static void
+video_converter_init_simd (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined (HAVE_NEON_LINES)
+    /* NEON is always there when the compiler targets it */
+    GST_DEBUG ("enable NEON optimisations");
+    simd_funcs.interleave_uv = video_converter_interleave_uv_neon;
+    simd_funcs.deinterleave_uv = video_converter_deinterleave_uv_neon;
+    simd_funcs.I420_BGRA = video_converter_I420_BGRA_neon;
+    simd_funcs.I420_RGBA = video_converter_I420_RGBA_neon;
+#elif defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && \
+    defined (__GNUC__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+    /* orc has no AVX2 target flags, ask the CPU directly */
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+      GST_DEBUG ("enable AVX2 optimisations");
+      simd_funcs.interleave_uv = video_converter_interleave_uv_avx2;
+      simd_funcs.deinterleave_uv = video_converter_deinterleave_uv_avx2;
+      simd_funcs.I420_BGRA = video_converter_I420_BGRA_avx2;
+      simd_funcs.I420_RGBA = video_converter_I420_RGBA_avx2;
+    } else {
+      GST_DEBUG ("AVX2 not supported by the CPU");
+    }
+#else
+    GST_DEBUG ("no SIMD line functions");
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
+static void
+interleave_uv_line (guint8 * d, const guint8 * u, const guint8 * v, gint n)
+{
+  gint i = 0;
+
+  if (simd_funcs.interleave_uv)
+    i = simd_funcs.interleave_uv (d, u, v, n);
+
+  for (; i < n; i++) {
+    d[2 * i] = u[i];
+    d[2 * i + 1] = v[i];
+  }
+}
+
+static void
+deinterleave_uv_line (guint8 * u, guint8 * v, const guint8 * s, gint n)
+{
+  gint i = 0;
+
+  if (simd_funcs.deinterleave_uv)
+    i = simd_funcs.deinterleave_uv (u, v, s, n);
+
+  for (; i < n; i++) {
+    u[i] = s[2 * i];
+    v[i] = s[2 * i + 1];
+  }
+}
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+static void
+convert_I420_BGRA_line (guint8 * d, const guint8 * sy, const guint8 * su,
+    const guint8 * sv, const MatrixData * data, gint width)
+{
+  gint i = 0;
+
+  if (simd_funcs.I420_BGRA)
+    i = simd_funcs.I420_BGRA (d, sy, su, sv, data->im[0][0], data->im[0][2],
+        data->im[2][1], data->im[1][1], data->im[1][2], width);
+
+  /* the SIMD versions do an even number of pixels */
+  if (i < width)
+    video_orc_convert_I420_BGRA (d + i * 4, sy + i, su + i / 2, sv + i / 2,
+        data->im[0][0], data->im[0][2], data->im[2][1], data->im[1][1],
+        data->im[1][2], width - i);
+}
+#endif
+
 static void
 convert_I420_YUY2_task (FConvertTask * task)
 {
@@ -6773,10 +6884,7 @@ convert_I420_BGRA_task (FConvertTask * task)
     sv += (task->in_x >> 1);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    video_orc_convert_I420_BGRA (d, sy, su, sv,
-        task->data->im[0][0], task->data->im[0][2],
-        task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
-        task->width);
+    convert_I420_BGRA_line (d, sy, su, sv, task->data, task->width);
 #else
     video_orc_convert_I420_ARGB (d, sy, su, sv,
         task->data->im[0][0], task->data->im[0][2],
@@ -6910,16 +7018,31 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
 static void
 convert_I420_pack_ARGB_task (FConvertTask * task)
 {
-  gint i;
+  gint i, pstride;
   gpointer d[GST_VIDEO_MAX_PLANES];
+  gboolean direct_rgba = FALSE;
 
+  pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (task->dest->info.finfo, 0);
   d[0] = FRAME_GET_LINE (task->dest, 0);
-  d[0] =
-      (guint8 *) d[0] +
-      task->out_x * GST_VIDEO_FORMAT_INFO_PSTRIDE (task->dest->info.finfo, 0);
+  d[0] = (guint8 *) d[0] + task->out_x * pstride;
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+  /* RGBA can be written directly, the pack function is then only used for
+   * the pixels the SIMD function leaves */
+  switch (GST_VIDEO_FRAME_FORMAT (task->dest)) {
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_RGBx:
+      direct_rgba = simd_funcs.I420_RGBA != NULL;
+      break;
+    default:
+      break;
+  }
+#endif
 
   for (i = task->height_0; i < task->height_1; i++) {
     guint8 *sy, *su, *sv;
+    gpointer dl[GST_VIDEO_MAX_PLANES];
+    gint done = 0;
 
     sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
     sy += task->in_x;
@@ -6928,23 +7051,39 @@ convert_I420_pack_ARGB_task (FConvertTask * task)
     sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
     sv += (task->in_x >> 1);
 
+    if (direct_rgba) {
+      guint8 *line = FRAME_GET_LINE (task->dest, i + task->out_y);
+
+      done = simd_funcs.I420_RGBA (line + task->out_x * pstride, sy, su, sv,
+          task->data->im[0][0], task->data->im[0][2],
+          task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
+          task->width);
+      if (done == task->width)
+        continue;
+
+      sy += done;
+      su += done / 2;
+      sv += done / 2;
+    }
+
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
     video_orc_convert_I420_ARGB (task->tmpline, sy, su, sv,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
-        task->width);
+        task->width - done);
 #else
     video_orc_convert_I420_BGRA (task->tmpline, sy, su, sv,
         task->data->im[0][0], task->data->im[0][2],
         task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
-        task->width);
+        task->width - done);
 #endif
+    dl[0] = (guint8 *) d[0] + done * pstride;
     task->dest->info.finfo->pack_func (task->dest->info.finfo,
         (GST_VIDEO_FRAME_IS_INTERLACED (task->dest) ?
             GST_VIDEO_PACK_FLAG_INTERLACED :
             GST_VIDEO_PACK_FLAG_NONE),
-        task->tmpline, 0, d, task->dest->info.stride,
-        task->dest->info.chroma_site, i + task->out_y, task->width);
+        task->tmpline, 0, dl, task->dest->info.stride,
+        task->dest->info.chroma_site, i + task->out_y, task->width - done);
   }
 }
 
@@ -6995,6 +7134,152 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_I420_NV12_task (FConvertTask * task)
+{
+  gint i;
+  gint cwidth = (task->width + 1) >> 1;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *sy, *su, *sv, *dy, *duv;
+
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    dy = FRAME_GET_Y_LINE (task->dest, i + task->out_y);
+    dy += task->out_x;
+    memcpy (dy, sy, task->width);
+
+    /* chroma lines are copied one to one, this also works for interlaced
+     * content */
+    if (i & 1)
+      continue;
+
+    su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+    su += (task->in_x >> 1);
+    sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+    sv += (task->in_x >> 1);
+    duv = FRAME_GET_PLANE_LINE (task->dest, 1, (i + task->out_y) >> 1);
+    duv += task->out_x;
+
+    interleave_uv_line (duv, su, sv, cwidth);
+  }
+}
+
+static void
+convert_I420_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_I420_NV12_task, (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_NV12_I420_task (FConvertTask * task)
+{
+  gint i;
+  gint cwidth = (task->width + 1) >> 1;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *sy, *suv, *dy, *du, *dv;
+
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    dy = FRAME_GET_Y_LINE (task->dest, i + task->out_y);
+    dy += task->out_x;
+    memcpy (dy, sy, task->width);
+
+    if (i & 1)
+      continue;
+
+    suv = FRAME_GET_PLANE_LINE (task->src, 1, (i + task->in_y) >> 1);
+    suv += task->in_x;
+    du = FRAME_GET_U_LINE (task->dest, (i + task->out_y) >> 1);
+    du += (task->out_x >> 1);
+    dv = FRAME_GET_V_LINE (task->dest, (i + task->out_y) >> 1);
+    dv += (task->out_x >> 1);
+
+    deinterleave_uv_line (du, dv, suv, cwidth);
+  }
+}
+
+static void
+convert_NV12_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_I420_task, (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
 static void
 convert_A420_pack_ARGB_task (FConvertTask * task)
 {
@@ -7789,6 +8074,82 @@ convert_scale_planes (GstVideoConverter * convert,
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_NV12_planar_uv_task (FConvertPlaneTask * task)
+{
+  gint i;
+
+  for (i = 0; i < task->height; i++) {
+    deinterleave_uv_line (task->du + i * task->dustride,
+        task->dv + i * task->dvstride, task->s + i * task->sstride,
+        task->width);
+  }
+}
+
+/* NV12 -> I420/YV12 with scaling: deinterleave the chroma into planar
+ * scratch planes and run the I420 plane scalers on them, so the result is
+ * the same as a same size NV12 -> I420 conversion followed by a scale */
+static void
+convert_NV12_I420_scale (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  const GstVideoFormatInfo *finfo = convert->in_info.finfo;
+  GstVideoFrame planar;
+  FConvertPlaneTask *tasks;
+  FConvertPlaneTask **tasks_p;
+  gint n_threads, lines_per_thread;
+  gint i, cy, cheight, cwidth, stride;
+  const guint8 *s;
+  guint8 *du, *dv;
+
+  stride = convert->planar_uv_stride;
+  cwidth = GST_VIDEO_FRAME_COMP_WIDTH (src, 1);
+  cy = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, 1, convert->in_y);
+  cheight = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, 1, convert->in_height);
+  cheight = MIN (cheight, convert->planar_uv_height - cy);
+
+  planar = *src;
+  planar.data[1] = convert->planar_uv;
+  planar.data[2] = convert->planar_uv + stride * convert->planar_uv_height;
+  planar.info.stride[1] = stride;
+  planar.info.stride[2] = stride;
+
+  s = FRAME_GET_PLANE_LINE (src, 1, cy);
+  du = FRAME_GET_PLANE_LINE (&planar, 1, cy);
+  dv = FRAME_GET_PLANE_LINE (&planar, 2, cy);
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[3] =
+      g_renew (FConvertPlaneTask, convert->tasks[3], n_threads);
+  tasks_p = convert->tasks_p[3] =
+      g_renew (FConvertPlaneTask *, convert->tasks_p[3], n_threads);
+
+  lines_per_thread = (cheight + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].sstride = FRAME_GET_PLANE_STRIDE (src, 1);
+    tasks[i].dustride = stride;
+    tasks[i].dvstride = stride;
+    tasks[i].s = s + i * lines_per_thread * tasks[i].sstride;
+    tasks[i].du = du + i * lines_per_thread * stride;
+    tasks[i].dv = dv + i * lines_per_thread * stride;
+
+    tasks[i].width = cwidth;
+    tasks[i].height = (i + 1) * lines_per_thread;
+    tasks[i].height = MIN (tasks[i].height, cheight);
+    tasks[i].height -= i * lines_per_thread;
+    tasks[i].height = MAX (tasks[i].height, 0);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_planar_uv_task,
+      (gpointer) tasks_p);
+
+  convert_scale_planes (convert, &planar, dest);
+}
+
 static GstVideoFormat
 get_scale_format (GstVideoFormat format, gint plane)
 {
@@ -7958,7 +8319,7 @@ get_scale_format (GstVideoFormat format, gint plane)
 }
 
 static gboolean
-is_merge_yuv (GstVideoInfo * info)
+is_merge_yuv (const GstVideoInfo * info)
 {
   switch (GST_VIDEO_INFO_FORMAT (info)) {
     case GST_VIDEO_FORMAT_YUY2:
@@ -7972,18 +8333,17 @@ is_merge_yuv (GstVideoInfo * info)
 }
 
 static gboolean
-setup_scale (GstVideoConverter * convert)
+setup_scale (GstVideoConverter * convert, const GstVideoInfo * in_info)
 {
   int i, n_planes;
   gint method, cr_method, in_width, in_height, out_width, out_height;
   guint taps;
-  GstVideoInfo *in_info, *out_info;
+  const GstVideoInfo *out_info;
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
   guint n_threads = convert->conversion_runner->n_threads;
 
-  in_info = &convert->in_info;
   out_info = &convert->out_info;
 
   in_finfo = in_info->finfo;
@@ -8581,6 +8941,20 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YVU9, GST_VIDEO_FORMAT_YVU9, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* planar <-> semiplanar */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420_scale},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420_scale},
+
   /* sempiplanar -> semiplanar */
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -8865,14 +9239,30 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       for (j = 0; j < convert->conversion_runner->n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
-      if (!transforms[i].keeps_size)
-        if (!setup_scale (convert))
+      if (transforms[i].convert == convert_NV12_I420_scale) {
+        GstVideoInfo planar_info = convert->in_info;
+
+        /* the chroma is deinterleaved first and scaled as I420 planes */
+        planar_info.finfo = gst_video_format_get_info (GST_VIDEO_FORMAT_I420);
+        convert->planar_uv_stride =
+            GST_ROUND_UP_32 (GST_VIDEO_INFO_COMP_WIDTH (&convert->in_info, 1));
+        convert->planar_uv_height =
+            GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (convert->in_info.finfo, 1,
+            height);
+        convert->planar_uv = g_malloc (2 * convert->planar_uv_stride *
+            convert->planar_uv_height);
+        if (!setup_scale (convert, &planar_info))
           return FALSE;
+      } else if (!transforms[i].keeps_size) {
+        if (!setup_scale (convert, &convert->in_info))
+          return FALSE;
+      }
       if (border)
         setup_borderline (convert);
       return TRUE;
     }
   }
+
   GST_LOG ("no fastpath found");
   return FALSE;
 }
@@ -0,0 +1,181 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <arm_neon.h>
+
+/* Same contract and arithmetic as the AVX2 versions. The 8 bit sums are
+ * done in 16 bits directly, which wraps like the orc code. */
+
+static inline int16x4_t
+h_ntap_u8_taps_neon (uint8x8_t p, const gint16 * t)
+{
+  int16x8_t m;
+
+  m = vmulq_s16 (vreinterpretq_s16_u16 (vmovl_u8 (p)), vld1q_s16 (t));
+  return vadd_s16 (vget_low_s16 (m), vget_high_s16 (m));
+}
+
+static inline int16x4_t
+h_ntap_1u8_4_neon (const guint8 * s, const guint32 * offset,
+    const guint32 * phase, const gint16 * taps)
+{
+  int16x4_t a0, a1, a2, a3;
+
+  a0 = h_ntap_u8_taps_neon (vld1_u8 (s + offset[0]), taps + 8 * phase[0]);
+  a1 = h_ntap_u8_taps_neon (vld1_u8 (s + offset[1]), taps + 8 * phase[1]);
+  a2 = h_ntap_u8_taps_neon (vld1_u8 (s + offset[2]), taps + 8 * phase[2]);
+  a3 = h_ntap_u8_taps_neon (vld1_u8 (s + offset[3]), taps + 8 * phase[3]);
+
+  return vpadd_s16 (vpadd_s16 (a0, a1), vpadd_s16 (a2, a3));
+}
+
+static gint
+video_scaler_h_ntap_1u8_neon (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    int16x8_t sum;
+
+    sum = vcombine_s16 (h_ntap_1u8_4_neon (s, offset + i, phase + i, taps),
+        h_ntap_1u8_4_neon (s, offset + i + 4, phase + i + 4, taps));
+    sum = vshrq_n_s16 (vaddq_s16 (sum, vdupq_n_s16 (32)), 6);
+
+    vst1_u8 (d + i, vqmovun_s16 (sum));
+  }
+  return i;
+}
+
+static gint
+video_scaler_h_ntap_2u8_neon (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  gint i, k;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    int16x4_t a[4], b[4];
+    int16x4x2_t uv;
+    int16x8_t sum;
+
+    for (k = 0; k < 4; k++) {
+      uint8x8x2_t p = vld2_u8 (s + 2 * offset[i + k]);
+      const gint16 *t = taps + 8 * phase[i + k];
+
+      a[k] = h_ntap_u8_taps_neon (p.val[0], t);
+      b[k] = h_ntap_u8_taps_neon (p.val[1], t);
+    }
+    uv = vzip_s16 (vpadd_s16 (vpadd_s16 (a[0], a[1]), vpadd_s16 (a[2], a[3])),
+        vpadd_s16 (vpadd_s16 (b[0], b[1]), vpadd_s16 (b[2], b[3])));
+
+    sum = vcombine_s16 (uv.val[0], uv.val[1]);
+    sum = vshrq_n_s16 (vaddq_s16 (sum, vdupq_n_s16 (32)), 6);
+
+    vst1_u8 (d + 2 * i, vqmovun_s16 (sum));
+  }
+  return i;
+}
+
+static inline int32x2_t
+h_ntap_u16_taps_neon (const guint16 * s, const gint16 * t)
+{
+  uint16x8_t p = vld1q_u16 (s);
+  int16x8_t tt = vld1q_s16 (t);
+  int32x4_t m;
+
+  m = vmulq_s32 (vreinterpretq_s32_u32 (vmovl_u16 (vget_low_u16 (p))),
+      vmovl_s16 (vget_low_s16 (tt)));
+  m = vmlaq_s32 (m, vreinterpretq_s32_u32 (vmovl_u16 (vget_high_u16 (p))),
+      vmovl_s16 (vget_high_s16 (tt)));
+
+  return vadd_s32 (vget_low_s32 (m), vget_high_s32 (m));
+}
+
+static gint
+video_scaler_h_ntap_1u16_neon (guint16 * d, const guint16 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  gint i;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    int32x4_t sum;
+
+    sum = vcombine_s32 (vpadd_s32 (h_ntap_u16_taps_neon (s + offset[i],
+                taps + 8 * phase[i]), h_ntap_u16_taps_neon (s + offset[i + 1],
+                taps + 8 * phase[i + 1])),
+        vpadd_s32 (h_ntap_u16_taps_neon (s + offset[i + 2],
+                taps + 8 * phase[i + 2]), h_ntap_u16_taps_neon (s +
+                offset[i + 3], taps + 8 * phase[i + 3])));
+    sum = vshrq_n_s32 (vaddq_s32 (sum, vdupq_n_s32 (4095)), 12);
+
+    vst1_u16 (d + i, vqmovun_s32 (sum));
+  }
+  return i;
+}
+
+static gint
+video_scaler_v_ntap_u8_neon (guint8 * d, const guint8 ** s,
+    const gint16 * taps, gint n_taps, gint n)
+{
+  gint i, j;
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    int16x8_t lo = vdupq_n_s16 (32);
+    int16x8_t hi = vdupq_n_s16 (32);
+
+    for (j = 0; j < n_taps; j++) {
+      uint8x16_t p = vld1q_u8 (s[j] + i);
+
+      lo = vmlaq_n_s16 (lo, vreinterpretq_s16_u16 (vmovl_u8 (vget_low_u8 (p))),
+          taps[j]);
+      hi = vmlaq_n_s16 (hi, vreinterpretq_s16_u16 (vmovl_u8 (vget_high_u8
+                  (p))), taps[j]);
+    }
+    vst1q_u8 (d + i, vcombine_u8 (vqmovun_s16 (vshrq_n_s16 (lo, 6)),
+            vqmovun_s16 (vshrq_n_s16 (hi, 6))));
+  }
+  return i;
+}
+
+static gint
+video_scaler_v_ntap_u16_neon (guint16 * d, const guint16 ** s,
+    const gint16 * taps, gint n_taps, gint n)
+{
+  gint i, j;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    int32x4_t lo = vdupq_n_s32 (4095);
+    int32x4_t hi = vdupq_n_s32 (4095);
+
+    for (j = 0; j < n_taps; j++) {
+      uint16x8_t p = vld1q_u16 (s[j] + i);
+
+      lo = vmlaq_n_s32 (lo, vreinterpretq_s32_u32 (vmovl_u16 (vget_low_u16
+                  (p))), taps[j]);
+      hi = vmlaq_n_s32 (hi, vreinterpretq_s32_u32 (vmovl_u16 (vget_high_u16
+                  (p))), taps[j]);
+    }
+    vst1q_u16 (d + i, vcombine_u16 (vqmovun_s32 (vshrq_n_s32 (lo, 12)),
+            vqmovun_s32 (vshrq_n_s32 (hi, 12))));
+  }
+  return i;
+}
@@ -0,0 +1,246 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-scaler-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && defined (__AVX2__)
+
+#include <immintrin.h>
+
+/* The 8 bit functions compute the same thing as the orc _lq functions:
+ * products and sums with 16 bit wraparound, (sum + 32) >> 6 and
+ * saturation to unsigned 8 bits. The 16 bit functions do the sums in 32
+ * bits, then (sum + 4095) >> 12 and saturate to unsigned 16 bits.
+ *
+ * Sums done in 32 bits wrap to the same low 16 bits, so the horizontal
+ * functions can use madd and only drop the high half at the end. */
+
+static inline __m256i
+scale_u8_lq_epi32 (__m256i sum)
+{
+  sum = _mm256_add_epi32 (sum, _mm256_set1_epi32 (32));
+  sum = _mm256_srai_epi32 (_mm256_slli_epi32 (sum, 16), 16);
+  return _mm256_srai_epi32 (sum, 6);
+}
+
+static inline __m256i
+load_2x8_u8 (const guint8 * a, const guint8 * b)
+{
+  return _mm256_cvtepu8_epi16 (_mm_unpacklo_epi64 (_mm_loadl_epi64 ((const
+                  __m128i *) a), _mm_loadl_epi64 ((const __m128i *) b)));
+}
+
+static inline __m256i
+load_2x8_s16 (const gint16 * a, const gint16 * b)
+{
+  return
+      _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((const
+                  __m128i *) a)), _mm_loadu_si128 ((const __m128i *) b), 1);
+}
+
+gint
+video_scaler_h_ntap_1u8_avx2 (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  gint i, k;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    __m256i m[4], sum;
+    __m128i r;
+
+    /* pixel k in the low lane, pixel k + 4 in the high lane */
+    for (k = 0; k < 4; k++) {
+      m[k] = _mm256_madd_epi16 (load_2x8_u8 (s + offset[i + k],
+              s + offset[i + k + 4]), load_2x8_s16 (taps + 8 * phase[i + k],
+              taps + 8 * phase[i + k + 4]));
+    }
+    /* 0 1 2 3 | 4 5 6 7 */
+    sum = _mm256_hadd_epi32 (_mm256_hadd_epi32 (m[0], m[1]),
+        _mm256_hadd_epi32 (m[2], m[3]));
+    sum = scale_u8_lq_epi32 (sum);
+    sum = _mm256_packs_epi32 (sum, sum);
+    sum = _mm256_packus_epi16 (sum, sum);
+
+    r = _mm_unpacklo_epi32 (_mm256_castsi256_si128 (sum),
+        _mm256_extracti128_si256 (sum, 1));
+    _mm_storel_epi64 ((__m128i *) (d + i), r);
+  }
+  return i;
+}
+
+gint
+video_scaler_h_ntap_2u8_avx2 (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  const __m128i split = _mm_setr_epi8 (0, 2, 4, 6, 8, 10, 12, 14,
+      1, 3, 5, 7, 9, 11, 13, 15);
+  gint i, k;
+
+  for (i = 0; i + 4 <= n; i += 4) {
+    __m256i m[4], sum;
+    __m128i p, r;
+
+    /* both components of a pixel at once, first in the low lane, second
+     * in the high lane */
+    for (k = 0; k < 4; k++) {
+      p = _mm_loadu_si128 ((const __m128i *) (s + 2 * offset[i + k]));
+      p = _mm_shuffle_epi8 (p, split);
+      m[k] = _mm256_madd_epi16 (_mm256_cvtepu8_epi16 (p),
+          _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *)
+                  (taps + 8 * phase[i + k]))));
+    }
+    /* c0: 0 1 2 3 | c1: 0 1 2 3 */
+    sum = _mm256_hadd_epi32 (_mm256_hadd_epi32 (m[0], m[1]),
+        _mm256_hadd_epi32 (m[2], m[3]));
+    sum = scale_u8_lq_epi32 (sum);
+    sum = _mm256_packs_epi32 (sum, sum);
+
+    r = _mm_unpacklo_epi16 (_mm256_castsi256_si128 (sum),
+        _mm256_extracti128_si256 (sum, 1));
+    _mm_storel_epi64 ((__m128i *) (d + 2 * i), _mm_packus_epi16 (r, r));
+  }
+  return i;
+}
+
+static inline __m256i
+mul_8_u16 (const guint16 * s, const gint16 * t)
+{
+  return _mm256_mullo_epi32 (_mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const
+                  __m128i *) s)),
+      _mm256_cvtepi16_epi32 (_mm_loadu_si128 ((const __m128i *) t)));
+}
+
+static inline __m128i
+h_ntap_4_u16 (const guint16 * s, const guint32 * offset,
+    const guint32 * phase, const gint16 * taps)
+{
+  __m256i m0, m1, m2, m3, sum;
+
+  m0 = mul_8_u16 (s + offset[0], taps + 8 * phase[0]);
+  m1 = mul_8_u16 (s + offset[1], taps + 8 * phase[1]);
+  m2 = mul_8_u16 (s + offset[2], taps + 8 * phase[2]);
+  m3 = mul_8_u16 (s + offset[3], taps + 8 * phase[3]);
+
+  /* taps 0-3 of pixel 0 1 2 3 | taps 4-7 of pixel 0 1 2 3 */
+  sum = _mm256_hadd_epi32 (_mm256_hadd_epi32 (m0, m1),
+      _mm256_hadd_epi32 (m2, m3));
+
+  return _mm_add_epi32 (_mm256_castsi256_si128 (sum),
+      _mm256_extracti128_si256 (sum, 1));
+}
+
+gint
+video_scaler_h_ntap_1u16_avx2 (guint16 * d, const guint16 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n)
+{
+  const __m128i round = _mm_set1_epi32 (4095);
+  gint i;
+
+  for (i = 0; i + 8 <= n; i += 8) {
+    __m128i a, b;
+
+    a = h_ntap_4_u16 (s, offset + i, phase + i, taps);
+    b = h_ntap_4_u16 (s, offset + i + 4, phase + i + 4, taps);
+    a = _mm_srai_epi32 (_mm_add_epi32 (a, round), 12);
+    b = _mm_srai_epi32 (_mm_add_epi32 (b, round), 12);
+
+    _mm_storeu_si128 ((__m128i *) (d + i), _mm_packus_epi32 (a, b));
+  }
+  return i;
+}
+
+gint
+video_scaler_v_ntap_u8_avx2 (guint8 * d, const guint8 ** s,
+    const gint16 * taps, gint n_taps, gint n)
+{
+  const __m256i round = _mm256_set1_epi16 (32);
+  __m256i t[8];
+  gint i, j;
+
+  for (j = 0; j < n_taps; j++)
+    t[j] = _mm256_set1_epi16 (taps[j]);
+
+  /* all taps are summed in registers, no temporary line */
+  for (i = 0; i + 32 <= n; i += 32) {
+    __m256i lo = _mm256_setzero_si256 ();
+    __m256i hi = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i p;
+
+      p = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s[j] +
+                  i)));
+      lo = _mm256_add_epi16 (lo, _mm256_mullo_epi16 (p, t[j]));
+      p = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i *) (s[j] + i +
+                  16)));
+      hi = _mm256_add_epi16 (hi, _mm256_mullo_epi16 (p, t[j]));
+    }
+    lo = _mm256_srai_epi16 (_mm256_add_epi16 (lo, round), 6);
+    hi = _mm256_srai_epi16 (_mm256_add_epi16 (hi, round), 6);
+
+    /* 0-7 16-23 | 8-15 24-31 */
+    lo = _mm256_permute4x64_epi64 (_mm256_packus_epi16 (lo, hi), 0xd8);
+    _mm256_storeu_si256 ((__m256i *) (d + i), lo);
+  }
+  return i;
+}
+
+gint
+video_scaler_v_ntap_u16_avx2 (guint16 * d, const guint16 ** s,
+    const gint16 * taps, gint n_taps, gint n)
+{
+  const __m256i round = _mm256_set1_epi32 (4095);
+  __m256i t[8];
+  gint i, j;
+
+  for (j = 0; j < n_taps; j++)
+    t[j] = _mm256_set1_epi32 (taps[j]);
+
+  for (i = 0; i + 16 <= n; i += 16) {
+    __m256i lo = _mm256_setzero_si256 ();
+    __m256i hi = _mm256_setzero_si256 ();
+
+    for (j = 0; j < n_taps; j++) {
+      __m256i p;
+
+      p = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (s[j] +
+                  i)));
+      lo = _mm256_add_epi32 (lo, _mm256_mullo_epi32 (p, t[j]));
+      p = _mm256_cvtepu16_epi32 (_mm_loadu_si128 ((const __m128i *) (s[j] + i +
+                  8)));
+      hi = _mm256_add_epi32 (hi, _mm256_mullo_epi32 (p, t[j]));
+    }
+    lo = _mm256_srai_epi32 (_mm256_add_epi32 (lo, round), 12);
+    hi = _mm256_srai_epi32 (_mm256_add_epi32 (hi, round), 12);
+
+    /* 0-3 8-11 | 4-7 12-15 */
+    lo = _mm256_permute4x64_epi64 (_mm256_packus_epi32 (lo, hi), 0xd8);
+    _mm256_storeu_si256 ((__m256i *) (d + i), lo);
+  }
+  return i;
+}
+
+#endif
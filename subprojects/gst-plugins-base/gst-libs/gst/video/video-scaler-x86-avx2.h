@@ -0,0 +1,55 @@
+/* GStreamer
+ * Copyright (C) <2026> GStreamer developers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_SCALER_X86_AVX2_H
+#define VIDEO_SCALER_X86_AVX2_H
+
+#include <glib.h>
+
+/* All functions handle a multiple of their block size of the @n output
+ * samples and return how many they did, the caller does the remainder.
+ *
+ * The horizontal functions take @offset and @phase for the first output
+ * sample and @taps with 8 zero padded taps per phase. They read 8 input
+ * pixels for each output pixel. */
+
+G_GNUC_INTERNAL
+gint video_scaler_h_ntap_1u8_avx2 (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n);
+
+G_GNUC_INTERNAL
+gint video_scaler_h_ntap_2u8_avx2 (guint8 * d, const guint8 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n);
+
+G_GNUC_INTERNAL
+gint video_scaler_h_ntap_1u16_avx2 (guint16 * d, const guint16 * s,
+    const guint32 * offset, const guint32 * phase, const gint16 * taps,
+    gint n);
+
+G_GNUC_INTERNAL
+gint video_scaler_v_ntap_u8_avx2 (guint8 * d, const guint8 ** s,
+    const gint16 * taps, gint n_taps, gint n);
+
+G_GNUC_INTERNAL
+gint video_scaler_v_ntap_u16_avx2 (guint16 * d, const guint16 ** s,
+    const gint16 * taps, gint n_taps, gint n);
+
+#endif /* VIDEO_SCALER_X86_AVX2_H */
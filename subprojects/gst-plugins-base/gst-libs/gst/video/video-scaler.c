@@ -43,6 +43,12 @@
 
 #include "video-orc.h"
 #include "video-scaler.h"
+#include "video-scaler-x86-avx2.h"
+
+#if defined (__ARM_NEON) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+#define HAVE_NEON_SCALER
+#include "video-scaler-neon.h"
+#endif
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -97,14 +103,116 @@ struct _GstVideoScaler
   gint16 *taps_s16;
   gint16 *taps_s16_4;
   guint32 *offset_n;
+  /* taps_s16 padded to 8 taps per phase for the SIMD functions */
+  gint16 *taps_s16_8;
   /* for ORC */
   gint inc;
 
   gint tmpwidth;
   gpointer tmpline1;
   gpointer tmpline2;
+
+  /* shared taps from the cache, owns the arrays in resampler when set */
+  struct _ScalerTaps *shared;
 };
 
+/* Computing the taps is the expensive part of making a scaler and the
+ * result only depends on the method, sizes and the resampler options.
+ * Keep the most recently used ones around so that reconfiguring to a
+ * geometry we've seen before does not compute them again. */
+#define SCALER_TAPS_CACHE_SIZE 64
+
+#define OPT_CUBIC_B    (1 << 0)
+#define OPT_CUBIC_C    (1 << 1)
+#define OPT_ENVELOPE   (1 << 2)
+#define OPT_SHARPNESS  (1 << 3)
+#define OPT_SHARPEN    (1 << 4)
+#define OPT_MAX_TAPS   (1 << 5)
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoScalerFlags flags;
+  guint n_taps;
+  guint in_size;
+  guint out_size;
+
+  guint opt_mask;
+  gdouble cubic_b;
+  gdouble cubic_c;
+  gdouble envelope;
+  gdouble sharpness;
+  gdouble sharpen;
+  gint max_taps;
+} ScalerTapsKey;
+
+typedef struct _ScalerTaps
+{
+  gint ref_count;
+  ScalerTapsKey key;
+  GstVideoResampler resampler;
+} ScalerTaps;
+
+static GMutex taps_cache_lock;
+static GQueue taps_cache = G_QUEUE_INIT;
+
+/* Vectorised polyphase functions for up to 8 taps, see
+ * video-scaler-x86-avx2.h for how they are called. They work straight
+ * from the source lines and sum all taps in registers, so unlike the orc
+ * path they don't need a gathered copy of the input for each tap or a
+ * temporary line with the partial sums. */
+#define SIMD_MAX_TAPS 8
+
+typedef struct
+{
+  gint (*h_ntap_1u8) (guint8 * d, const guint8 * s, const guint32 * offset,
+      const guint32 * phase, const gint16 * taps, gint n);
+  gint (*h_ntap_2u8) (guint8 * d, const guint8 * s, const guint32 * offset,
+      const guint32 * phase, const gint16 * taps, gint n);
+  gint (*h_ntap_1u16) (guint16 * d, const guint16 * s,
+      const guint32 * offset, const guint32 * phase, const gint16 * taps,
+      gint n);
+  gint (*v_ntap_u8) (guint8 * d, const guint8 ** s, const gint16 * taps,
+      gint n_taps, gint n);
+  gint (*v_ntap_u16) (guint16 * d, const guint16 ** s, const gint16 * taps,
+      gint n_taps, gint n);
+} SimdScaleFuncs;
+
+static SimdScaleFuncs simd_funcs;
+
+static void
+video_scaler_init_simd (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined (HAVE_NEON_SCALER)
+    GST_DEBUG ("enable NEON optimisations");
+    simd_funcs.h_ntap_1u8 = video_scaler_h_ntap_1u8_neon;
+    simd_funcs.h_ntap_2u8 = video_scaler_h_ntap_2u8_neon;
+    simd_funcs.h_ntap_1u16 = video_scaler_h_ntap_1u16_neon;
+    simd_funcs.v_ntap_u8 = video_scaler_v_ntap_u8_neon;
+    simd_funcs.v_ntap_u16 = video_scaler_v_ntap_u16_neon;
+#elif defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2 && \
+    defined (__GNUC__) && G_BYTE_ORDER == G_LITTLE_ENDIAN
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("avx2")) {
+      GST_DEBUG ("enable AVX2 optimisations");
+      simd_funcs.h_ntap_1u8 = video_scaler_h_ntap_1u8_avx2;
+      simd_funcs.h_ntap_2u8 = video_scaler_h_ntap_2u8_avx2;
+      simd_funcs.h_ntap_1u16 = video_scaler_h_ntap_1u16_avx2;
+      simd_funcs.v_ntap_u8 = video_scaler_v_ntap_u8_avx2;
+      simd_funcs.v_ntap_u16 = video_scaler_v_ntap_u16_avx2;
+    } else {
+      GST_DEBUG ("AVX2 not supported by the CPU");
+    }
+#else
+    GST_DEBUG ("no SIMD scaler functions");
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
 static void
 resampler_zip (GstVideoResampler * resampler, const GstVideoResampler * r1,
     const GstVideoResampler * r2)
@@ -145,6 +253,88 @@ resampler_zip (GstVideoResampler * resampler, const GstVideoResampler * r1,
   }
 }
 
+static void
+scaler_taps_key_init (ScalerTapsKey * key, GstVideoResamplerMethod method,
+    GstVideoScalerFlags flags, guint n_taps, guint in_size, guint out_size,
+    GstStructure * options)
+{
+  /* zero the padding too, keys are compared with memcmp */
+  memset (key, 0, sizeof (ScalerTapsKey));
+
+  key->method = method;
+  key->flags = flags;
+  key->n_taps = n_taps;
+  key->in_size = in_size;
+  key->out_size = out_size;
+
+  /* only the resampler options matter, the structure might contain many
+   * other fields (like the converter config with its rectangles) */
+  if (options == NULL)
+    return;
+
+  if (gst_structure_get_double (options, GST_VIDEO_RESAMPLER_OPT_CUBIC_B,
+          &key->cubic_b))
+    key->opt_mask |= OPT_CUBIC_B;
+  if (gst_structure_get_double (options, GST_VIDEO_RESAMPLER_OPT_CUBIC_C,
+          &key->cubic_c))
+    key->opt_mask |= OPT_CUBIC_C;
+  if (gst_structure_get_double (options, GST_VIDEO_RESAMPLER_OPT_ENVELOPE,
+          &key->envelope))
+    key->opt_mask |= OPT_ENVELOPE;
+  if (gst_structure_get_double (options, GST_VIDEO_RESAMPLER_OPT_SHARPNESS,
+          &key->sharpness))
+    key->opt_mask |= OPT_SHARPNESS;
+  if (gst_structure_get_double (options, GST_VIDEO_RESAMPLER_OPT_SHARPEN,
+          &key->sharpen))
+    key->opt_mask |= OPT_SHARPEN;
+  if (gst_structure_get_int (options, GST_VIDEO_RESAMPLER_OPT_MAX_TAPS,
+          &key->max_taps))
+    key->opt_mask |= OPT_MAX_TAPS;
+}
+
+static void
+scaler_taps_unref (ScalerTaps * taps)
+{
+  if (!g_atomic_int_dec_and_test (&taps->ref_count))
+    return;
+
+  gst_video_resampler_clear (&taps->resampler);
+  g_free (taps);
+}
+
+/* called with the cache lock */
+static ScalerTaps *
+scaler_taps_cache_lookup (const ScalerTapsKey * key)
+{
+  GList *walk;
+
+  for (walk = taps_cache.head; walk; walk = walk->next) {
+    ScalerTaps *taps = walk->data;
+
+    if (memcmp (&taps->key, key, sizeof (ScalerTapsKey)) == 0) {
+      /* move to the front, the tail is evicted first */
+      if (walk != taps_cache.head) {
+        g_queue_unlink (&taps_cache, walk);
+        g_queue_push_head_link (&taps_cache, walk);
+      }
+      g_atomic_int_inc (&taps->ref_count);
+      return taps;
+    }
+  }
+  return NULL;
+}
+
+/* called with the cache lock, takes a new ref on @taps */
+static void
+scaler_taps_cache_insert (ScalerTaps * taps)
+{
+  g_atomic_int_inc (&taps->ref_count);
+  g_queue_push_head (&taps_cache, taps);
+
+  while (taps_cache.length > SCALER_TAPS_CACHE_SIZE)
+    scaler_taps_unref (g_queue_pop_tail (&taps_cache));
+}
+
 static void
 realloc_tmplines (GstVideoScaler * scale, gint n_elems, gint width)
 {
@@ -215,6 +405,8 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
     guint n_taps, guint in_size, guint out_size, GstStructure * options)
 {
   GstVideoScaler *scale;
+  ScalerTapsKey key;
+  ScalerTaps *taps, *existing;
 
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
@@ -226,31 +418,62 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   scale->method = method;
   scale->flags = flags;
 
-  if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
-    GstVideoResampler tresamp, bresamp;
-    gdouble shift;
+  video_scaler_init_simd ();
 
-    shift = (INTERLACE_SHIFT * out_size) / in_size;
+  scaler_taps_key_init (&key, method, flags, n_taps, in_size, out_size,
+      options);
 
-    gst_video_resampler_init (&tresamp, method,
-        GST_VIDEO_RESAMPLER_FLAG_HALF_TAPS, (out_size + 1) / 2, n_taps, shift,
-        (in_size + 1) / 2, (out_size + 1) / 2, options);
+  g_mutex_lock (&taps_cache_lock);
+  taps = scaler_taps_cache_lookup (&key);
+  g_mutex_unlock (&taps_cache_lock);
 
-    n_taps = tresamp.max_taps;
+  if (taps) {
+    GST_DEBUG ("reusing cached taps %p", taps);
+  } else {
+    taps = g_new0 (ScalerTaps, 1);
+    taps->ref_count = 1;
+    taps->key = key;
 
-    gst_video_resampler_init (&bresamp, method, 0, out_size - tresamp.out_size,
-        n_taps, -shift, in_size - tresamp.in_size,
-        out_size - tresamp.out_size, options);
+    if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
+      GstVideoResampler tresamp, bresamp;
+      gdouble shift;
 
-    resampler_zip (&scale->resampler, &tresamp, &bresamp);
-    gst_video_resampler_clear (&tresamp);
-    gst_video_resampler_clear (&bresamp);
-  } else {
-    gst_video_resampler_init (&scale->resampler, method,
-        GST_VIDEO_RESAMPLER_FLAG_NONE, out_size, n_taps, 0.0, in_size, out_size,
-        options);
+      shift = (INTERLACE_SHIFT * out_size) / in_size;
+
+      gst_video_resampler_init (&tresamp, method,
+          GST_VIDEO_RESAMPLER_FLAG_HALF_TAPS, (out_size + 1) / 2, n_taps,
+          shift, (in_size + 1) / 2, (out_size + 1) / 2, options);
+
+      n_taps = tresamp.max_taps;
+
+      gst_video_resampler_init (&bresamp, method, 0,
+          out_size - tresamp.out_size, n_taps, -shift,
+          in_size - tresamp.in_size, out_size - tresamp.out_size, options);
+
+      resampler_zip (&taps->resampler, &tresamp, &bresamp);
+      gst_video_resampler_clear (&tresamp);
+      gst_video_resampler_clear (&bresamp);
+    } else {
+      gst_video_resampler_init (&taps->resampler, method,
+          GST_VIDEO_RESAMPLER_FLAG_NONE, out_size, n_taps, 0.0, in_size,
+          out_size, options);
+    }
+
+    /* someone else might have computed the same taps in the meantime, in
+     * which case we just keep ours private */
+    g_mutex_lock (&taps_cache_lock);
+    existing = scaler_taps_cache_lookup (&key);
+    if (existing)
+      scaler_taps_unref (existing);
+    else
+      scaler_taps_cache_insert (taps);
+    g_mutex_unlock (&taps_cache_lock);
   }
 
+  /* the arrays are shared and never modified */
+  scale->shared = taps;
+  scale->resampler = taps->resampler;
+
   if (out_size == 1)
     scale->inc = 0;
   else
@@ -273,10 +496,14 @@ gst_video_scaler_free (GstVideoScaler * scale)
 {
   g_return_if_fail (scale != NULL);
 
-  gst_video_resampler_clear (&scale->resampler);
+  if (scale->shared)
+    scaler_taps_unref (scale->shared);
+  else
+    gst_video_resampler_clear (&scale->resampler);
   g_free (scale->taps_s16);
   g_free (scale->taps_s16_4);
   g_free (scale->offset_n);
+  g_free (scale->taps_s16_8);
   g_free (scale->tmpline1);
   g_free (scale->tmpline2);
   g_free (scale);
@@ -448,6 +675,34 @@ make_s16_taps (GstVideoScaler * scale, gint n_elems, gint precision)
   }
 }
 
+static void
+make_s16_8_taps (GstVideoScaler * scale)
+{
+  gint i, max_taps, n_phases;
+
+  n_phases = scale->resampler.n_phases;
+  max_taps = scale->resampler.max_taps;
+
+  scale->taps_s16_8 = g_malloc0 (sizeof (gint16) * n_phases * SIMD_MAX_TAPS);
+  for (i = 0; i < n_phases; i++) {
+    memcpy (scale->taps_s16_8 + i * SIMD_MAX_TAPS,
+        scale->taps_s16 + i * max_taps, sizeof (gint16) * max_taps);
+  }
+}
+
+/* the horizontal SIMD functions read SIMD_MAX_TAPS pixels for every output
+ * pixel, leave the ones that would read past the end of the line to the C
+ * code. The offsets only go up. */
+static guint
+simd_h_width (GstVideoScaler * scale, const guint32 * offset, guint width)
+{
+  while (width > 0 &&
+      (gint) offset[width - 1] + SIMD_MAX_TAPS > scale->resampler.in_size)
+    width--;
+
+  return width;
+}
+
 #undef ACC_SCALE
 
 static void
@@ -825,6 +1080,89 @@ video_scale_h_ntap_u16 (GstVideoScaler * scale,
   }
 }
 
+static void
+video_scale_h_ntap_u8_simd (GstVideoScaler * scale,
+    gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
+{
+  const guint32 *offset, *phase;
+  const gint16 *taps;
+  guint8 *s, *d;
+  gint i, c, j, max_taps;
+
+  if (scale->taps_s16 == NULL)
+    make_s16_taps (scale, n_elems, SCALE_U8_LQ);
+  if (scale->taps_s16_8 == NULL)
+    make_s16_8_taps (scale);
+
+  max_taps = scale->resampler.max_taps;
+  offset = scale->resampler.offset + dest_offset;
+  phase = scale->resampler.phase + dest_offset;
+  taps = scale->taps_s16_8;
+
+  s = (guint8 *) src;
+  d = (guint8 *) dest + dest_offset * n_elems;
+
+  if (n_elems == 1)
+    i = simd_funcs.h_ntap_1u8 (d, s, offset, phase, taps,
+        simd_h_width (scale, offset, width));
+  else
+    i = simd_funcs.h_ntap_2u8 (d, s, offset, phase, taps,
+        simd_h_width (scale, offset, width));
+
+  /* same as the _lq orc functions */
+  for (; i < width; i++) {
+    const gint16 *t = taps + phase[i] * SIMD_MAX_TAPS;
+    const guint8 *p = s + offset[i] * n_elems;
+
+    for (c = 0; c < n_elems; c++) {
+      guint16 sum = 0;
+
+      for (j = 0; j < max_taps; j++)
+        sum += p[j * n_elems + c] * t[j];
+
+      d[i * n_elems + c] = CLAMP ((gint16) (sum + 32) >> 6, 0, 255);
+    }
+  }
+}
+
+static void
+video_scale_h_ntap_u16_simd (GstVideoScaler * scale,
+    gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
+{
+  const guint32 *offset, *phase;
+  const gint16 *taps;
+  guint16 *s, *d;
+  gint i, j, max_taps;
+
+  if (scale->taps_s16 == NULL)
+    make_s16_taps (scale, n_elems, SCALE_U16);
+  if (scale->taps_s16_8 == NULL)
+    make_s16_8_taps (scale);
+
+  max_taps = scale->resampler.max_taps;
+  offset = scale->resampler.offset + dest_offset;
+  phase = scale->resampler.phase + dest_offset;
+  taps = scale->taps_s16_8;
+
+  s = (guint16 *) src;
+  d = (guint16 *) dest + dest_offset;
+
+  i = simd_funcs.h_ntap_1u16 (d, s, offset, phase, taps,
+      simd_h_width (scale, offset, width));
+
+  /* same as the orc u16 functions */
+  for (; i < width; i++) {
+    const gint16 *t = taps + phase[i] * SIMD_MAX_TAPS;
+    const guint16 *p = s + offset[i];
+    guint32 sum = 0;
+
+    for (j = 0; j < max_taps; j++)
+      sum += (guint32) (p[j] * t[j]);
+
+    d[i] = CLAMP ((gint32) (sum + 4095) >> 12, 0, 65535);
+  }
+}
+
 static void
 video_scale_v_near_u8 (GstVideoScaler * scale,
     gpointer srcs[], gpointer dest, guint dest_offset, guint width,
@@ -1105,6 +1443,84 @@ video_scale_v_ntap_u16 (GstVideoScaler * scale,
   video_orc_resample_scaletaps_u16 (d, temp, count);
 }
 
+static void
+video_scale_v_ntap_u8_simd (GstVideoScaler * scale,
+    gpointer srcs[], gpointer dest, guint dest_offset, guint width,
+    guint n_elems)
+{
+  const guint8 *lines[SIMD_MAX_TAPS];
+  gint16 *taps;
+  gint i, j, max_taps, count, src_inc;
+  guint8 *d;
+
+  if (scale->taps_s16 == NULL)
+    make_s16_taps (scale, n_elems, SCALE_U8_LQ);
+
+  max_taps = scale->resampler.max_taps;
+  taps = scale->taps_s16 + (scale->resampler.phase[dest_offset] * max_taps);
+
+  if (scale->flags & GST_VIDEO_SCALER_FLAG_INTERLACED)
+    src_inc = 2;
+  else
+    src_inc = 1;
+
+  for (j = 0; j < max_taps; j++)
+    lines[j] = srcs[j * src_inc];
+
+  d = (guint8 *) dest;
+  count = width * n_elems;
+
+  i = simd_funcs.v_ntap_u8 (d, lines, taps, max_taps, count);
+
+  for (; i < count; i++) {
+    guint16 sum = 0;
+
+    for (j = 0; j < max_taps; j++)
+      sum += lines[j][i] * taps[j];
+
+    d[i] = CLAMP ((gint16) (sum + 32) >> 6, 0, 255);
+  }
+}
+
+static void
+video_scale_v_ntap_u16_simd (GstVideoScaler * scale,
+    gpointer srcs[], gpointer dest, guint dest_offset, guint width,
+    guint n_elems)
+{
+  const guint16 *lines[SIMD_MAX_TAPS];
+  gint16 *taps;
+  gint i, j, max_taps, count, src_inc;
+  guint16 *d;
+
+  if (scale->taps_s16 == NULL)
+    make_s16_taps (scale, n_elems, SCALE_U16);
+
+  max_taps = scale->resampler.max_taps;
+  taps = scale->taps_s16 + (scale->resampler.phase[dest_offset] * max_taps);
+
+  if (scale->flags & GST_VIDEO_SCALER_FLAG_INTERLACED)
+    src_inc = 2;
+  else
+    src_inc = 1;
+
+  for (j = 0; j < max_taps; j++)
+    lines[j] = srcs[j * src_inc];
+
+  d = (guint16 *) dest;
+  count = width * n_elems;
+
+  i = simd_funcs.v_ntap_u16 (d, lines, taps, max_taps, count);
+
+  for (; i < count; i++) {
+    guint32 sum = 0;
+
+    for (j = 0; j < max_taps; j++)
+      sum += (guint32) (lines[j][i] * taps[j]);
+
+    d[i] = CLAMP ((gint32) (sum + 4095) >> 12, 0, 65535);
+  }
+}
+
 static gint
 get_y_offset (GstVideoFormat format)
 {
@@ -1310,6 +1726,15 @@ get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
         *vfunc = video_scale_v_ntap_u8;
         break;
     }
+#ifdef LQ
+    if (hscale && hscale->resampler.max_taps >= 3 &&
+        hscale->resampler.max_taps <= SIMD_MAX_TAPS && !hscale->merged &&
+        simd_funcs.h_ntap_1u8 && ((*n_elems == 1 && mono) || *n_elems == 2))
+      *hfunc = video_scale_h_ntap_u8_simd;
+    if (vscale && vscale->resampler.max_taps >= 3 &&
+        vscale->resampler.max_taps <= SIMD_MAX_TAPS && simd_funcs.v_ntap_u8)
+      *vfunc = video_scale_v_ntap_u8_simd;
+#endif
   } else if (*bits == 16) {
     switch (hscale ? hscale->resampler.max_taps : 0) {
       case 0:
@@ -1337,6 +1762,13 @@ get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
         *vfunc = video_scale_v_ntap_u16;
         break;
     }
+    if (hscale && hscale->resampler.max_taps >= 3 &&
+        hscale->resampler.max_taps <= SIMD_MAX_TAPS && !hscale->merged &&
+        simd_funcs.h_ntap_1u16 && *n_elems == 1)
+      *hfunc = video_scale_h_ntap_u16_simd;
+    if (vscale && vscale->resampler.max_taps >= 3 &&
+        vscale->resampler.max_taps <= SIMD_MAX_TAPS && simd_funcs.v_ntap_u16)
+      *vfunc = video_scale_v_ntap_u16_simd;
   }
   return TRUE;
 }
@@ -39,6 +39,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gstaudiomixerelements.h"
 #include "gstaudiointerleave.h"
 
@@ -123,7 +125,7 @@ GST_STATIC_PAD_TEMPLATE ("src",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) [ 1, MAX ], "
         "format = (string) " GST_AUDIO_FORMATS_ALL ", "
-        "layout = (string) interleaved")
+        "layout = (string) {interleaved, non-interleaved}")
     );
 
 static void gst_audio_interleave_child_proxy_init (gpointer g_iface,
@@ -502,6 +504,8 @@ gst_audio_interleave_update_src_caps (GstAggregator * agg, GstCaps * caps,
 {
   GstAudioInterleave *self = GST_AUDIO_INTERLEAVE (agg);
   GstStructure *s;
+  GstCaps *tmp;
+  GValue layouts = G_VALUE_INIT, layout = G_VALUE_INIT;
 
   /* This means that either no caps have been set on the sink pad (if
    * sinkcaps is NULL) or that there is no sink pad (if channels == 0).
@@ -521,6 +525,32 @@ gst_audio_interleave_update_src_caps (GstAggregator * agg, GstCaps * caps,
 
   GST_OBJECT_UNLOCK (self);
 
+  /* Produce non-interleaved output directly if downstream prefers it, so that
+   * it does not have to be deinterleaved again. Interleaved output stays the
+   * default if downstream accepts both. */
+  tmp = gst_caps_copy (*ret);
+  g_value_init (&layouts, GST_TYPE_LIST);
+  g_value_init (&layout, G_TYPE_STRING);
+  g_value_set_static_string (&layout, "interleaved");
+  gst_value_list_append_value (&layouts, &layout);
+  g_value_set_static_string (&layout, "non-interleaved");
+  gst_value_list_append_value (&layouts, &layout);
+  gst_caps_set_value (tmp, "layout", &layouts);
+  g_value_unset (&layout);
+  g_value_unset (&layouts);
+
+  if (caps) {
+    GstCaps *intersection =
+        gst_caps_intersect_full (caps, tmp, GST_CAPS_INTERSECT_FIRST);
+
+    gst_caps_unref (tmp);
+    tmp = intersection;
+  }
+
+  if (!gst_caps_is_empty (tmp))
+    gst_caps_replace (ret, tmp);
+  gst_caps_unref (tmp);
+
   return GST_FLOW_OK;
 }
 
@@ -811,8 +841,9 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
   GstAudioInterleavePad *pad = GST_AUDIO_INTERLEAVE_PAD (aaggpad);
   GstMapInfo inmap;
   GstMapInfo outmap;
+  GstAudioMeta *in_meta, *out_meta;
   gint out_width, in_bpf, out_bpf, out_channels, channel;
-  guint8 *outdata;
+  guint8 *indata, *outdata;
   GstAggregator *agg = GST_AGGREGATOR (aagg);
   GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
 
@@ -836,11 +867,25 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
     channel = self->default_channels_ordering_map[pad->channel];
   }
 
-  outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
-
+  /* Mono input has the same memory layout either way, but a non-interleaved
+   * one can start at an offset */
+  in_meta = gst_buffer_get_audio_meta (inbuf);
+  indata = inmap.data + (in_offset * in_bpf);
+  if (in_meta && in_meta->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    indata += in_meta->offsets[0];
+
+  out_meta = gst_buffer_get_audio_meta (outbuf);
+  if (GST_AUDIO_INFO_LAYOUT (&srcpad->info) ==
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED && out_meta) {
+    /* Every input is one of the output planes, nothing to interleave */
+    outdata = outmap.data + out_meta->offsets[channel] +
+        (out_offset * out_width);
+    memcpy (outdata, indata, num_frames * out_width);
+  } else {
+    outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
 
-  self->func (outdata, inmap.data + (in_offset * in_bpf), out_channels,
-      num_frames);
+    self->func (outdata, indata, out_channels, num_frames);
+  }
 
 
   gst_buffer_unmap (inbuf, &inmap);
@@ -39,6 +39,9 @@
  * that comes out of the audiomixer, which supports changing the format of
  * its output while playing.
  *
+ * Non-interleaved audio is mixed plane by plane, so that it does not have to
+ * be interleaved and deinterleaved again around the mixer. (Since: 1.28)
+ *
  * If you want to control the manner in which incoming data gets converted,
  * see the #GstAudioAggregatorConvertPad:converter-config property, which will let
  * you for example change the way in which channels may get remapped.
@@ -49,11 +52,24 @@
  * * "mute": Whether to mute the pad or not (#gboolean)
  * * "volume": The volume of the pad, between 0.0 and 10.0 (#gdouble)
  *
+ * For every sink pad a mix-minus source pad can be requested, named after
+ * the sink pad: "src_0" for "sink_0" and so on. It outputs the mix of all
+ * the other sink pads, as needed for example for the return feed of each
+ * participant of a conference. The full mix is only computed once and the
+ * (volume scaled) contribution of the pad is subtracted from it, which is
+ * exact as long as the full mix does not clip. (Since: 1.28)
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 audiotestsrc freq=100 ! audiomixer name=mix ! audioconvert ! alsasink audiotestsrc freq=500 ! mix.
  * ]| This pipeline produces two sine waves mixed together.
  *
+ * |[
+ * gst-launch-1.0 audiomixer name=mix ! fakesink \
+ *     audiotestsrc freq=100 ! mix.sink_0 mix.src_0 ! audioconvert ! autoaudiosink \
+ *     audiotestsrc freq=500 ! mix.sink_1 mix.src_1 ! fakesink
+ * ]| This pipeline plays only the 500Hz sine wave, the mix without sink_0.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -137,6 +153,17 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static void
+gst_audiomixer_pad_finalize (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  gst_clear_object (&pad->minus_srcpad);
+  gst_clear_buffer (&pad->contribution);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
@@ -144,6 +171,7 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->finalize = gst_audiomixer_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -173,7 +201,7 @@ enum
   GST_AUDIO_CAPS_MAKE ("{ " GST_AUDIO_NE (S32) ", " GST_AUDIO_NE (U32) ", " \
   GST_AUDIO_NE (S16) ", " GST_AUDIO_NE (U16) ", S8, U8, " \
   GST_AUDIO_NE (F32) ", " GST_AUDIO_NE (F64) " }") \
-  ", layout = interleaved"
+  ", layout = (string) { interleaved, non-interleaved }"
 
 static GstStaticPadTemplate gst_audiomixer_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
@@ -182,9 +210,16 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS (CAPS)
     );
 
+static GstStaticPadTemplate gst_audiomixer_minus_src_template =
+GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (CAPS)
+    );
+
 #define SINK_CAPS \
   GST_STATIC_CAPS (GST_AUDIO_CAPS_MAKE (GST_AUDIO_FORMATS_ALL) \
-      ", layout=interleaved")
+      ", layout = (string) { interleaved, non-interleaved }")
 
 static GstStaticPadTemplate gst_audiomixer_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink_%u",
@@ -208,16 +243,25 @@ static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static GstBuffer *gst_audiomixer_create_output_buffer (GstAudioAggregator *
+    aagg, guint num_frames);
+static GstFlowReturn gst_audiomixer_finish_buffer (GstAggregator * agg,
+    GstBuffer * outbuf);
+static GstPadProbeReturn gst_audiomixer_src_event_probe (GstPad * pad,
+    GstPadProbeInfo * info, gpointer user_data);
 
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_audiomixer_minus_src_template);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_sink_template, GST_TYPE_AUDIO_MIXER_PAD);
   gst_element_class_set_static_metadata (gstelement_class, "AudioMixer",
@@ -229,7 +273,10 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->finish_buffer = GST_DEBUG_FUNCPTR (gst_audiomixer_finish_buffer);
+
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
+  aagg_class->create_output_buffer = gst_audiomixer_create_output_buffer;
 
   gst_type_mark_as_plugin_api (GST_TYPE_AUDIO_MIXER_PAD, 0);
 }
@@ -237,6 +284,231 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  /* everything that goes out on the main source pad also has to go out on
+   * the mix-minus pads */
+  gst_pad_add_probe (GST_AGGREGATOR_SRC_PAD (audiomixer),
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH,
+      gst_audiomixer_src_event_probe, audiomixer, NULL);
+}
+
+/* Adapts an event of the main source pad for a mix-minus pad */
+static GstEvent *
+gst_audiomixer_minus_event (GstAudioMixer * audiomixer, GstPad * minus_pad,
+    GstEvent * event)
+{
+  GstEvent *stream_start;
+  gchar *stream_id;
+  guint group_id;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_STREAM_START)
+    return gst_event_ref (event);
+
+  /* each mix-minus pad is a stream of its own */
+  stream_id = gst_pad_create_stream_id (minus_pad,
+      GST_ELEMENT_CAST (audiomixer), GST_PAD_NAME (minus_pad));
+  stream_start = gst_event_new_stream_start (stream_id);
+  g_free (stream_id);
+  if (gst_event_parse_group_id (event, &group_id))
+    gst_event_set_group_id (stream_start, group_id);
+
+  return stream_start;
+}
+
+static GstPadProbeReturn
+gst_audiomixer_src_event_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (user_data);
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GList *minus_pads = NULL, *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = GST_ELEMENT_CAST (audiomixer)->srcpads; l; l = l->next) {
+    if (l->data != (gpointer) pad)
+      minus_pads = g_list_prepend (minus_pads, gst_object_ref (l->data));
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (l = minus_pads; l; l = l->next) {
+    GstPad *minus_pad = l->data;
+
+    gst_pad_push_event (minus_pad,
+        gst_audiomixer_minus_event (audiomixer, minus_pad, event));
+  }
+  g_list_free_full (minus_pads, gst_object_unref);
+
+  return GST_PAD_PROBE_OK;
+}
+
+typedef struct
+{
+  GstAudioMixer *audiomixer;
+  GstPad *minus_pad;
+} CopyStickyEventsData;
+
+static gboolean
+copy_sticky_events (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  CopyStickyEventsData *data = user_data;
+  GstEvent *minus_event;
+
+  minus_event = gst_audiomixer_minus_event (data->audiomixer, data->minus_pad,
+      *event);
+  gst_pad_store_sticky_event (data->minus_pad, minus_event);
+  gst_event_unref (minus_event);
+
+  return TRUE;
+}
+
+static gboolean
+gst_audiomixer_minus_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstAggregator *agg = GST_AGGREGATOR (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:{
+      GstCaps *filter, *caps;
+
+      /* always the same format as the full mix */
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_current_caps (agg->srcpad);
+      if (caps == NULL)
+        caps = gst_pad_get_pad_template_caps (pad);
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    case GST_QUERY_ACCEPT_CAPS:
+      return gst_pad_query_default (pad, parent, query);
+    default:
+      /* answer like the main source pad, e.g. for the latency */
+      return gst_pad_query (agg->srcpad, query);
+  }
+}
+
+static gboolean
+gst_audiomixer_minus_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  gboolean res = FALSE;
+
+  /* seeking, QoS and so on are handled by the main source pad only */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_RECONFIGURE)
+    res = TRUE;
+  else
+    GST_DEBUG_OBJECT (pad, "dropping event %" GST_PTR_FORMAT, event);
+
+  gst_event_unref (event);
+
+  return res;
+}
+
+static GstPad *
+gst_audiomixer_request_minus_pad (GstAudioMixer * audiomixer,
+    GstPadTemplate * templ, const gchar * req_name)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstAudioMixerPad *sinkpad = NULL;
+  CopyStickyEventsData data;
+  GstPad *srcpad;
+  gchar *endptr = NULL;
+  gchar *sinkname;
+  guint64 serial;
+
+  /* the mix-minus pad is named after its sink pad */
+  if (req_name == NULL || !g_str_has_prefix (req_name, "src_"))
+    goto invalid_name;
+  serial = g_ascii_strtoull (req_name + 4, &endptr, 10);
+  if (endptr == req_name + 4 || *endptr != '\0')
+    goto invalid_name;
+
+  sinkname = g_strdup_printf ("sink_%" G_GUINT64_FORMAT, serial);
+  sinkpad = (GstAudioMixerPad *) gst_element_get_static_pad (element, sinkname);
+  g_free (sinkname);
+  if (sinkpad == NULL || !GST_IS_AUDIO_MIXER_PAD (sinkpad))
+    goto no_sinkpad;
+
+  srcpad = gst_pad_new_from_template (templ, req_name);
+  gst_pad_set_query_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_src_query));
+  gst_pad_set_event_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_audiomixer_minus_src_event));
+  gst_pad_use_fixed_caps (srcpad);
+  gst_pad_set_element_private (srcpad, sinkpad);
+
+  GST_OBJECT_LOCK (audiomixer);
+  if (sinkpad->minus_srcpad != NULL) {
+    GST_OBJECT_UNLOCK (audiomixer);
+    gst_object_unref (srcpad);
+    goto already_requested;
+  }
+  sinkpad->minus_srcpad = gst_object_ref (srcpad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  gst_pad_set_active (srcpad, TRUE);
+
+  /* catch up with what was already sent on the main source pad */
+  data.audiomixer = audiomixer;
+  data.minus_pad = srcpad;
+  gst_pad_sticky_events_foreach (GST_AGGREGATOR_SRC_PAD (audiomixer),
+      copy_sticky_events, &data);
+
+  gst_element_add_pad (element, srcpad);
+  gst_object_unref (sinkpad);
+
+  GST_DEBUG_OBJECT (audiomixer, "added mix-minus pad %s", req_name);
+
+  return srcpad;
+
+invalid_name:
+  {
+    GST_WARNING_OBJECT (audiomixer, "mix-minus pads need to be requested "
+        "by name, e.g. src_0 for sink_0, not %s", GST_STR_NULL (req_name));
+    return NULL;
+  }
+no_sinkpad:
+  {
+    GST_WARNING_OBJECT (audiomixer, "no sink pad for mix-minus pad %s",
+        req_name);
+    if (sinkpad)
+      gst_object_unref (sinkpad);
+    return NULL;
+  }
+already_requested:
+  {
+    GST_WARNING_OBJECT (audiomixer, "mix-minus pad %s exists already",
+        req_name);
+    gst_object_unref (sinkpad);
+    return NULL;
+  }
+}
+
+static void
+gst_audiomixer_release_minus_pad (GstAudioMixer * audiomixer,
+    GstAudioMixerPad * sinkpad)
+{
+  GstPad *srcpad;
+
+  GST_OBJECT_LOCK (audiomixer);
+  srcpad = g_steal_pointer (&sinkpad->minus_srcpad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  if (srcpad == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (audiomixer, "removing mix-minus pad %s:%s",
+      GST_DEBUG_PAD_NAME (srcpad));
+
+  gst_pad_set_active (srcpad, FALSE);
+  gst_element_remove_pad (GST_ELEMENT_CAST (audiomixer), srcpad);
+  gst_object_unref (srcpad);
 }
 
 static GstPad *
@@ -245,6 +517,10 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
 {
   GstAudioMixerPad *newpad;
 
+  if (GST_PAD_TEMPLATE_DIRECTION (templ) == GST_PAD_SRC)
+    return gst_audiomixer_request_minus_pad (GST_AUDIO_MIXER (element),
+        templ, req_name);
+
   newpad = (GstAudioMixerPad *)
       GST_ELEMENT_CLASS (parent_class)->request_new_pad (element,
       templ, req_name, caps);
@@ -273,6 +549,15 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (audiomixer, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  if (GST_PAD_IS_SRC (pad)) {
+    gst_audiomixer_release_minus_pad (audiomixer,
+        gst_pad_get_element_private (pad));
+    return;
+  }
+
+  /* the mix-minus pad goes away together with its sink pad */
+  gst_audiomixer_release_minus_pad (audiomixer, GST_AUDIO_MIXER_PAD (pad));
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (audiomixer), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
@@ -280,138 +565,382 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
-static gboolean
-gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
-    GstBuffer * outbuf, guint out_offset, guint num_frames)
+/* Adds @num_samples samples from @in to @out, scaled by the volume of @pad.
+ * Called with the pad object lock held. */
+static void
+gst_audiomixer_pad_mix (GstAudioMixerPad * pad, GstAudioFormat format,
+    guint8 * out, const guint8 * in, guint num_samples)
 {
-  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint bpf;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
-
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (aaggpad);
-
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
-    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
-    GST_OBJECT_UNLOCK (aaggpad);
-    GST_OBJECT_UNLOCK (aagg);
-    return FALSE;
-  }
-
-  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
-      num_frames * bpf, out_offset * bpf, in_offset * bpf);
-
-  /* further buffers, need to add them */
   if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u8 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s8 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u16 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s16 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f64 ((gpointer) out, (gpointer) in, num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   } else {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u8 ((gpointer) out, (gpointer) in,
+            pad->volume_i8, num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s8 ((gpointer) out, (gpointer) in,
+            pad->volume_i8, num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u16 ((gpointer) out, (gpointer) in,
+            pad->volume_i16, num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s16 ((gpointer) out, (gpointer) in,
+            pad->volume_i16, num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u32 ((gpointer) out, (gpointer) in,
+            pad->volume_i32, num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s32 ((gpointer) out, (gpointer) in,
+            pad->volume_i32, num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f32 ((gpointer) out, (gpointer) in,
+            pad->volume, num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f64 ((gpointer) out, (gpointer) in,
+            pad->volume, num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
-  gst_buffer_unmap (inbuf, &inmap);
+}
+
+/* Mixes @num_frames samples of every plane of @in into the same plane of
+ * @out. Both are mappings of non-interleaved buffers whose planes are
+ * found through their audio metas.
+ *
+ * Called with the pad object lock held. */
+static void
+gst_audiomixer_pad_mix_planes (GstAudioMixerPad * pad, GstAudioFormat format,
+    gint bps, guint8 * out, const GstAudioMeta * out_meta, guint out_offset,
+    const guint8 * in, const GstAudioMeta * in_meta, guint in_offset,
+    guint num_frames)
+{
+  gint i;
+
+  for (i = 0; i < out_meta->info.channels; i++)
+    gst_audiomixer_pad_mix (pad, format,
+        out + out_meta->offsets[i] + out_offset * bps,
+        in + in_meta->offsets[i] + in_offset * bps, num_frames);
+}
+
+static gboolean
+gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
+  GstMapInfo inmap;
+  GstMapInfo outmap;
+  GstAudioMeta *in_meta = NULL, *out_meta = NULL;
+  gint bpf, bps;
+  GstAudioFormat format;
+  guint num_samples;
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+
+  GST_OBJECT_LOCK (aagg);
+  GST_OBJECT_LOCK (aaggpad);
+
+  if (pad->mute || pad->volume < G_MINDOUBLE) {
+    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
+    GST_OBJECT_UNLOCK (aaggpad);
+    GST_OBJECT_UNLOCK (aagg);
+    return FALSE;
+  }
+
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  bps = GST_AUDIO_INFO_WIDTH (&srcpad->info) / 8;
+  num_samples = num_frames * GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+
+  /* Non-interleaved audio is mixed plane by plane, without reinterleaving */
+  if (GST_AUDIO_INFO_LAYOUT (&srcpad->info) ==
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    in_meta = gst_buffer_get_audio_meta (inbuf);
+    out_meta = gst_buffer_get_audio_meta (outbuf);
+
+    if (!in_meta || !out_meta) {
+      GST_WARNING_OBJECT (pad, "Non-interleaved buffer without audio meta");
+      GST_OBJECT_UNLOCK (aaggpad);
+      GST_OBJECT_UNLOCK (aagg);
+      return FALSE;
+    }
+  }
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
+      num_frames * bpf, out_offset * bpf, in_offset * bpf);
+
+  /* further buffers, need to add them */
+  if (out_meta)
+    gst_audiomixer_pad_mix_planes (pad, format, bps, outmap.data, out_meta,
+        out_offset, inmap.data, in_meta, in_offset, num_frames);
+  else
+    gst_audiomixer_pad_mix (pad, format, outmap.data + out_offset * bpf,
+        inmap.data + in_offset * bpf, num_samples);
   gst_buffer_unmap (outbuf, &outmap);
 
+  /* also keep what this pad added on its own, the mix-minus output is the
+   * full mix without it */
+  if (pad->minus_srcpad) {
+    GstMapInfo cmap;
+
+    if (pad->contribution == NULL ||
+        pad->contribution_cookie != audiomixer->mix_cookie) {
+      gsize size = gst_buffer_get_size (outbuf);
+
+      gst_buffer_replace (&pad->contribution, NULL);
+      pad->contribution = gst_buffer_new_allocate (NULL, size, NULL);
+      gst_buffer_memset (pad->contribution, 0, 0, size);
+      pad->contribution_cookie = audiomixer->mix_cookie;
+    }
+
+    /* the contribution has the same size and planes as the output buffer */
+    gst_buffer_map (pad->contribution, &cmap, GST_MAP_READWRITE);
+    if (out_meta)
+      gst_audiomixer_pad_mix_planes (pad, format, bps, cmap.data, out_meta,
+          out_offset, inmap.data, in_meta, in_offset, num_frames);
+    else
+      gst_audiomixer_pad_mix (pad, format, cmap.data + out_offset * bpf,
+          inmap.data + in_offset * bpf, num_samples);
+    gst_buffer_unmap (pad->contribution, &cmap);
+  }
+  gst_buffer_unmap (inbuf, &inmap);
+
   GST_OBJECT_UNLOCK (aaggpad);
   GST_OBJECT_UNLOCK (aagg);
 
   return TRUE;
 }
 
+#define MAKE_MINUS_FUNC_SIGNED(name, type, wtype, min, max)     \
+static void                                                     \
+audiomixer_minus_##name (type * d, const type * s, guint n)     \
+{                                                               \
+  guint i;                                                      \
+                                                                \
+  for (i = 0; i < n; i++) {                                     \
+    wtype v = (wtype) s[i] - (wtype) d[i];                      \
+    d[i] = CLAMP (v, min, max);                                 \
+  }                                                             \
+}
+
+#define MAKE_MINUS_FUNC_UNSIGNED(name, type)                    \
+static void                                                     \
+audiomixer_minus_##name (type * d, const type * s, guint n)     \
+{                                                               \
+  guint i;                                                      \
+                                                                \
+  for (i = 0; i < n; i++)                                       \
+    d[i] = s[i] > d[i] ? s[i] - d[i] : 0;                       \
+}
+
+#define MAKE_MINUS_FUNC_FLOAT(name, type)                       \
+static void                                                     \
+audiomixer_minus_##name (type * d, const type * s, guint n)     \
+{                                                               \
+  guint i;                                                      \
+                                                                \
+  for (i = 0; i < n; i++)                                       \
+    d[i] = s[i] - d[i];                                         \
+}
+
+MAKE_MINUS_FUNC_SIGNED (s8, gint8, gint16, G_MININT8, G_MAXINT8);
+MAKE_MINUS_FUNC_SIGNED (s16, gint16, gint32, G_MININT16, G_MAXINT16);
+MAKE_MINUS_FUNC_SIGNED (s32, gint32, gint64, G_MININT32, G_MAXINT32);
+MAKE_MINUS_FUNC_UNSIGNED (u8, guint8);
+MAKE_MINUS_FUNC_UNSIGNED (u16, guint16);
+MAKE_MINUS_FUNC_UNSIGNED (u32, guint32);
+MAKE_MINUS_FUNC_FLOAT (f32, gfloat);
+MAKE_MINUS_FUNC_FLOAT (f64, gdouble);
+
+/* Replaces the contribution of one pad in @minus by the mix of all other
+ * pads, which is @full minus that contribution. This saturates like the
+ * mixing functions, so it is only exact if the full mix did not clip. */
+static void
+gst_audiomixer_mix_minus (GstAudioFormat format, guint8 * minus,
+    const guint8 * full, guint num_samples)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      audiomixer_minus_u8 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      audiomixer_minus_s8 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      audiomixer_minus_u16 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      audiomixer_minus_s16 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      audiomixer_minus_u32 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      audiomixer_minus_s32 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      audiomixer_minus_f32 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      audiomixer_minus_f64 ((gpointer) minus, (gconstpointer) full,
+          num_samples);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+typedef struct
+{
+  GstPad *srcpad;
+  GstBuffer *contribution;
+} MinusOutput;
+
+static GstFlowReturn
+gst_audiomixer_finish_buffer (GstAggregator * agg, GstBuffer * outbuf)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GArray *outputs;
+  GstAudioFormat format;
+  GstFlowReturn ret;
+  GstMapInfo outmap;
+  GList *l;
+  guint i;
+  gint sample_size;
+
+  outputs = g_array_new (FALSE, FALSE, sizeof (MinusOutput));
+
+  GST_OBJECT_LOCK (agg);
+  format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  sample_size = GST_AUDIO_INFO_WIDTH (&srcpad->info) / 8;
+  for (l = GST_ELEMENT_CAST (agg)->sinkpads; l; l = l->next) {
+    GstAudioMixerPad *pad = l->data;
+    MinusOutput output;
+
+    if (pad->minus_srcpad == NULL)
+      continue;
+
+    output.srcpad = gst_object_ref (pad->minus_srcpad);
+    output.contribution = NULL;
+    if (pad->contribution_cookie == audiomixer->mix_cookie)
+      output.contribution = g_steal_pointer (&pad->contribution);
+    g_array_append_val (outputs, output);
+  }
+  GST_OBJECT_UNLOCK (agg);
+
+  if (outputs->len == 0) {
+    g_array_free (outputs, TRUE);
+    return GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, outbuf);
+  }
+
+  /* push the full mix first so that the mandatory events are sent and
+   * forwarded to the mix-minus pads, but keep the data around */
+  gst_buffer_ref (outbuf);
+  ret = GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, outbuf);
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READ);
+  for (i = 0; i < outputs->len; i++) {
+    MinusOutput *output = &g_array_index (outputs, MinusOutput, i);
+    GstBuffer *buf = output->contribution;
+    GstFlowReturn minus_ret;
+
+    if (buf == NULL) {
+      /* this pad did not add anything, everybody else is the full mix */
+      buf = gst_buffer_ref (outbuf);
+    } else {
+      GstMapInfo map;
+
+      /* the output buffer might have been shortened at EOS */
+      if (gst_buffer_get_size (buf) > outmap.size)
+        gst_buffer_resize (buf, 0, outmap.size);
+
+      gst_buffer_map (buf, &map, GST_MAP_READWRITE);
+      gst_audiomixer_mix_minus (format, map.data, outmap.data,
+          map.size / sample_size);
+      gst_buffer_unmap (buf, &map);
+      gst_buffer_copy_into (buf, outbuf, GST_BUFFER_COPY_METADATA, 0, -1);
+    }
+
+    minus_ret = gst_pad_push (output->srcpad, buf);
+    if (minus_ret != GST_FLOW_OK)
+      GST_LOG_OBJECT (output->srcpad, "push returned %s",
+          gst_flow_get_name (minus_ret));
+    gst_object_unref (output->srcpad);
+  }
+  gst_buffer_unmap (outbuf, &outmap);
+  gst_buffer_unref (outbuf);
+  g_array_free (outputs, TRUE);
+
+  return ret;
+}
+
+static GstBuffer *
+gst_audiomixer_create_output_buffer (GstAudioAggregator * aagg,
+    guint num_frames)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+
+  /* invalidates the pad contributions to the previous output buffer */
+  GST_OBJECT_LOCK (aagg);
+  audiomixer->mix_cookie++;
+  GST_OBJECT_UNLOCK (aagg);
+
+  return
+      GST_AUDIO_AGGREGATOR_CLASS (parent_class)->create_output_buffer (aagg,
+      num_frames);
+}
+
 
 /* GstChildProxy implementation */
 static GObject *
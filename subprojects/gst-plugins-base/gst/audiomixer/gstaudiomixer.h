@@ -41,6 +41,10 @@ G_DECLARE_FINAL_TYPE (GstAudioMixer, gst_audiomixer, GST, AUDIO_MIXER,
  */
 struct _GstAudioMixer {
   GstAudioAggregator element;
+
+  /*< private >*/
+  /* incremented for every new output buffer */
+  guint64 mix_cookie;
 };
 
 #define GST_TYPE_AUDIO_MIXER_PAD (gst_audiomixer_pad_get_type())
@@ -55,6 +59,13 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /*< private >*/
+  /* mix-minus source pad, the mix of all other pads */
+  GstPad *minus_srcpad;
+  /* contribution of this pad to the current output buffer */
+  GstBuffer *contribution;
+  guint64 contribution_cookie;
 };
 
 G_END_DECLS
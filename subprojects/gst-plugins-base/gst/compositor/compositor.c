@@ -515,6 +515,142 @@ _pad_obscures_rectangle (GstVideoAggregator * vagg, GstVideoAggregatorPad * pad,
   return TRUE;
 }
 
+static void
+gst_compositor_pad_clear_fused_scale (GstCompositorPad * cpad)
+{
+  guint i, j;
+
+  for (i = 0; i < GST_VIDEO_MAX_PLANES; i++) {
+    for (j = 0; cpad->fused_h_scaler[i] && j < cpad->fused_n_threads; j++)
+      gst_video_scaler_free (cpad->fused_h_scaler[i][j]);
+    g_clear_pointer (&cpad->fused_h_scaler[i], g_free);
+
+    for (j = 0; cpad->fused_v_scaler[i] && j < cpad->fused_n_threads; j++)
+      gst_video_scaler_free (cpad->fused_v_scaler[i][j]);
+    g_clear_pointer (&cpad->fused_v_scaler[i], g_free);
+  }
+
+  cpad->fused_format = GST_VIDEO_FORMAT_UNKNOWN;
+  cpad->fused_n_threads = 0;
+}
+
+/* Opaque pads that have the same format as the output and only need scaling
+ * can skip the conversion into a temporary frame. Their input frame is scaled
+ * straight into the output frame by the blending threads instead, which
+ * saves writing and reading back a full intermediate frame per pad. */
+static gboolean
+gst_compositor_pad_can_fuse_scale (GstCompositorPad * cpad,
+    GstVideoAggregator * vagg, gint width, gint height)
+{
+  GstVideoAggregatorPad *pad = GST_VIDEO_AGGREGATOR_PAD (cpad);
+  GstStructure *converter_config = NULL;
+  gint xpos;
+
+  if (GST_COMPOSITOR (vagg)->intermediate_frame)
+    return FALSE;
+
+  switch (GST_VIDEO_INFO_FORMAT (&vagg->info)) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+      break;
+    default:
+      return FALSE;
+  }
+
+  if (GST_VIDEO_INFO_FORMAT (&pad->info) != GST_VIDEO_INFO_FORMAT (&vagg->info)
+      || GST_VIDEO_INFO_IS_INTERLACED (&pad->info)
+      || pad->info.chroma_site != vagg->info.chroma_site
+      || !gst_video_colorimetry_is_equal (&pad->info.colorimetry,
+          &vagg->info.colorimetry))
+    return FALSE;
+
+  /* Nothing to win without scaling, the frame is blended as-is then */
+  if (width <= 0 || height <= 0 || (width == GST_VIDEO_INFO_WIDTH (&pad->info)
+          && height == GST_VIDEO_INFO_HEIGHT (&pad->info)))
+    return FALSE;
+
+  if (cpad->alpha != 1.0)
+    return FALSE;
+
+  /* The scalers can only produce whole lines, so the picture has to be
+   * horizontally inside the output. Lines above and below are skipped. */
+  xpos = GST_ROUND_UP_2 (cpad->xpos + cpad->x_offset);
+  if (xpos < 0 || xpos + width > GST_VIDEO_INFO_WIDTH (&vagg->info))
+    return FALSE;
+
+  /* A converter-config can ask for anything, leave it to the converter */
+  g_object_get (pad, "converter-config", &converter_config, NULL);
+  if (converter_config) {
+    gst_structure_free (converter_config);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+gst_compositor_pad_setup_fused_scale (GstCompositorPad * cpad,
+    GstCompositor * comp, gint width, gint height)
+{
+  GstVideoAggregatorPad *pad = GST_VIDEO_AGGREGATOR_PAD (cpad);
+  const GstVideoFormatInfo *finfo = pad->info.finfo;
+  gint in_width = GST_VIDEO_INFO_WIDTH (&pad->info);
+  gint in_height = GST_VIDEO_INFO_HEIGHT (&pad->info);
+  guint n_threads = comp->blend_runner->n_threads;
+  guint i, j;
+
+  if (cpad->fused_format == GST_VIDEO_FORMAT_INFO_FORMAT (finfo)
+      && cpad->fused_in_width == in_width && cpad->fused_in_height == in_height
+      && cpad->fused_out_width == width && cpad->fused_out_height == height
+      && cpad->fused_n_threads == n_threads)
+    return;
+
+  gst_compositor_pad_clear_fused_scale (cpad);
+
+  GST_DEBUG_OBJECT (cpad, "scaling %dx%d -> %dx%d while blending", in_width,
+      in_height, width, height);
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_PLANES (finfo); i++) {
+    gint comps[GST_VIDEO_MAX_COMPONENTS];
+    GstVideoResamplerMethod method;
+    gint iw, ih, ow, oh;
+
+    gst_video_format_info_component (finfo, i, comps);
+    iw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comps[0], in_width);
+    ih = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comps[0], in_height);
+    ow = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comps[0], width);
+    oh = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comps[0], height);
+
+    /* same defaults as GstVideoConverter uses for the luma and chroma planes */
+    method = (i == 0 ? GST_VIDEO_RESAMPLER_METHOD_CUBIC :
+        GST_VIDEO_RESAMPLER_METHOD_LINEAR);
+
+    /* the scalers keep temporary lines, so every blending thread needs its
+     * own */
+    if (iw != ow) {
+      cpad->fused_h_scaler[i] = g_new (GstVideoScaler *, n_threads);
+      for (j = 0; j < n_threads; j++)
+        cpad->fused_h_scaler[i][j] = gst_video_scaler_new (method,
+            GST_VIDEO_SCALER_FLAG_NONE, 0, iw, ow, NULL);
+    }
+    if (ih != oh) {
+      cpad->fused_v_scaler[i] = g_new (GstVideoScaler *, n_threads);
+      for (j = 0; j < n_threads; j++)
+        cpad->fused_v_scaler[i][j] = gst_video_scaler_new (method,
+            GST_VIDEO_SCALER_FLAG_NONE, 0, ih, oh, NULL);
+    }
+  }
+
+  cpad->fused_format = GST_VIDEO_FORMAT_INFO_FORMAT (finfo);
+  cpad->fused_in_width = in_width;
+  cpad->fused_in_height = in_height;
+  cpad->fused_out_width = width;
+  cpad->fused_out_height = height;
+  cpad->fused_n_threads = n_threads;
+}
+
 static void
 gst_compositor_pad_prepare_frame_start (GstVideoAggregatorPad * pad,
     GstVideoAggregator * vagg, GstBuffer * buffer,
@@ -544,6 +680,8 @@ gst_compositor_pad_prepare_frame_start (GstVideoAggregatorPad * pad,
       GST_VIDEO_INFO_PAR_N (&vagg->info), GST_VIDEO_INFO_PAR_D (&vagg->info),
       &width, &height, &cpad->x_offset, &cpad->y_offset);
 
+  cpad->fused_scale = FALSE;
+
   if (cpad->alpha == 0.0) {
     GST_DEBUG_OBJECT (pad, "Pad has alpha 0.0, not converting frame");
     return;
@@ -595,6 +733,19 @@ gst_compositor_pad_prepare_frame_start (GstVideoAggregatorPad * pad,
   if (frame_obscured)
     return;
 
+  if (gst_compositor_pad_can_fuse_scale (cpad, vagg, width, height)) {
+    if (!gst_video_frame_map (prepared_frame, &pad->info, buffer,
+            GST_MAP_READ)) {
+      GST_WARNING_OBJECT (vagg, "Could not map input buffer");
+      return;
+    }
+
+    gst_compositor_pad_setup_fused_scale (cpad, GST_COMPOSITOR (vagg), width,
+        height);
+    cpad->fused_scale = TRUE;
+    return;
+  }
+
   GST_VIDEO_AGGREGATOR_PAD_CLASS
       (gst_compositor_pad_parent_class)->prepare_frame_start (pad, vagg, buffer,
       prepared_frame);
@@ -662,6 +813,29 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_notify (GObject * object, GParamSpec * pspec)
+{
+  /* a new converter configuration changes the output even if neither the
+   * input buffer nor the geometry changed */
+  if (g_strcmp0 (pspec->name, "converter-config") == 0)
+    GST_COMPOSITOR_PAD (object)->damage_config_changed = TRUE;
+
+  if (G_OBJECT_CLASS (gst_compositor_pad_parent_class)->notify)
+    G_OBJECT_CLASS (gst_compositor_pad_parent_class)->notify (object, pspec);
+}
+
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *cpad = GST_COMPOSITOR_PAD (object);
+
+  gst_compositor_pad_clear_fused_scale (cpad);
+  gst_clear_buffer (&cpad->damage_buffer);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -673,6 +847,8 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->finalize = gst_compositor_pad_finalize;
+  gobject_class->notify = gst_compositor_pad_notify;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -740,6 +916,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
   compo_pad->width = DEFAULT_PAD_WIDTH;
   compo_pad->height = DEFAULT_PAD_HEIGHT;
   compo_pad->sizing_policy = DEFAULT_PAD_SIZING_POLICY;
+  compo_pad->fused_format = GST_VIDEO_FORMAT_UNKNOWN;
 }
 
 
@@ -747,6 +924,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
+#define DEFAULT_DAMAGE_TRACKING FALSE
 
 enum
 {
@@ -755,6 +933,7 @@ enum
   PROP_ZERO_SIZE_IS_UNSCALED,
   PROP_MAX_THREADS,
   PROP_IGNORE_INACTIVE_PADS,
+  PROP_DAMAGE_TRACKING,
 };
 
 static void
@@ -777,6 +956,9 @@ gst_compositor_get_property (GObject * object,
       g_value_set_boolean (value,
           gst_aggregator_get_ignore_inactive_pads (GST_AGGREGATOR (object)));
       break;
+    case PROP_DAMAGE_TRACKING:
+      g_value_set_boolean (value, self->damage_tracking);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -792,6 +974,7 @@ gst_compositor_set_property (GObject * object,
   switch (prop_id) {
     case PROP_BACKGROUND:
       self->background = g_value_get_enum (value);
+      self->force_redraw = TRUE;
       break;
     case PROP_ZERO_SIZE_IS_UNSCALED:
       self->zero_size_is_unscaled = g_value_get_boolean (value);
@@ -803,6 +986,10 @@ gst_compositor_set_property (GObject * object,
       gst_aggregator_set_ignore_inactive_pads (GST_AGGREGATOR (object),
           g_value_get_boolean (value));
       break;
+    case PROP_DAMAGE_TRACKING:
+      self->damage_tracking = g_value_get_boolean (value);
+      self->force_redraw = TRUE;
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -825,6 +1012,7 @@ set_functions (GstCompositor * self, const GstVideoInfo * info)
 
   gst_clear_buffer (&self->intermediate_frame);
   g_clear_pointer (&self->intermediate_convert, gst_video_converter_free);
+  gst_clear_buffer (&self->damage_buffer);
 
   self->blend = NULL;
   self->overlay = NULL;
@@ -1448,9 +1636,10 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
   else
     n_threads = compositor->max_threads;
 
-  /* Magic number of 200 lines */
-  if (GST_VIDEO_INFO_HEIGHT (&v_info) / n_threads < 200)
-    n_threads = (GST_VIDEO_INFO_HEIGHT (&v_info) + 199) / 200;
+  /* The output is blended in bands of 16 to 64 lines that the threads pick
+   * up one after another, make sure every thread gets a few of them */
+  if (GST_VIDEO_INFO_HEIGHT (&v_info) / n_threads < 64)
+    n_threads = (GST_VIDEO_INFO_HEIGHT (&v_info) + 63) / 64;
   if (n_threads < 1)
     n_threads = 1;
 
@@ -1493,6 +1682,7 @@ gst_composior_stop (GstAggregator * agg)
 
   gst_clear_buffer (&self->intermediate_frame);
   g_clear_pointer (&self->intermediate_convert, gst_video_converter_free);
+  gst_clear_buffer (&self->damage_buffer);
 
   return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
 }
@@ -1544,17 +1734,31 @@ struct CompositePadInfo
   GstVideoFrame *prepared_frame;
   GstCompositorPad *pad;
   GstCompositorBlendMode blend_mode;
+  gboolean fused_scale;
+  /* output lines the pad may draw to */
+  gint line_start, line_end;
+};
+
+struct CompositeBand
+{
+  guint line_start;
+  guint line_end;
 };
 
 struct CompositeTask
 {
   GstCompositor *compositor;
   GstVideoFrame *out_frame;
+  guint thread_idx;
   guint dst_line_start;
   guint dst_line_end;
   gboolean draw_background;
   guint n_pads;
   struct CompositePadInfo *pads_info;
+  /* shared by all tasks, each band is taken by the next idle task */
+  struct CompositeBand *bands;
+  guint n_bands;
+  gint *next_band;
 };
 
 static void
@@ -1616,6 +1820,83 @@ _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
   }
 }
 
+/* Scales the unconverted input frame of @pad_info straight into the lines of
+ * the output frame handled by @comp. Only used for opaque planar and
+ * semi-planar 4:2:0 YUV, see gst_compositor_pad_can_fuse_scale() */
+static void
+blend_fused_scale (struct CompositeTask *comp,
+    struct CompositePadInfo *pad_info)
+{
+  GstCompositorPad *cpad = pad_info->pad;
+  GstVideoFrame *srcframe = pad_info->prepared_frame;
+  GstVideoFrame *destframe = comp->out_frame;
+  const GstVideoFormatInfo *finfo = destframe->info.finfo;
+  gint xpos, ypos, dest_height;
+  guint plane;
+
+  /* same rounding as the 4:2:0 blend functions */
+  xpos = GST_ROUND_UP_2 (cpad->xpos + cpad->x_offset);
+  ypos = GST_ROUND_UP_2 (cpad->ypos + cpad->y_offset);
+  dest_height = GST_VIDEO_FRAME_HEIGHT (destframe);
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (destframe); plane++) {
+    gint comps[GST_VIDEO_MAX_COMPONENTS];
+    GstVideoScaler *h_scaler = NULL, *v_scaler = NULL;
+    GstVideoFormat format;
+    gint px, py, pw, ph, y0, y1, line_start, line_end;
+    gint pstride, sstride, dstride;
+    guint8 *s, *d;
+
+    gst_video_format_info_component (finfo, plane, comps);
+    pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, comps[0]);
+
+    /* position and size of the scaled picture in this plane. The position is
+     * a multiple of the subsampling, so the division is exact */
+    px = xpos / (1 << GST_VIDEO_FORMAT_INFO_W_SUB (finfo, comps[0]));
+    py = ypos / (1 << GST_VIDEO_FORMAT_INFO_H_SUB (finfo, comps[0]));
+    pw = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comps[0],
+        cpad->fused_out_width);
+    ph = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comps[0],
+        cpad->fused_out_height);
+
+    /* the lines of this plane that belong to our part of the output, so that
+     * no two threads write the same subsampled line */
+    line_start = comp->dst_line_start >> GST_VIDEO_FORMAT_INFO_H_SUB (finfo,
+        comps[0]);
+    if (comp->dst_line_end >= dest_height)
+      line_end = GST_VIDEO_FRAME_COMP_HEIGHT (destframe, comps[0]);
+    else
+      line_end = comp->dst_line_end >> GST_VIDEO_FORMAT_INFO_H_SUB (finfo,
+          comps[0]);
+
+    y0 = MAX (py, line_start);
+    y1 = MIN (py + ph, line_end);
+    if (y1 <= y0)
+      continue;
+
+    if (cpad->fused_h_scaler[plane])
+      h_scaler = cpad->fused_h_scaler[plane][comp->thread_idx];
+    if (cpad->fused_v_scaler[plane])
+      v_scaler = cpad->fused_v_scaler[plane][comp->thread_idx];
+
+    format = (plane == 1 && GST_VIDEO_FORMAT_INFO_N_PLANES (finfo) == 2) ?
+        GST_VIDEO_FORMAT_NV12 : GST_VIDEO_FORMAT_GRAY8;
+
+    sstride = GST_VIDEO_FRAME_PLANE_STRIDE (srcframe, plane);
+    dstride = GST_VIDEO_FRAME_PLANE_STRIDE (destframe, plane);
+    s = GST_VIDEO_FRAME_PLANE_DATA (srcframe, plane);
+
+    /* The scaler addresses output lines relative to the top of the scaled
+     * picture, which can be above the frame. Only lines from y0 on are
+     * written. */
+    d = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (destframe, plane) +
+        (gintptr) py * dstride + px * pstride;
+
+    gst_video_scaler_2d (h_scaler, v_scaler, format, s, sstride, d, dstride,
+        0, y0 - py, pw, y1 - py);
+  }
+}
+
 static void
 blend_pads (struct CompositeTask *comp)
 {
@@ -1630,6 +1911,16 @@ blend_pads (struct CompositeTask *comp)
   }
 
   for (i = 0; i < comp->n_pads; i++) {
+    /* skip pads that don't touch this band of lines */
+    if (comp->pads_info[i].line_end <= (gint) comp->dst_line_start ||
+        comp->pads_info[i].line_start >= (gint) comp->dst_line_end)
+      continue;
+
+    if (comp->pads_info[i].fused_scale) {
+      blend_fused_scale (comp, &comp->pads_info[i]);
+      continue;
+    }
+
     composite (comp->pads_info[i].prepared_frame,
         comp->pads_info[i].pad->xpos + comp->pads_info[i].pad->x_offset,
         comp->pads_info[i].pad->ypos + comp->pads_info[i].pad->y_offset,
@@ -1638,6 +1929,214 @@ blend_pads (struct CompositeTask *comp)
   }
 }
 
+static void
+blend_bands (struct CompositeTask *comp)
+{
+  gint band;
+
+  while ((band = g_atomic_int_add (comp->next_band, 1)) <
+      (gint) comp->n_bands) {
+    comp->dst_line_start = comp->bands[band].line_start;
+    comp->dst_line_end = comp->bands[band].line_end;
+    blend_pads (comp);
+  }
+}
+
+/* Alignment of the lines and columns the blend functions can start drawing at
+ * for the output format, see the rounding of xpos/ypos in blend.c */
+static gint
+_blend_alignment (const GstVideoInfo * info)
+{
+  gint align = 1;
+  guint i;
+
+  for (i = 0; i < GST_VIDEO_INFO_N_COMPONENTS (info); i++) {
+    align = MAX (align, 1 << GST_VIDEO_FORMAT_INFO_W_SUB (info->finfo, i));
+    align = MAX (align, 1 << GST_VIDEO_FORMAT_INFO_H_SUB (info->finfo, i));
+  }
+
+  return align;
+}
+
+/* Call this with the lock taken */
+static GstVideoRectangle
+_pad_damage_rect (GstVideoAggregator * vagg, GstCompositorPad * cpad,
+    gint align)
+{
+  GstVideoRectangle rect = { 0, };
+  gint width, height, x_offset, y_offset;
+
+  _mixer_pad_get_output_size (GST_COMPOSITOR (vagg), cpad,
+      GST_VIDEO_INFO_PAR_N (&vagg->info), GST_VIDEO_INFO_PAR_D (&vagg->info),
+      &width, &height, &x_offset, &y_offset);
+  if (width <= 0 || height <= 0)
+    return rect;
+
+  /* grow by the alignment, the blend functions round the position up */
+  return clamp_rectangle (cpad->xpos + x_offset - align,
+      cpad->ypos + y_offset - align, width + 2 * align, height + 2 * align,
+      GST_VIDEO_INFO_WIDTH (&vagg->info), GST_VIDEO_INFO_HEIGHT (&vagg->info));
+}
+
+/* Call this with the lock taken. Adds the rectangles of the output that
+ * change compared to the last output frame to @damage, and remembers what
+ * is composited from each pad for the next frame */
+static void
+_collect_damage (GstVideoAggregator * vagg, GArray * damage, gint align)
+{
+  GList *l;
+  guint pos = 0;
+
+  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next, pos++) {
+    GstVideoAggregatorPad *pad = l->data;
+    GstCompositorPad *cpad = GST_COMPOSITOR_PAD (pad);
+    GstVideoRectangle rect = { 0, };
+    GstBuffer *buffer = NULL;
+    gboolean changed;
+
+    if (gst_video_aggregator_pad_get_prepared_frame (pad) != NULL)
+      rect = _pad_damage_rect (vagg, cpad, align);
+    if (rect.w > 0 && rect.h > 0)
+      buffer = gst_video_aggregator_pad_get_current_buffer (pad);
+
+    /* Keeping a reference to the last composited buffer makes sure that a
+     * new buffer can't have the same address */
+    changed = buffer != cpad->damage_buffer || cpad->damage_config_changed ||
+        rect.x != cpad->damage_rect.x || rect.y != cpad->damage_rect.y ||
+        rect.w != cpad->damage_rect.w || rect.h != cpad->damage_rect.h;
+    if (buffer && !changed) {
+      changed = cpad->alpha != cpad->damage_alpha ||
+          cpad->op != cpad->damage_op || pos != cpad->damage_index;
+    }
+
+    if (changed) {
+      GST_LOG_OBJECT (pad, "changed, damaging %ix%i@(%i,%i) and "
+          "%ix%i@(%i,%i)", cpad->damage_rect.w, cpad->damage_rect.h,
+          cpad->damage_rect.x, cpad->damage_rect.y, rect.w, rect.h, rect.x,
+          rect.y);
+      if (cpad->damage_rect.w > 0 && cpad->damage_rect.h > 0)
+        g_array_append_val (damage, cpad->damage_rect);
+      if (rect.w > 0 && rect.h > 0)
+        g_array_append_val (damage, rect);
+    }
+
+    gst_buffer_replace (&cpad->damage_buffer, buffer);
+    cpad->damage_rect = rect;
+    cpad->damage_alpha = cpad->alpha;
+    cpad->damage_op = cpad->op;
+    cpad->damage_index = pos;
+    cpad->damage_config_changed = FALSE;
+  }
+}
+
+static gint
+_compare_bands (gconstpointer a, gconstpointer b)
+{
+  const struct CompositeBand *ba = a, *bb = b;
+
+  return (gint) ba->line_start - (gint) bb->line_start;
+}
+
+/* Turns the damaged rectangles into a sorted list of non-overlapping ranges of
+ * output lines */
+static GArray *
+_damage_to_ranges (GArray * damage, gint align, gint height)
+{
+  GArray *ranges = g_array_sized_new (FALSE, FALSE,
+      sizeof (struct CompositeBand), damage->len);
+  struct CompositeBand *last = NULL;
+  guint i;
+
+  for (i = 0; i < damage->len; i++) {
+    const GstVideoRectangle *r = &g_array_index (damage, GstVideoRectangle, i);
+    struct CompositeBand range;
+
+    range.line_start = GST_ROUND_DOWN_N (r->y, align);
+    range.line_end = MIN (GST_ROUND_UP_N (r->y + r->h, align), height);
+    g_array_append_val (ranges, range);
+  }
+
+  g_array_sort (ranges, _compare_bands);
+
+  for (i = 0; i < ranges->len;) {
+    struct CompositeBand *range =
+        &g_array_index (ranges, struct CompositeBand, i);
+
+    if (last && range->line_start <= last->line_end) {
+      last->line_end = MAX (last->line_end, range->line_end);
+      g_array_remove_index (ranges, i);
+      continue;
+    }
+
+    last = range;
+    i++;
+  }
+
+  return ranges;
+}
+
+/* Blends all pads into the given ranges of output lines. The ranges are cut
+ * into bands of a few dozen lines that the worker threads take one after
+ * another, blending every pad that touches the band before moving on. This
+ * keeps the band in the cache while it is drawn to and lets threads that got
+ * bands with few pads take over more of the work. */
+static void
+_blend_ranges (GstCompositor * compositor, GstVideoFrame * outframe,
+    struct CompositePadInfo *pads_info, guint n_pads,
+    gboolean draw_background, const struct CompositeBand *ranges,
+    guint n_ranges, gint align)
+{
+  guint i, n_threads, n_lines = 0, band_height, n_bands = 0;
+  struct CompositeTask *tasks;
+  struct CompositeTask **tasks_p;
+  struct CompositeBand *bands;
+  gint next_band = 0;
+
+  n_threads = compositor->blend_runner->n_threads;
+
+  for (i = 0; i < n_ranges; i++)
+    n_lines += ranges[i].line_end - ranges[i].line_start;
+  if (n_lines == 0)
+    return;
+
+  /* A few bands per thread to balance the load, but not so small that the
+   * per band overhead (scaler taps, blend setup) starts to matter */
+  band_height = CLAMP (n_lines / (n_threads * 4), 16, 64);
+  band_height = GST_ROUND_UP_N (band_height, align);
+
+  bands = g_newa (struct CompositeBand, n_lines / band_height + n_ranges);
+  for (i = 0; i < n_ranges; i++) {
+    guint line;
+
+    for (line = ranges[i].line_start; line < ranges[i].line_end;
+        line += band_height) {
+      bands[n_bands].line_start = line;
+      bands[n_bands].line_end = MIN (line + band_height, ranges[i].line_end);
+      n_bands++;
+    }
+  }
+
+  tasks = g_newa (struct CompositeTask, n_threads);
+  tasks_p = g_newa (struct CompositeTask *, n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].compositor = compositor;
+    tasks[i].thread_idx = i;
+    tasks[i].n_pads = n_pads;
+    tasks[i].pads_info = pads_info;
+    tasks[i].out_frame = outframe;
+    tasks[i].draw_background = draw_background;
+    tasks[i].bands = bands;
+    tasks[i].n_bands = n_bands;
+    tasks[i].next_band = &next_band;
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (compositor->blend_runner,
+      (GstParallelizedTaskFunc) blend_bands, (gpointer *) tasks_p);
+}
+
 static GstFlowReturn
 gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 {
@@ -1648,6 +2147,9 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   guint drawn_a_pad = FALSE;
   struct CompositePadInfo *pads_info;
   guint i, n_pads = 0;
+  GArray *damage = NULL;
+  gboolean redraw = TRUE;
+  gint align;
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
     GST_WARNING_OBJECT (vagg, "Could not map output buffer");
@@ -1674,7 +2176,25 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
    * overlay on top of a transparent background. */
   draw_background = _should_draw_background (vagg);
 
+  align = _blend_alignment (&vagg->info);
+
   GST_OBJECT_LOCK (vagg);
+
+  if (compositor->damage_tracking) {
+    damage = g_array_new (FALSE, FALSE, sizeof (GstVideoRectangle));
+    _collect_damage (vagg, damage, align);
+
+    /* Only the damaged parts need drawing if the output buffer already
+     * contains the previous frame */
+    redraw = !compositor->have_previous_frame || compositor->force_redraw ||
+        compositor->intermediate_frame != NULL;
+    compositor->force_redraw = FALSE;
+
+    GST_LOG_OBJECT (vagg, "%u damaged rectangles%s", damage->len,
+        redraw ? ", redrawing everything" : "");
+  }
+  compositor->have_previous_frame = FALSE;
+
   for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
     GstVideoAggregatorPad *pad = l->data;
     GstVideoFrame *prepared_frame =
@@ -1698,6 +2218,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     GstVideoFrame *prepared_frame =
         gst_video_aggregator_pad_get_prepared_frame (pad);
     GstCompositorBlendMode blend_mode = COMPOSITOR_BLEND_MODE_OVER;
+    gint ypos, height;
 
     switch (compo_pad->op) {
       case COMPOSITOR_OPERATOR_SOURCE:
@@ -1719,51 +2240,44 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
        * background, and @prepared_frame has the same format, height, and width
        * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
        * will be composited on top of it. */
-      if (!drawn_a_pad && !draw_background &&
+      if (redraw && !drawn_a_pad && !draw_background &&
+          !compo_pad->fused_scale &&
           frames_can_copy (prepared_frame, outframe)) {
         gst_video_frame_copy (outframe, prepared_frame);
       } else {
         pads_info[n_pads].pad = compo_pad;
         pads_info[n_pads].prepared_frame = prepared_frame;
         pads_info[n_pads].blend_mode = blend_mode;
+        pads_info[n_pads].fused_scale = compo_pad->fused_scale;
+        ypos = compo_pad->ypos + compo_pad->y_offset;
+        if (compo_pad->fused_scale)
+          height = compo_pad->fused_out_height;
+        else
+          height = GST_VIDEO_FRAME_HEIGHT (prepared_frame);
+        /* with some slack for the rounding of the position */
+        pads_info[n_pads].line_start = ypos - align;
+        pads_info[n_pads].line_end = ypos + height + align;
         n_pads++;
       }
       drawn_a_pad = TRUE;
     }
   }
 
-  {
-    guint n_threads, lines_per_thread;
-    guint out_height;
-    struct CompositeTask *tasks;
-    struct CompositeTask **tasks_p;
-
-    n_threads = compositor->blend_runner->n_threads;
-
-    tasks = g_newa (struct CompositeTask, n_threads);
-    tasks_p = g_newa (struct CompositeTask *, n_threads);
-
-    out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
-    lines_per_thread = (out_height + n_threads - 1) / n_threads;
-
-    for (i = 0; i < n_threads; i++) {
-      tasks[i].compositor = compositor;
-      tasks[i].n_pads = n_pads;
-      tasks[i].pads_info = pads_info;
-      tasks[i].out_frame = outframe;
-      tasks[i].draw_background = draw_background;
-      /* This is a dumb split of the work by number of output lines.
-       * If there is a section of the output that reads from a lot of source
-       * pads, then that thread will consume more time. Maybe tracking and
-       * splitting on the source fill rate would produce better results. */
-      tasks[i].dst_line_start = i * lines_per_thread;
-      tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
-
-      tasks_p[i] = &tasks[i];
-    }
-
-    gst_parallelized_task_runner_run (compositor->blend_runner,
-        (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+  if (redraw) {
+    struct CompositeBand all = { 0, GST_VIDEO_FRAME_HEIGHT (outframe) };
+
+    _blend_ranges (compositor, outframe, pads_info, n_pads, draw_background,
+        &all, 1, align);
+  } else if (damage->len > 0) {
+    GArray *ranges;
+
+    /* Redraw everything in the lines the damaged rectangles cover. Drawing
+     * the unchanged pads again there gives the same result as before */
+    ranges = _damage_to_ranges (damage, align,
+        GST_VIDEO_FRAME_HEIGHT (outframe));
+    _blend_ranges (compositor, outframe, pads_info, n_pads, draw_background,
+        (struct CompositeBand *) ranges->data, ranges->len, align);
+    g_array_unref (ranges);
   }
 
   GST_OBJECT_UNLOCK (vagg);
@@ -1777,9 +2291,92 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 
   gst_video_frame_unmap (&out_frame);
 
+  if (damage) {
+    GstVideoDamageMeta *meta = gst_buffer_add_video_damage_meta (outbuf);
+
+    if (redraw) {
+      gst_video_damage_meta_add_region (meta, 0, 0,
+          GST_VIDEO_INFO_WIDTH (&vagg->info),
+          GST_VIDEO_INFO_HEIGHT (&vagg->info));
+    } else {
+      for (i = 0; i < damage->len; i++) {
+        GstVideoRectangle *r = &g_array_index (damage, GstVideoRectangle, i);
+
+        gst_video_damage_meta_add_region (meta, r->x, r->y, r->w, r->h);
+      }
+    }
+    g_array_unref (damage);
+
+    gst_buffer_replace (&compositor->damage_buffer, outbuf);
+  } else {
+    gst_clear_buffer (&compositor->damage_buffer);
+  }
+
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_compositor_create_output_buffer (GstVideoAggregator * vagg,
+    GstBuffer ** outbuf)
+{
+  GstCompositor *compositor = GST_COMPOSITOR (vagg);
+  GstBuffer *previous;
+  GstVideoFrame src_frame, dest_frame;
+  GstFlowReturn ret;
+
+  compositor->have_previous_frame = FALSE;
+  previous = g_steal_pointer (&compositor->damage_buffer);
+
+  if (!compositor->damage_tracking || !previous ||
+      compositor->intermediate_frame) {
+    gst_clear_buffer (&previous);
+    return GST_VIDEO_AGGREGATOR_CLASS (parent_class)->create_output_buffer
+        (vagg, outbuf);
+  }
+
+  /* Nothing downstream uses the previous output buffer anymore, draw the
+   * changes of the next frame right into it */
+  if (gst_buffer_is_writable (previous)) {
+    GstMeta *meta;
+
+    GST_BUFFER_FLAGS (previous) &= GST_BUFFER_FLAG_TAG_MEMORY;
+    GST_BUFFER_PTS (previous) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DTS (previous) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DURATION (previous) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_OFFSET (previous) = GST_BUFFER_OFFSET_NONE;
+    GST_BUFFER_OFFSET_END (previous) = GST_BUFFER_OFFSET_NONE;
+
+    meta = (GstMeta *) gst_buffer_get_video_damage_meta (previous);
+    if (meta)
+      gst_buffer_remove_meta (previous, meta);
+
+    GST_LOG_OBJECT (vagg, "reusing previous output buffer %p", previous);
+    compositor->have_previous_frame = TRUE;
+    *outbuf = previous;
+    return GST_FLOW_OK;
+  }
+
+  ret = GST_VIDEO_AGGREGATOR_CLASS (parent_class)->create_output_buffer (vagg,
+      outbuf);
+
+  /* Otherwise start from a copy of the previous frame, which is still cheaper
+   * than composing everything again */
+  if (ret == GST_FLOW_OK && *outbuf) {
+    if (gst_video_frame_map (&src_frame, &vagg->info, previous, GST_MAP_READ)) {
+      if (gst_video_frame_map (&dest_frame, &vagg->info, *outbuf,
+              GST_MAP_WRITE)) {
+        compositor->have_previous_frame =
+            gst_video_frame_copy (&dest_frame, &src_frame);
+        gst_video_frame_unmap (&dest_frame);
+      }
+      gst_video_frame_unmap (&src_frame);
+    }
+  }
+  gst_buffer_unref (previous);
+
+  return ret;
+}
+
 static GstPad *
 gst_compositor_request_new_pad (GstElement * element, GstPadTemplate * templ,
     const gchar * req_name, const GstCaps * caps)
@@ -1817,6 +2414,9 @@ gst_compositor_release_pad (GstElement * element, GstPad * pad)
   gst_child_proxy_child_removed (GST_CHILD_PROXY (compositor), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
+  /* the area the pad was drawn to is not known anymore once it is gone */
+  compositor->force_redraw = TRUE;
+
   GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
 }
 
@@ -1954,6 +2554,33 @@ _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
   }
 }
 
+static gboolean
+_decide_allocation (GstAggregator * agg, GstQuery * query)
+{
+  GstCompositor *compositor = GST_COMPOSITOR (agg);
+
+  /* With damage tracking the previous output buffer is kept to draw the
+   * next frame into, so the pool needs one buffer more */
+  if (compositor->damage_tracking) {
+    GstBufferPool *pool = NULL;
+    guint size = 0, min = 0, max = 0;
+
+    if (gst_query_get_n_allocation_pools (query) > 0) {
+      gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min,
+          &max);
+      if (max != 0)
+        max++;
+      gst_query_set_nth_allocation_pool (query, 0, pool, size, min + 1, max);
+      gst_clear_object (&pool);
+    } else {
+      gst_query_add_allocation_pool (query, NULL,
+          GST_VIDEO_INFO_SIZE (&GST_VIDEO_AGGREGATOR (agg)->info), 1, 0);
+    }
+  }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->decide_allocation (agg, query);
+}
+
 static void
 gst_compositor_finalize (GObject * object)
 {
@@ -1988,8 +2615,11 @@ gst_compositor_class_init (GstCompositorClass * klass)
   agg_class->src_event = _src_event;
   agg_class->fixate_src_caps = _fixate_caps;
   agg_class->negotiated_src_caps = _negotiated_caps;
+  agg_class->decide_allocation = _decide_allocation;
   agg_class->stop = GST_DEBUG_FUNCPTR (gst_composior_stop);
   videoaggregator_class->aggregate_frames = gst_compositor_aggregate_frames;
+  videoaggregator_class->create_output_buffer =
+      gst_compositor_create_output_buffer;
 
   g_object_class_install_property (gobject_class, PROP_BACKGROUND,
       g_param_spec_enum ("background", "Background", "Background type",
@@ -2026,6 +2656,28 @@ gst_compositor_class_init (GstCompositorClass * klass)
           GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * compositor:damage-tracking:
+   *
+   * Only redraw the parts of the output that changed since the previous
+   * output frame: the areas of pads that got a new buffer or whose position,
+   * size, alpha, operator or z-order changed. The previous output buffer is
+   * drawn into again if nothing downstream still uses it, otherwise its
+   * content is copied into the new output buffer first.
+   *
+   * Each output buffer carries a #GstVideoDamageMeta describing the changed
+   * regions, which encoders can use to skip the unchanged parts. Output
+   * buffers stay referenced by the compositor until the next frame is
+   * produced.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_DAMAGE_TRACKING,
+      g_param_spec_boolean ("damage-tracking", "Damage tracking",
+          "Only redraw the changed parts of the output and mark them with a "
+          "damage meta", DEFAULT_DAMAGE_TRACKING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &src_factory, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -2068,6 +2720,7 @@ gst_compositor_init (GstCompositor * self)
   self->background = DEFAULT_BACKGROUND;
   self->zero_size_is_unscaled = DEFAULT_ZERO_SIZE_IS_UNSCALED;
   self->max_threads = DEFAULT_MAX_THREADS;
+  self->damage_tracking = DEFAULT_DAMAGE_TRACKING;
 }
 
 /* GstChildProxy implementation */
@@ -154,6 +154,13 @@ struct _GstCompositor
   GstVideoConverter *intermediate_convert;
 
   GstParallelizedTaskRunner *blend_runner;
+
+  /* damage tracking: the last output buffer, into which only the changed
+   * parts of the next frame are drawn again */
+  gboolean damage_tracking;
+  gboolean force_redraw;
+  gboolean have_previous_frame;
+  GstBuffer *damage_buffer;
 };
 
 /**
@@ -177,6 +184,25 @@ struct _GstCompositorPad
    * keep-aspect-ratio */
   gint x_offset;
   gint y_offset;
+
+  /* TRUE if the prepared frame is the unscaled input frame, which is scaled
+   * while blending with the scalers below, one per plane and thread */
+  gboolean fused_scale;
+  GstVideoFormat fused_format;
+  gint fused_in_width, fused_in_height;
+  gint fused_out_width, fused_out_height;
+  guint fused_n_threads;
+  GstVideoScaler **fused_h_scaler[GST_VIDEO_MAX_PLANES];
+  GstVideoScaler **fused_v_scaler[GST_VIDEO_MAX_PLANES];
+
+  /* what was composited from this pad into the last output frame, to find
+   * out which part of the output changes with the next one */
+  GstBuffer *damage_buffer;
+  GstVideoRectangle damage_rect;
+  gdouble damage_alpha;
+  GstCompositorOperator damage_op;
+  guint damage_index;
+  gboolean damage_config_changed;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (compositor);
@@ -100,6 +100,7 @@ enum
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
+#define DEFAULT_MARK_DUPLICATES FALSE
 
 enum
 {
@@ -115,7 +116,8 @@ enum
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
   PROP_RATE,
-  PROP_MAX_DUPLICATION_TIME
+  PROP_MAX_DUPLICATION_TIME,
+  PROP_MARK_DUPLICATES
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -295,6 +297,21 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           0, G_MAXUINT64, DEFAULT_MAX_DUPLICATION_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:mark-duplicates:
+   *
+   * Mark duplicated frames with a #GstVideoDamageMeta without any region so
+   * that downstream elements, such as encoders, know they are identical to
+   * the previous frame and can skip them. Duplicates always share the memory
+   * of the original frame.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (object_class, PROP_MARK_DUPLICATES,
+      g_param_spec_boolean ("mark-duplicates", "Mark duplicates",
+          "Mark duplicated frames as unchanged with a damage meta",
+          DEFAULT_MARK_DUPLICATES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -632,6 +649,7 @@ gst_video_rate_reset (GstVideoRate * videorate)
   videorate->out_frame_count = 0;
   videorate->drop = 0;
   videorate->dup = 0;
+  videorate->last_push_drop = 0;
   videorate->next_ts = GST_CLOCK_TIME_NONE;
   videorate->last_ts = GST_CLOCK_TIME_NONE;
   videorate->discont = TRUE;
@@ -655,6 +673,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->rate = DEFAULT_RATE;
   videorate->pending_rate = DEFAULT_RATE;
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
+  videorate->mark_duplicates = DEFAULT_MARK_DUPLICATES;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -664,6 +683,32 @@ gst_video_rate_init (GstVideoRate * videorate)
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (videorate), TRUE);
 }
 
+static void
+gst_video_rate_remove_damage_meta (GstBuffer * buf)
+{
+  GstVideoDamageMeta *meta;
+
+  while ((meta = gst_buffer_get_video_damage_meta (buf)))
+    gst_buffer_remove_meta (buf, (GstMeta *) meta);
+}
+
+/* Duplicates are marked with an empty damage meta. Other frames keep theirs
+ * only if it still describes the change from the previously pushed frame,
+ * which is no longer the case once frames were dropped in between */
+static void
+gst_video_rate_update_damage_meta (GstVideoRate * videorate,
+    GstBuffer * outbuf, gboolean duplicate)
+{
+  if (duplicate) {
+    gst_video_rate_remove_damage_meta (outbuf);
+    gst_buffer_add_video_damage_meta (outbuf);
+  } else if (videorate->drop != videorate->last_push_drop
+      || videorate->discont) {
+    gst_video_rate_remove_damage_meta (outbuf);
+  }
+  videorate->last_push_drop = videorate->drop;
+}
+
 /* @outbuf: (transfer full) needs to be writable */
 static GstFlowReturn
 gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
@@ -675,6 +720,10 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
   GST_BUFFER_OFFSET (outbuf) = videorate->out;
   GST_BUFFER_OFFSET_END (outbuf) = videorate->out + 1;
 
+  /* the drop-only path does this before taking its extra reference */
+  if (videorate->mark_duplicates && gst_buffer_is_writable (outbuf))
+    gst_video_rate_update_damage_meta (videorate, outbuf, duplicate);
+
   if (videorate->discont) {
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
     videorate->discont = FALSE;
@@ -1627,6 +1676,9 @@ gst_video_rate_transform_ip (GstBaseTransform * trans, GstBuffer * buffer)
           (videorate->segment.rate < 0.0 && intime <= videorate->next_ts)) {
         GstFlowReturn r;
 
+        if (videorate->mark_duplicates)
+          gst_video_rate_update_damage_meta (videorate, buffer, FALSE);
+
         /* The buffer received from basetransform is guaranteed to be writable.
          * It just needs to be reffed so the buffer won't be consumed once pushed and
          * GstBaseTransform can get its reference back. */
@@ -1900,6 +1952,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       videorate->max_duplication_time = g_value_get_uint64 (value);
       break;
+    case PROP_MARK_DUPLICATES:
+      videorate->mark_duplicates = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1962,6 +2017,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       g_value_set_uint64 (value, videorate->max_duplication_time);
       break;
+    case PROP_MARK_DUPLICATES:
+      g_value_set_boolean (value, videorate->mark_duplicates);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
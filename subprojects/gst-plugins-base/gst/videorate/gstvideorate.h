@@ -62,6 +62,7 @@ struct _GstVideoRate
   gboolean updating_caps;
   guint64 max_duplication_time;
   guint64 max_closing_segment_duplication_duration;
+  guint64 last_push_drop;       /* drop count when the last frame was pushed */
 
   /* segment handling */
   GstSegment segment;
@@ -74,6 +75,7 @@ struct _GstVideoRate
   gboolean drop_only;
   gboolean drop_out_of_segment;
   guint64 average_period_set;
+  gboolean mark_duplicates;
 
   int max_rate;
   gdouble rate;
@@ -2221,6 +2221,261 @@ GST_START_TEST (test_qos_message_live)
 
 GST_END_TEST;
 
+GST_START_TEST (test_mix_minus)
+{
+  GstHarness *h, *h2, *h_minus;
+  GstBuffer *b;
+  GstMapInfo map;
+  GstPad *pad;
+  static const char *caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S16) ", "
+      "rate=(int)1000, channels=(int)1, layout=(string)interleaved";
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+  h_minus = gst_harness_new_with_element (h->element, NULL, "src_0");
+
+  /* mix-minus pads only exist for existing sink pads */
+  fail_unless (gst_element_request_pad_simple (h->element, "src_5") == NULL);
+  fail_unless (gst_element_request_pad_simple (h->element, "src_0") == NULL);
+
+  pad = gst_element_get_static_pad (h->element, "sink_0");
+  g_object_set (pad, "volume", 2.0, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+  gst_harness_set_src_caps_str (h2, caps_str);
+
+  gst_harness_push (h, new_buffer (2000, 1, 0, GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (2000, 2, 0, GST_SECOND, 0));
+
+  /* full mix: 2 * 0x0101 + 0x0202 */
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), 0);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 2 * 0x0101 + 0x0202);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  /* everything but sink_0 */
+  b = gst_harness_pull (h_minus);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), 0);
+  fail_unless_equals_int64 (GST_BUFFER_DURATION (b), GST_SECOND);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 2000);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 0x0202);
+  fail_unless_equals_int (((gint16 *) map.data)[999], 0x0202);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  gst_harness_teardown (h_minus);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_max_active_pads)
+{
+  GstHarness *h, *h2, *h3;
+  GstBuffer *b;
+  GstMapInfo map;
+  static const char *caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S16) ", "
+      "rate=(int)1000, channels=(int)1, layout=(string)interleaved";
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND,
+      "max-active-pads", 1, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+  h3 = gst_harness_new_with_element (h->element, "sink_2", NULL);
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_play (h3);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+  gst_harness_set_src_caps_str (h2, caps_str);
+  gst_harness_set_src_caps_str (h3, caps_str);
+
+  /* sink_1 is louder than sink_0 */
+  gst_harness_push (h, new_buffer (2000, 1, 0, GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (2000, 2, 0, GST_SECOND, 0));
+  gst_harness_push (h3, new_buffer (2000, 0, 0, GST_SECOND, 0));
+
+  b = gst_harness_pull (h);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 0x0202);
+  fail_unless_equals_int (((gint16 *) map.data)[999], 0x0202);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  /* the level meta takes precedence over the samples */
+  gst_harness_push (h, new_buffer (2000, 1, GST_SECOND, GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (2000, 2, GST_SECOND, GST_SECOND, 0));
+  b = new_buffer (2000, 1, GST_SECOND, GST_SECOND, 0);
+  gst_buffer_add_audio_level_meta (b, 0, TRUE);
+  gst_harness_push (h3, b);
+
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), GST_SECOND);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 0x0101);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  gst_harness_teardown (h3);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_convert_inputs)
+{
+  GstHarness *h, *h2, *h3;
+  GstBuffer *b;
+  GstMapInfo map;
+  static const char *s16_caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S16) ", "
+      "rate=(int)1000, channels=(int)1, layout=(string)interleaved";
+  static const char *s32_caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S32) ", "
+      "rate=(int)1000, channels=(int)1, layout=(string)interleaved";
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+  h3 = gst_harness_new_with_element (h->element, "sink_2", NULL);
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_play (h3);
+  gst_harness_set_caps_str (h, s16_caps_str, s16_caps_str);
+  gst_harness_set_src_caps_str (h2, s32_caps_str);
+  gst_harness_set_src_caps_str (h3, s32_caps_str);
+
+  /* the S32 inputs are converted before mixing and span two output
+   * buffers, so the second one is mixed from what was converted before */
+  gst_harness_push (h, new_buffer (2000, 1, 0, GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (8000, 1, 0, 2 * GST_SECOND, 0));
+  gst_harness_push (h3, new_buffer (8000, 2, 0, 2 * GST_SECOND, 0));
+
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), 0);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 2000);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 0x0101 + 0x0101 + 0x0202);
+  fail_unless_equals_int (((gint16 *) map.data)[999],
+      0x0101 + 0x0101 + 0x0202);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  gst_harness_push (h, new_buffer (2000, 1, GST_SECOND, GST_SECOND, 0));
+
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), GST_SECOND);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (((gint16 *) map.data)[0], 0x0101 + 0x0101 + 0x0202);
+  fail_unless_equals_int (((gint16 *) map.data)[999],
+      0x0101 + 0x0101 + 0x0202);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  gst_harness_teardown (h3);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+new_planar_buffer (const GstAudioInfo * info, gsize num_frames, gint left,
+    gint right, GstClockTime ts, GstClockTime dur)
+{
+  GstBuffer *buffer = new_buffer (num_frames * GST_AUDIO_INFO_BPF (info), 0,
+      ts, dur, 0);
+  GstAudioBuffer abuf;
+
+  gst_buffer_add_audio_meta (buffer, info, num_frames, NULL);
+  fail_unless (gst_audio_buffer_map (&abuf, info, buffer, GST_MAP_WRITE));
+  memset (abuf.planes[0], left, num_frames * GST_AUDIO_INFO_WIDTH (info) / 8);
+  memset (abuf.planes[1], right, num_frames * GST_AUDIO_INFO_WIDTH (info) / 8);
+  gst_audio_buffer_unmap (&abuf);
+
+  return buffer;
+}
+
+GST_START_TEST (test_non_interleaved)
+{
+  GstHarness *h, *h2;
+  GstBuffer *b;
+  GstAudioInfo info;
+  GstAudioBuffer abuf;
+  GstAudioMeta *meta;
+  GstCaps *caps;
+  static const char *caps_str =
+      "audio/x-raw, format=(string)" GST_AUDIO_NE (S16) ", "
+      "rate=(int)1000, channels=(int)2, layout=(string)non-interleaved";
+
+  caps = gst_caps_from_string (caps_str);
+  fail_unless (gst_audio_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+  gst_harness_set_src_caps_str (h2, caps_str);
+
+  gst_harness_push (h, new_planar_buffer (&info, 1000, 1, 2, 0, GST_SECOND));
+  gst_harness_push (h2, new_planar_buffer (&info, 1000, 2, 1, 0, GST_SECOND));
+
+  /* the planes are mixed separately and not interleaved */
+  b = gst_harness_pull (h);
+  meta = gst_buffer_get_audio_meta (b);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->info.layout, GST_AUDIO_LAYOUT_NON_INTERLEAVED);
+  fail_unless_equals_int (meta->samples, 1000);
+  fail_unless (gst_audio_buffer_map (&abuf, &info, b, GST_MAP_READ));
+  fail_unless_equals_int (((gint16 *) abuf.planes[0])[0], 0x0101 + 0x0202);
+  fail_unless_equals_int (((gint16 *) abuf.planes[0])[999], 0x0101 + 0x0202);
+  fail_unless_equals_int (((gint16 *) abuf.planes[1])[0], 0x0202 + 0x0101);
+  fail_unless_equals_int (((gint16 *) abuf.planes[1])[999], 0x0202 + 0x0101);
+  gst_audio_buffer_unmap (&abuf);
+  gst_buffer_unref (b);
+
+  /* a short last buffer only reduces the number of samples per plane */
+  gst_harness_push (h, new_planar_buffer (&info, 500, 1, 2, GST_SECOND,
+          GST_SECOND / 2));
+  gst_harness_push (h2, new_planar_buffer (&info, 500, 2, 1, GST_SECOND,
+          GST_SECOND / 2));
+  gst_harness_push_event (h, gst_event_new_eos ());
+  gst_harness_push_event (h2, gst_event_new_eos ());
+
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), GST_SECOND);
+  fail_unless_equals_int64 (GST_BUFFER_DURATION (b), GST_SECOND / 2);
+  meta = gst_buffer_get_audio_meta (b);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->samples, 500);
+  fail_unless (gst_audio_buffer_map (&abuf, &info, b, GST_MAP_READ));
+  fail_unless_equals_int (((gint16 *) abuf.planes[1])[0], 0x0303);
+  fail_unless_equals_int (((gint16 *) abuf.planes[1])[499], 0x0303);
+  gst_audio_buffer_unmap (&abuf);
+  gst_buffer_unref (b);
+
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -2250,6 +2505,10 @@ audiomixer_suite (void)
   tcase_add_test (tc_chain, test_segment_base_handling);
   tcase_add_test (tc_chain, test_sinkpad_property_controller);
   tcase_add_test (tc_chain, test_qos_message_live);
+  tcase_add_test (tc_chain, test_mix_minus);
+  tcase_add_test (tc_chain, test_max_active_pads);
+  tcase_add_test (tc_chain, test_non_interleaved);
+  tcase_add_test (tc_chain, test_convert_inputs);
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
@@ -28,6 +28,11 @@
 
 #include <gst/audio/audio.h>
 
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
 #include <gst/fft/gstfft.h>
 #include <gst/fft/gstffts16.h>
 #include <gst/fft/gstffts32.h>
@@ -1255,6 +1260,283 @@ GST_START_TEST (test_fft)
 
 GST_END_TEST;
 
+#define EQUIV_IN_FRAMES 4096
+
+static void
+resample_sine (GstAudioFormat format, gint in_rate, gint out_rate,
+    GstAudioResamplerFilterMode mode,
+    GstAudioResamplerFilterInterpolation interpolation, gdouble * result,
+    gsize * n_result)
+{
+  GstAudioResampler *resampler;
+  GstStructure *options;
+  const GstAudioFormatInfo *finfo = gst_audio_format_get_info (format);
+  gint bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+  gpointer in, out;
+  gsize out_frames, i;
+
+  options = gst_structure_new_empty ("resampler");
+  gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, in_rate, out_rate, options);
+  gst_structure_set (options,
+      GST_AUDIO_RESAMPLER_OPT_FILTER_MODE, GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+      mode, GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+      GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION, interpolation, NULL);
+
+  resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NONE, format, 1, in_rate, out_rate, options);
+  fail_unless (resampler != NULL);
+  gst_structure_free (options);
+
+  in = g_malloc (EQUIV_IN_FRAMES * bpf);
+  for (i = 0; i < EQUIV_IN_FRAMES; i++) {
+    gdouble v = 0.5 * sin (2.0 * G_PI * 1000.0 * i / in_rate);
+
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        ((gint16 *) in)[i] = (gint16) lrint (v * G_MAXINT16);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        ((gint32 *) in)[i] = (gint32) lrint (v * G_MAXINT32);
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        ((gfloat *) in)[i] = v;
+        break;
+      default:
+        ((gdouble *) in)[i] = v;
+        break;
+    }
+  }
+
+  out_frames = gst_audio_resampler_get_out_frames (resampler, EQUIV_IN_FRAMES);
+  fail_unless (out_frames <= *n_result);
+  out = g_malloc (out_frames * bpf);
+  gst_audio_resampler_resample (resampler, &in, EQUIV_IN_FRAMES, &out,
+      out_frames);
+
+  for (i = 0; i < out_frames; i++) {
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        result[i] = ((gint16 *) out)[i] / (gdouble) G_MAXINT16;
+        break;
+      case GST_AUDIO_FORMAT_S32:
+        result[i] = ((gint32 *) out)[i] / (gdouble) G_MAXINT32;
+        break;
+      case GST_AUDIO_FORMAT_F32:
+        result[i] = ((gfloat *) out)[i];
+        break;
+      default:
+        result[i] = ((gdouble *) out)[i];
+        break;
+    }
+  }
+  *n_result = out_frames;
+
+  g_free (in);
+  g_free (out);
+  gst_audio_resampler_free (resampler);
+}
+
+/* All sample formats go through their own (possibly SIMD) inner product
+ * implementation, check that they all compute the same thing as the F64
+ * one, which has the most headroom. */
+GST_START_TEST (test_format_equivalence)
+{
+  static const struct
+  {
+    GstAudioResamplerFilterMode mode;
+    GstAudioResamplerFilterInterpolation interpolation;
+  } filters[] = {
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+  };
+  static const struct
+  {
+    GstAudioFormat format;
+    gdouble tolerance;
+  } formats[] = {
+    {GST_AUDIO_FORMAT_S16, 4e-3},
+    {GST_AUDIO_FORMAT_S32, 1e-4},
+    {GST_AUDIO_FORMAT_F32, 1e-4},
+  };
+  static const gint rates[][2] = {
+    {48000, 44100}, {16000, 48000}, {8000, 48000}
+  };
+  const gsize max_out = EQUIV_IN_FRAMES * 6 + 64;
+  gdouble *ref, *res;
+  gsize r, f, m, i;
+
+  ref = g_new (gdouble, max_out);
+  res = g_new (gdouble, max_out);
+
+  for (r = 0; r < G_N_ELEMENTS (rates); r++) {
+    for (m = 0; m < G_N_ELEMENTS (filters); m++) {
+      gsize n_ref = max_out;
+
+      resample_sine (GST_AUDIO_FORMAT_F64, rates[r][0], rates[r][1],
+          filters[m].mode, filters[m].interpolation, ref, &n_ref);
+      fail_unless (n_ref > 0);
+
+      for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+        gsize n_res = max_out;
+
+        resample_sine (formats[f].format, rates[r][0], rates[r][1],
+            filters[m].mode, filters[m].interpolation, res, &n_res);
+        fail_unless_equals_int (n_res, n_ref);
+
+        for (i = 0; i < n_ref; i++) {
+          fail_unless (fabs (res[i] - ref[i]) <= formats[f].tolerance,
+              "%s %d->%d filter %" G_GSIZE_FORMAT ": sample %"
+              G_GSIZE_FORMAT " is %f, expected %f",
+              gst_audio_format_to_string (formats[f].format), rates[r][0],
+              rates[r][1], m, i, res[i], ref[i]);
+        }
+      }
+    }
+  }
+
+  g_free (ref);
+  g_free (res);
+}
+
+GST_END_TEST;
+
+#ifdef G_OS_UNIX
+static void
+write_all (gint fd, gconstpointer data, gsize size)
+{
+  const guint8 *p = data;
+
+  while (size > 0) {
+    gssize r = write (fd, p, size);
+
+    if (r <= 0)
+      _exit (1);
+    p += r;
+    size -= r;
+  }
+}
+
+static void
+read_all (gint fd, gpointer data, gsize size)
+{
+  guint8 *p = data;
+
+  while (size > 0) {
+    gssize r = read (fd, p, size);
+
+    fail_unless (r > 0);
+    p += r;
+    size -= r;
+  }
+}
+
+/* The AVX2 kernels are selected once per process, so compute the C/SSE
+ * output in a child that disables them before its first resampler is
+ * created, and compare it with the output of the default dispatch here.
+ * Without AVX2 (or with CK_FORK=no, where the dispatch is already set up)
+ * both sides run the same code. */
+GST_START_TEST (test_avx2_equivalence)
+{
+  static const struct
+  {
+    GstAudioResamplerFilterMode mode;
+    GstAudioResamplerFilterInterpolation interpolation;
+  } filters[] = {
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_FULL,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_LINEAR},
+    {GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED,
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC},
+  };
+  /* the integer kernels round exactly like the C code, the float ones
+   * only differ by the FMA rounding */
+  static const struct
+  {
+    GstAudioFormat format;
+    gdouble tolerance;
+  } formats[] = {
+    {GST_AUDIO_FORMAT_S16, 0.0},
+    {GST_AUDIO_FORMAT_S32, 0.0},
+    {GST_AUDIO_FORMAT_F32, 1e-5},
+    {GST_AUDIO_FORMAT_F64, 1e-12},
+  };
+  static const gint rates[][2] = {
+    {48000, 44100}, {16000, 48000}
+  };
+  const gsize max_out = EQUIV_IN_FRAMES * 6 + 64;
+  gdouble *ref, *res;
+  gsize r, f, m, i;
+  gint fds[2], status;
+  pid_t pid;
+
+  ref = g_new (gdouble, max_out);
+  res = g_new (gdouble, max_out);
+
+  fail_unless (pipe (fds) == 0);
+  pid = fork ();
+  fail_unless (pid >= 0);
+
+  if (pid == 0) {
+    close (fds[0]);
+    g_setenv ("GST_AUDIO_RESAMPLER_DISABLE_AVX2", "1", TRUE);
+
+    for (r = 0; r < G_N_ELEMENTS (rates); r++) {
+      for (m = 0; m < G_N_ELEMENTS (filters); m++) {
+        for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+          gsize n_ref = max_out;
+
+          resample_sine (formats[f].format, rates[r][0], rates[r][1],
+              filters[m].mode, filters[m].interpolation, ref, &n_ref);
+          write_all (fds[1], &n_ref, sizeof (n_ref));
+          write_all (fds[1], ref, n_ref * sizeof (gdouble));
+        }
+      }
+    }
+    _exit (0);
+  }
+  close (fds[1]);
+
+  for (r = 0; r < G_N_ELEMENTS (rates); r++) {
+    for (m = 0; m < G_N_ELEMENTS (filters); m++) {
+      for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+        gsize n_ref, n_res = max_out;
+
+        read_all (fds[0], &n_ref, sizeof (n_ref));
+        fail_unless (n_ref > 0 && n_ref <= max_out);
+        read_all (fds[0], ref, n_ref * sizeof (gdouble));
+
+        resample_sine (formats[f].format, rates[r][0], rates[r][1],
+            filters[m].mode, filters[m].interpolation, res, &n_res);
+        fail_unless_equals_int (n_res, n_ref);
+
+        for (i = 0; i < n_ref; i++) {
+          fail_unless (fabs (res[i] - ref[i]) <= formats[f].tolerance,
+              "%s %d->%d filter %" G_GSIZE_FORMAT ": sample %"
+              G_GSIZE_FORMAT " is %.17g, C/SSE gives %.17g",
+              gst_audio_format_to_string (formats[f].format), rates[r][0],
+              rates[r][1], m, i, res[i], ref[i]);
+        }
+      }
+    }
+  }
+  close (fds[0]);
+
+  fail_unless (waitpid (pid, &status, 0) == pid);
+  fail_unless (WIFEXITED (status) && WEXITSTATUS (status) == 0);
+
+  g_free (ref);
+  g_free (res);
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 audioresample_suite (void)
 {
@@ -1270,6 +1552,10 @@ audioresample_suite (void)
   tcase_add_test (tc_chain, test_live_switch_downstream);
   tcase_add_test (tc_chain, test_timestamp_drift);
   tcase_add_test (tc_chain, test_fft);
+  tcase_add_test (tc_chain, test_format_equivalence);
+#ifdef G_OS_UNIX
+  tcase_add_test (tc_chain, test_avx2_equivalence);
+#endif
 
 #ifndef GST_DISABLE_PARSE
   tcase_set_timeout (tc_chain, 360);
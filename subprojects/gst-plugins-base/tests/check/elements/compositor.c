@@ -2323,6 +2323,322 @@ GST_START_TEST (test_gap_events)
 
 GST_END_TEST;
 
+static GstBuffer *
+compose_scaled_frame (const gchar * format, gint ypos, gboolean with_config)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buf;
+  GstPad *pad;
+  gchar *caps;
+  guint plane, x, y;
+
+  /* black background */
+  g_object_set (comp, "background", 1, NULL);
+
+  pad = gst_element_get_static_pad (comp, "sink_0");
+  g_object_set (pad, "xpos", 8, "ypos", ypos, "width", 40, "height", 30, NULL);
+  /* a converter-config makes the pad go through the converter instead of
+   * being scaled while blending */
+  if (with_config) {
+    GstStructure *config =
+        gst_structure_new_empty ("GstVideoConverterConfig");
+    g_object_set (pad, "converter-config", config, NULL);
+    gst_structure_free (config);
+  }
+  gst_object_unref (pad);
+
+  caps = g_strdup_printf ("video/x-raw, format=%s, width=64, height=48, "
+      "framerate=25/1", format);
+  gst_harness_set_src_caps_str (h, caps);
+  gst_harness_set_sink_caps_str (h, caps);
+  g_free (caps);
+
+  gst_video_info_set_format (&info, gst_video_format_from_string (format), 64,
+      48);
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_WRITE));
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (&frame); plane++) {
+    guint8 *data = GST_VIDEO_FRAME_PLANE_DATA (&frame, plane);
+    gint stride = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, plane);
+
+    for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&frame, plane); y++) {
+      for (x = 0; x < stride; x++)
+        data[y * stride + x] = (x * 7 + y * 13 + plane * 50) & 0xff;
+    }
+  }
+  gst_video_frame_unmap (&frame);
+
+  GST_BUFFER_PTS (buf) = 0;
+  GST_BUFFER_DURATION (buf) = 40 * GST_MSECOND;
+
+  gst_harness_play (h);
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  buf = gst_harness_pull (h);
+
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+
+  return buf;
+}
+
+static void
+check_scaled_blend (const gchar * format, gint ypos)
+{
+  GstBuffer *fused, *converted;
+  GstMapInfo fused_map, converted_map;
+  gsize i;
+
+  fused = compose_scaled_frame (format, ypos, FALSE);
+  converted = compose_scaled_frame (format, ypos, TRUE);
+
+  fail_unless (gst_buffer_map (fused, &fused_map, GST_MAP_READ));
+  fail_unless (gst_buffer_map (converted, &converted_map, GST_MAP_READ));
+  fail_unless_equals_int (fused_map.size, converted_map.size);
+
+  /* the same scalers are used either way, only the order in which lines
+   * are scaled may differ */
+  for (i = 0; i < fused_map.size; i++) {
+    if (ABS (fused_map.data[i] - converted_map.data[i]) > 1)
+      fail ("%s ypos %d: byte %" G_GSIZE_FORMAT " differs: %u != %u", format,
+          ypos, i, fused_map.data[i], converted_map.data[i]);
+  }
+
+  gst_buffer_unmap (fused, &fused_map);
+  gst_buffer_unmap (converted, &converted_map);
+  gst_buffer_unref (fused);
+  gst_buffer_unref (converted);
+}
+
+GST_START_TEST (test_fused_scale_blend)
+{
+  check_scaled_blend ("I420", 6);
+  check_scaled_blend ("I420", -6);
+  check_scaled_blend ("NV12", 6);
+  check_scaled_blend ("NV12", -6);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+create_damage_input (guint8 luma, GstClockTime pts, GstClockTime duration)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buf;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 16, 16);
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_WRITE));
+  gst_video_frame_fill_color (&frame, luma, 128, 128);
+  gst_video_frame_unmap (&frame);
+
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = duration;
+
+  return buf;
+}
+
+static guint8
+damage_output_luma (GstBuffer * buf, gint x, gint y)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  guint8 luma;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+  fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_READ));
+  luma = ((guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&frame, 0))[y *
+      GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0) + x];
+  gst_video_frame_unmap (&frame);
+
+  return luma;
+}
+
+static gboolean
+damage_meta_covers (GstVideoDamageMeta * meta, gint x, gint y)
+{
+  guint i;
+
+  for (i = 0; i < meta->n_regions; i++) {
+    GstVideoDamageRegion *r = &meta->regions[i];
+
+    if (x >= r->x && x < r->x + r->w && y >= r->y && y < r->y + r->h)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+GST_START_TEST (test_damage_tracking)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstVideoDamageMeta *meta;
+  GstBuffer *out[6];
+  gpointer previous;
+  GstPad *pad;
+  guint i;
+
+  /* black background */
+  g_object_set (comp, "background", 1, "damage-tracking", TRUE, NULL);
+
+  pad = gst_element_get_static_pad (comp, "sink_0");
+  g_object_set (pad, "xpos", 8, "ypos", 8, NULL);
+
+  gst_harness_set_src_caps_str (h, "video/x-raw, format=I420, width=16, "
+      "height=16, framerate=25/1");
+  gst_harness_set_sink_caps_str (h, "video/x-raw, format=I420, width=64, "
+      "height=48, framerate=25/1");
+  gst_harness_play (h);
+
+  /* one input buffer for three output frames */
+  fail_unless_equals_int (gst_harness_push (h, create_damage_input (200, 0,
+              120 * GST_MSECOND)), GST_FLOW_OK);
+  for (i = 0; i < 3; i++)
+    out[i] = gst_harness_pull (h);
+
+  /* the first frame is drawn completely */
+  meta = gst_buffer_get_video_damage_meta (out[0]);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->n_regions, 1);
+  fail_unless_equals_int (meta->regions[0].w, 64);
+  fail_unless_equals_int (meta->regions[0].h, 48);
+
+  /* the repeated frames did not change, the previous output was still in
+   * use so they were copied into new buffers */
+  for (i = 1; i < 3; i++) {
+    fail_unless (out[i] != out[i - 1]);
+    meta = gst_buffer_get_video_damage_meta (out[i]);
+    fail_unless (meta != NULL);
+    fail_unless_equals_int (meta->n_regions, 0);
+    fail_unless_equals_int (damage_output_luma (out[i], 0, 0), 16);
+    fail_unless_equals_int (damage_output_luma (out[i], 10, 10), 200);
+  }
+
+  /* once downstream released it, the previous output buffer is drawn
+   * into again */
+  previous = out[2];
+  for (i = 0; i < 3; i++)
+    gst_clear_buffer (&out[i]);
+
+  /* a new buffer only damages the area of the pad */
+  fail_unless_equals_int (gst_harness_push (h, create_damage_input (100,
+              120 * GST_MSECOND, 40 * GST_MSECOND)), GST_FLOW_OK);
+  out[3] = gst_harness_pull (h);
+  fail_unless (out[3] == previous);
+  meta = gst_buffer_get_video_damage_meta (out[3]);
+  fail_unless (meta != NULL);
+  fail_unless (meta->n_regions > 0);
+  fail_unless (damage_meta_covers (meta, 8, 8));
+  fail_unless (damage_meta_covers (meta, 23, 23));
+  fail_if (damage_meta_covers (meta, 40, 40));
+  fail_unless_equals_int (damage_output_luma (out[3], 10, 10), 100);
+  fail_unless_equals_int (damage_output_luma (out[3], 0, 0), 16);
+  fail_unless_equals_int (damage_output_luma (out[3], 40, 40), 16);
+
+  /* moving the pad damages the old and the new position */
+  previous = out[3];
+  gst_clear_buffer (&out[3]);
+  g_object_set (pad, "xpos", 40, "ypos", 24, NULL);
+  fail_unless_equals_int (gst_harness_push (h, create_damage_input (100,
+              160 * GST_MSECOND, 80 * GST_MSECOND)), GST_FLOW_OK);
+  out[4] = gst_harness_pull (h);
+  fail_unless (out[4] == previous);
+  out[5] = gst_harness_pull (h);
+
+  meta = gst_buffer_get_video_damage_meta (out[4]);
+  fail_unless (meta != NULL);
+  fail_unless (damage_meta_covers (meta, 10, 10));
+  fail_unless (damage_meta_covers (meta, 50, 30));
+  fail_unless_equals_int (damage_output_luma (out[4], 10, 10), 16);
+  fail_unless_equals_int (damage_output_luma (out[4], 50, 30), 100);
+
+  meta = gst_buffer_get_video_damage_meta (out[5]);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->n_regions, 0);
+  fail_unless_equals_int (damage_output_luma (out[5], 10, 10), 16);
+  fail_unless_equals_int (damage_output_luma (out[5], 50, 30), 100);
+
+  for (i = 0; i < G_N_ELEMENTS (out); i++)
+    gst_clear_buffer (&out[i]);
+  gst_object_unref (pad);
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+compose_tiles (guint max_threads)
+{
+  GString *desc = g_string_new (NULL);
+  GstElement *pipeline, *sink;
+  GstSample *sample;
+  GstBuffer *buf;
+  gint i;
+
+  g_string_append_printf (desc, "compositor name=c max-threads=%u "
+      "background=black", max_threads);
+  /* 7x7 slightly overlapping and scaled tiles, every other one translucent */
+  for (i = 0; i < 49; i++) {
+    g_string_append_printf (desc, " sink_%d::xpos=%d sink_%d::ypos=%d "
+        "sink_%d::width=44 sink_%d::height=36 sink_%d::alpha=%s", i,
+        (i % 7) * 40 - 2, i, (i / 7) * 32 - 2, i, i, i,
+        i % 2 ? "0.6" : "1.0");
+  }
+  g_string_append (desc, " ! video/x-raw, format=I420, width=280, height=224 "
+      "! appsink name=sink sync=false");
+  for (i = 0; i < 49; i++) {
+    g_string_append_printf (desc, " videotestsrc num-buffers=1 pattern=%d ! "
+        "video/x-raw, format=I420, width=40, height=32 ! c.sink_%d", i % 20,
+        i);
+  }
+
+  pipeline = gst_parse_launch (desc->str, NULL);
+  fail_unless (pipeline != NULL);
+  g_string_free (desc, TRUE);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  g_signal_emit_by_name (sink, "pull-sample", &sample);
+  fail_unless (sample != NULL);
+  buf = gst_buffer_ref (gst_sample_get_buffer (sample));
+  gst_sample_unref (sample);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  return buf;
+}
+
+GST_START_TEST (test_tiled_blend_threads)
+{
+  GstBuffer *single, *threaded;
+  GstMapInfo single_map, threaded_map;
+
+  /* the output is split into bands differently depending on the number of
+   * threads, which must not change the result */
+  single = compose_tiles (1);
+  threaded = compose_tiles (4);
+
+  fail_unless (gst_buffer_map (single, &single_map, GST_MAP_READ));
+  fail_unless (gst_buffer_map (threaded, &threaded_map, GST_MAP_READ));
+  fail_unless_equals_int (single_map.size, threaded_map.size);
+  fail_unless (memcmp (single_map.data, threaded_map.data,
+          single_map.size) == 0);
+
+  gst_buffer_unmap (single, &single_map);
+  gst_buffer_unmap (threaded, &threaded_map);
+  gst_buffer_unref (single);
+  gst_buffer_unref (threaded);
+}
+
+GST_END_TEST;
+
 static GstBuffer *expected_selected_buffer = NULL;
 
 static void
@@ -2785,6 +3101,9 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
+  tcase_add_test (tc_chain, test_fused_scale_blend);
+  tcase_add_test (tc_chain, test_damage_tracking);
+  tcase_add_test (tc_chain, test_tiled_blend_threads);
   tcase_add_test (tc_chain, test_signals);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_stream_start_after_eos);
@@ -25,6 +25,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -2236,6 +2237,149 @@ GST_START_TEST (test_drop_only_ref_count)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_damaged_buffer (GstClockTime pts, guint8 value)
+{
+  GstBuffer *buf;
+  GstVideoDamageMeta *meta;
+
+  buf = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_PTS (buf) = pts;
+  gst_buffer_memset (buf, 0, value, 4);
+  meta = gst_buffer_add_video_damage_meta (buf);
+  gst_video_damage_meta_add_region (meta, 0, 0, 16, 16);
+
+  return buf;
+}
+
+static gint
+buffer_get_damage_regions (GstBuffer * buffer)
+{
+  GstVideoDamageMeta *meta = gst_buffer_get_video_damage_meta (buffer);
+
+  return meta ? (gint) meta->n_regions : -1;
+}
+
+static GstElement *
+setup_videorate_mark_duplicates (void)
+{
+  GstElement *videorate;
+  GstCaps *caps;
+
+  /* upsample from 10 to 25 fps so that frames get duplicated */
+  videorate = setup_videorate_full (&srctemplate, &downstreamsinktemplate);
+  g_object_set (videorate, "mark-duplicates", TRUE, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string ("video/x-raw, width = (int) 320, "
+      "height = (int) 240, framerate = (fraction) 10/1, "
+      "format = (string) I420");
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  return videorate;
+}
+
+GST_START_TEST (test_mark_duplicates)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second;
+  GList *l;
+
+  videorate = setup_videorate_mark_duplicates ();
+
+  first = create_damaged_buffer (0, 1);
+  gst_buffer_ref (first);
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+
+  second = create_damaged_buffer (GST_SECOND / 10, 2);
+  gst_buffer_ref (second);
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+
+  fail_unless (gst_pad_push (mysrcpad,
+          create_damaged_buffer (GST_SECOND / 5, 3)) == GST_FLOW_OK);
+
+  /* each of the first two buffers is pushed twice */
+  assert_videorate_stats (videorate, "third buffer", 3, 4, 0, 2);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+
+  /* a discont frame doesn't describe what changed */
+  l = buffers;
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 1);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), -1);
+  fail_if (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_GAP));
+
+  /* duplicates are unchanged and share the memory of the original */
+  l = g_list_next (l);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), 0);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_GAP));
+  fail_unless (gst_buffer_peek_memory (l->data, 0) ==
+      gst_buffer_peek_memory (first, 0));
+
+  l = g_list_next (l);
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 2);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), 1);
+  fail_if (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_GAP));
+
+  l = g_list_next (l);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), 0);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_GAP));
+  fail_unless (gst_buffer_peek_memory (l->data, 0) ==
+      gst_buffer_peek_memory (second, 0));
+
+  /* the input buffers are left untouched */
+  fail_unless_equals_int (buffer_get_damage_regions (first), 1);
+  fail_unless_equals_int (buffer_get_damage_regions (second), 1);
+
+  gst_buffer_unref (first);
+  gst_buffer_unref (second);
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_mark_duplicates_after_drop)
+{
+  GstElement *videorate;
+  GList *l;
+
+  videorate = setup_videorate_mark_duplicates ();
+
+  fail_unless (gst_pad_push (mysrcpad, create_damaged_buffer (0,
+              1)) == GST_FLOW_OK);
+  /* dropped, the next one is closer to the second output frame */
+  fail_unless (gst_pad_push (mysrcpad,
+          create_damaged_buffer (GST_MSECOND * 10, 2)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (mysrcpad,
+          create_damaged_buffer (GST_MSECOND * 40, 3)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (mysrcpad,
+          create_damaged_buffer (GST_MSECOND * 100, 4)) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (mysrcpad,
+          create_damaged_buffer (GST_MSECOND * 200, 5)) == GST_FLOW_OK);
+
+  assert_videorate_stats (videorate, "fifth buffer", 5, 4, 1, 1);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+
+  /* the damage of the third buffer is relative to the dropped one */
+  l = g_list_next (buffers);
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 3);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), -1);
+
+  l = g_list_next (l);
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 4);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), 1);
+
+  l = g_list_next (l);
+  fail_unless_equals_int (buffer_get_byte (l->data, 0), 4);
+  fail_unless_equals_int (buffer_get_damage_regions (l->data), 0);
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -2268,6 +2412,8 @@ videorate_suite (void)
   tcase_add_test (tc_chain, test_segment_update_average_period);
   tcase_add_test (tc_chain, test_segment_update);
   tcase_add_test (tc_chain, test_drop_only_ref_count);
+  tcase_add_test (tc_chain, test_mark_duplicates);
+  tcase_add_test (tc_chain, test_mark_duplicates_after_drop);
 
   return s;
 }
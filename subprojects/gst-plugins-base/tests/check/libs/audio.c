@@ -1678,6 +1678,247 @@ GST_START_TEST (test_audio_meta_serialize_65_chans)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GstAudioFormat in_format;
+  gint in_channels;
+  GstAudioFormat out_format;
+  gint out_channels;
+} FusedConversion;
+
+static const FusedConversion fused_conversions[] = {
+  {GST_AUDIO_FORMAT_S16, 1, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_S16, 1},
+  {GST_AUDIO_FORMAT_F32, 1, GST_AUDIO_FORMAT_F32, 2},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_FORMAT_F32, 1},
+  {GST_AUDIO_FORMAT_F32, 1, GST_AUDIO_FORMAT_S16, 1},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_F32, 1, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_FORMAT_S16, 1},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_F32, 2},
+  {GST_AUDIO_FORMAT_S16, 1, GST_AUDIO_FORMAT_F32, 2},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_F32, 1},
+};
+
+#define FUSED_FRAMES 4800
+
+/* Passing the default mix matrix explicitly makes the converter use the
+ * generic conversion chain, which the fused conversions must match */
+static GstAudioConverter *
+make_fused_converter (const FusedConversion * conv, gboolean generic,
+    GstAudioDitherMethod dither)
+{
+  GstAudioInfo in_info, out_info;
+  GstStructure *config = NULL;
+
+  gst_audio_info_set_format (&in_info, conv->in_format, 48000,
+      conv->in_channels, NULL);
+  gst_audio_info_set_format (&out_info, conv->out_format, 48000,
+      conv->out_channels, NULL);
+
+  config = gst_structure_new ("config",
+      GST_AUDIO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_AUDIO_DITHER_METHOD,
+      dither, NULL);
+
+  if (generic) {
+    GValue matrix = G_VALUE_INIT;
+    gint i, j;
+
+    g_value_init (&matrix, GST_TYPE_ARRAY);
+    for (j = 0; j < conv->out_channels; j++) {
+      GValue row = G_VALUE_INIT;
+
+      g_value_init (&row, GST_TYPE_ARRAY);
+      for (i = 0; i < conv->in_channels; i++) {
+        GValue v = G_VALUE_INIT;
+
+        g_value_init (&v, G_TYPE_FLOAT);
+        if (conv->in_channels == conv->out_channels)
+          g_value_set_float (&v, i == j ? 1.0 : 0.0);
+        else
+          g_value_set_float (&v, conv->in_channels == 2 ? 0.5 : 1.0);
+        gst_value_array_append_and_take_value (&row, &v);
+      }
+      gst_value_array_append_and_take_value (&matrix, &row);
+    }
+    gst_structure_take_value (config, GST_AUDIO_CONVERTER_OPT_MIX_MATRIX,
+        &matrix);
+  }
+
+  return gst_audio_converter_new (0, &in_info, &out_info, config);
+}
+
+static gpointer
+make_fused_input (const FusedConversion * conv)
+{
+  gint i, n_samples = FUSED_FRAMES * conv->in_channels;
+  gpointer data;
+
+  if (conv->in_format == GST_AUDIO_FORMAT_S16) {
+    gint16 *s = g_new (gint16, n_samples);
+
+    for (i = 0; i < n_samples; i++)
+      s[i] = g_random_int ();
+    data = s;
+  } else {
+    gfloat *f = g_new (gfloat, n_samples);
+
+    /* also go a bit out of range to check the clipping */
+    for (i = 0; i < n_samples; i++)
+      f[i] = g_random_double_range (-1.1, 1.1);
+    data = f;
+  }
+  return data;
+}
+
+GST_START_TEST (test_audio_converter_fused)
+{
+  guint c;
+
+  for (c = 0; c < G_N_ELEMENTS (fused_conversions); c++) {
+    const FusedConversion *conv = &fused_conversions[c];
+    GstAudioConverter *fast, *generic;
+    gpointer in, out_fast, out_generic;
+    gsize out_size;
+
+    fast = make_fused_converter (conv, FALSE, GST_AUDIO_DITHER_NONE);
+    generic = make_fused_converter (conv, TRUE, GST_AUDIO_DITHER_NONE);
+    fail_unless (fast != NULL && generic != NULL);
+
+    in = make_fused_input (conv);
+    out_size = FUSED_FRAMES * conv->out_channels *
+        (conv->out_format == GST_AUDIO_FORMAT_S16 ? 2 : 4);
+    out_fast = g_malloc (out_size);
+    out_generic = g_malloc (out_size);
+
+    fail_unless (gst_audio_converter_samples (fast, 0, &in, FUSED_FRAMES,
+            &out_fast, FUSED_FRAMES));
+    fail_unless (gst_audio_converter_samples (generic, 0, &in, FUSED_FRAMES,
+            &out_generic, FUSED_FRAMES));
+    fail_unless (memcmp (out_fast, out_generic, out_size) == 0,
+        "conversion %d differs from the generic one", c);
+
+    /* same sized frames can be converted in place */
+    if (gst_audio_converter_supports_inplace (fast)) {
+      fail_unless (gst_audio_converter_samples (fast, 0, &in, FUSED_FRAMES,
+              &in, FUSED_FRAMES));
+      fail_unless (memcmp (in, out_generic, out_size) == 0,
+          "in place conversion %d differs from the generic one", c);
+    }
+
+    g_free (in);
+    g_free (out_fast);
+    g_free (out_generic);
+    gst_audio_converter_free (fast);
+    gst_audio_converter_free (generic);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_audio_converter_fused_dither)
+{
+  guint c;
+
+  for (c = 0; c < G_N_ELEMENTS (fused_conversions); c++) {
+    const FusedConversion *conv = &fused_conversions[c];
+    GstAudioConverter *convert, *generic;
+    gpointer in, out, out_generic;
+    gsize out_size;
+
+    /* the dither is seeded the same way, so both must output the same */
+    convert = make_fused_converter (conv, FALSE, GST_AUDIO_DITHER_TPDF);
+    generic = make_fused_converter (conv, TRUE, GST_AUDIO_DITHER_TPDF);
+    fail_unless (convert != NULL && generic != NULL);
+
+    /* the fused conversions are in place when the frame sizes match, the
+     * generic chain never is */
+    fail_if (gst_audio_converter_supports_inplace (convert),
+        "conversion %d uses a fused conversion with dither", c);
+
+    in = make_fused_input (conv);
+    out_size = FUSED_FRAMES * conv->out_channels *
+        (conv->out_format == GST_AUDIO_FORMAT_S16 ? 2 : 4);
+    out = g_malloc (out_size);
+    out_generic = g_malloc (out_size);
+
+    fail_unless (gst_audio_converter_samples (convert, 0, &in, FUSED_FRAMES,
+            &out, FUSED_FRAMES));
+    fail_unless (gst_audio_converter_samples (generic, 0, &in, FUSED_FRAMES,
+            &out_generic, FUSED_FRAMES));
+    fail_unless (memcmp (out, out_generic, out_size) == 0,
+        "dithered conversion %d differs from the generic one", c);
+
+    g_free (in);
+    g_free (out);
+    g_free (out_generic);
+    gst_audio_converter_free (convert);
+    gst_audio_converter_free (generic);
+  }
+}
+
+GST_END_TEST;
+
+#define TIME 0.01
+
+GST_START_TEST (test_audio_converter_fused_speed)
+{
+  GTimer *timer;
+  guint c;
+
+  timer = g_timer_new ();
+
+  for (c = 0; c < G_N_ELEMENTS (fused_conversions); c++) {
+    const FusedConversion *conv = &fused_conversions[c];
+    gpointer in, out;
+    gdouble rate[2];
+    gint generic;
+
+    in = make_fused_input (conv);
+    out = g_malloc (FUSED_FRAMES * conv->out_channels * 4);
+
+    for (generic = 0; generic < 2; generic++) {
+      GstAudioConverter *convert;
+      gdouble elapsed;
+      gint count = 0;
+
+      convert = make_fused_converter (conv, generic, GST_AUDIO_DITHER_NONE);
+
+      /* warmup */
+      gst_audio_converter_samples (convert, 0, &in, FUSED_FRAMES, &out,
+          FUSED_FRAMES);
+
+      g_timer_start (timer);
+      while (TRUE) {
+        gst_audio_converter_samples (convert, 0, &in, FUSED_FRAMES, &out,
+            FUSED_FRAMES);
+
+        count++;
+        elapsed = g_timer_elapsed (timer, NULL);
+        if (elapsed >= TIME)
+          break;
+      }
+      rate[generic] = count * FUSED_FRAMES / elapsed;
+
+      gst_audio_converter_free (convert);
+    }
+
+    GST_DEBUG ("%s/%d -> %s/%d: %f frames/sec fused, %f generic (%.1fx)",
+        gst_audio_format_to_string (conv->in_format), conv->in_channels,
+        gst_audio_format_to_string (conv->out_format), conv->out_channels,
+        rate[0], rate[1], rate[0] / rate[1]);
+
+    g_free (in);
+    g_free (out);
+  }
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+#undef TIME
+
 static Suite *
 audio_suite (void)
 {
@@ -1718,6 +1959,9 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
   tcase_add_test (tc_chain, test_audio_meta_serialize);
   tcase_add_test (tc_chain, test_audio_meta_serialize_65_chans);
+  tcase_add_test (tc_chain, test_audio_converter_fused);
+  tcase_add_test (tc_chain, test_audio_converter_fused_dither);
+  tcase_add_test (tc_chain, test_audio_converter_fused_speed);
 
   return s;
 }
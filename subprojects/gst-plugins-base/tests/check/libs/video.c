@@ -2477,6 +2477,133 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_scaler_cached_taps)
+{
+  GstVideoScaler *scale1, *scale2, *scale3;
+  GstStructure *options;
+  const gdouble *coeff1, *coeff2, *coeff3;
+  guint offset1, offset2, n_taps1, n_taps2;
+  guint i;
+
+  /* the converter passes its whole config, unrelated fields must not
+   * prevent reuse */
+  options = gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, 10, NULL);
+  scale1 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 640, options);
+  gst_structure_set (options, GST_VIDEO_CONVERTER_OPT_DEST_X, G_TYPE_INT, 20,
+      NULL);
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 640, options);
+
+  fail_unless_equals_int (gst_video_scaler_get_max_taps (scale1),
+      gst_video_scaler_get_max_taps (scale2));
+  for (i = 0; i < 640; i++) {
+    coeff1 = gst_video_scaler_get_coeff (scale1, i, &offset1, &n_taps1);
+    coeff2 = gst_video_scaler_get_coeff (scale2, i, &offset2, &n_taps2);
+    fail_unless (coeff1 == coeff2);
+    fail_unless_equals_int (offset1, offset2);
+    fail_unless_equals_int (n_taps1, n_taps2);
+  }
+
+  /* a resampler option produces different taps */
+  gst_structure_set (options, GST_VIDEO_RESAMPLER_OPT_CUBIC_B, G_TYPE_DOUBLE,
+      0.0, NULL);
+  scale3 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 1920, 640, options);
+  coeff1 = gst_video_scaler_get_coeff (scale1, 1, NULL, NULL);
+  coeff3 = gst_video_scaler_get_coeff (scale3, 1, NULL, NULL);
+  fail_unless (coeff1 != coeff3);
+  gst_video_scaler_free (scale3);
+  gst_structure_free (options);
+
+  /* the taps stay valid as long as one scaler uses them */
+  coeff2 = gst_video_scaler_get_coeff (scale2, 639, NULL, NULL);
+  gst_video_scaler_free (scale1);
+  coeff1 = gst_video_scaler_get_coeff (scale2, 639, NULL, NULL);
+  fail_unless (coeff1 == coeff2);
+  gst_video_scaler_free (scale2);
+}
+
+GST_END_TEST;
+
+/* Scales with widths that the SIMD functions can handle and compares the
+ * result with scaling one pixel at a time, which is always done by the C
+ * code. */
+static void
+check_scaler_simd (GstVideoFormat format, gint bpp, guint n_taps,
+    guint in_size, guint out_size)
+{
+  GstVideoScaler *scale;
+  guint8 *src, *dest, *ref;
+  gpointer lines[8];
+  guint32 state = 0x12345678;
+  guint i, j;
+
+  src = g_malloc (in_size * bpp * 8);
+  for (i = 0; i < in_size * bpp * 8; i++) {
+    state = state * 1103515245 + 12345;
+    src[i] = state >> 16;
+  }
+  dest = g_malloc0 (out_size * bpp);
+  ref = g_malloc0 (out_size * bpp);
+
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, n_taps, in_size, out_size, NULL);
+  fail_unless_equals_int (gst_video_scaler_get_max_taps (scale), n_taps);
+
+  gst_video_scaler_horizontal (scale, format, src, dest, 0, out_size);
+  for (i = 0; i < out_size; i++)
+    gst_video_scaler_horizontal (scale, format, src, ref, i, 1);
+  fail_unless (memcmp (dest, ref, out_size * bpp) == 0,
+      "%s horizontal %u taps differs", gst_video_format_to_string (format),
+      n_taps);
+  gst_video_scaler_free (scale);
+
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LANCZOS,
+      GST_VIDEO_SCALER_FLAG_NONE, n_taps, 8, 3, NULL);
+  for (i = 0; i < 3; i++) {
+    guint in;
+
+    gst_video_scaler_get_coeff (scale, i, &in, NULL);
+    for (j = 0; j < n_taps; j++)
+      lines[j] = src + (in + j) * in_size * bpp;
+
+    gst_video_scaler_vertical (scale, format, lines, dest, i, in_size);
+    for (j = 0; j < in_size * bpp; j += bpp) {
+      gpointer pixel_lines[8];
+      guint k;
+
+      for (k = 0; k < n_taps; k++)
+        pixel_lines[k] = (guint8 *) lines[k] + j;
+      gst_video_scaler_vertical (scale, format, pixel_lines, ref + j, i, 1);
+    }
+    fail_unless (memcmp (dest, ref, in_size * bpp) == 0,
+        "%s vertical %u taps differs", gst_video_format_to_string (format),
+        n_taps);
+  }
+  gst_video_scaler_free (scale);
+
+  g_free (ref);
+  g_free (dest);
+  g_free (src);
+}
+
+GST_START_TEST (test_video_scaler_simd)
+{
+  guint n_taps;
+
+  for (n_taps = 3; n_taps <= 8; n_taps++) {
+    /* odd sizes leave a remainder for the C code */
+    check_scaler_simd (GST_VIDEO_FORMAT_GRAY8, 1, n_taps, 301, 203);
+    check_scaler_simd (GST_VIDEO_FORMAT_GRAY8, 1, n_taps, 203, 301);
+    check_scaler_simd (GST_VIDEO_FORMAT_NV12, 2, n_taps, 301, 203);
+    check_scaler_simd (GST_VIDEO_FORMAT_GRAY16_LE, 2, n_taps, 301, 203);
+  }
+}
+
+GST_END_TEST;
+
 typedef enum
 {
   RGB,
@@ -2927,6 +3054,213 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+static void
+fill_pattern_buffer (GstBuffer * buffer)
+{
+  guint32 state = 0x12345678;
+  GstMapInfo map;
+  gsize i;
+
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++) {
+    state = state * 1103515245 + 12345;
+    map.data[i] = state >> 16;
+  }
+  gst_buffer_unmap (buffer, &map);
+}
+
+/* copy (@to_strip) or compare the columns @x to @x + @width of @frame with
+ * @strip */
+static gboolean
+frame_strip (GstVideoFrame * frame, GstVideoFrame * strip, gint x,
+    gboolean to_strip)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  gint width = GST_VIDEO_FRAME_WIDTH (strip);
+  guint p;
+
+  for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (frame); p++) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+    gint pstride, xoff, bytes, rows, y;
+
+    gst_video_format_info_component (finfo, p, comp);
+    pstride = GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, comp[0]);
+    xoff = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comp[0], x) * pstride;
+    bytes = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comp[0], width) *
+        pstride;
+    rows = GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp[0]);
+
+    for (y = 0; y < rows; y++) {
+      guint8 *f = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, p) +
+          y * GST_VIDEO_FRAME_PLANE_STRIDE (frame, p) + xoff;
+      guint8 *s = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (strip, p) +
+          y * GST_VIDEO_FRAME_PLANE_STRIDE (strip, p);
+
+      if (to_strip)
+        memcpy (s, f, bytes);
+      else if (memcmp (s, f, bytes) != 0)
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/* Converts a frame that is wide enough for the SIMD line functions and
+ * compares the result with converting it in strips of 4 pixels, which
+ * are too narrow for SIMD and done entirely by the C and orc functions. */
+static void
+check_convert_simd (GstVideoFormat in_format, GstVideoFormat out_format,
+    gint width, gint height)
+{
+  GstVideoInfo ininfo, outinfo, sininfo, soutinfo;
+  GstVideoFrame inframe, outframe, sinframe, soutframe;
+  GstBuffer *inbuffer, *outbuffer, *sinbuffer, *soutbuffer;
+  GstVideoConverter *convert;
+  gint x;
+
+  fail_unless (gst_video_info_set_format (&ininfo, in_format, width, height));
+  fail_unless (gst_video_info_set_format (&outinfo, out_format, width, height));
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  fill_pattern_buffer (inbuffer);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (x = 0; x < width; x += 4) {
+    gint swidth = MIN (4, width - x);
+
+    fail_unless (gst_video_info_set_format (&sininfo, in_format, swidth,
+            height));
+    fail_unless (gst_video_info_set_format (&soutinfo, out_format, swidth,
+            height));
+    sininfo.colorimetry = ininfo.colorimetry;
+    sininfo.chroma_site = ininfo.chroma_site;
+    soutinfo.colorimetry = outinfo.colorimetry;
+    soutinfo.chroma_site = outinfo.chroma_site;
+
+    sinbuffer = gst_buffer_new_and_alloc (sininfo.size);
+    gst_video_frame_map (&sinframe, &sininfo, sinbuffer, GST_MAP_WRITE);
+    frame_strip (&inframe, &sinframe, x, TRUE);
+    soutbuffer = gst_buffer_new_and_alloc (soutinfo.size);
+    gst_video_frame_map (&soutframe, &soutinfo, soutbuffer, GST_MAP_WRITE);
+
+    convert = gst_video_converter_new (&sininfo, &soutinfo, NULL);
+    gst_video_converter_frame (convert, &sinframe, &soutframe);
+    gst_video_converter_free (convert);
+
+    fail_unless (frame_strip (&outframe, &soutframe, x, FALSE),
+        "%s -> %s differs at %d", gst_video_format_to_string (in_format),
+        gst_video_format_to_string (out_format), x);
+
+    gst_video_frame_unmap (&soutframe);
+    gst_buffer_unref (soutbuffer);
+    gst_video_frame_unmap (&sinframe);
+    gst_buffer_unref (sinbuffer);
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+static GstStructure *
+scale_options (GstVideoResamplerMethod method, guint threads)
+{
+  return gst_structure_new ("options",
+      GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+      GST_TYPE_VIDEO_RESAMPLER_METHOD, method,
+      GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads, NULL);
+}
+
+/* Scales NV12 directly to the planar @out_format and compares the result
+ * with converting to @out_format at the same size first and scaling that,
+ * which goes through the plane scalers only. */
+static void
+check_convert_scale_simd (GstVideoFormat out_format, gint width, gint height,
+    gint factor, GstVideoResamplerMethod method)
+{
+  GstVideoInfo ininfo, midinfo, outinfo;
+  GstVideoFrame inframe, midframe, outframe, refframe;
+  GstBuffer *inbuffer, *midbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_NV12,
+          width, height));
+  fail_unless (gst_video_info_set_format (&midinfo, out_format, width,
+          height));
+  fail_unless (gst_video_info_set_format (&outinfo, out_format,
+          width / factor, height / factor));
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  fill_pattern_buffer (inbuffer);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+  midbuffer = gst_buffer_new_and_alloc (midinfo.size);
+  gst_video_frame_map (&midframe, &midinfo, midbuffer, GST_MAP_READWRITE);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_READWRITE);
+  refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&refframe, &outinfo, refbuffer, GST_MAP_READWRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      scale_options (method, 3));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&ininfo, &midinfo,
+      scale_options (method, 1));
+  gst_video_converter_frame (convert, &inframe, &midframe);
+  gst_video_converter_free (convert);
+  convert = gst_video_converter_new (&midinfo, &outinfo,
+      scale_options (method, 1));
+  gst_video_converter_frame (convert, &midframe, &refframe);
+  gst_video_converter_free (convert);
+
+  fail_unless (frame_strip (&refframe, &outframe, 0, FALSE),
+      "NV12 -> %s scaled by 1/%d with method %d differs",
+      gst_video_format_to_string (out_format), factor, method);
+
+  gst_video_frame_unmap (&refframe);
+  gst_buffer_unref (refbuffer);
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&midframe);
+  gst_buffer_unref (midbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_START_TEST (test_video_convert_simd)
+{
+  /* 238 is 7 blocks of 32 pixels and a remainder */
+  check_convert_simd (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_BGRA, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_BGRx, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_RGBA, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_RGBx, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, 238, 5);
+  check_convert_simd (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, 238, 5);
+
+  /* 2x goes through the halving functions with linear resampling */
+  check_convert_scale_simd (GST_VIDEO_FORMAT_I420, 476, 20, 2,
+      GST_VIDEO_RESAMPLER_METHOD_LINEAR);
+  check_convert_scale_simd (GST_VIDEO_FORMAT_YV12, 476, 20, 2,
+      GST_VIDEO_RESAMPLER_METHOD_LINEAR);
+  check_convert_scale_simd (GST_VIDEO_FORMAT_I420, 476, 20, 2,
+      GST_VIDEO_RESAMPLER_METHOD_CUBIC);
+  check_convert_scale_simd (GST_VIDEO_FORMAT_I420, 952, 40, 4,
+      GST_VIDEO_RESAMPLER_METHOD_LINEAR);
+  check_convert_scale_simd (GST_VIDEO_FORMAT_YV12, 952, 40, 4,
+      GST_VIDEO_RESAMPLER_METHOD_CUBIC);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -4247,6 +4581,57 @@ GST_START_TEST (test_info_dma_drm)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_damage_meta)
+{
+  GstBuffer *buf, *copy, *scaled;
+  GstVideoDamageMeta *meta;
+  GstVideoInfo in_info, out_info;
+  GstVideoMetaTransform trans = { &in_info, &out_info };
+
+  buf = gst_buffer_new ();
+  meta = gst_buffer_add_video_damage_meta (buf);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->n_regions, 0);
+
+  gst_video_damage_meta_add_region (meta, 10, 20, 30, 40);
+  /* empty regions are ignored */
+  gst_video_damage_meta_add_region (meta, 0, 0, 0, 10);
+  gst_video_damage_meta_add_region (meta, 100, 0, 20, 20);
+  fail_unless_equals_int (meta->n_regions, 2);
+
+  copy = gst_buffer_copy (buf);
+  meta = gst_buffer_get_video_damage_meta (copy);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->n_regions, 2);
+  fail_unless_equals_int (meta->regions[0].x, 10);
+  fail_unless_equals_int (meta->regions[0].y, 20);
+  fail_unless_equals_int (meta->regions[0].w, 30);
+  fail_unless_equals_int (meta->regions[0].h, 40);
+  fail_unless_equals_int (meta->regions[1].x, 100);
+  gst_buffer_unref (copy);
+
+  /* scaling to half the size rounds outwards */
+  gst_video_info_set_format (&in_info, GST_VIDEO_FORMAT_I420, 160, 120);
+  gst_video_info_set_format (&out_info, GST_VIDEO_FORMAT_I420, 80, 60);
+  scaled = gst_buffer_new ();
+  meta = gst_buffer_get_video_damage_meta (buf);
+  fail_unless (meta->meta.info->transform_func (scaled, (GstMeta *) meta, buf,
+          gst_video_meta_transform_scale_get_quark (), &trans));
+  meta = gst_buffer_get_video_damage_meta (scaled);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->n_regions, 2);
+  fail_unless (meta->regions[0].x <= 5);
+  fail_unless (meta->regions[0].y <= 10);
+  fail_unless (meta->regions[0].x + meta->regions[0].w >= 20);
+  fail_unless (meta->regions[0].y + meta->regions[0].h >= 30);
+  fail_unless (meta->regions[1].x + meta->regions[1].w <= 80);
+  gst_buffer_unref (scaled);
+
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_meta_serialize)
 {
   GstBuffer *buf;
@@ -4370,6 +4755,8 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_chroma);
   tcase_add_test (tc_chain, test_video_chroma_site);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_cached_taps);
+  tcase_add_test (tc_chain, test_video_scaler_simd);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_rgb);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_yuv);
   tcase_add_test (tc_chain, test_video_color_convert_yuv_yuv);
@@ -4378,6 +4765,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_simd);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
@@ -4396,6 +4784,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_color_primaries_equivalent);
   tcase_add_test (tc_chain, test_info_dma_drm);
   tcase_add_test (tc_chain, test_video_meta_serialize);
+  tcase_add_test (tc_chain, test_video_damage_meta);
   tcase_add_test (tc_chain, test_video_convert_with_config_update);
   tcase_add_test (tc_chain, test_dma_drm_big_engian);
 
@@ -83,6 +83,14 @@ struct _GstVideoDecoderTester
   guint64 last_kf_num;
   gboolean set_output_state;
   gboolean subframe_mode;
+
+  /* finish the frames from a thread pool */
+  gboolean async;
+  GThreadPool *pool;
+  /* busy time per frame instead of a random sleep, for measuring */
+  gint64 work_us;
+
+  guint num_handled;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -93,6 +101,48 @@ struct _GstVideoDecoderTesterClass
 G_DEFINE_TYPE (GstVideoDecoderTester, gst_video_decoder_tester,
     GST_TYPE_VIDEO_DECODER);
 
+static void
+gst_video_decoder_tester_work (GstVideoDecoderTester * dectester)
+{
+  gint64 end = g_get_monotonic_time () + dectester->work_us;
+
+  while (g_get_monotonic_time () < end);
+}
+
+static void
+gst_video_decoder_tester_async_decode (gpointer data, gpointer user_data)
+{
+  GstVideoDecoderTester *dectester = user_data;
+
+  /* complete the frames out of order */
+  if (dectester->work_us)
+    gst_video_decoder_tester_work (dectester);
+  else
+    g_usleep (g_random_int_range (0, 200));
+
+  gst_video_decoder_finish_frame_async (GST_VIDEO_DECODER (dectester),
+      data);
+}
+
+static void
+gst_video_decoder_tester_start_pool (GstVideoDecoderTester * dectester)
+{
+  if (dectester->async) {
+    dectester->pool =
+        g_thread_pool_new (gst_video_decoder_tester_async_decode, dectester, 4,
+        FALSE, NULL);
+  }
+}
+
+static void
+gst_video_decoder_tester_stop_pool (GstVideoDecoderTester * dectester)
+{
+  if (dectester->pool) {
+    g_thread_pool_free (dectester->pool, FALSE, TRUE);
+    dectester->pool = NULL;
+  }
+}
+
 static gboolean
 gst_video_decoder_tester_start (GstVideoDecoder * dec)
 {
@@ -102,12 +152,16 @@ gst_video_decoder_tester_start (GstVideoDecoder * dec)
   dectester->last_kf_num = -1;
   dectester->set_output_state = TRUE;
 
+  gst_video_decoder_tester_start_pool (dectester);
+
   return TRUE;
 }
 
 static gboolean
 gst_video_decoder_tester_stop (GstVideoDecoder * dec)
 {
+  gst_video_decoder_tester_stop_pool ((GstVideoDecoderTester *) dec);
+
   return TRUE;
 }
 
@@ -119,6 +173,10 @@ gst_video_decoder_tester_flush (GstVideoDecoder * dec)
   dectester->last_buf_num = -1;
   dectester->last_kf_num = -1;
 
+  /* wait for the pending frames */
+  gst_video_decoder_tester_stop_pool (dectester);
+  gst_video_decoder_tester_start_pool (dectester);
+
   return TRUE;
 }
 
@@ -149,6 +207,8 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   gboolean last_subframe = GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
       GST_VIDEO_BUFFER_FLAG_MARKER);
 
+  dectester->num_handled++;
+
   if (gst_video_decoder_get_subframe_mode (dec) && !last_subframe) {
     if (!GST_CLOCK_TIME_IS_VALID (frame->pts))
       return gst_video_decoder_drop_subframe (dec, frame);
@@ -185,8 +245,15 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
     if (gst_video_decoder_get_subframe_mode (dec) && last_subframe)
       gst_video_decoder_have_last_subframe (dec, frame);
 
-    if (frame->output_buffer)
+    if (frame->output_buffer && dectester->pool) {
+      g_thread_pool_push (dectester->pool, frame, NULL);
+      return GST_FLOW_OK;
+    }
+
+    if (frame->output_buffer) {
+      gst_video_decoder_tester_work (dectester);
       return gst_video_decoder_finish_frame (dec, frame);
+    }
   } else {
     return gst_video_decoder_drop_frame (dec, frame);
 
@@ -1578,6 +1645,194 @@ GST_START_TEST (videodecoder_playback_invalid_ts_packetized_subframes)
 
 GST_END_TEST;
 
+GST_START_TEST (videodecoder_playback_async)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i, num;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  ((GstVideoDecoderTester *) dec)->async = TRUE;
+  gst_video_decoder_set_async_depth (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_async_depth (GST_VIDEO_DECODER
+          (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS / 2; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* no more than 3 frames are pending after each buffer */
+  fail_unless (g_list_length (buffers) >= NUM_BUFFERS / 2 - 3);
+
+  /* the pending frames are discarded */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_start ()));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_stop (TRUE)));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = NUM_BUFFERS / 2; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* and all the others are pushed on EOS */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* the buffers are in order with their own timestamps, up to the flush and
+   * after it */
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    num = *(guint64 *) map.data;
+    gst_buffer_unmap (buffer, &map);
+
+    if (num == NUM_BUFFERS / 2) {
+      fail_unless (i <= NUM_BUFFERS / 2);
+      i = num;
+    }
+    fail_unless_equals_uint64 (num, i);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (num,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+    i++;
+  }
+  fail_unless_equals_uint64 (i, NUM_BUFFERS);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+#define ASYNC_SPEED_BUFFERS 200
+#define ASYNC_SPEED_WORK_US 1000
+
+GST_START_TEST (videodecoder_async_speed)
+{
+  GstSegment segment;
+  gdouble elapsed[2];
+  GTimer *timer;
+  gint async;
+  guint64 i;
+
+  timer = g_timer_new ();
+
+  for (async = 0; async < 2; async++) {
+    setup_videodecodertester (NULL, NULL);
+
+    ((GstVideoDecoderTester *) dec)->async = async;
+    ((GstVideoDecoderTester *) dec)->work_us = ASYNC_SPEED_WORK_US;
+    gst_video_decoder_set_async_depth (GST_VIDEO_DECODER (dec),
+        async ? 4 : 0);
+
+    gst_pad_set_active (mysrcpad, TRUE);
+    gst_element_set_state (dec, GST_STATE_PLAYING);
+    gst_pad_set_active (mysinkpad, TRUE);
+
+    send_startup_events ();
+
+    gst_segment_init (&segment, GST_FORMAT_TIME);
+    fail_unless (gst_pad_push_event (mysrcpad,
+            gst_event_new_segment (&segment)));
+
+    g_timer_start (timer);
+    for (i = 0; i < ASYNC_SPEED_BUFFERS; i++)
+      fail_unless (gst_pad_push (mysrcpad, create_test_buffer (i)) ==
+          GST_FLOW_OK);
+    fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+    elapsed[async] = g_timer_elapsed (timer, NULL);
+
+    fail_unless_equals_int (g_list_length (buffers), ASYNC_SPEED_BUFFERS);
+
+    g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+    buffers = NULL;
+
+    cleanup_videodecodertest ();
+  }
+
+  GST_DEBUG ("%d frames of %d us: %f frames/sec sync, %f async (%.1fx)",
+      ASYNC_SPEED_BUFFERS, ASYNC_SPEED_WORK_US,
+      ASYNC_SPEED_BUFFERS / elapsed[0], ASYNC_SPEED_BUFFERS / elapsed[1],
+      elapsed[0] / elapsed[1]);
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+#define QOS_BUFFERS 60
+
+GST_START_TEST (videodecoder_drop_before_decode)
+{
+  gboolean drop_before_decode = __i__;
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+
+  g_object_set (dec, "drop-before-decode", drop_before_decode, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* everything ending before 1s is late */
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW, 1.5, GST_SECOND / 2, 0)));
+
+  /* every other frame is not a reference */
+  for (i = 0; i < QOS_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+    if (i % 2)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DROPPABLE);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* the late droppable frames 1, 3, ..., 27 are not decoded, the late
+   * reference frames 0, 2, ..., 28 are decoded and dropped after that */
+  if (drop_before_decode)
+    fail_unless_equals_int (((GstVideoDecoderTester *) dec)->num_handled,
+        QOS_BUFFERS - 14);
+  else
+    fail_unless_equals_int (((GstVideoDecoderTester *) dec)->num_handled,
+        QOS_BUFFERS);
+  fail_unless_equals_int (g_list_length (buffers), QOS_BUFFERS - 29);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 static void
 test_videodecoder_property_detect_reordering (gboolean detect_reordering)
 {
@@ -1688,6 +1943,11 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_property_detect_reordering_enabled);
   tcase_add_test (tc, videodecoder_property_detect_reordering_disabled);
 
+  tcase_add_test (tc, videodecoder_playback_async);
+  tcase_add_test (tc, videodecoder_async_speed);
+
+  tcase_add_loop_test (tc, videodecoder_drop_before_decode, 0, 2);
+
   return s;
 }
 
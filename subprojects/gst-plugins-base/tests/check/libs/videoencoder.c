@@ -56,6 +56,14 @@ struct _GstVideoEncoderTester
   gboolean enable_step_by_step;
   gboolean negotiate_in_set_format;
   GstVideoCodecFrame *last_frame;
+  guint num_unchanged;
+
+  /* block hints of the last frame when block_size is set */
+  guint block_size;
+  gboolean have_hints;
+  guint n_roi;
+  guint n_skip;
+  gint8 *qp_delta;
 };
 
 struct _GstVideoEncoderTesterClass
@@ -175,6 +183,24 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
     return gst_video_encoder_finish_frame (enc, frame);
   }
 
+  if (GST_VIDEO_CODEC_FRAME_IS_UNCHANGED (frame))
+    enc_tester->num_unchanged++;
+
+  if (enc_tester->block_size) {
+    const GstVideoEncoderBlockHints *hints;
+
+    hints = gst_video_encoder_get_block_hints (enc, frame,
+        enc_tester->block_size);
+    enc_tester->have_hints = hints != NULL;
+    g_clear_pointer (&enc_tester->qp_delta, g_free);
+    if (hints) {
+      enc_tester->n_roi = hints->n_roi;
+      enc_tester->n_skip = hints->n_skip;
+      enc_tester->qp_delta = g_memdup2 (hints->qp_delta,
+          hints->n_columns * hints->n_rows);
+    }
+  }
+
   enc_tester->last_frame = gst_video_codec_frame_ref (frame);
   if (enc_tester->enable_step_by_step)
     return GST_FLOW_OK;
@@ -1263,6 +1289,165 @@ GST_START_TEST (videoencoder_hdr_metadata)
 
 GST_END_TEST;
 
+static void
+videoencoder_push_unchanged_frames (gboolean drop_unchanged)
+{
+  GstVideoEncoderTester *enc_tester;
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videoencodertester ();
+  enc_tester = GST_VIDEO_ENCODER_TESTER (enc);
+  g_object_set (enc, "drop-unchanged", drop_unchanged, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* the first frame and every odd frame repeat the previous one */
+  for (i = 0; i < 10; i++) {
+    buffer = create_test_buffer (i);
+    if (i == 0 || i % 2 == 1)
+      gst_buffer_add_video_damage_meta (buffer);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  if (drop_unchanged) {
+    /* nothing to repeat for the first frame, so it's always encoded */
+    fail_unless_equals_int (enc_tester->num_unchanged, 1);
+    fail_unless_equals_int (g_list_length (buffers), 5);
+  } else {
+    fail_unless_equals_int (enc_tester->num_unchanged, 6);
+    fail_unless_equals_int (g_list_length (buffers), 10);
+  }
+
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    gst_buffer_map (iter->data, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (iter->data, &map);
+
+    i += drop_unchanged ? 2 : 1;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_START_TEST (videoencoder_unchanged_frames)
+{
+  videoencoder_push_unchanged_frames (FALSE);
+  videoencoder_push_unchanged_frames (TRUE);
+}
+
+GST_END_TEST;
+
+static void
+push_block_hints_frame (GstBuffer * buffer, gboolean have_hints, guint n_roi,
+    guint n_skip)
+{
+  GstVideoEncoderTester *enc_tester = GST_VIDEO_ENCODER_TESTER (enc);
+
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_unless_equals_int (enc_tester->have_hints, have_hints);
+  if (have_hints) {
+    fail_unless_equals_int (enc_tester->n_roi, n_roi);
+    fail_unless_equals_int (enc_tester->n_skip, n_skip);
+  }
+}
+
+GST_START_TEST (videoencoder_block_hints)
+{
+  GstVideoEncoderTester *enc_tester;
+  GstVideoRegionOfInterestMeta *roi;
+  GstVideoDamageMeta *damage;
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint n_columns = TEST_VIDEO_WIDTH / 16;
+  guint n_blocks = n_columns * (TEST_VIDEO_HEIGHT / 16);
+
+  setup_videoencodertester ();
+  enc_tester = GST_VIDEO_ENCODER_TESTER (enc);
+  enc_tester->block_size = 16;
+  g_object_set (enc, "roi-delta-qp", -5, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* ROI with the default offset, no previous frame for the damage */
+  buffer = create_test_buffer (0);
+  gst_buffer_add_video_region_of_interest_meta (buffer, "face", 0, 0, 20, 32);
+  damage = gst_buffer_add_video_damage_meta (buffer);
+  gst_video_damage_meta_add_region (damage, 0, 0, 16, 16);
+  push_block_hints_frame (buffer, TRUE, 4, 0);
+  fail_unless_equals_int (enc_tester->qp_delta[0], -5);
+  fail_unless_equals_int (enc_tester->qp_delta[n_columns + 1], -5);
+  fail_unless_equals_int (enc_tester->qp_delta[2], 0);
+
+  /* only the 4 blocks touched by the damage changed */
+  buffer = create_test_buffer (1);
+  damage = gst_buffer_add_video_damage_meta (buffer);
+  gst_video_damage_meta_add_region (damage, 8, 8, 20, 20);
+  push_block_hints_frame (buffer, TRUE, 0, n_blocks - 4);
+
+  /* overlapping ROIs use the lowest offset */
+  buffer = create_test_buffer (2);
+  roi = gst_buffer_add_video_region_of_interest_meta (buffer, "face",
+      16, 16, 16, 16);
+  gst_video_region_of_interest_meta_add_param (roi,
+      gst_structure_new ("roi/test", "delta-qp", G_TYPE_INT, -10, NULL));
+  gst_buffer_add_video_region_of_interest_meta (buffer, "face", 0, 0, 48, 48);
+  push_block_hints_frame (buffer, TRUE, 9, 0);
+  fail_unless_equals_int (enc_tester->qp_delta[0], -5);
+  fail_unless_equals_int (enc_tester->qp_delta[n_columns + 1], -10);
+
+  /* no metas */
+  buffer = create_test_buffer (3);
+  push_block_hints_frame (buffer, FALSE, 0, 0);
+
+  /* repeat of the previous frame */
+  buffer = create_test_buffer (4);
+  gst_buffer_add_video_damage_meta (buffer);
+  push_block_hints_frame (buffer, TRUE, 0, n_blocks);
+
+  /* the damage isn't relative to the previous frame after a discont */
+  buffer = create_test_buffer (5);
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+  gst_buffer_add_video_damage_meta (buffer);
+  push_block_hints_frame (buffer, FALSE, 0, 0);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  g_clear_pointer (&enc_tester->qp_delta, g_free);
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_videoencoder_suite (void)
 {
@@ -1277,6 +1462,8 @@ gst_videoencoder_suite (void)
   tcase_add_test (tc, videoencoder_flush_events);
   tcase_add_test (tc, videoencoder_pre_push_fails);
   tcase_add_test (tc, videoencoder_qos);
+  tcase_add_test (tc, videoencoder_unchanged_frames);
+  tcase_add_test (tc, videoencoder_block_hints);
   tcase_add_test (tc, videoencoder_playback_subframes);
   tcase_add_test (tc, videoencoder_playback_events_subframes);
   tcase_add_test (tc, videoencoder_force_keyunit_handling);
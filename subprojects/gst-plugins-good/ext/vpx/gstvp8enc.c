@@ -169,6 +169,8 @@ gst_vp8_enc_class_init (GstVP8EncClass * klass)
 
   video_encoder_class->pre_push = gst_vp8_enc_pre_push;
 
+  vpx_encoder_class->roi_map_block_size = 16;
+  vpx_encoder_class->roi_map_q_scale = 2;
   vpx_encoder_class->get_algo = gst_vp8_enc_get_algo;
   vpx_encoder_class->enable_scaling = gst_vp8_enc_enable_scaling;
   vpx_encoder_class->enable_tiles = gst_vp8_enc_enable_tiles;
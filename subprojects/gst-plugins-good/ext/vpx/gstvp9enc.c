@@ -232,6 +232,8 @@ gst_vp9_enc_class_init (GstVP9EncClass * klass)
       "Encode VP9 video streams", "David Schleef <ds@entropywave.com>, "
       "Sebastian Dröge <sebastian.droege@collabora.co.uk>");
 
+  vpx_encoder_class->roi_map_block_size = 8;
+  vpx_encoder_class->roi_map_q_scale = 5;
   vpx_encoder_class->get_algo = gst_vp9_enc_get_algo;
   vpx_encoder_class->enable_scaling = gst_vp9_enc_enable_scaling;
   vpx_encoder_class->enable_tiles = gst_vp9_enc_enable_tiles;
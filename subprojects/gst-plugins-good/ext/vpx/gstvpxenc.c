@@ -2022,6 +2022,8 @@ gst_vpx_enc_set_format (GstVideoEncoder * video_encoder,
         GST_VIDEO_INFO_FPS_D (info) * GST_SECOND, GST_VIDEO_INFO_FPS_N (info));
   }
   gst_video_encoder_set_latency (video_encoder, latency, latency);
+  encoder->roi_map_set = FALSE;
+  encoder->roi_map_failed = FALSE;
   encoder->inited = TRUE;
 
   /* Store input state */
@@ -2295,6 +2297,110 @@ gst_vpx_enc_buffer_to_image (GstVPXEnc * enc, GstVideoFrame * frame)
   return image;
 }
 
+/* Segment 0 is left as is, 1 is for the blocks that didn't change and 2
+ * and 3 for the regions of interest */
+#define ROI_MAP_SEGMENT_SKIP 1
+#define ROI_MAP_SEGMENT_ROI 2
+#define ROI_MAP_N_SEGMENTS 4
+
+static guint
+gst_vpx_enc_get_roi_segment (vpx_roi_map_t * roi_map, gint delta_q)
+{
+  guint i, best = ROI_MAP_SEGMENT_ROI;
+
+  for (i = ROI_MAP_SEGMENT_ROI; i < ROI_MAP_N_SEGMENTS; i++) {
+    if (roi_map->delta_q[i] == delta_q)
+      return i;
+  }
+
+  for (i = ROI_MAP_SEGMENT_ROI; i < ROI_MAP_N_SEGMENTS; i++) {
+    if (roi_map->delta_q[i] == 0) {
+      roi_map->delta_q[i] = delta_q;
+      return i;
+    }
+    if (ABS (roi_map->delta_q[i] - delta_q) <
+        ABS (roi_map->delta_q[best] - delta_q))
+      best = i;
+  }
+
+  /* more offsets than segments, use the closest one */
+  return best;
+}
+
+/* called with the encoder lock */
+static void
+gst_vpx_enc_set_roi_map (GstVPXEnc * encoder, GstVideoCodecFrame * frame)
+{
+  GstVPXEncClass *vpx_enc_class = GST_VPX_ENC_GET_CLASS (encoder);
+  const GstVideoEncoderBlockHints *hints = NULL;
+  vpx_codec_err_t status;
+  vpx_roi_map_t roi_map;
+  gboolean use_skip;
+  guint i;
+
+  if (vpx_enc_class->roi_map_block_size == 0 || encoder->roi_map_failed)
+    return;
+
+  hints = gst_video_encoder_get_block_hints (GST_VIDEO_ENCODER (encoder),
+      frame, vpx_enc_class->roi_map_block_size);
+  /* Skipped blocks are copied from the last reference, which is only the
+   * previous input frame if that one was encoded and updated it. Temporal
+   * layer patterns can leave it alone and the rate control can drop
+   * frames. */
+  use_skip = encoder->n_ts_layer_flags == 0
+      && encoder->cfg.rc_dropframe_thresh == 0;
+
+  if (hints && hints->n_roi == 0 && (hints->n_skip == 0 || !use_skip))
+    hints = NULL;
+
+  if (!hints && !encoder->roi_map_set)
+    return;
+
+  memset (&roi_map, 0, sizeof (roi_map));
+  roi_map.rows = (GST_VIDEO_INFO_HEIGHT (&encoder->input_state->info) +
+      vpx_enc_class->roi_map_block_size - 1) /
+      vpx_enc_class->roi_map_block_size;
+  roi_map.cols = (GST_VIDEO_INFO_WIDTH (&encoder->input_state->info) +
+      vpx_enc_class->roi_map_block_size - 1) /
+      vpx_enc_class->roi_map_block_size;
+#ifdef HAVE_VPX_1_8
+  for (i = 0; i < G_N_ELEMENTS (roi_map.ref_frame); i++)
+    roi_map.ref_frame[i] = -1;
+#endif
+
+  if (hints) {
+    roi_map.roi_map = g_malloc0 (roi_map.rows * roi_map.cols);
+
+    /* only VP8 uses the static threshold, and only for inter prediction,
+     * the VP9 skip feature would also apply to the keyframes libvpx places
+     * on its own */
+    if (use_skip && hints->n_skip > 0)
+      roi_map.static_threshold[ROI_MAP_SEGMENT_SKIP] = G_MAXINT;
+
+    for (i = 0; i < roi_map.rows * roi_map.cols; i++) {
+      if (hints->qp_delta[i] != 0) {
+        roi_map.roi_map[i] = gst_vpx_enc_get_roi_segment (&roi_map,
+            CLAMP (hints->qp_delta[i] * vpx_enc_class->roi_map_q_scale, -63,
+                63));
+      } else if (use_skip && hints->skip[i]) {
+        roi_map.roi_map[i] = ROI_MAP_SEGMENT_SKIP;
+      }
+    }
+  }
+
+  /* libvpx copies the map, a NULL map disables it */
+  status = vpx_codec_control (&encoder->encoder, VP8E_SET_ROI_MAP, &roi_map);
+  g_free (roi_map.roi_map);
+
+  if (status != VPX_CODEC_OK) {
+    GST_VPX_ENC_WARN (encoder, "Failed to set VP8E_SET_ROI_MAP", status);
+    encoder->roi_map_failed = TRUE;
+    return;
+  }
+
+  encoder->roi_map_set = hints != NULL;
+}
+
 static GstFlowReturn
 gst_vpx_enc_handle_frame (GstVideoEncoder * video_encoder,
     GstVideoCodecFrame * frame)
@@ -2372,6 +2478,8 @@ gst_vpx_enc_handle_frame (GstVideoEncoder * video_encoder,
             encoder->n_ts_layer_sync_flags]);
   }
 
+  gst_vpx_enc_set_roi_map (encoder, frame);
+
   status = vpx_codec_encode (&encoder->encoder, image,
       pts, duration, flags, encoder->deadline);
 
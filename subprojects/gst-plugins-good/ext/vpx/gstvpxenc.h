@@ -114,6 +114,9 @@ struct _GstVPXEnc
   gboolean inited;
   guint8 tl0picidx;
   gboolean prev_was_keyframe;
+  /* whether a ROI map is set, and whether libvpx refused one */
+  gboolean roi_map_set;
+  gboolean roi_map_failed;
 
   vpx_image_t image;
 
@@ -128,6 +131,10 @@ struct _GstVPXEnc
 struct _GstVPXEncClass
 {
   GstVideoEncoderClass base_video_encoder_class;
+  /* size of the blocks of the ROI map, 0 if not supported, and the number
+   * of quantizer index steps per H.264 QP step */
+  guint roi_map_block_size;
+  gint roi_map_q_scale;
   /*virtual function to get supported algo*/
   vpx_codec_iface_t* (*get_algo) (GstVPXEnc *enc);
   /*enabled scaling*/
@@ -416,6 +416,94 @@ GST_START_TEST (test_encode_fresh_meta)
 
 GST_END_TEST;
 
+static guint64
+region_square_error (GstVideoFrame * a, GstVideoFrame * b, gint x0, gint x1)
+{
+  guint64 err = 0;
+  gint x, y;
+
+  for (y = 0; y < GST_VIDEO_FRAME_HEIGHT (a); y++) {
+    const guint8 *la = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (a, 0) +
+        y * GST_VIDEO_FRAME_COMP_STRIDE (a, 0);
+    const guint8 *lb = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (b, 0) +
+        y * GST_VIDEO_FRAME_COMP_STRIDE (b, 0);
+
+    for (x = x0; x < x1; x++)
+      err += (la[x] - lb[x]) * (la[x] - lb[x]);
+  }
+
+  return err;
+}
+
+GST_START_TEST (test_encode_roi_offsets)
+{
+  GstHarness *h;
+  GstBuffer *buffer, *out;
+  GstVideoRegionOfInterestMeta *roi;
+  GstVideoFrame in_frame, out_frame;
+  GstVideoInfo info;
+  guint64 err_better, err_worse;
+  guint32 state = 0x12345678;
+  GstPluginFeature *dec;
+  GstMapInfo map;
+  gsize i;
+
+  dec = gst_registry_lookup_feature (gst_registry_get (), "vp8dec");
+  if (!dec) {
+    GST_INFO ("no vp8dec, skipping");
+    return;
+  }
+  gst_object_unref (dec);
+
+  h = gst_harness_new_parse ("vp8enc lag-in-frames=0 deadline=1 "
+      "min-quantizer=20 max-quantizer=20 ! vp8dec");
+  gst_harness_set_src_caps (h, gst_caps_new_i420 (128, 64));
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 128, 64);
+  buffer = gst_harness_create_video_buffer_from_info (h, 0, &info, 0,
+      gst_util_uint64_scale (1, GST_SECOND, 30));
+
+  /* noise, so that the quantizer makes a difference */
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++) {
+    state = state * 1103515245 + 12345;
+    map.data[i] = state >> 16;
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  /* two regions of interest spanning several macroblocks with different
+   * offsets, each must get its own segment */
+  roi = gst_buffer_add_video_region_of_interest_meta (buffer, "better",
+      0, 0, 64, 64);
+  gst_video_region_of_interest_meta_add_param (roi,
+      gst_structure_new ("roi/vp8enc", "delta-qp", G_TYPE_INT, -10, NULL));
+  roi = gst_buffer_add_video_region_of_interest_meta (buffer, "worse",
+      64, 0, 64, 64);
+  gst_video_region_of_interest_meta_add_param (roi,
+      gst_structure_new ("roi/vp8enc", "delta-qp", G_TYPE_INT, 10, NULL));
+
+  fail_unless_equals_int (GST_FLOW_OK,
+      gst_harness_push (h, gst_buffer_ref (buffer)));
+  out = gst_harness_pull (h);
+
+  fail_unless (gst_video_frame_map (&in_frame, &info, buffer, GST_MAP_READ));
+  fail_unless (gst_video_frame_map (&out_frame, &info, out, GST_MAP_READ));
+  err_better = region_square_error (&in_frame, &out_frame, 0, 64);
+  err_worse = region_square_error (&in_frame, &out_frame, 64, 128);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  GST_DEBUG ("square error %" G_GUINT64_FORMAT " with the negative offset, %"
+      G_GUINT64_FORMAT " with the positive one", err_better, err_worse);
+  fail_unless (err_worse > 2 * err_better);
+
+  gst_buffer_unref (out);
+  gst_buffer_unref (buffer);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 vp8enc_suite (void)
 {
@@ -430,6 +518,7 @@ vp8enc_suite (void)
   tcase_add_test (tc_chain, test_autobitrate_changes_with_caps);
   tcase_add_test (tc_chain, test_encode_temporally_scaled);
   tcase_add_test (tc_chain, test_encode_fresh_meta);
+  tcase_add_test (tc_chain, test_encode_roi_offsets);
 
   return s;
 }
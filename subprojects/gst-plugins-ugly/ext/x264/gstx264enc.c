@@ -2644,6 +2644,40 @@ gst_x264_enc_add_cc (GstBuffer * buffer, x264_picture_t * pic_in)
   }
 }
 
+/* Turns the regions of interest into per macroblock QP offsets. The skip
+ * hints are not used: x264 decides the frame types in its lookahead and
+ * raising the QP of static blocks of a keyframe would hurt the following
+ * frames. */
+static void
+gst_x264_enc_add_quant_offsets (GstX264Enc * encoder,
+    GstVideoCodecFrame * frame, x264_picture_t * pic_in)
+{
+  const GstVideoEncoderBlockHints *hints;
+  guint n_rows, i;
+  float *offsets;
+
+  /* x264 only applies the offsets with adaptive quantization */
+  if (encoder->x264param.rc.i_aq_mode == X264_AQ_NONE)
+    return;
+
+  hints = gst_video_encoder_get_block_hints (GST_VIDEO_ENCODER (encoder),
+      frame, 16);
+  if (!hints || hints->n_roi == 0)
+    return;
+
+  /* interlaced streams have an even number of macroblock rows */
+  n_rows = hints->n_rows;
+  if (encoder->x264param.b_interlaced)
+    n_rows = GST_ROUND_UP_2 (n_rows);
+
+  offsets = g_new0 (float, hints->n_columns * n_rows);
+  for (i = 0; i < hints->n_columns * hints->n_rows; i++)
+    offsets[i] = hints->qp_delta[i];
+
+  pic_in->prop.quant_offsets = offsets;
+  pic_in->prop.quant_offsets_free = g_free;
+}
+
 /* chain function
  * this function does the actual processing
  */
@@ -2702,6 +2736,7 @@ gst_x264_enc_handle_frame (GstVideoEncoder * video_enc,
   }
 
   gst_x264_enc_add_cc (frame->input_buffer, &pic_in);
+  gst_x264_enc_add_quant_offsets (encoder, frame, &pic_in);
 
   ret = gst_x264_enc_encode_frame (encoder, &pic_in, frame, &i_nal, TRUE);
 
@@ -430,6 +430,10 @@ struct _GstTypeFindFactory {
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
 
+  /* caps string in the registry cache, parsed on first use */
+  GBytes *                      registry_data;
+  const gchar *                 registry_caps;
+
   gpointer _gst_reserved[GST_PADDING];
 };
 
@@ -477,6 +481,12 @@ struct _GstElementFactory {
 
   GList *               interfaces;             /* interface type names this element implements */
 
+  /* metadata and pad templates in the registry cache, decoded on first use.
+   * registry_data keeps the cache contents around */
+  GBytes *              registry_data;
+  const gchar *         registry_metadata;
+  const gchar *         registry_padtemplates;
+
   /*< private >*/
   gpointer _gst_reserved[GST_PADDING];
 };
@@ -85,10 +85,18 @@ typedef struct _GstCapsImpl
   GstCaps caps;
 
   GArray *array;
+
+  /* set once the caps are in the intern table, never cleared */
+  gboolean interned;
 } GstCapsImpl;
 
 #define GST_CAPS_ARRAY(c) (((GstCapsImpl *)(c))->array)
 
+#define GST_CAPS_IS_INTERNED(c) (((GstCapsImpl *)(c))->interned)
+
+#define CAPS_ARE_INTERNED(c1,c2) \
+  (GST_CAPS_IS_INTERNED (c1) && GST_CAPS_IS_INTERNED (c2))
+
 #define GST_CAPS_LEN(c)   (GST_CAPS_ARRAY(c)->len)
 
 #define IS_WRITABLE(caps) \
@@ -131,12 +139,95 @@ static void gst_caps_transform_to_string (const GValue * src_value,
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
     const gchar * string);
 
+/* maximum number of cached operation results between interned caps */
+#define CAPS_CACHE_SIZE 256
+
+typedef enum
+{
+  CAPS_CACHE_CAN_INTERSECT,
+  CAPS_CACHE_IS_SUBSET,
+  CAPS_CACHE_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_INTERSECT_FIRST,
+} GstCapsCacheOp;
+
+typedef struct
+{
+  /* interned caps, which stay alive as long as the intern table */
+  const GstCaps *caps1;
+  const GstCaps *caps2;
+  GstCapsCacheOp op;
+
+  gboolean result;
+  GstCaps *caps;
+
+  GList link;
+} GstCapsCacheEntry;
+
+/* protects the intern table and the cache */
+G_LOCK_DEFINE_STATIC (caps_intern_lock);
+static GHashTable *caps_intern_table;
+static GHashTable *caps_cache;
+/* most recently used entries first */
+static GQueue caps_cache_lru = G_QUEUE_INIT;
+
 GType _gst_caps_type = 0;
 GstCaps *_gst_caps_any;
 GstCaps *_gst_caps_none;
 
 GST_DEFINE_MINI_OBJECT_TYPE (GstCaps, gst_caps);
 
+static guint
+gst_caps_intern_hash (gconstpointer key)
+{
+  const GstCaps *caps = key;
+  guint i, hash;
+
+  /* must be consistent with gst_caps_is_strictly_equal() */
+  if (CAPS_IS_ANY (caps))
+    return 1;
+
+  hash = GST_CAPS_LEN (caps);
+  for (i = 0; i < GST_CAPS_LEN (caps); i++) {
+    GstStructure *s = gst_caps_get_structure_unchecked (caps, i);
+
+    hash = hash * 31 + g_str_hash (gst_structure_get_name (s));
+    hash = hash * 31 + gst_structure_n_fields (s);
+  }
+
+  return hash;
+}
+
+static gboolean
+gst_caps_intern_equal (gconstpointer a, gconstpointer b)
+{
+  return gst_caps_is_strictly_equal (a, b);
+}
+
+static guint
+gst_caps_cache_entry_hash (gconstpointer key)
+{
+  const GstCapsCacheEntry *entry = key;
+
+  return (g_direct_hash (entry->caps1) * 31 +
+      g_direct_hash (entry->caps2)) * 31 + entry->op;
+}
+
+static gboolean
+gst_caps_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const GstCapsCacheEntry *ea = a, *eb = b;
+
+  return ea->caps1 == eb->caps1 && ea->caps2 == eb->caps2 && ea->op == eb->op;
+}
+
+static void
+gst_caps_cache_entry_free (GstCapsCacheEntry * entry)
+{
+  if (entry->caps)
+    gst_caps_unref (entry->caps);
+  g_free (entry);
+}
+
 void
 _priv_gst_caps_initialize (void)
 {
@@ -145,6 +236,12 @@ _priv_gst_caps_initialize (void)
   _gst_caps_any = gst_caps_new_any ();
   _gst_caps_none = gst_caps_new_empty ();
 
+  caps_intern_table = g_hash_table_new_full (gst_caps_intern_hash,
+      gst_caps_intern_equal, (GDestroyNotify) gst_caps_unref, NULL);
+  caps_cache = g_hash_table_new_full (gst_caps_cache_entry_hash,
+      gst_caps_cache_entry_equal, (GDestroyNotify) gst_caps_cache_entry_free,
+      NULL);
+
   g_value_register_transform_func (_gst_caps_type,
       G_TYPE_STRING, gst_caps_transform_to_string);
 }
@@ -152,12 +249,169 @@ _priv_gst_caps_initialize (void)
 void
 _priv_gst_caps_cleanup (void)
 {
+  G_LOCK (caps_intern_lock);
+  /* the links are embedded in the entries */
+  g_queue_init (&caps_cache_lru);
+  g_hash_table_unref (caps_cache);
+  caps_cache = NULL;
+  g_hash_table_unref (caps_intern_table);
+  caps_intern_table = NULL;
+  G_UNLOCK (caps_intern_lock);
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
   _gst_caps_none = NULL;
 }
 
+/* must be called with the intern lock */
+static GstCapsCacheEntry *
+gst_caps_cache_lookup_unlocked (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op)
+{
+  GstCapsCacheEntry key, *entry;
+
+  if (G_UNLIKELY (caps_cache == NULL))
+    return NULL;
+
+  key.caps1 = caps1;
+  key.caps2 = caps2;
+  key.op = op;
+
+  entry = g_hash_table_lookup (caps_cache, &key);
+  if (entry) {
+    g_queue_unlink (&caps_cache_lru, &entry->link);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+  }
+
+  return entry;
+}
+
+static gboolean
+gst_caps_cache_get_boolean (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, gboolean * result)
+{
+  GstCapsCacheEntry *entry;
+
+  G_LOCK (caps_intern_lock);
+  entry = gst_caps_cache_lookup_unlocked (caps1, caps2, op);
+  if (entry)
+    *result = entry->result;
+  G_UNLOCK (caps_intern_lock);
+
+  return entry != NULL;
+}
+
+static GstCaps *
+gst_caps_cache_get_caps (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op)
+{
+  GstCapsCacheEntry *entry;
+  GstCaps *caps = NULL;
+
+  G_LOCK (caps_intern_lock);
+  entry = gst_caps_cache_lookup_unlocked (caps1, caps2, op);
+  if (entry)
+    caps = gst_caps_ref (entry->caps);
+  G_UNLOCK (caps_intern_lock);
+
+  return caps;
+}
+
+static void
+gst_caps_cache_insert (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, gboolean result, GstCaps * caps)
+{
+  GstCapsCacheEntry *entry, *evicted = NULL;
+
+  G_LOCK (caps_intern_lock);
+  /* another thread might have been faster */
+  if (G_UNLIKELY (caps_cache == NULL)
+      || gst_caps_cache_lookup_unlocked (caps1, caps2, op)) {
+    G_UNLOCK (caps_intern_lock);
+    return;
+  }
+
+  entry = g_new0 (GstCapsCacheEntry, 1);
+  entry->caps1 = caps1;
+  entry->caps2 = caps2;
+  entry->op = op;
+  entry->result = result;
+  entry->caps = caps ? gst_caps_ref (caps) : NULL;
+  entry->link.data = entry;
+
+  g_hash_table_add (caps_cache, entry);
+  g_queue_push_head_link (&caps_cache_lru, &entry->link);
+
+  if (caps_cache_lru.length > CAPS_CACHE_SIZE) {
+    evicted = g_queue_pop_tail_link (&caps_cache_lru)->data;
+    g_hash_table_steal (caps_cache, evicted);
+  }
+  G_UNLOCK (caps_intern_lock);
+
+  if (evicted)
+    gst_caps_cache_entry_free (evicted);
+}
+
+/**
+ * gst_caps_intern:
+ * @caps: (transfer full): a #GstCaps
+ *
+ * Returns the canonical instance of @caps: all caps that are strictly equal
+ * (see gst_caps_is_strictly_equal()) are interned to the same #GstCaps. The
+ * interned caps are kept alive until gst_deinit() and are never writable.
+ *
+ * The results of gst_caps_intersect(), gst_caps_intersect_full(),
+ * gst_caps_can_intersect() and gst_caps_is_subset() between two interned
+ * caps are kept in a bounded cache, which makes repeated negotiations
+ * between the same caps, e.g. pad template caps, a lot cheaper. Note that the
+ * intersections returned for interned caps are shared and not writable.
+ *
+ * As interned caps are never freed, only caps that are used over and over
+ * again should be interned.
+ *
+ * Returns: (transfer full): the interned caps
+ *
+ * Since: 1.28
+ */
+GstCaps *
+gst_caps_intern (GstCaps * caps)
+{
+  GstCaps *interned;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+
+  if (GST_CAPS_IS_INTERNED (caps))
+    return caps;
+
+  G_LOCK (caps_intern_lock);
+  if (G_UNLIKELY (caps_intern_table == NULL)) {
+    G_UNLOCK (caps_intern_lock);
+    return caps;
+  }
+
+  interned = g_hash_table_lookup (caps_intern_table, caps);
+  if (interned == NULL) {
+    /* the table keeps the reference of the caller, so nobody can modify the
+     * caps anymore */
+    GST_CAPS_IS_INTERNED (caps) = TRUE;
+    GST_MINI_OBJECT_FLAG_SET (caps, GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+    g_hash_table_add (caps_intern_table, caps);
+    interned = gst_caps_ref (caps);
+    caps = NULL;
+
+    GST_CAT_TRACE (GST_CAT_CAPS, "interned caps %" GST_PTR_FORMAT, interned);
+  } else {
+    gst_caps_ref (interned);
+  }
+  G_UNLOCK (caps_intern_lock);
+
+  if (caps)
+    gst_caps_unref (caps);
+
+  return interned;
+}
+
 GstCapsFeatures *
 __gst_caps_get_features_unchecked (const GstCaps * caps, guint idx)
 {
@@ -240,6 +494,7 @@ gst_caps_init (GstCaps * caps)
    */
   GST_CAPS_ARRAY (caps) =
       g_array_new (FALSE, TRUE, sizeof (GstCapsArrayElement));
+  GST_CAPS_IS_INTERNED (caps) = FALSE;
 }
 
 /**
@@ -1688,6 +1943,11 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
     return FALSE;
 
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (subset, superset))
+      && gst_caps_cache_get_boolean (subset, superset, CAPS_CACHE_IS_SUBSET,
+          &ret))
+    return ret;
+
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1716,6 +1976,9 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
     }
   }
 
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (subset, superset)))
+    gst_caps_cache_insert (subset, superset, CAPS_CACHE_IS_SUBSET, ret, NULL);
+
   return ret;
 }
 
@@ -1898,6 +2161,7 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   GstStructure *struct2;
   GstCapsFeatures *features1;
   GstCapsFeatures *features2;
+  gboolean ret = FALSE;
 
   g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
   g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
@@ -1914,6 +2178,11 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
     return TRUE;
 
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (caps1, caps2))
+      && gst_caps_cache_get_boolean (caps1, caps2, CAPS_CACHE_CAN_INTERSECT,
+          &ret))
+    return ret;
+
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -1952,7 +2221,8 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
         features2 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
       if (gst_caps_features_is_equal (features1, features2) &&
           gst_structure_can_intersect (struct1, struct2)) {
-        return TRUE;
+        ret = TRUE;
+        goto done;
       }
       /* move down left */
       k++;
@@ -1962,7 +2232,11 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
     }
   }
 
-  return FALSE;
+done:
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (caps1, caps2)))
+    gst_caps_cache_insert (caps1, caps2, CAPS_CACHE_CAN_INTERSECT, ret, NULL);
+
+  return ret;
 }
 
 static GstCaps *
@@ -2109,6 +2383,9 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCapsCacheOp op;
+  GstCaps *res;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -2128,15 +2405,29 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
+  op = (mode == GST_CAPS_INTERSECT_FIRST) ? CAPS_CACHE_INTERSECT_FIRST :
+      CAPS_CACHE_INTERSECT_ZIG_ZAG;
+
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (caps1, caps2))
+      && (res = gst_caps_cache_get_caps (caps1, caps2, op)))
+    return res;
+
   switch (mode) {
     case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
+      res = gst_caps_intersect_first (caps1, caps2);
+      break;
     default:
       g_warning ("Unknown caps intersect mode: %d", mode);
       /* fallthrough */
     case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+      res = gst_caps_intersect_zig_zag (caps1, caps2);
+      break;
   }
+
+  if (G_UNLIKELY (CAPS_ARE_INTERNED (caps1, caps2)))
+    gst_caps_cache_insert (caps1, caps2, op, FALSE, res);
+
+  return res;
 }
 
 /**
@@ -61,6 +61,7 @@
 #include "gstinfo.h"
 #include "gsturi.h"
 #include "gstregistry.h"
+#include "gstregistrychunks.h"
 #include "gst.h"
 
 #include "glib-compat-private.h"
@@ -146,6 +147,13 @@ gst_element_factory_find (const gchar * name)
   return NULL;
 }
 
+static void
+free_static_pad_template (GstStaticPadTemplate * templ)
+{
+  gst_static_caps_cleanup (&templ->static_caps);
+  g_free (templ);
+}
+
 static void
 gst_element_factory_cleanup (GstElementFactory * factory)
 {
@@ -159,13 +167,8 @@ gst_element_factory_cleanup (GstElementFactory * factory)
     factory->type = G_TYPE_INVALID;
   }
 
-  for (item = factory->staticpadtemplates; item; item = item->next) {
-    GstStaticPadTemplate *templ = item->data;
-
-    gst_static_caps_cleanup (&templ->static_caps);
-    g_free (templ);
-  }
-  g_list_free (factory->staticpadtemplates);
+  g_list_free_full (factory->staticpadtemplates,
+      (GDestroyNotify) free_static_pad_template);
   factory->staticpadtemplates = NULL;
   factory->numpadtemplates = 0;
   factory->uri_type = GST_URI_UNKNOWN;
@@ -176,6 +179,65 @@ gst_element_factory_cleanup (GstElementFactory * factory)
 
   g_list_free (factory->interfaces);
   factory->interfaces = NULL;
+
+  factory->registry_metadata = NULL;
+  factory->registry_padtemplates = NULL;
+  if (factory->registry_data) {
+    g_bytes_unref (factory->registry_data);
+    factory->registry_data = NULL;
+  }
+}
+
+/* Factories loaded from the registry cache only parse their metadata and
+ * pad templates when somebody asks for them. Concurrent callers may both
+ * decode, the first one to store its result wins. */
+static GstStructure *
+gst_element_factory_ensure_metadata (GstElementFactory * factory)
+{
+  GstStructure *metadata = g_atomic_pointer_get (&factory->metadata);
+
+  if (G_LIKELY (metadata != NULL) || factory->registry_metadata == NULL)
+    return metadata;
+
+  metadata = gst_structure_from_string (factory->registry_metadata, NULL);
+  if (G_UNLIKELY (metadata == NULL)) {
+    GST_ERROR_OBJECT (factory,
+        "Error when trying to deserialize structure for metadata '%s'",
+        factory->registry_metadata);
+    return NULL;
+  }
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+          metadata)) {
+    gst_structure_free (metadata);
+    metadata = g_atomic_pointer_get (&factory->metadata);
+  }
+
+  return metadata;
+}
+
+static GList *
+gst_element_factory_ensure_pad_templates (GstElementFactory * factory)
+{
+  GList *templates = g_atomic_pointer_get (&factory->staticpadtemplates);
+  const gchar *end;
+
+  if (G_LIKELY (templates != NULL) || factory->registry_padtemplates == NULL)
+    return templates;
+
+  end = (const gchar *) g_bytes_get_data (factory->registry_data, NULL) +
+      g_bytes_get_size (factory->registry_data);
+  templates =
+      _priv_gst_registry_chunks_load_pad_templates
+      (factory->registry_padtemplates, end, factory->numpadtemplates);
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->staticpadtemplates,
+          NULL, templates)) {
+    g_list_free_full (templates, (GDestroyNotify) free_static_pad_template);
+    templates = g_atomic_pointer_get (&factory->staticpadtemplates);
+  }
+
+  return templates;
 }
 
 #define CHECK_METADATA_FIELD(klass, name, key)                                 \
@@ -872,9 +934,15 @@ const gchar *
 gst_element_factory_get_metadata (GstElementFactory * factory,
     const gchar * key)
 {
+  GstStructure *metadata;
+
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  metadata = gst_element_factory_ensure_metadata (factory);
+  if (metadata == NULL)
+    return NULL;
+
+  return gst_structure_get_string (metadata, key);
 }
 
 /**
@@ -896,7 +964,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
@@ -963,7 +1031,7 @@ gst_element_factory_get_static_pad_templates (GstElementFactory * factory)
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return factory->staticpadtemplates;
+  return gst_element_factory_ensure_pad_templates (factory);
 }
 
 /**
@@ -99,6 +99,13 @@
 #include <errno.h>
 #include <string.h>             /* G_VA_COPY */
 
+#include <stddef.h>             /* ptrdiff_t */
+#include <stdint.h>             /* intmax_t */
+
+#ifdef G_OS_UNIX
+#  include <signal.h>           /* SIGUSR2 for the deferred logger */
+#endif
+
 #ifdef ENABLE_GST_DEBUG_SYSLOG
 #  include <syslog.h>
 #endif
@@ -120,6 +127,9 @@
 
 static char *gst_info_printf_pointer_extension_func (const char *format,
     void *ptr);
+#ifndef GST_DISABLE_GST_DEBUG
+static gboolean gst_debug_setup_deferred_logger (FILE * log_file);
+#endif
 
 #ifdef HAVE_UNISTD_H
 #  include <unistd.h>           /* getpid on UNIX */
@@ -454,7 +464,8 @@ _priv_gst_debug_init (void)
       log_file = stderr;
     }
 
-    gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
+    if (!gst_debug_setup_deferred_logger (log_file))
+      gst_debug_add_log_function (gst_debug_log_default, log_file, NULL);
   }
 
 #ifdef ENABLE_GST_DEBUG_SYSLOG
@@ -3150,6 +3161,9 @@ _gst_log_context_cleanup (void)
 void
 _priv_gst_debug_cleanup (void)
 {
+  /* Write out pending deferred messages while the categories still exist */
+  gst_debug_remove_deferred_logger ();
+
   /* Clean up our log contexts */
   _gst_log_context_cleanup ();
 
@@ -4454,6 +4468,1124 @@ gst_debug_remove_ring_buffer_logger (void)
   gst_debug_remove_log_function (gst_ring_buffer_logger_log);
 }
 
+/* Deferred logger: the log function only captures the format string, the raw
+ * arguments and a timestamp into a per-thread ring buffer, and the actual
+ * formatting happens later from a background thread (streaming mode) or when
+ * the recorded history is dumped (flight recorder mode). */
+
+#define DEFERRED_LOG_MIN_SIZE (4 * 1024)
+#define DEFERRED_LOG_FLUSH_INTERVAL (100 * G_TIME_SPAN_MILLISECOND)
+
+typedef enum
+{
+  DEFERRED_RECORD_LITERAL = (1 << 0),
+  DEFERRED_RECORD_HAS_ID = (1 << 1),
+} GstDeferredRecordFlags;
+
+/* Followed by the file, function, object id (if any) and format (or literal
+ * message) strings, each 0-terminated, and the captured arguments. The
+ * total size is always a multiple of 8 */
+typedef struct
+{
+  guint32 size;
+  guint16 level;
+  guint16 flags;
+  gint32 line;
+  guint32 reserved;
+  GstDebugCategory *category;
+  GstClockTime elapsed;
+} GstDeferredRecord;
+
+/* tags of the captured arguments */
+#define DEFERRED_ARG_TAG_INT 'i'
+#define DEFERRED_ARG_TAG_DOUBLE 'd'
+#define DEFERRED_ARG_TAG_STRING 's'
+#define DEFERRED_ARG_TAG_NULL 'n'
+
+typedef enum
+{
+  DEFERRED_ARG_NONE,
+  DEFERRED_ARG_INT,
+  DEFERRED_ARG_DOUBLE,
+  DEFERRED_ARG_STRING,
+  DEFERRED_ARG_POINTER,
+  DEFERRED_ARG_POINTER_EXT,
+} GstDeferredArgType;
+
+typedef struct
+{
+  const gchar *start;
+  const gchar *end;
+  GstDeferredArgType type;
+  gchar length;
+  gchar ext;
+  gint n_stars;
+  gboolean star_precision;
+  gint precision;
+} GstDeferredSpec;
+
+typedef struct
+{
+  gint refcount;
+  guint generation;
+  GThread *thread;
+
+  GMutex lock;
+  guint8 *data;
+  gsize size;
+  guint64 read_pos;
+  guint64 write_pos;
+  guint dropped;
+  gboolean wakeup_sent;
+
+  /* only used by the thread owning the log */
+  GByteArray *scratch;
+} GstDeferredLog;
+
+typedef struct
+{
+  gsize offset;
+  GThread *thread;
+  GstClockTime elapsed;
+} GstDeferredEntry;
+
+typedef struct
+{
+  guint generation;
+  guint max_size_per_thread;
+  /* GST_CLOCK_TIME_NONE in streaming mode */
+  GstClockTime window;
+  FILE *file;
+
+  GMutex lock;
+  GCond cond;
+  GThread *thread;
+  gboolean running;
+  gboolean dump_pending;
+  GPtrArray *logs;
+
+  /* protects everything below and the output */
+  GMutex output_lock;
+  GByteArray *records;
+  GArray *entries;
+  GString *line;
+  GString *message;
+} GstDeferredLogger;
+
+G_LOCK_DEFINE_STATIC (deferred_logger);
+static GstDeferredLogger *deferred_logger = NULL;
+static guint deferred_logger_generation = 0;
+static FILE *deferred_logger_file = NULL;
+#ifdef G_OS_UNIX
+static volatile sig_atomic_t deferred_logger_signalled = 0;
+#endif
+
+static void
+gst_deferred_log_unref (GstDeferredLog * log)
+{
+  if (!g_atomic_int_dec_and_test (&log->refcount))
+    return;
+
+  g_mutex_clear (&log->lock);
+  g_free (log->data);
+  g_byte_array_unref (log->scratch);
+  g_free (log);
+}
+
+static GPrivate deferred_log_private =
+G_PRIVATE_INIT ((GDestroyNotify) gst_deferred_log_unref);
+
+/* Parses the conversion specification starting at the '%' @p points to.
+ * Returns %FALSE for anything that can't be captured and replayed later,
+ * like positional arguments, long doubles or %n */
+static gboolean
+gst_deferred_parse_spec (const gchar * p, GstDeferredSpec * spec)
+{
+  spec->start = p++;
+  spec->type = DEFERRED_ARG_NONE;
+  spec->length = 0;
+  spec->ext = 0;
+  spec->n_stars = 0;
+  spec->star_precision = FALSE;
+  spec->precision = -1;
+
+  if (*p == '%') {
+    spec->end = p + 1;
+    return TRUE;
+  }
+
+  while (*p != '\0' && strchr ("-+ #0'", *p))
+    p++;
+
+  if (*p == '*') {
+    spec->n_stars++;
+    p++;
+  } else {
+    while (g_ascii_isdigit (*p))
+      p++;
+  }
+  if (*p == '$')
+    return FALSE;
+
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      spec->n_stars++;
+      spec->star_precision = TRUE;
+      p++;
+    } else {
+      spec->precision = 0;
+      while (g_ascii_isdigit (*p))
+        spec->precision = spec->precision * 10 + (*p++ - '0');
+    }
+  }
+
+  switch (*p) {
+    case 'h':
+      p++;
+      if (*p == 'h')
+        p++;
+      break;
+    case 'l':
+      p++;
+      spec->length = 'l';
+      if (*p == 'l') {
+        p++;
+        spec->length = 'q';
+      }
+      break;
+    case 'q':
+    case 'j':
+    case 'z':
+    case 't':
+      spec->length = *p++;
+      break;
+    case 'L':
+      /* long double */
+      return FALSE;
+    default:
+      break;
+  }
+
+  switch (*p) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+      spec->type = DEFERRED_ARG_INT;
+      break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      spec->type = DEFERRED_ARG_DOUBLE;
+      break;
+    case 's':
+      /* wide strings are not supported */
+      if (spec->length != 0)
+        return FALSE;
+      spec->type = DEFERRED_ARG_STRING;
+      break;
+    case 'p':
+      if (p[1] == '\a' && p[2] != '\0') {
+        spec->type = DEFERRED_ARG_POINTER_EXT;
+        spec->ext = p[2];
+        p += 2;
+      } else {
+        spec->type = DEFERRED_ARG_POINTER;
+      }
+      break;
+      /* old GST_PTR_FORMAT and GST_SEGMENT_FORMAT */
+    case 'P':
+      spec->type = DEFERRED_ARG_POINTER_EXT;
+      spec->ext = 'A';
+      break;
+    case 'Q':
+      spec->type = DEFERRED_ARG_POINTER_EXT;
+      spec->ext = 'B';
+      break;
+    default:
+      return FALSE;
+  }
+
+  spec->end = p + 1;
+  return TRUE;
+}
+
+static inline void
+gst_deferred_put_int (GByteArray * buf, gint64 v)
+{
+  guint8 tag = DEFERRED_ARG_TAG_INT;
+
+  g_byte_array_append (buf, &tag, 1);
+  g_byte_array_append (buf, (const guint8 *) &v, sizeof (v));
+}
+
+static inline void
+gst_deferred_put_double (GByteArray * buf, gdouble v)
+{
+  guint8 tag = DEFERRED_ARG_TAG_DOUBLE;
+
+  g_byte_array_append (buf, &tag, 1);
+  g_byte_array_append (buf, (const guint8 *) &v, sizeof (v));
+}
+
+static inline void
+gst_deferred_put_string (GByteArray * buf, const gchar * s, gssize len)
+{
+  guint8 tag;
+
+  if (s == NULL) {
+    tag = DEFERRED_ARG_TAG_NULL;
+    g_byte_array_append (buf, &tag, 1);
+    return;
+  }
+
+  if (len < 0)
+    len = strlen (s);
+
+  tag = DEFERRED_ARG_TAG_STRING;
+  g_byte_array_append (buf, &tag, 1);
+  g_byte_array_append (buf, (const guint8 *) s, len);
+  g_byte_array_append (buf, (const guint8 *) "", 1);
+}
+
+/* Stores all arguments referenced by @format. Integers are widened to 64 bit,
+ * strings are copied and the GStreamer pointer extensions are serialized right
+ * away as the objects they point to might be gone by the time the message is
+ * formatted */
+static gboolean
+gst_deferred_capture_args (GByteArray * buf, const gchar * format,
+    va_list args)
+{
+  const gchar *p = format;
+  GstDeferredSpec spec;
+
+  while ((p = strchr (p, '%'))) {
+    gint precision, i;
+
+    if (!gst_deferred_parse_spec (p, &spec))
+      return FALSE;
+    p = spec.end;
+
+    precision = spec.precision;
+    for (i = 0; i < spec.n_stars; i++) {
+      gint v = va_arg (args, gint);
+
+      gst_deferred_put_int (buf, v);
+      if (spec.star_precision && i == spec.n_stars - 1)
+        precision = v;
+    }
+
+    switch (spec.type) {
+      case DEFERRED_ARG_NONE:
+        break;
+      case DEFERRED_ARG_INT:{
+        gint64 v;
+
+        switch (spec.length) {
+          case 'l':
+            v = va_arg (args, long);
+            break;
+          case 'q':
+            v = va_arg (args, long long);
+            break;
+          case 'j':
+            v = va_arg (args, intmax_t);
+            break;
+          case 'z':
+            v = va_arg (args, gsize);
+            break;
+          case 't':
+            v = va_arg (args, ptrdiff_t);
+            break;
+          default:
+            v = va_arg (args, gint);
+            break;
+        }
+        gst_deferred_put_int (buf, v);
+        break;
+      }
+      case DEFERRED_ARG_DOUBLE:
+        gst_deferred_put_double (buf, va_arg (args, gdouble));
+        break;
+      case DEFERRED_ARG_STRING:{
+        const gchar *s = va_arg (args, const gchar *);
+        gssize len = -1;
+
+        /* the string doesn't need to be 0-terminated with a precision */
+        if (s != NULL && precision >= 0) {
+          const gchar *nul = memchr (s, '\0', precision);
+
+          len = nul ? nul - s : precision;
+        }
+        gst_deferred_put_string (buf, s, len);
+        break;
+      }
+      case DEFERRED_ARG_POINTER:
+        gst_deferred_put_int (buf, GPOINTER_TO_SIZE (va_arg (args, gpointer)));
+        break;
+      case DEFERRED_ARG_POINTER_EXT:{
+        const gchar ext_format[] = { 'p', '\a', spec.ext, '\0' };
+        gchar *s;
+
+        s = gst_info_printf_pointer_extension_func (ext_format,
+            va_arg (args, gpointer));
+        gst_deferred_put_string (buf, s, -1);
+        g_free (s);
+        break;
+      }
+    }
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_deferred_get_int (const guint8 ** p, const guint8 * end, gint64 * v)
+{
+  if (end - *p < 1 + (gssize) sizeof (*v) || **p != DEFERRED_ARG_TAG_INT)
+    return FALSE;
+
+  memcpy (v, *p + 1, sizeof (*v));
+  *p += 1 + sizeof (*v);
+  return TRUE;
+}
+
+static gboolean
+gst_deferred_get_double (const guint8 ** p, const guint8 * end, gdouble * v)
+{
+  if (end - *p < 1 + (gssize) sizeof (*v) || **p != DEFERRED_ARG_TAG_DOUBLE)
+    return FALSE;
+
+  memcpy (v, *p + 1, sizeof (*v));
+  *p += 1 + sizeof (*v);
+  return TRUE;
+}
+
+static gboolean
+gst_deferred_get_string (const guint8 ** p, const guint8 * end,
+    const gchar ** s)
+{
+  const guint8 *nul;
+
+  if (*p >= end)
+    return FALSE;
+
+  if (**p == DEFERRED_ARG_TAG_NULL) {
+    *s = NULL;
+    *p += 1;
+    return TRUE;
+  }
+
+  if (**p != DEFERRED_ARG_TAG_STRING)
+    return FALSE;
+
+  nul = memchr (*p + 1, '\0', end - *p - 1);
+  if (nul == NULL)
+    return FALSE;
+
+  *s = (const gchar *) *p + 1;
+  *p = nul + 1;
+  return TRUE;
+}
+
+static void
+gst_deferred_append_printf (GString * str, const gchar * format, ...)
+{
+  va_list args;
+  gchar *s;
+  gint len;
+
+  va_start (args, format);
+  len = __gst_vasprintf (&s, format, args);
+  va_end (args);
+
+  if (len > 0)
+    g_string_append_len (str, s, len);
+  if (len >= 0)
+    g_free (s);
+}
+
+/* Formats @format with the captured arguments in @args into @message, exactly
+ * like gst_debug_message_get() would have done at the time of logging */
+static void
+gst_deferred_format_message (GString * message, const gchar * format,
+    const guint8 * args, const guint8 * end)
+{
+  const gchar *p = format, *pct;
+  GstDeferredSpec spec;
+
+  while ((pct = strchr (p, '%'))) {
+    gchar conversion[64];
+    gsize len = 0;
+    const gchar *c;
+
+    g_string_append_len (message, p, pct - p);
+
+    if (!gst_deferred_parse_spec (pct, &spec))
+      goto invalid;
+    p = spec.end;
+
+    if (spec.type == DEFERRED_ARG_NONE) {
+      g_string_append_c (message, '%');
+      continue;
+    }
+
+    /* rebuild the conversion with the captured '*' values filled in */
+    for (c = spec.start; c < spec.end; c++) {
+      if (*c == '*') {
+        gint64 v;
+
+        if (!gst_deferred_get_int (&args, end, &v))
+          goto invalid;
+        len += g_snprintf (conversion + len, sizeof (conversion) - len,
+            "%d", (gint) v);
+      } else {
+        conversion[len++] = *c;
+      }
+      if (len >= sizeof (conversion) - 1)
+        goto invalid;
+    }
+    conversion[len] = '\0';
+
+    switch (spec.type) {
+      case DEFERRED_ARG_INT:{
+        gint64 v;
+
+        if (!gst_deferred_get_int (&args, end, &v))
+          goto invalid;
+
+        switch (spec.length) {
+          case 'l':
+            gst_deferred_append_printf (message, conversion, (long) v);
+            break;
+          case 'q':
+            gst_deferred_append_printf (message, conversion, (long long) v);
+            break;
+          case 'j':
+            gst_deferred_append_printf (message, conversion, (intmax_t) v);
+            break;
+          case 'z':
+            gst_deferred_append_printf (message, conversion, (gsize) v);
+            break;
+          case 't':
+            gst_deferred_append_printf (message, conversion, (ptrdiff_t) v);
+            break;
+          default:
+            gst_deferred_append_printf (message, conversion, (gint) v);
+            break;
+        }
+        break;
+      }
+      case DEFERRED_ARG_DOUBLE:{
+        gdouble v;
+
+        if (!gst_deferred_get_double (&args, end, &v))
+          goto invalid;
+        gst_deferred_append_printf (message, conversion, v);
+        break;
+      }
+      case DEFERRED_ARG_STRING:{
+        const gchar *s;
+
+        if (!gst_deferred_get_string (&args, end, &s))
+          goto invalid;
+        if (s == NULL)
+          g_string_append (message, "(NULL)");
+        else
+          gst_deferred_append_printf (message, conversion, s);
+        break;
+      }
+      case DEFERRED_ARG_POINTER:{
+        gint64 v;
+
+        if (!gst_deferred_get_int (&args, end, &v))
+          goto invalid;
+        gst_deferred_append_printf (message, conversion,
+            GSIZE_TO_POINTER ((gsize) v));
+        break;
+      }
+      case DEFERRED_ARG_POINTER_EXT:{
+        const gchar *s;
+
+        if (!gst_deferred_get_string (&args, end, &s))
+          goto invalid;
+        g_string_append (message, GST_STR_NULL (s));
+        break;
+      }
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+
+  g_string_append (message, p);
+  return;
+
+invalid:
+  g_string_append (message, "(invalid deferred message)");
+}
+
+static void
+gst_deferred_log_copy_in (GstDeferredLog * log, guint64 pos,
+    const guint8 * data, gsize len)
+{
+  gsize offset = pos % log->size;
+  gsize n = MIN (len, log->size - offset);
+
+  memcpy (log->data + offset, data, n);
+  memcpy (log->data, data + n, len - n);
+}
+
+static void
+gst_deferred_log_copy_out (GstDeferredLog * log, guint64 pos,
+    guint8 * data, gsize len)
+{
+  gsize offset = pos % log->size;
+  gsize n = MIN (len, log->size - offset);
+
+  memcpy (data, log->data + offset, n);
+  memcpy (data + n, log->data, len - n);
+}
+
+static GstDeferredLog *
+gst_deferred_log_get (GstDeferredLogger * logger)
+{
+  GstDeferredLog *log = g_private_get (&deferred_log_private);
+
+  if (log != NULL && log->generation == logger->generation)
+    return log;
+
+  log = g_new0 (GstDeferredLog, 1);
+  /* one reference for the thread, one for the logger */
+  log->refcount = 2;
+  log->generation = logger->generation;
+  log->thread = g_thread_self ();
+  g_mutex_init (&log->lock);
+  log->size = logger->max_size_per_thread;
+  log->data = g_malloc (log->size);
+  log->scratch = g_byte_array_sized_new (256);
+
+  g_mutex_lock (&logger->lock);
+  g_ptr_array_add (logger->logs, log);
+  g_mutex_unlock (&logger->lock);
+
+  /* drops the log of a previous logger, if any */
+  g_private_replace (&deferred_log_private, log);
+
+  return log;
+}
+
+static void
+gst_deferred_logger_log (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message, gpointer user_data)
+{
+  GstDeferredLogger *logger = user_data;
+  GstDeferredLog *log;
+  GstDeferredRecord record;
+  GByteArray *buf;
+  const gchar *object_id;
+  guint args_offset;
+  gboolean wakeup = FALSE;
+  gchar c;
+
+  log = gst_deferred_log_get (logger);
+  buf = log->scratch;
+
+  /* same as in gst_debug_log_default() */
+  c = file[0];
+  if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':')) {
+    file = gst_path_basename (file);
+  }
+
+  record.size = 0;
+  record.level = level;
+  record.flags = 0;
+  record.line = line;
+  record.reserved = 0;
+  record.category = category;
+  record.elapsed =
+      GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+
+  /* the object might be gone later, so the id is resolved now. File and
+   * function are copied because bindings don't pass static strings */
+  object_id = gst_debug_message_get_id (message);
+
+  g_byte_array_set_size (buf, sizeof (GstDeferredRecord));
+  g_byte_array_append (buf, (const guint8 *) file, strlen (file) + 1);
+  g_byte_array_append (buf, (const guint8 *) function, strlen (function) + 1);
+  if (object_id) {
+    record.flags |= DEFERRED_RECORD_HAS_ID;
+    g_byte_array_append (buf, (const guint8 *) object_id,
+        strlen (object_id) + 1);
+  }
+  args_offset = buf->len;
+
+  if (message->message == NULL) {
+    va_list arguments;
+    gboolean captured;
+
+    g_byte_array_append (buf, (const guint8 *) message->format,
+        strlen (message->format) + 1);
+
+    G_VA_COPY (arguments, message->arguments);
+    captured = gst_deferred_capture_args (buf, message->format, arguments);
+    va_end (arguments);
+
+    if (!captured)
+      g_byte_array_set_size (buf, args_offset);
+  }
+
+  /* literal messages, already formatted messages and anything we can't
+   * capture is stored as is */
+  if (buf->len == args_offset) {
+    const gchar *message_str = gst_debug_message_get (message);
+
+    record.flags |= DEFERRED_RECORD_LITERAL;
+    message_str = GST_STR_NULL (message_str);
+    g_byte_array_append (buf, (const guint8 *) message_str,
+        strlen (message_str) + 1);
+  }
+
+  g_byte_array_set_size (buf, GST_ROUND_UP_8 (buf->len));
+  record.size = buf->len;
+  memcpy (buf->data, &record, sizeof (record));
+
+  g_mutex_lock (&log->lock);
+  if (record.size > log->size) {
+    log->dropped++;
+  } else {
+    /* overwrite the oldest records */
+    while (log->write_pos + record.size - log->read_pos > log->size) {
+      guint32 size;
+
+      gst_deferred_log_copy_out (log, log->read_pos, (guint8 *) & size,
+          sizeof (size));
+      log->read_pos += size;
+      log->dropped++;
+    }
+    gst_deferred_log_copy_in (log, log->write_pos, buf->data, record.size);
+    log->write_pos += record.size;
+
+    if (!GST_CLOCK_TIME_IS_VALID (logger->window) && !log->wakeup_sent
+        && log->write_pos - log->read_pos > log->size / 2) {
+      log->wakeup_sent = TRUE;
+      wakeup = TRUE;
+    }
+  }
+  g_mutex_unlock (&log->lock);
+
+  if (level == GST_LEVEL_ERROR && GST_CLOCK_TIME_IS_VALID (logger->window)) {
+    g_mutex_lock (&logger->lock);
+    logger->dump_pending = TRUE;
+    g_mutex_unlock (&logger->lock);
+    wakeup = TRUE;
+  }
+
+  if (wakeup)
+    g_cond_signal (&logger->cond);
+}
+
+static gint
+gst_deferred_entry_compare (gconstpointer a, gconstpointer b)
+{
+  const GstDeferredEntry *ea = a, *eb = b;
+
+  if (ea->elapsed < eb->elapsed)
+    return -1;
+  if (ea->elapsed > eb->elapsed)
+    return 1;
+  /* keep the order of a thread */
+  if (ea->offset < eb->offset)
+    return -1;
+  if (ea->offset > eb->offset)
+    return 1;
+  return 0;
+}
+
+static void
+gst_deferred_logger_write_record (GstDeferredLogger * logger,
+    const guint8 * data, GThread * thread)
+{
+  GstDeferredRecord record;
+  const gchar *file, *function, *object_id = NULL, *message_str;
+  const guint8 *args, *end;
+
+  memcpy (&record, data, sizeof (record));
+  end = data + record.size;
+
+  file = (const gchar *) data + sizeof (record);
+  function = file + strlen (file) + 1;
+  message_str = function + strlen (function) + 1;
+  if (record.flags & DEFERRED_RECORD_HAS_ID) {
+    object_id = message_str;
+    message_str = object_id + strlen (object_id) + 1;
+  }
+
+  if (!(record.flags & DEFERRED_RECORD_LITERAL)) {
+    args = (const guint8 *) message_str + strlen (message_str) + 1;
+    g_string_truncate (logger->message, 0);
+    gst_deferred_format_message (logger->message, message_str, args, end);
+    message_str = logger->message->str;
+  }
+
+  g_string_truncate (logger->line, 0);
+  if (object_id) {
+    g_string_append_printf (logger->line,
+        "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT_ID,
+        GST_TIME_ARGS (record.elapsed), _gst_getpid (), thread,
+        gst_debug_level_get_name (record.level),
+        gst_debug_category_get_name (record.category), file, record.line,
+        function, object_id, message_str);
+  } else {
+    g_string_append_printf (logger->line,
+        "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT,
+        GST_TIME_ARGS (record.elapsed), _gst_getpid (), thread,
+        gst_debug_level_get_name (record.level),
+        gst_debug_category_get_name (record.category), file, record.line,
+        function, "", message_str);
+  }
+
+  fwrite (logger->line->str, 1, logger->line->len, logger->file);
+}
+
+/* Takes all records out of the per-thread logs and writes them in timestamp
+ * order. In flight recorder mode only the records of the last window are
+ * written */
+static void
+gst_deferred_logger_flush (GstDeferredLogger * logger)
+{
+  GPtrArray *logs;
+  GstClockTime now, elapsed;
+  guint dropped = 0;
+  guint i;
+
+  g_mutex_lock (&logger->output_lock);
+
+  g_mutex_lock (&logger->lock);
+  logs = g_ptr_array_new_full (logger->logs->len,
+      (GDestroyNotify) gst_deferred_log_unref);
+  for (i = 0; i < logger->logs->len;) {
+    GstDeferredLog *log = g_ptr_array_index (logger->logs, i);
+
+    /* the thread is gone and everything was written already */
+    if (g_atomic_int_get (&log->refcount) == 1
+        && log->read_pos == log->write_pos) {
+      g_ptr_array_remove_index_fast (logger->logs, i);
+      continue;
+    }
+
+    g_atomic_int_inc (&log->refcount);
+    g_ptr_array_add (logs, log);
+    i++;
+  }
+  g_mutex_unlock (&logger->lock);
+
+  g_byte_array_set_size (logger->records, 0);
+  g_array_set_size (logger->entries, 0);
+
+  for (i = 0; i < logs->len; i++) {
+    GstDeferredLog *log = g_ptr_array_index (logs, i);
+    gsize offset = logger->records->len;
+    gsize len;
+
+    g_mutex_lock (&log->lock);
+    len = log->write_pos - log->read_pos;
+    g_byte_array_set_size (logger->records, offset + len);
+    gst_deferred_log_copy_out (log, log->read_pos,
+        logger->records->data + offset, len);
+    log->read_pos = log->write_pos;
+    if (!GST_CLOCK_TIME_IS_VALID (logger->window))
+      dropped += log->dropped;
+    log->dropped = 0;
+    log->wakeup_sent = FALSE;
+    g_mutex_unlock (&log->lock);
+
+    while (len > 0) {
+      GstDeferredEntry entry;
+      GstDeferredRecord record;
+
+      memcpy (&record, logger->records->data + offset, sizeof (record));
+
+      entry.offset = offset;
+      entry.thread = log->thread;
+      entry.elapsed = record.elapsed;
+      g_array_append_val (logger->entries, entry);
+
+      offset += record.size;
+      len -= record.size;
+    }
+  }
+
+  g_ptr_array_unref (logs);
+
+  g_array_sort (logger->entries, gst_deferred_entry_compare);
+
+  now = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  if (GST_CLOCK_TIME_IS_VALID (logger->window) && now > logger->window)
+    elapsed = now - logger->window;
+  else
+    elapsed = 0;
+
+  if (dropped > 0) {
+    fprintf (logger->file, "%" GST_TIME_FORMAT
+        " deferred logger dropped %u messages\n", GST_TIME_ARGS (now), dropped);
+  }
+
+  for (i = 0; i < logger->entries->len; i++) {
+    GstDeferredEntry *entry =
+        &g_array_index (logger->entries, GstDeferredEntry, i);
+
+    if (entry->elapsed < elapsed)
+      continue;
+
+    gst_deferred_logger_write_record (logger,
+        logger->records->data + entry->offset, entry->thread);
+  }
+  fflush (logger->file);
+
+  g_mutex_unlock (&logger->output_lock);
+}
+
+static gpointer
+gst_deferred_logger_thread_func (GstDeferredLogger * logger)
+{
+  gboolean streaming = !GST_CLOCK_TIME_IS_VALID (logger->window);
+
+  g_mutex_lock (&logger->lock);
+  while (logger->running) {
+    gboolean flush = streaming;
+
+    g_cond_wait_until (&logger->cond, &logger->lock,
+        g_get_monotonic_time () + DEFERRED_LOG_FLUSH_INTERVAL);
+    if (!logger->running)
+      break;
+
+    if (logger->dump_pending) {
+      logger->dump_pending = FALSE;
+      flush = TRUE;
+    }
+#ifdef G_OS_UNIX
+    if (deferred_logger_signalled) {
+      deferred_logger_signalled = 0;
+      flush = TRUE;
+    }
+#endif
+
+    if (flush) {
+      g_mutex_unlock (&logger->lock);
+      gst_deferred_logger_flush (logger);
+      g_mutex_lock (&logger->lock);
+    }
+  }
+  g_mutex_unlock (&logger->lock);
+
+  if (streaming)
+    gst_deferred_logger_flush (logger);
+
+  return NULL;
+}
+
+static void
+gst_deferred_logger_free (GstDeferredLogger * logger)
+{
+  G_LOCK (deferred_logger);
+  if (deferred_logger == logger)
+    deferred_logger = NULL;
+  G_UNLOCK (deferred_logger);
+
+  g_mutex_lock (&logger->lock);
+  logger->running = FALSE;
+  g_cond_signal (&logger->cond);
+  g_mutex_unlock (&logger->lock);
+  g_thread_join (logger->thread);
+
+  g_ptr_array_unref (logger->logs);
+  g_mutex_clear (&logger->lock);
+  g_cond_clear (&logger->cond);
+  g_mutex_clear (&logger->output_lock);
+  g_byte_array_unref (logger->records);
+  g_array_unref (logger->entries);
+  g_string_free (logger->line, TRUE);
+  g_string_free (logger->message, TRUE);
+  g_free (logger);
+}
+
+/**
+ * gst_debug_add_deferred_logger:
+ * @max_size_per_thread: Maximum size of the log per thread in bytes
+ * @window: the duration of the flight recorder history, or
+ *     %GST_CLOCK_TIME_NONE to write out all messages
+ *
+ * Adds a debug logger that only records the format string, the arguments and
+ * a timestamp of every message into a buffer of @max_size_per_thread bytes
+ * per thread, and formats them later on a separate thread. This moves the
+ * cost of formatting out of the streaming threads. Objects and other
+ * arguments using the GStreamer specific printf extensions like
+ * %GST_PTR_FORMAT are still serialized when logging.
+ *
+ * If @window is %GST_CLOCK_TIME_NONE, the messages are written out in
+ * timestamp order every 100 milliseconds or whenever a buffer is half full.
+ * Messages are dropped if a thread logs faster than that.
+ *
+ * Otherwise the logger works as a flight recorder: the most recent messages
+ * are kept in memory and only the messages of the last @window are written
+ * out after an error message was logged or gst_debug_deferred_logger_dump()
+ * was called.
+ *
+ * Output goes to the same place as the output of gst_debug_log_default(),
+ * so usually the default log function should be removed when using this
+ * logger. Setting the `GST_DEBUG_DEFERRED` environment variable does this
+ * automatically.
+ *
+ * The logger can be removed again with gst_debug_remove_deferred_logger().
+ * Only one logger at a time is possible.
+ *
+ * Since: 1.28
+ */
+void
+gst_debug_add_deferred_logger (guint max_size_per_thread, GstClockTime window)
+{
+  GstDeferredLogger *logger;
+
+  G_LOCK (deferred_logger);
+
+  if (deferred_logger) {
+    g_warn_if_reached ();
+    G_UNLOCK (deferred_logger);
+    return;
+  }
+
+  logger = deferred_logger = g_new0 (GstDeferredLogger, 1);
+
+  logger->generation = ++deferred_logger_generation;
+  logger->max_size_per_thread =
+      MAX (max_size_per_thread, DEFERRED_LOG_MIN_SIZE) & ~7;
+  logger->window = window;
+  logger->file = deferred_logger_file ? deferred_logger_file : stderr;
+
+  g_mutex_init (&logger->lock);
+  g_cond_init (&logger->cond);
+  logger->logs =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) gst_deferred_log_unref);
+  g_mutex_init (&logger->output_lock);
+  logger->records = g_byte_array_new ();
+  logger->entries = g_array_new (FALSE, FALSE, sizeof (GstDeferredEntry));
+  logger->line = g_string_sized_new (256);
+  logger->message = g_string_sized_new (256);
+
+  logger->running = TRUE;
+  logger->thread = g_thread_new ("gst-deferred-logger",
+      (GThreadFunc) gst_deferred_logger_thread_func, logger);
+
+  gst_debug_add_log_function (gst_deferred_logger_log, logger,
+      (GDestroyNotify) gst_deferred_logger_free);
+  G_UNLOCK (deferred_logger);
+}
+
+/**
+ * gst_debug_remove_deferred_logger:
+ *
+ * Removes any previously added deferred logger with
+ * gst_debug_add_deferred_logger(). Pending messages are written out first in
+ * streaming mode.
+ *
+ * Since: 1.28
+ */
+void
+gst_debug_remove_deferred_logger (void)
+{
+  gst_debug_remove_log_function (gst_deferred_logger_log);
+}
+
+/**
+ * gst_debug_deferred_logger_dump:
+ *
+ * Writes out all messages of the deferred logger that were not written yet.
+ * In flight recorder mode this writes the messages of the configured window.
+ * See gst_debug_add_deferred_logger() for details.
+ *
+ * Since: 1.28
+ */
+void
+gst_debug_deferred_logger_dump (void)
+{
+  G_LOCK (deferred_logger);
+  if (deferred_logger)
+    gst_deferred_logger_flush (deferred_logger);
+  G_UNLOCK (deferred_logger);
+}
+
+#ifdef G_OS_UNIX
+static void
+gst_deferred_logger_signal_handler (int signum)
+{
+  deferred_logger_signalled = 1;
+}
+#endif
+
+/* Sets up the deferred logger from GST_DEBUG_DEFERRED, which is either
+ * "stream" or the flight recorder window in seconds, optionally followed by
+ * the buffer size per thread in kB, e.g. "10" or "10:1024". Returns %FALSE
+ * if the variable is not set. */
+static gboolean
+gst_debug_setup_deferred_logger (FILE * log_file)
+{
+  const gchar *env = g_getenv ("GST_DEBUG_DEFERRED");
+  GstClockTime window = GST_CLOCK_TIME_NONE;
+  guint64 size = 1024;
+  gchar **split;
+
+  if (env == NULL || *env == '\0')
+    return FALSE;
+
+  split = g_strsplit (env, ":", 2);
+  if (g_strcmp0 (split[0], "stream") != 0) {
+    gdouble secs = g_ascii_strtod (split[0], NULL);
+
+    if (secs <= 0) {
+      g_printerr ("Invalid GST_DEBUG_DEFERRED value '%s'\n", env);
+      g_strfreev (split);
+      return FALSE;
+    }
+    window = secs * GST_SECOND;
+  }
+  if (split[1] != NULL)
+    size = MAX (g_ascii_strtoull (split[1], NULL, 10), 4);
+  g_strfreev (split);
+
+  deferred_logger_file = log_file;
+  gst_debug_add_deferred_logger (MIN (size, G_MAXUINT / 1024) * 1024, window);
+
+#ifdef G_OS_UNIX
+  /* allow dumping the flight recorder from the outside with SIGUSR2, unless
+   * the application already uses it */
+  if (GST_CLOCK_TIME_IS_VALID (window)) {
+    struct sigaction action, old_action;
+
+    if (sigaction (SIGUSR2, NULL, &old_action) == 0
+        && old_action.sa_handler == SIG_DFL) {
+      memset (&action, 0, sizeof (action));
+      action.sa_handler = gst_deferred_logger_signal_handler;
+      sigemptyset (&action.sa_mask);
+      action.sa_flags = SA_RESTART;
+      sigaction (SIGUSR2, &action, NULL);
+    }
+  }
+#endif
+
+  return TRUE;
+}
+
 #else /* GST_DISABLE_GST_DEBUG */
 #ifndef GST_REMOVE_DISABLED
 
@@ -4474,5 +5606,20 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+void
+gst_debug_add_deferred_logger (guint max_size_per_thread, GstClockTime window)
+{
+}
+
+void
+gst_debug_remove_deferred_logger (void)
+{
+}
+
+void
+gst_debug_deferred_logger_dump (void)
+{
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
@@ -1617,6 +1617,13 @@ void                  gst_debug_remove_ring_buffer_logger   (void);
 GST_API
 gchar **              gst_debug_ring_buffer_logger_get_logs (void);
 
+GST_API
+void                  gst_debug_add_deferred_logger         (guint max_size_per_thread, GstClockTime window);
+GST_API
+void                  gst_debug_remove_deferred_logger      (void);
+GST_API
+void                  gst_debug_deferred_logger_dump        (void);
+
 /**
  * GstLogContextHashFlags:
  * @GST_LOG_CONTEXT_DEFAULT: Default behavior for logging context
@@ -47,6 +47,9 @@
 #include <gst/gstregistrychunks.h>
 #include <gst/gstregistrybinary.h>
 
+/* For g_memdup2 */
+#include "glib-compat-private.h"
+
 /* IMPORTANT: Bump the version number if the plugin loader packet protocol
  * changes. Changes in the binary registry format itself are handled by
  * bumping the GST_MAGIC_BINARY_VERSION_STR
@@ -69,9 +72,15 @@ typedef struct _PendingPluginEntry
 {
   /* sequence number */
   guint32 tag;
+  /* position of the file in the registry scan */
+  guint scan_index;
   gchar *filename;
   off_t file_size;
   time_t file_mtime;
+  /* serialised plugin details received from the child, NULL if the file
+   * is to be blacklisted */
+  guint8 *details;
+  guint details_len;
 } PendingPluginEntry;
 
 struct _GstPluginLoader
@@ -105,6 +114,19 @@ struct _GstPluginLoader
      PendingPluginEntry structs */
   GList *pending_plugins;
   GList *pending_plugins_tail;
+
+  /* TRUE once PACKET_EXIT was queued for the child */
+  gboolean exit_requested;
+
+  /* Loaders of the scanner helpers that plugin files are distributed
+   * over, the first one being this loader itself. Only set on the
+   * loader handed out to the registry. */
+  GPtrArray *workers;
+  guint next_scan_index;
+
+  /* Entries the helpers answered for, shared by all workers. They are only
+   * added to the registry once all helpers are done, in scan order. */
+  GPtrArray *scanned;
 };
 
 #define PACKET_EXIT 1
@@ -113,6 +135,9 @@ struct _GstPluginLoader
 #define PACKET_PLUGIN_DETAILS 4
 #define PACKET_VERSION 5
 
+/* Default maximum number of scanner helpers running at the same time */
+#define DEFAULT_MAX_WORKERS 4
+
 #define BUF_INIT_SIZE 512
 #define BUF_GROW_EXTRA 512
 #define BUF_MAX_SIZE (32 * 1024 * 1024)
@@ -129,10 +154,16 @@ static gboolean exchange_packets (GstPluginLoader * l);
 static gboolean plugin_loader_replay_pending (GstPluginLoader * l);
 static gboolean plugin_loader_load_and_sync (GstPluginLoader * l,
     PendingPluginEntry * entry);
-static void plugin_loader_create_blacklist_plugin (GstPluginLoader * l,
+static void plugin_loader_create_blacklist_plugin (GstRegistry * registry,
     PendingPluginEntry * entry);
 static void plugin_loader_cleanup_child (GstPluginLoader * loader);
 static gboolean plugin_loader_sync_with_child (GstPluginLoader * l);
+static gboolean plugin_loader_free_one (GstPluginLoader * loader);
+static gboolean plugin_loader_load_one (GstPluginLoader * loader,
+    const gchar * filename, off_t file_size, time_t file_mtime,
+    guint scan_index);
+static void plugin_loader_add_scanned (GstRegistry * registry,
+    GPtrArray * scanned);
 
 static GstPluginLoader *
 plugin_loader_new (GstRegistry * registry)
@@ -156,8 +187,83 @@ plugin_loader_new (GstRegistry * registry)
   return l;
 }
 
+static guint
+plugin_loader_get_n_workers (void)
+{
+  const gchar *env;
+  guint n_workers;
+
+  env = g_getenv ("GST_PLUGIN_SCANNER_JOBS");
+  if (env != NULL && *env != '\0') {
+    n_workers = (guint) g_ascii_strtoull (env, NULL, 10);
+  } else {
+    n_workers = MIN (g_get_num_processors (), DEFAULT_MAX_WORKERS);
+  }
+
+  return CLAMP (n_workers, 1, 64);
+}
+
+/* Queue the exit request and flush it out, so that all helpers finish
+ * their remaining work concurrently while we wait for each in turn */
+static void
+plugin_loader_request_exit (GstPluginLoader * l)
+{
+  if (!l->child_running)
+    return;
+
+  put_packet (l, PACKET_EXIT, 0, NULL, 0);
+  while (!exchange_packets (l) && !l->rx_done) {
+    if (!plugin_loader_replay_pending (l))
+      return;
+    put_packet (l, PACKET_EXIT, 0, NULL, 0);
+  }
+  l->exit_requested = TRUE;
+}
+
+static void
+pending_plugin_entry_free (PendingPluginEntry * entry)
+{
+  g_free (entry->filename);
+  g_free (entry->details);
+  g_free (entry);
+}
+
 static gboolean
 plugin_loader_free (GstPluginLoader * loader)
+{
+  gboolean got_plugin_details = FALSE;
+  GstRegistry *registry;
+  GPtrArray *scanned;
+  guint i;
+
+  if (loader->workers == NULL)
+    return plugin_loader_free_one (loader);
+
+  registry = gst_object_ref (loader->registry);
+  scanned = loader->scanned;
+
+  for (i = 0; i < loader->workers->len; i++)
+    plugin_loader_request_exit (g_ptr_array_index (loader->workers, i));
+
+  /* The first worker is the loader itself, free it last */
+  for (i = loader->workers->len - 1; i > 0; i--) {
+    got_plugin_details |=
+        plugin_loader_free_one (g_ptr_array_index (loader->workers, i));
+  }
+  g_ptr_array_free (loader->workers, TRUE);
+  loader->workers = NULL;
+
+  got_plugin_details |= plugin_loader_free_one (loader);
+
+  plugin_loader_add_scanned (registry, scanned);
+  g_ptr_array_free (scanned, TRUE);
+  gst_object_unref (registry);
+
+  return got_plugin_details;
+}
+
+static gboolean
+plugin_loader_free_one (GstPluginLoader * loader)
 {
   GList *cur;
   gboolean got_plugin_details;
@@ -168,7 +274,8 @@ plugin_loader_free (GstPluginLoader * loader)
   } while (fsync_ret < 0 && errno == EINTR);
 
   if (loader->child_running) {
-    put_packet (loader, PACKET_EXIT, 0, NULL, 0);
+    if (!loader->exit_requested)
+      put_packet (loader, PACKET_EXIT, 0, NULL, 0);
 
     /* Swap packets with the child until it exits cleanly */
     while (!loader->rx_done) {
@@ -199,10 +306,7 @@ plugin_loader_free (GstPluginLoader * loader)
   /* Free any pending plugin entries */
   cur = loader->pending_plugins;
   while (cur) {
-    PendingPluginEntry *entry = (PendingPluginEntry *) (cur->data);
-    g_free (entry->filename);
-    g_free (entry);
-
+    pending_plugin_entry_free ((PendingPluginEntry *) (cur->data));
     cur = g_list_delete_link (cur, cur);
   }
 
@@ -211,9 +315,50 @@ plugin_loader_free (GstPluginLoader * loader)
   return got_plugin_details;
 }
 
+/* Plugin files are distributed over several scanner helpers so they get
+ * loaded in parallel. Files with the same basename always go to the same
+ * helper, and what the helpers send back is only added to the registry
+ * once all of them are done, in the order the files were scanned in. That
+ * way the registry ends up the same as with a single helper. */
 static gboolean
 plugin_loader_load (GstPluginLoader * loader, const gchar * filename,
     off_t file_size, time_t file_mtime)
+{
+  GstPluginLoader *worker;
+  gchar *basename;
+  guint idx;
+
+  if (G_UNLIKELY (loader->workers == NULL)) {
+    guint i, n_workers = plugin_loader_get_n_workers ();
+
+    GST_DEBUG_OBJECT (loader->registry, "Using up to %u scanner helpers",
+        n_workers);
+
+    loader->scanned = g_ptr_array_new_with_free_func ((GDestroyNotify)
+        pending_plugin_entry_free);
+    loader->workers = g_ptr_array_new_full (n_workers, NULL);
+    g_ptr_array_add (loader->workers, loader);
+    for (i = 1; i < n_workers; i++) {
+      GstPluginLoader *worker = plugin_loader_new (loader->registry);
+
+      worker->scanned = loader->scanned;
+      g_ptr_array_add (loader->workers, worker);
+    }
+  }
+
+  basename = g_path_get_basename (filename);
+  idx = g_str_hash (basename) % loader->workers->len;
+  g_free (basename);
+
+  worker = g_ptr_array_index (loader->workers, idx);
+
+  return plugin_loader_load_one (worker, filename, file_size, file_mtime,
+      loader->next_scan_index++);
+}
+
+static gboolean
+plugin_loader_load_one (GstPluginLoader * loader, const gchar * filename,
+    off_t file_size, time_t file_mtime, guint scan_index)
 {
   gint len;
   PendingPluginEntry *entry;
@@ -225,8 +370,9 @@ plugin_loader_load (GstPluginLoader * loader, const gchar * filename,
   GST_LOG_OBJECT (loader->registry,
       "Sending file %s to child. tag %u", filename, loader->next_tag);
 
-  entry = g_new (PendingPluginEntry, 1);
+  entry = g_new0 (PendingPluginEntry, 1);
   entry->tag = loader->next_tag++;
+  entry->scan_index = scan_index;
   entry->filename = g_strdup (filename);
   entry->file_size = file_size;
   entry->file_mtime = file_mtime;
@@ -273,12 +419,10 @@ restart:
       /* Create dummy plugin entry to block re-scanning this file */
       GST_ERROR ("Plugin file %s failed to load. Blacklisting",
           entry->filename);
-      plugin_loader_create_blacklist_plugin (l, entry);
+      g_ptr_array_add (l->scanned, entry);
       l->got_plugin_details = TRUE;
       /* Now remove this crashy plugin from the head of the list */
       l->pending_plugins = g_list_delete_link (cur, cur);
-      g_free (entry->filename);
-      g_free (entry);
       if (l->pending_plugins == NULL)
         l->pending_plugins_tail = NULL;
       if (!gst_plugin_loader_spawn (l))
@@ -334,7 +478,7 @@ plugin_loader_load_and_sync (GstPluginLoader * l, PendingPluginEntry * entry)
 }
 
 static void
-plugin_loader_create_blacklist_plugin (GstPluginLoader * l,
+plugin_loader_create_blacklist_plugin (GstRegistry * registry,
     PendingPluginEntry * entry)
 {
   GstPlugin *plugin = g_object_new (GST_TYPE_PLUGIN, NULL);
@@ -354,7 +498,75 @@ plugin_loader_create_blacklist_plugin (GstPluginLoader * l,
   plugin->desc.origin = plugin->desc.license;
 
   GST_DEBUG ("Adding blacklist plugin '%s'", plugin->desc.name);
-  gst_registry_add_plugin (l->registry, plugin);
+  gst_registry_add_plugin (registry, plugin);
+}
+
+static gint
+pending_plugin_entry_compare (gconstpointer a, gconstpointer b)
+{
+  const PendingPluginEntry *entry_a = *(const PendingPluginEntry **) a;
+  const PendingPluginEntry *entry_b = *(const PendingPluginEntry **) b;
+
+  if (entry_a->scan_index < entry_b->scan_index)
+    return -1;
+  return entry_a->scan_index > entry_b->scan_index;
+}
+
+/* Adds what the helpers sent back to the registry in the order the files
+ * were scanned in, so that which file wins for a basename and which plugin
+ * a feature name ends up with doesn't depend on which helper was faster.
+ * Like when scanning in-process, the first file with a given basename that
+ * could be loaded is the one that is kept. */
+static void
+plugin_loader_add_scanned (GstRegistry * registry, GPtrArray * scanned)
+{
+  GHashTable *basenames;
+  guint i;
+
+  g_ptr_array_sort (scanned, pending_plugin_entry_compare);
+  basenames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  for (i = 0; i < scanned->len; i++) {
+    PendingPluginEntry *entry = g_ptr_array_index (scanned, i);
+    GstPlugin *newplugin = NULL;
+    gchar *tmp;
+
+    if (entry->filename != NULL) {
+      gchar *basename = g_path_get_basename (entry->filename);
+      gboolean registered = g_hash_table_contains (basenames, basename);
+
+      g_free (basename);
+      if (registered) {
+        GST_DEBUG_OBJECT (registry, "plugin already registered, ignoring %s",
+            entry->filename);
+        continue;
+      }
+    }
+
+    if (entry->details == NULL) {
+      plugin_loader_create_blacklist_plugin (registry, entry);
+      continue;
+    }
+
+    tmp = (gchar *) entry->details;
+    if (!_priv_gst_registry_chunks_load_plugin (registry, &tmp,
+            tmp + entry->details_len, NULL, &newplugin)) {
+      /* Nothing is added for the file, so it's scanned again next time */
+      GST_ERROR_OBJECT (registry,
+          "Problems loading plugin details for %s from scanner",
+          GST_STR_NULL (entry->filename));
+      continue;
+    }
+
+    GST_OBJECT_FLAG_UNSET (newplugin, GST_PLUGIN_FLAG_CACHED);
+    GST_LOG_OBJECT (registry,
+        "marking plugin %p as registered as %s", newplugin,
+        newplugin->filename);
+    newplugin->registered = TRUE;
+    g_hash_table_add (basenames, g_strdup (newplugin->basename));
+  }
+
+  g_hash_table_destroy (basenames);
 }
 
 #ifdef __APPLE__
@@ -601,7 +813,7 @@ _gst_plugin_loader_client_run (const gchar * pipe_name)
   while (!l->rx_done && exchange_packets (l));
 
 beach:
-  plugin_loader_free (l);
+  plugin_loader_free_one (l);
 
   return res;
 }
@@ -879,8 +1091,7 @@ handle_rx_packet (GstPluginLoader * l,
           break;
         } else {
           cur = g_list_delete_link (cur, cur);
-          g_free (e->filename);
-          g_free (e);
+          pending_plugin_entry_free (e);
         }
       }
 
@@ -889,34 +1100,24 @@ handle_rx_packet (GstPluginLoader * l,
         l->pending_plugins_tail = NULL;
 
       if (payload_len > 0) {
-        GstPlugin *newplugin = NULL;
-        if (!_priv_gst_registry_chunks_load_plugin (l->registry, &tmp,
-                tmp + payload_len, &newplugin)) {
-          /* Got garbage from the child, so fail and trigger replay of plugins */
-          GST_ERROR_OBJECT (l->registry,
-              "Problems loading plugin details with tag %u from scanner", tag);
-          return FALSE;
+        /* Keep the details until all helpers are done, see
+         * plugin_loader_add_scanned() */
+        if (entry == NULL) {
+          entry = g_new0 (PendingPluginEntry, 1);
+          entry->scan_index = G_MAXUINT;
         }
-
-        GST_OBJECT_FLAG_UNSET (newplugin, GST_PLUGIN_FLAG_CACHED);
-        GST_LOG_OBJECT (l->registry,
-            "marking plugin %p as registered as %s", newplugin,
-            newplugin->filename);
-        newplugin->registered = TRUE;
+        entry->details = g_memdup2 (tmp, payload_len);
+        entry->details_len = payload_len;
+        g_ptr_array_add (l->scanned, entry);
 
         /* We got a set of plugin details - remember it for later */
         l->got_plugin_details = TRUE;
       } else if (entry != NULL) {
         /* Create a blacklist entry for this file to prevent scanning every time */
-        plugin_loader_create_blacklist_plugin (l, entry);
+        g_ptr_array_add (l->scanned, entry);
         l->got_plugin_details = TRUE;
       }
 
-      if (entry != NULL) {
-        g_free (entry->filename);
-        g_free (entry);
-      }
-
       /* Remove the plugin entry we just loaded */
       cur = l->pending_plugins;
       if (cur != NULL)
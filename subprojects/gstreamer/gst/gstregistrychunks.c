@@ -288,7 +288,7 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
     }
 
     /* save pad-templates */
-    for (walk = factory->staticpadtemplates; walk;
+    for (walk = gst_element_factory_get_static_pad_templates (factory); walk;
         walk = g_list_next (walk), ef->npadtemplates++) {
       GstStaticPadTemplate *template = walk->data;
 
@@ -298,9 +298,15 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, the still undecoded metadata from the
+     * registry cache can be written out as it is */
+    if (factory->metadata == NULL && factory->registry_metadata != NULL) {
+      gst_registry_chunks_save_const_string (list,
+          factory->registry_metadata);
+    } else {
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    }
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -333,6 +339,9 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       gst_caps_unref (fcaps);
 
       gst_registry_chunks_save_string (list, str);
+    } else if (factory->registry_caps) {
+      /* not decoded yet, the string is already simplified */
+      gst_registry_chunks_save_const_string (list, factory->registry_caps);
     } else {
       gst_registry_chunks_save_const_string (list, "");
     }
@@ -526,9 +535,8 @@ fail:
  *
  * Returns: new GstStaticPadTemplate
  */
-static gboolean
-gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
-    gchar * end)
+static GstStaticPadTemplate *
+gst_registry_chunks_load_pad_template (gchar ** in, gchar * end)
 {
   GstRegistryChunkPadTemplate *pt;
   GstStaticPadTemplate *template = NULL;
@@ -547,17 +555,73 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   unpack_const_string (*in, template->name_template, end, fail);
   unpack_const_string (*in, template->static_caps.string, end, fail);
 
-  __gst_element_factory_add_static_pad_template (factory, template);
-  GST_DEBUG ("Added pad_template %s", template->name_template);
+  GST_DEBUG ("Loaded pad_template %s", template->name_template);
 
-  return TRUE;
+  return template;
 fail:
   GST_INFO ("Reading pad template failed");
   if (template)
     g_free (template);
+  return NULL;
+}
+
+/*
+ * gst_registry_chunks_skip_pad_template:
+ *
+ * Move over the current GstRegistryChunkPadTemplate structure without
+ * decoding it.
+ */
+static gboolean
+gst_registry_chunks_skip_pad_template (gchar ** in, gchar * end)
+{
+  const gchar *str;
+
+  align (*in);
+  if (*in + sizeof (GstRegistryChunkPadTemplate) > end)
+    goto fail;
+  *in += sizeof (GstRegistryChunkPadTemplate);
+
+  unpack_string_nocopy (*in, str, end, fail);
+  unpack_string_nocopy (*in, str, end, fail);
+
+  return TRUE;
+fail:
+  GST_INFO ("Skipping pad template failed");
   return FALSE;
 }
 
+/*
+ * _priv_gst_registry_chunks_load_pad_templates:
+ * @data: the pad template chunks of an element factory
+ * @end: end of the registry data
+ * @n: the number of pad templates
+ *
+ * Decodes the pad templates of an element factory that were skipped when
+ * loading the registry cache.
+ *
+ * Returns: (transfer full): a list of #GstStaticPadTemplate
+ */
+GList *
+_priv_gst_registry_chunks_load_pad_templates (const gchar * data,
+    const gchar * end, guint n)
+{
+  GstStaticPadTemplate *template;
+  GList *templates = NULL;
+  gchar *in = (gchar *) data;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    template = gst_registry_chunks_load_pad_template (&in, (gchar *) end);
+    if (G_UNLIKELY (template == NULL)) {
+      GST_ERROR ("Error while loading binary pad template");
+      break;
+    }
+    templates = g_list_prepend (templates, template);
+  }
+
+  return g_list_reverse (templates);
+}
+
 /*
  * gst_registry_chunks_load_feature:
  *
@@ -567,7 +631,7 @@ fail:
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GBytes * backing, GstPlugin * plugin)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -626,26 +690,47 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
     if (meta_data_str && *meta_data_str) {
-      factory->metadata = gst_structure_from_string (meta_data_str, NULL);
-      if (!factory->metadata) {
-        GST_ERROR
-            ("Error when trying to deserialize structure for metadata '%s'",
-            meta_data_str);
-        goto fail;
+      if (backing) {
+        /* decoded on first use */
+        factory->registry_metadata = meta_data_str;
+      } else {
+        factory->metadata = gst_structure_from_string (meta_data_str, NULL);
+        if (!factory->metadata) {
+          GST_ERROR
+              ("Error when trying to deserialize structure for metadata '%s'",
+              meta_data_str);
+          goto fail;
+        }
       }
     }
     n = ef->npadtemplates;
     GST_DEBUG ("Element factory : npadtemplates=%d", n);
 
-    /* load pad templates */
+    /* load pad templates, or only remember where they are when the
+     * registry data stays around */
+    if (backing && n > 0) {
+      factory->registry_padtemplates = *in;
+      factory->numpadtemplates = n;
+    }
     for (i = 0; i < n; i++) {
-      if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
-                  end))) {
-        GST_ERROR ("Error while loading binary pad template");
-        goto fail;
+      GstStaticPadTemplate *template;
+
+      if (backing) {
+        if (G_UNLIKELY (!gst_registry_chunks_skip_pad_template (in, end)))
+          goto fail;
+      } else {
+        template = gst_registry_chunks_load_pad_template (in, end);
+        if (G_UNLIKELY (template == NULL)) {
+          GST_ERROR ("Error while loading binary pad template");
+          goto fail;
+        }
+        __gst_element_factory_add_static_pad_template (factory, template);
       }
     }
 
+    if (factory->registry_metadata || factory->registry_padtemplates)
+      factory->registry_data = g_bytes_ref (backing);
+
     /* load uritypes */
     if (G_UNLIKELY ((n = ef->nuriprotocols))) {
       GST_DEBUG ("Reading %d UriTypes at address %p", n, *in);
@@ -680,12 +765,18 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     unpack_element (*in, tff, GstRegistryChunkTypeFindFactory, end, fail);
     pf = (GstRegistryChunkPluginFeature *) tff;
 
-    /* load typefinder caps */
+    /* load typefinder caps, on first use if the registry data stays around */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
+    if (const_str != NULL && *const_str != '\0') {
+      if (backing) {
+        factory->registry_data = g_bytes_ref (backing);
+        factory->registry_caps = const_str;
+      } else {
+        factory->caps = gst_caps_from_string (const_str);
+      }
+    } else {
       factory->caps = NULL;
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -834,10 +925,14 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ *
+ * When @backing holds the data the plugin is read from, the features keep a
+ * reference to it and only decode their metadata, pad templates and caps on
+ * first use.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GBytes * backing, GstPlugin ** out_plugin)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -910,7 +1005,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                backing, plugin))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
@@ -171,7 +171,11 @@ _priv_gst_registry_chunks_save_plugin (GList ** list, GstRegistry * registry,
 
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar *end, GstPlugin **out_plugin);
+    gchar *end, GBytes * backing, GstPlugin **out_plugin);
+
+GList *
+_priv_gst_registry_chunks_load_pad_templates (const gchar * data,
+    const gchar * end, guint n);
 
 void
 _priv_gst_registry_chunks_save_global_header (GList ** list,
@@ -230,6 +230,7 @@ struct _GstClockEntryFutex
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  guint heap_pos;
 
   GMutex lock;
   guint cond_val;
@@ -404,6 +405,7 @@ struct _GstClockEntryPThread
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  guint heap_pos;
 
   pthread_cond_t cond;
   pthread_mutex_t lock;
@@ -536,6 +538,7 @@ struct _GstClockEntryGLib
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  guint heap_pos;
 
   GMutex lock;
   GCond cond;
@@ -578,12 +581,111 @@ struct _GstSystemClockPrivate
   gboolean starting;
   gboolean stopping;
 
-  GList *entries;
+  GPtrArray *entries;           /* min-heap of pending async entries */
+  GstClockEntry *current;       /* entry handled by the async thread */
+  gboolean current_requeued;
   GCond entries_changed;
 
   GstClockType clock_type;
+  GstClockTime wakeup_tolerance;
 };
 
+/* The pending async entries are kept in a binary min-heap ordered by entry
+ * time, the head being the entry the async thread is waiting on. Each entry
+ * stores its 1-based position in the heap (0 when not queued) so that it can
+ * be moved or removed without searching the heap.
+ *
+ * All of these must be called with the clock lock. */
+#define HEAP_ENTRY(heap,idx) ((GstClockEntryImpl *) g_ptr_array_index ((heap), (idx)))
+
+static inline void
+entry_heap_set (GPtrArray * heap, guint idx, GstClockEntryImpl * entry)
+{
+  heap->pdata[idx] = entry;
+  entry->heap_pos = idx + 1;
+}
+
+static void
+entry_heap_sift_up (GPtrArray * heap, guint idx)
+{
+  GstClockEntryImpl *entry = HEAP_ENTRY (heap, idx);
+
+  while (idx > 0) {
+    guint parent = (idx - 1) / 2;
+    GstClockEntryImpl *pentry = HEAP_ENTRY (heap, parent);
+
+    if (gst_clock_id_compare_func (pentry, entry) <= 0)
+      break;
+
+    entry_heap_set (heap, idx, pentry);
+    idx = parent;
+  }
+  entry_heap_set (heap, idx, entry);
+}
+
+static void
+entry_heap_sift_down (GPtrArray * heap, guint idx)
+{
+  GstClockEntryImpl *entry = HEAP_ENTRY (heap, idx);
+
+  while (TRUE) {
+    guint child = 2 * idx + 1;
+    GstClockEntryImpl *centry;
+
+    if (child >= heap->len)
+      break;
+
+    if (child + 1 < heap->len &&
+        gst_clock_id_compare_func (HEAP_ENTRY (heap, child + 1),
+            HEAP_ENTRY (heap, child)) < 0)
+      child++;
+
+    centry = HEAP_ENTRY (heap, child);
+    if (gst_clock_id_compare_func (entry, centry) <= 0)
+      break;
+
+    entry_heap_set (heap, idx, centry);
+    idx = child;
+  }
+  entry_heap_set (heap, idx, entry);
+}
+
+/* restore the heap order after the time of a queued entry changed */
+static void
+entry_heap_update (GPtrArray * heap, GstClockEntryImpl * entry)
+{
+  guint idx = entry->heap_pos - 1;
+
+  if (idx > 0 && gst_clock_id_compare_func (entry,
+          HEAP_ENTRY (heap, (idx - 1) / 2)) < 0)
+    entry_heap_sift_up (heap, idx);
+  else
+    entry_heap_sift_down (heap, idx);
+}
+
+static void
+entry_heap_push (GPtrArray * heap, GstClockEntryImpl * entry)
+{
+  g_ptr_array_add (heap, entry);
+  entry_heap_sift_up (heap, heap->len - 1);
+}
+
+static void
+entry_heap_remove (GPtrArray * heap, GstClockEntryImpl * entry)
+{
+  guint idx = entry->heap_pos - 1;
+
+  entry->heap_pos = 0;
+  /* moves the last entry into the hole, which then needs to be reordered */
+  g_ptr_array_remove_index_fast (heap, idx);
+  if (idx < heap->len) {
+    GstClockEntryImpl *moved = HEAP_ENTRY (heap, idx);
+
+    moved->heap_pos = idx + 1;
+    entry_heap_update (heap, moved);
+  }
+}
+
 #ifdef HAVE_POSIX_TIMERS
 # ifdef HAVE_MONOTONIC_CLOCK
 #  define DEFAULT_CLOCK_TYPE GST_CLOCK_TYPE_MONOTONIC
@@ -594,10 +696,13 @@ struct _GstSystemClockPrivate
 #define DEFAULT_CLOCK_TYPE GST_CLOCK_TYPE_MONOTONIC
 #endif
 
+#define DEFAULT_WAKEUP_TOLERANCE 0
+
 enum
 {
   PROP_0,
   PROP_CLOCK_TYPE,
+  PROP_WAKEUP_TOLERANCE,
   /* FILL ME */
 };
 
@@ -617,7 +722,7 @@ static GstClockReturn gst_system_clock_id_wait_jitter (GstClock * clock,
     GstClockEntry * entry, GstClockTimeDiff * jitter);
 static GstClockReturn gst_system_clock_id_wait_jitter_unlocked
     (GstClock * clock, GstClockEntry * entry, GstClockTimeDiff * jitter,
-    gboolean restart);
+    gboolean restart, GstClockTime tolerance);
 static GstClockReturn gst_system_clock_id_wait_async (GstClock * clock,
     GstClockEntry * entry);
 static void gst_system_clock_id_unschedule (GstClock * clock,
@@ -651,6 +756,22 @@ gst_system_clock_class_init (GstSystemClockClass * klass)
           GST_TYPE_CLOCK_TYPE, DEFAULT_CLOCK_TYPE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSystemClock:wakeup-tolerance:
+   *
+   * Async clock ids that expire within this time of the current time are
+   * fired right away instead of putting the async thread to sleep for them.
+   * This coalesces wakeups of entries that expire close together, at the
+   * expense of firing them up to this much too early.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_WAKEUP_TOLERANCE,
+      g_param_spec_uint64 ("wakeup-tolerance", "Wakeup tolerance",
+          "Fire async clock ids this much early to coalesce wakeups "
+          "(in nanoseconds)", 0, G_MAXUINT64, DEFAULT_WAKEUP_TOLERANCE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstclock_class->get_internal_time = gst_system_clock_get_internal_time;
   gstclock_class->get_resolution = gst_system_clock_get_resolution;
   gstclock_class->wait = gst_system_clock_id_wait_jitter;
@@ -672,8 +793,9 @@ gst_system_clock_init (GstSystemClock * clock)
   clock->priv = priv = gst_system_clock_get_instance_private (clock);
 
   priv->clock_type = DEFAULT_CLOCK_TYPE;
+  priv->wakeup_tolerance = DEFAULT_WAKEUP_TOLERANCE;
 
-  priv->entries = NULL;
+  priv->entries = g_ptr_array_new ();
   g_cond_init (&priv->entries_changed);
 
 #if 0
@@ -690,14 +812,14 @@ gst_system_clock_dispose (GObject * object)
   GstClock *clock = (GstClock *) object;
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstSystemClockPrivate *priv = sysclock->priv;
-  GList *entries;
+  guint i;
 
   /* else we have to stop the thread */
   GST_SYSTEM_CLOCK_LOCK (clock);
   priv->stopping = TRUE;
   /* unschedule all entries */
-  for (entries = priv->entries; entries; entries = g_list_next (entries)) {
-    GstClockEntryImpl *entry = (GstClockEntryImpl *) entries->data;
+  for (i = 0; priv->entries && i < priv->entries->len; i++) {
+    GstClockEntryImpl *entry = HEAP_ENTRY (priv->entries, i);
 
     /* We don't need to take the entry lock here because the async thread
      * would only ever look at the head entry, which is locked below and only
@@ -711,7 +833,7 @@ gst_system_clock_dispose (GObject * object)
      * next entry. Once it gets the lock it will notice that all further
      * entries are unscheduled, would remove them one by one from the list and
      * then shut down. */
-    if (!entries->prev) {
+    if (i == 0) {
       /* it was initialized before adding to the list */
       g_assert (entry->initialized);
 
@@ -730,9 +852,16 @@ gst_system_clock_dispose (GObject * object)
   priv->thread = NULL;
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "joined thread");
 
-  g_list_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
-  g_list_free (priv->entries);
-  priv->entries = NULL;
+  if (priv->entries) {
+    for (i = 0; i < priv->entries->len; i++) {
+      GstClockEntryImpl *entry = HEAP_ENTRY (priv->entries, i);
+
+      entry->heap_pos = 0;
+      gst_clock_id_unref ((GstClockID) entry);
+    }
+    g_ptr_array_free (priv->entries, TRUE);
+    priv->entries = NULL;
+  }
 
   g_cond_clear (&priv->entries_changed);
 
@@ -756,6 +885,11 @@ gst_system_clock_set_property (GObject * object, guint prop_id,
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, sysclock, "clock-type set to %d",
           sysclock->priv->clock_type);
       break;
+    case PROP_WAKEUP_TOLERANCE:
+      GST_SYSTEM_CLOCK_LOCK (sysclock);
+      sysclock->priv->wakeup_tolerance = g_value_get_uint64 (value);
+      GST_SYSTEM_CLOCK_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -772,6 +906,11 @@ gst_system_clock_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CLOCK_TYPE:
       g_value_set_enum (value, sysclock->priv->clock_type);
       break;
+    case PROP_WAKEUP_TOLERANCE:
+      GST_SYSTEM_CLOCK_LOCK (sysclock);
+      g_value_set_uint64 (value, sysclock->priv->wakeup_tolerance);
+      GST_SYSTEM_CLOCK_UNLOCK (sysclock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -857,9 +996,10 @@ gst_system_clock_obtain (void)
   return clock;
 }
 
-/* this thread reads the sorted clock entries from the queue.
+/* this thread takes the earliest clock entry from the heap.
  *
  * It waits on each of them and fires the callback when the timeout occurs.
+ * Entries expiring within the wakeup tolerance are fired without waiting.
  *
  * When an entry in the queue was canceled before we wait for it, it is
  * simply skipped.
@@ -885,10 +1025,11 @@ gst_system_clock_async_thread (GstClock * clock)
   while (!priv->stopping) {
     GstClockEntry *entry;
     GstClockTime requested;
+    GstClockTime tolerance;
     GstClockReturn res;
 
     /* check if something to be done */
-    while (priv->entries == NULL) {
+    while (priv->entries->len == 0) {
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
           "no clock entries, waiting..");
       /* wait for work to do */
@@ -900,7 +1041,10 @@ gst_system_clock_async_thread (GstClock * clock)
     }
 
     /* pick the next entry */
-    entry = priv->entries->data;
+    entry = (GstClockEntry *) HEAP_ENTRY (priv->entries, 0);
+    priv->current = entry;
+    priv->current_requeued = FALSE;
+    tolerance = priv->wakeup_tolerance;
 
     /* it was initialized before adding to the list */
     g_assert (((GstClockEntryImpl *) entry)->initialized);
@@ -941,7 +1085,7 @@ gst_system_clock_async_thread (GstClock * clock)
     /* now wait for the entry */
     res =
         gst_system_clock_id_wait_jitter_unlocked (clock, (GstClockID) entry,
-        NULL, FALSE);
+        NULL, FALSE, tolerance);
 
     switch (res) {
       case GST_CLOCK_UNSCHEDULED:
@@ -967,11 +1111,18 @@ gst_system_clock_async_thread (GstClock * clock)
               "updating periodic entry %p", entry);
 
           GST_SYSTEM_CLOCK_LOCK (clock);
+          GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) entry);
+          status = GST_CLOCK_ENTRY_STATUS (entry);
+          GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+          /* might have been unscheduled from the callback */
+          if (G_UNLIKELY (status == GST_CLOCK_UNSCHEDULED))
+            goto remove_entry;
+
+          priv->current = NULL;
           /* adjust time now */
           entry->time = requested + entry->interval;
-          /* and resort the list now */
-          priv->entries =
-              g_list_sort (priv->entries, gst_clock_id_compare_func);
+          /* and move it to its new position in the heap */
+          entry_heap_update (priv->entries, (GstClockEntryImpl *) entry);
           /* and restart */
           continue;
         } else {
@@ -992,6 +1143,7 @@ gst_system_clock_async_thread (GstClock * clock)
         GST_CLOCK_ENTRY_STATUS (entry) = GST_CLOCK_OK;
         GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
         GST_SYSTEM_CLOCK_LOCK (clock);
+        priv->current = NULL;
         continue;
       default:
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
@@ -1004,10 +1156,15 @@ gst_system_clock_async_thread (GstClock * clock)
     GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
   next_entry:
     GST_SYSTEM_CLOCK_LOCK (clock);
-
-    /* we remove the current entry and unref it */
-    priv->entries = g_list_remove (priv->entries, entry);
-    gst_clock_id_unref ((GstClockID) entry);
+  remove_entry:
+    priv->current = NULL;
+    /* we remove the current entry and unref it, unless it was re-armed in the
+     * meantime */
+    if (((GstClockEntryImpl *) entry)->heap_pos != 0
+        && !priv->current_requeued) {
+      entry_heap_remove (priv->entries, (GstClockEntryImpl *) entry);
+      gst_clock_id_unref ((GstClockID) entry);
+    }
   }
 exit:
   /* signal exit */
@@ -1114,8 +1271,8 @@ gst_system_clock_get_resolution (GstClock * clock)
  * individually. This ensures that we don't wake up possibly multiple threads
  * when unscheduling an entry.
  *
- * Entries that arrive too late are simply not waited on and a
- * GST_CLOCK_EARLY result is returned.
+ * Entries that arrive too late, or less than @tolerance before their time,
+ * are simply not waited on and a GST_CLOCK_EARLY result is returned.
  *
  * This is called with the ENTRY_LOCK but not SYSTEM_CLOCK_LOCK!
  *
@@ -1123,13 +1280,16 @@ gst_system_clock_get_resolution (GstClock * clock)
  */
 static GstClockReturn
 gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
-    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart)
+    GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart,
+    GstClockTime tolerance)
 {
   GstClockTime entryt, now;
-  GstClockTimeDiff diff;
+  GstClockTimeDiff diff, min_wait;
   GstClockReturn status;
   gint64 mono_ts;
 
+  min_wait = MAX (CLOCK_MIN_WAIT_TIME, MIN (tolerance, G_MAXINT64));
+
   /* Getting the time from the clock locks the clock, so without unlocking the
    * entry we would have a lock order violation here that can lead to deadlocks.
    *
@@ -1165,7 +1325,7 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
       " diff (time-now) %" G_GINT64_FORMAT,
       entry, GST_TIME_ARGS (entryt), GST_TIME_ARGS (now), diff);
 
-  if (G_LIKELY (diff > CLOCK_MIN_WAIT_TIME)) {
+  if (G_LIKELY (diff > min_wait)) {
 #ifdef WAIT_DEBUGGING
     GstClockTime final;
 #endif
@@ -1253,7 +1413,7 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
 
         diff = GST_CLOCK_DIFF (now, entryt);
 
-        if (diff <= CLOCK_MIN_WAIT_TIME) {
+        if (diff <= min_wait) {
           /* timeout, this is fine, we can report success now */
           GST_CLOCK_ENTRY_STATUS (entry) = status = GST_CLOCK_OK;
           GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
@@ -1320,7 +1480,7 @@ gst_system_clock_id_wait_jitter (GstClock * clock, GstClockEntry * entry,
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "waiting on entry %p", entry);
 
   status =
-      gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE);
+      gst_system_clock_id_wait_jitter_unlocked (clock, entry, jitter, TRUE, 0);
 
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK (entry_impl);
 
@@ -1361,10 +1521,9 @@ no_thread:
   return FALSE;
 }
 
-/* Add an entry to the list of pending async waits. The entry is inserted
- * in sorted order. If we inserted the entry at the head of the list, we
- * need to signal the thread as it might either be waiting on it or waiting
- * for a new entry.
+/* Add an entry to the heap of pending async waits. If the entry became the
+ * new head of the heap, we need to signal the thread as it might either be
+ * waiting on the previous head or waiting for a new entry.
  *
  * MT safe.
  */
@@ -1373,6 +1532,7 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
 {
   GstSystemClock *sysclock;
   GstSystemClockPrivate *priv;
+  GstClockEntryImpl *entry_impl = (GstClockEntryImpl *) entry;
   GstClockEntry *head;
 
   sysclock = GST_SYSTEM_CLOCK_CAST (clock);
@@ -1391,22 +1551,28 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
     goto was_unscheduled;
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
 
-  if (priv->entries)
-    head = priv->entries->data;
+  if (priv->entries->len > 0)
+    head = (GstClockEntry *) HEAP_ENTRY (priv->entries, 0);
   else
     head = NULL;
 
-  /* need to take a ref */
-  gst_clock_id_ref ((GstClockID) entry);
-
-  /* insert the entry in sorted order */
-  priv->entries = g_list_insert_sorted (priv->entries, entry,
-      gst_clock_id_compare_func);
+  if (entry_impl->heap_pos != 0) {
+    /* still queued, e.g. re-armed from its own callback. Only move it to its
+     * new position and make sure the async thread does not drop it once it
+     * is done with the previous expiration */
+    entry_heap_update (priv->entries, entry_impl);
+    if (entry == priv->current)
+      priv->current_requeued = TRUE;
+  } else {
+    /* need to take a ref */
+    gst_clock_id_ref ((GstClockID) entry);
+    entry_heap_push (priv->entries, entry_impl);
+  }
 
   /* only need to send the signal if the entry was added to the
    * front, else the thread is just waiting for another entry and
    * will get to this entry automatically. */
-  if (priv->entries->data == entry) {
+  if (head != entry && (GstClockEntry *) HEAP_ENTRY (priv->entries, 0) == entry) {
     GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
         "async entry added to head %p", head);
     if (head == NULL) {
@@ -1465,7 +1631,10 @@ was_unscheduled:
 static void
 gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
 {
+  GstSystemClockPrivate *priv = GST_SYSTEM_CLOCK_CAST (clock)->priv;
+  GstClockEntryImpl *entry_impl = (GstClockEntryImpl *) entry;
   GstClockReturn status;
+  gboolean dequeued = FALSE;
 
   GST_SYSTEM_CLOCK_LOCK (clock);
 
@@ -1485,5 +1654,16 @@ gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
     GST_SYSTEM_CLOCK_ENTRY_BROADCAST ((GstClockEntryImpl *) entry);
   }
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+
+  /* drop pending async entries from the heap right away instead of waiting
+   * for them to become the head. The entry currently handled by the async
+   * thread is removed by the thread itself. */
+  if (entry_impl->heap_pos != 0 && entry != priv->current) {
+    entry_heap_remove (priv->entries, entry_impl);
+    dequeued = TRUE;
+  }
   GST_SYSTEM_CLOCK_UNLOCK (clock);
+
+  if (dequeued)
+    gst_clock_id_unref ((GstClockID) entry);
 }
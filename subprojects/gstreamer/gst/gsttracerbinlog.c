@@ -0,0 +1,447 @@
+/* GStreamer
+ * Copyright (C) 2026 GStreamer developers
+ *
+ * gsttracerbinlog.c: binary tracer record log
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Binary tracer record log:
+ *
+ * When the environment variable GST_TRACER_BINARY_FILE is set to a file name,
+ * gst_tracer_record_log() does not format the record into a string and pass
+ * it through the debug log anymore. Instead the raw values are serialized
+ * into a per-thread ring buffer that is written to without taking any lock.
+ * A background thread periodically drains all ring buffers into the file.
+ * If a ring buffer is full, the record is dropped and counted.
+ *
+ * File format, all integers in host byte order:
+ *
+ *   header:  "GSTTRBIN" (8 bytes), guint32 version, guint32 byte order mark
+ *   blocks:  guint32 type, guint32 length, length bytes of data
+ *
+ * Block types:
+ *
+ *   RECORD:  guint32 id, then 0-terminated strings: record name, class
+ *            structure, ','-separated field names with type abbreviations
+ *            ("name=(abbr)") and the layout, one value code per field
+ *   EVENTS:  guint64 thread id, guint32 dropped, then events:
+ *            guint32 record id, guint32 payload length, guint64 time since
+ *            gst_init(), payload with the values in layout order. Strings
+ *            are stored as guint32 length followed by the (not 0-terminated)
+ *            characters.
+ *
+ * The decoder in gst-devtools/tracer/gsttr-decode.py turns such files back
+ * into the text log format understood by the tracer tools.
+ */
+
+#include "gst_private.h"
+#include "gstinfo.h"
+#include "gstutils.h"
+#include "gsttracerbinlog.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#ifndef GST_DISABLE_GST_DEBUG
+
+GST_DEBUG_CATEGORY_EXTERN (tracer_debug);
+#define GST_CAT_DEFAULT tracer_debug
+
+#define BINLOG_MAGIC "GSTTRBIN"
+#define BINLOG_VERSION 1
+#define BINLOG_BOM 0x01020304
+
+#define BINLOG_BLOCK_RECORD 1
+#define BINLOG_BLOCK_EVENTS 2
+
+/* must be a power of two */
+#define RING_SIZE (256 * 1024)
+#define RING_MASK (RING_SIZE - 1)
+
+/* events that don't fit are truncated (strings) or dropped */
+#define MAX_EVENT_SIZE 4096
+#define EVENT_HEADER_SIZE 16
+
+#define FLUSH_INTERVAL (100 * G_TIME_SPAN_MILLISECOND)
+
+typedef struct
+{
+  guint64 thread_id;
+  guint8 *data;
+
+  /* free running positions, the producer only writes write_pos and the
+   * consumer only writes read_pos */
+  guint write_pos;
+  guint read_pos;
+  guint dropped;
+
+  /* set when the owning thread exited, the ring is freed once drained */
+  gboolean orphaned;
+} BinlogRing;
+
+gboolean _priv_gst_tracer_binlog_enabled = FALSE;
+
+static FILE *binlog_file = NULL;
+static GMutex binlog_lock;      /* protects the file and the list of rings */
+static GCond binlog_cond;
+static GPtrArray *binlog_rings = NULL;
+static GThread *binlog_thread = NULL;
+static gboolean binlog_stopping = FALSE;
+static gint binlog_record_id = 0;
+
+static void
+binlog_ring_orphan (BinlogRing * ring)
+{
+  g_mutex_lock (&binlog_lock);
+  ring->orphaned = TRUE;
+  g_mutex_unlock (&binlog_lock);
+}
+
+static GPrivate binlog_ring_key =
+G_PRIVATE_INIT ((GDestroyNotify) binlog_ring_orphan);
+
+static BinlogRing *
+binlog_get_ring (void)
+{
+  BinlogRing *ring = g_private_get (&binlog_ring_key);
+
+  if (G_LIKELY (ring))
+    return ring;
+
+  ring = g_new0 (BinlogRing, 1);
+  ring->thread_id = (guint64) (guintptr) g_thread_self ();
+  ring->data = g_malloc (RING_SIZE);
+
+  g_mutex_lock (&binlog_lock);
+  g_ptr_array_add (binlog_rings, ring);
+  g_mutex_unlock (&binlog_lock);
+
+  g_private_set (&binlog_ring_key, ring);
+
+  return ring;
+}
+
+static void
+binlog_ring_free (BinlogRing * ring)
+{
+  g_free (ring->data);
+  g_free (ring);
+}
+
+/* called with the lock */
+static void
+binlog_write_block (guint32 type, const guint8 * data1, guint32 len1,
+    const guint8 * data2, guint32 len2)
+{
+  guint32 header[2];
+
+  header[0] = type;
+  header[1] = len1 + len2;
+
+  fwrite (header, sizeof (header), 1, binlog_file);
+  if (len1)
+    fwrite (data1, len1, 1, binlog_file);
+  if (len2)
+    fwrite (data2, len2, 1, binlog_file);
+}
+
+/* called with the lock, returns TRUE if the ring can be freed */
+static gboolean
+binlog_ring_drain (BinlogRing * ring)
+{
+  guint8 header[12];
+  guint read_pos, write_pos, len, offset;
+  guint32 dropped;
+
+  read_pos = ring->read_pos;
+  write_pos = (guint) g_atomic_int_get ((gint *) & ring->write_pos);
+  dropped = g_atomic_int_and (&ring->dropped, 0);
+
+  len = write_pos - read_pos;
+  if (len == 0 && dropped == 0)
+    return ring->orphaned;
+
+  memcpy (header, &ring->thread_id, 8);
+  memcpy (header + 8, &dropped, 4);
+
+  offset = read_pos & RING_MASK;
+  if (offset + len <= RING_SIZE) {
+    /* contiguous, write the events behind the header */
+    guint32 block[2] = { BINLOG_BLOCK_EVENTS, sizeof (header) + len };
+
+    fwrite (block, sizeof (block), 1, binlog_file);
+    fwrite (header, sizeof (header), 1, binlog_file);
+    if (len)
+      fwrite (ring->data + offset, len, 1, binlog_file);
+  } else {
+    guint32 first = RING_SIZE - offset;
+    guint32 block[2] = { BINLOG_BLOCK_EVENTS, sizeof (header) + len };
+
+    fwrite (block, sizeof (block), 1, binlog_file);
+    fwrite (header, sizeof (header), 1, binlog_file);
+    fwrite (ring->data + offset, first, 1, binlog_file);
+    fwrite (ring->data, len - first, 1, binlog_file);
+  }
+
+  /* hand the space back to the producer */
+  g_atomic_int_set ((gint *) & ring->read_pos, (gint) write_pos);
+
+  return ring->orphaned;
+}
+
+/* called with the lock */
+static void
+binlog_flush_unlocked (void)
+{
+  guint i;
+
+  for (i = 0; i < binlog_rings->len;) {
+    BinlogRing *ring = g_ptr_array_index (binlog_rings, i);
+
+    if (binlog_ring_drain (ring)) {
+      g_ptr_array_remove_index_fast (binlog_rings, i);
+      binlog_ring_free (ring);
+    } else {
+      i++;
+    }
+  }
+  fflush (binlog_file);
+}
+
+static gpointer
+binlog_thread_func (gpointer user_data)
+{
+  g_mutex_lock (&binlog_lock);
+  while (!binlog_stopping) {
+    gint64 end_time = g_get_monotonic_time () + FLUSH_INTERVAL;
+
+    g_cond_wait_until (&binlog_cond, &binlog_lock, end_time);
+    binlog_flush_unlocked ();
+  }
+  g_mutex_unlock (&binlog_lock);
+
+  return NULL;
+}
+
+void
+_priv_gst_tracer_binlog_init (void)
+{
+  const gchar *filename = g_getenv ("GST_TRACER_BINARY_FILE");
+  guint32 version = BINLOG_VERSION, bom = BINLOG_BOM;
+
+  if (filename == NULL || *filename == '\0')
+    return;
+
+  binlog_file = g_fopen (filename, "wb");
+  if (binlog_file == NULL) {
+    g_printerr ("Could not open tracer binary file '%s' for writing: %s\n",
+        filename, g_strerror (errno));
+    return;
+  }
+
+  fwrite (BINLOG_MAGIC, 8, 1, binlog_file);
+  fwrite (&version, sizeof (version), 1, binlog_file);
+  fwrite (&bom, sizeof (bom), 1, binlog_file);
+
+  binlog_rings = g_ptr_array_new ();
+  binlog_stopping = FALSE;
+  binlog_thread = g_thread_new ("GstTracerBinlog", binlog_thread_func, NULL);
+
+  GST_INFO ("writing binary tracer records to '%s'", filename);
+  _priv_gst_tracer_binlog_enabled = TRUE;
+}
+
+void
+_priv_gst_tracer_binlog_deinit (void)
+{
+  if (!_priv_gst_tracer_binlog_enabled)
+    return;
+
+  _priv_gst_tracer_binlog_enabled = FALSE;
+
+  g_mutex_lock (&binlog_lock);
+  binlog_stopping = TRUE;
+  g_cond_signal (&binlog_cond);
+  g_mutex_unlock (&binlog_lock);
+
+  g_thread_join (binlog_thread);
+  binlog_thread = NULL;
+
+  /* write out what is left, the rings of threads that are still alive are
+   * leaked on purpose as they might still be referenced from their TLS */
+  g_mutex_lock (&binlog_lock);
+  binlog_flush_unlocked ();
+  fclose (binlog_file);
+  binlog_file = NULL;
+  g_mutex_unlock (&binlog_lock);
+}
+
+guint32
+_priv_gst_tracer_binlog_register (const gchar * name, const gchar * spec,
+    const gchar * fields, const gchar * layout)
+{
+  GString *s;
+  guint32 id;
+
+  id = (guint32) g_atomic_int_add (&binlog_record_id, 1);
+
+  s = g_string_new (NULL);
+  g_string_append_len (s, (const gchar *) &id, sizeof (id));
+  g_string_append_len (s, name, strlen (name) + 1);
+  g_string_append_len (s, spec, strlen (spec) + 1);
+  g_string_append_len (s, fields, strlen (fields) + 1);
+  g_string_append_len (s, layout, strlen (layout) + 1);
+
+  /* written right away, so that it is in the file before any event using it */
+  g_mutex_lock (&binlog_lock);
+  if (binlog_file)
+    binlog_write_block (BINLOG_BLOCK_RECORD, (const guint8 *) s->str, s->len,
+        NULL, 0);
+  g_mutex_unlock (&binlog_lock);
+
+  g_string_free (s, TRUE);
+
+  return id;
+}
+
+static inline gboolean
+binlog_put (guint8 * event, guint * pos, gconstpointer data, guint size)
+{
+  if (G_UNLIKELY (*pos + size > MAX_EVENT_SIZE))
+    return FALSE;
+
+  memcpy (event + *pos, data, size);
+  *pos += size;
+  return TRUE;
+}
+
+static inline gboolean
+binlog_put_string (guint8 * event, guint * pos, const gchar * str)
+{
+  guint32 len = str ? strlen (str) : 0;
+
+  /* truncate overly long strings */
+  if (*pos + 4 + len > MAX_EVENT_SIZE)
+    len = MAX_EVENT_SIZE - MIN (*pos + 4, MAX_EVENT_SIZE);
+
+  if (!binlog_put (event, pos, &len, 4))
+    return FALSE;
+
+  return len == 0 || binlog_put (event, pos, str, len);
+}
+
+/* Serialize one event into the calling thread's ring. Lock-free unless this
+ * is the first event from this thread. */
+void
+_priv_gst_tracer_binlog_write (guint32 record_id, const gchar * layout,
+    va_list var_args)
+{
+  guint8 event[MAX_EVENT_SIZE];
+  guint pos = EVENT_HEADER_SIZE;
+  guint64 ts = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  BinlogRing *ring;
+  guint32 payload_len;
+  guint read_pos, write_pos, offset;
+  gboolean ok = TRUE;
+
+  for (; *layout && ok; layout++) {
+    switch (*layout) {
+      case GST_TRACER_BINLOG_INT32:{
+        gint32 v = va_arg (var_args, gint);
+        ok = binlog_put (event, &pos, &v, 4);
+        break;
+      }
+      case GST_TRACER_BINLOG_UINT32:{
+        guint32 v = va_arg (var_args, guint);
+        ok = binlog_put (event, &pos, &v, 4);
+        break;
+      }
+      case GST_TRACER_BINLOG_INT64:{
+        gint64 v = va_arg (var_args, gint64);
+        ok = binlog_put (event, &pos, &v, 8);
+        break;
+      }
+      case GST_TRACER_BINLOG_UINT64:{
+        guint64 v = va_arg (var_args, guint64);
+        ok = binlog_put (event, &pos, &v, 8);
+        break;
+      }
+      case GST_TRACER_BINLOG_DOUBLE:{
+        gdouble v = va_arg (var_args, gdouble);
+        ok = binlog_put (event, &pos, &v, 8);
+        break;
+      }
+      case GST_TRACER_BINLOG_STRING:
+        ok = binlog_put_string (event, &pos, va_arg (var_args, const gchar *));
+        break;
+      case GST_TRACER_BINLOG_POINTER:{
+        guint64 v = (guint64) (guintptr) va_arg (var_args, gpointer);
+        ok = binlog_put (event, &pos, &v, 8);
+        break;
+      }
+      case GST_TRACER_BINLOG_OBJECT:{
+        /* no fixed layout for these, use the same representation as the
+         * text log. Slow, but only used by a few records */
+        gchar *str =
+            priv_gst_string_take_and_wrap (gst_debug_print_object (va_arg
+                (var_args, gpointer)));
+        ok = binlog_put_string (event, &pos, str);
+        g_free (str);
+        break;
+      }
+      default:
+        g_assert_not_reached ();
+    }
+  }
+
+  ring = binlog_get_ring ();
+
+  if (G_UNLIKELY (!ok)) {
+    g_atomic_int_inc ((gint *) & ring->dropped);
+    return;
+  }
+
+  payload_len = pos - EVENT_HEADER_SIZE;
+  memcpy (event, &record_id, 4);
+  memcpy (event + 4, &payload_len, 4);
+  memcpy (event + 8, &ts, 8);
+
+  write_pos = ring->write_pos;
+  read_pos = (guint) g_atomic_int_get ((gint *) & ring->read_pos);
+  if (G_UNLIKELY (RING_SIZE - (write_pos - read_pos) < pos)) {
+    /* the consumer can't keep up, drop rather than block */
+    g_atomic_int_inc ((gint *) & ring->dropped);
+    return;
+  }
+
+  offset = write_pos & RING_MASK;
+  if (offset + pos <= RING_SIZE) {
+    memcpy (ring->data + offset, event, pos);
+  } else {
+    guint first = RING_SIZE - offset;
+
+    memcpy (ring->data + offset, event, first);
+    memcpy (ring->data, event + first, pos - first);
+  }
+
+  /* publish the event to the consumer */
+  g_atomic_int_set ((gint *) & ring->write_pos, (gint) (write_pos + pos));
+}
+
+#endif /* GST_DISABLE_GST_DEBUG */
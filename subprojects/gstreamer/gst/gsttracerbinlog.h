@@ -0,0 +1,77 @@
+/* GStreamer
+ * Copyright (C) 2026 GStreamer developers
+ *
+ * gsttracerbinlog.h: binary tracer record log
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_TRACER_BINLOG_H__
+#define __GST_TRACER_BINLOG_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* value codes used in the record layout, one per logged value */
+#define GST_TRACER_BINLOG_INT32         'i'  /* int, boolean, enum, flags */
+#define GST_TRACER_BINLOG_UINT32        'u'
+#define GST_TRACER_BINLOG_INT64         'I'
+#define GST_TRACER_BINLOG_UINT64        'U'
+#define GST_TRACER_BINLOG_DOUBLE        'd'  /* float, double */
+#define GST_TRACER_BINLOG_STRING        's'  /* string, gtype name */
+#define GST_TRACER_BINLOG_POINTER       'p'
+#define GST_TRACER_BINLOG_OBJECT        'o'  /* structure, anything else */
+
+#ifndef GST_DISABLE_GST_DEBUG
+
+G_GNUC_INTERNAL
+extern gboolean _priv_gst_tracer_binlog_enabled;
+
+G_GNUC_INTERNAL
+void      _priv_gst_tracer_binlog_init     (void);
+
+G_GNUC_INTERNAL
+void      _priv_gst_tracer_binlog_deinit   (void);
+
+G_GNUC_INTERNAL
+guint32   _priv_gst_tracer_binlog_register (const gchar * name,
+                                            const gchar * spec,
+                                            const gchar * fields,
+                                            const gchar * layout);
+
+G_GNUC_INTERNAL
+void      _priv_gst_tracer_binlog_write    (guint32 record_id,
+                                            const gchar * layout,
+                                            va_list var_args);
+
+#else /* GST_DISABLE_GST_DEBUG */
+
+static inline void
+_priv_gst_tracer_binlog_init (void)
+{
+}
+
+static inline void
+_priv_gst_tracer_binlog_deinit (void)
+{
+}
+
+#endif /* GST_DISABLE_GST_DEBUG */
+
+G_END_DECLS
+
+#endif /* __GST_TRACER_BINLOG_H__ */
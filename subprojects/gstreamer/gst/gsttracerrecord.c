@@ -35,6 +35,7 @@
 #include "gstinfo.h"
 #include "gststructure.h"
 #include "gsttracerrecord.h"
+#include "gsttracerbinlog.h"
 #include "gstvalue.h"
 #include <gobject/gvaluecollector.h>
 
@@ -47,6 +48,10 @@ struct _GstTracerRecord
 
   GstStructure *spec;
   gchar *format;
+
+  /* binary log */
+  guint32 id;
+  gchar *layout;
 };
 
 struct _GstTracerRecordClass
@@ -57,11 +62,51 @@ struct _GstTracerRecordClass
 #define gst_tracer_record_parent_class parent_class
 G_DEFINE_TYPE (GstTracerRecord, gst_tracer_record, GST_TYPE_OBJECT);
 
+typedef struct
+{
+  GString *format;
+  GString *fields;
+  GString *layout;
+} FieldTemplate;
+
+static gchar
+get_layout_code (GType type)
+{
+  if (type == G_TYPE_INT || type == G_TYPE_BOOLEAN
+      || g_type_is_a (type, G_TYPE_ENUM) || g_type_is_a (type, G_TYPE_FLAGS))
+    return GST_TRACER_BINLOG_INT32;
+  else if (type == G_TYPE_UINT)
+    return GST_TRACER_BINLOG_UINT32;
+  else if (type == G_TYPE_INT64)
+    return GST_TRACER_BINLOG_INT64;
+  else if (type == G_TYPE_UINT64)
+    return GST_TRACER_BINLOG_UINT64;
+  else if (type == G_TYPE_FLOAT || type == G_TYPE_DOUBLE)
+    return GST_TRACER_BINLOG_DOUBLE;
+  else if (type == G_TYPE_STRING || type == G_TYPE_GTYPE)
+    return GST_TRACER_BINLOG_STRING;
+  else if (type == G_TYPE_POINTER)
+    return GST_TRACER_BINLOG_POINTER;
+  else
+    return GST_TRACER_BINLOG_OBJECT;
+}
+
+static void
+append_field_layout (FieldTemplate * t, const gchar * name, GType type)
+{
+  if (t->fields->len)
+    g_string_append_c (t->fields, ',');
+  g_string_append_printf (t->fields, "%s=(%s)", name,
+      _priv_gst_value_gtype_to_abbr (type));
+  g_string_append_c (t->layout, get_layout_code (type));
+}
+
 static gboolean
 build_field_template (const GstIdStr * field, const GValue * value,
     gpointer user_data)
 {
-  GString *s = (GString *) user_data;
+  FieldTemplate *t = (FieldTemplate *) user_data;
+  GString *s = t->format;
   const GstStructure *sub;
   GValue template_value = { 0, };
   GType type = G_TYPE_INVALID;
@@ -86,6 +131,7 @@ build_field_template (const GstIdStr * field, const GValue * value,
     priv__gst_structure_append_template_to_gstring (opt_name, &template_value,
         s);
     g_value_unset (&template_value);
+    append_field_layout (t, opt_name, G_TYPE_BOOLEAN);
     g_free (opt_name);
   }
 
@@ -94,6 +140,7 @@ build_field_template (const GstIdStr * field, const GValue * value,
       priv__gst_structure_append_template_to_gstring (gst_id_str_as_str (field),
       &template_value, s);
   g_value_unset (&template_value);
+  append_field_layout (t, gst_id_str_as_str (field), type);
   return res;
 }
 
@@ -101,6 +148,7 @@ static void
 gst_tracer_record_build_format (GstTracerRecord * self)
 {
   GstStructure *structure = self->spec;
+  FieldTemplate t;
   GString *s;
   gchar *name = (gchar *) gst_structure_get_name (structure);
   gchar *p;
@@ -118,11 +166,26 @@ gst_tracer_record_build_format (GstTracerRecord * self)
 
   s = g_string_sized_new (STRUCTURE_ESTIMATED_STRING_LEN (structure));
   g_string_append (s, name);
-  gst_structure_foreach_id_str (structure, build_field_template, s);
+  t.format = s;
+  t.fields = g_string_new (NULL);
+  t.layout = g_string_new (NULL);
+  gst_structure_foreach_id_str (structure, build_field_template, &t);
   g_string_append_c (s, ';');
 
   self->format = g_string_free (s, FALSE);
   GST_DEBUG ("new format string: %s", self->format);
+
+#ifndef GST_DISABLE_GST_DEBUG
+  if (_priv_gst_tracer_binlog_enabled) {
+    gchar *spec = gst_structure_to_string (structure);
+
+    self->id = _priv_gst_tracer_binlog_register (name, spec, t.fields->str,
+        t.layout->str);
+    g_free (spec);
+  }
+#endif
+  self->layout = g_string_free (t.layout, FALSE);
+  g_string_free (t.fields, TRUE);
   g_free (name);
 }
 
@@ -137,6 +200,8 @@ gst_tracer_record_dispose (GObject * object)
   }
   g_free (self->format);
   self->format = NULL;
+  g_free (self->layout);
+  self->layout = NULL;
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -248,7 +313,9 @@ gst_tracer_record_new (const gchar * name, const gchar * firstfield, ...)
  * Serialzes the trace event into the log.
  *
  * Right now this is using the gstreamer debug log with the level TRACE (7) and
- * the category "GST_TRACER".
+ * the category "GST_TRACER". If the environment variable
+ * `GST_TRACER_BINARY_FILE` is set, the values are instead serialized in
+ * binary form into that file without formatting them.
  *
  * > Please note that this is still under discussion and subject to change.
  *
@@ -272,7 +339,9 @@ gst_tracer_record_log (GstTracerRecord * self, ...)
    */
 
   va_start (var_args, self);
-  if (G_LIKELY (GST_LEVEL_TRACE <= _gst_debug_min)) {
+  if (_priv_gst_tracer_binlog_enabled) {
+    _priv_gst_tracer_binlog_write (self->id, self->layout, var_args);
+  } else if (G_LIKELY (GST_LEVEL_TRACE <= _gst_debug_min)) {
     gst_debug_log_valist (GST_CAT_DEFAULT, GST_LEVEL_TRACE, "", "", 0, NULL,
         self->format, var_args);
   }
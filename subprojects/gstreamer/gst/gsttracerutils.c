@@ -34,6 +34,7 @@
 #include "gst_private.h"
 #include "gsttracer.h"
 #include "gsttracerfactory.h"
+#include "gsttracerbinlog.h"
 #include "gstvalue.h"
 #include "gsttracerutils.h"
 
@@ -295,6 +296,9 @@ _priv_gst_tracing_init (void)
         g_quark_from_static_string (_quark_strings[i]);
   }
 
+  /* must be set up before tracers create their records */
+  _priv_gst_tracer_binlog_init ();
+
   if (env != NULL && *env != '\0') {
     GstRegistry *registry = gst_registry_get ();
     GstPluginFeature *feature;
@@ -373,6 +377,9 @@ _priv_gst_tracing_deinit (void)
   g_list_free (h_list);
   g_hash_table_destroy (_priv_tracers);
   _priv_tracers = NULL;
+
+  /* after the tracers wrote their final reports */
+  _priv_gst_tracer_binlog_deinit ();
 }
 
 static void
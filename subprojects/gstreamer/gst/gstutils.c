@@ -1412,12 +1412,12 @@ static gboolean
 gst_element_factory_can_accept_all_caps_in_direction (GstElementFactory *
     factory, const GstCaps * caps, GstPadDirection direction)
 {
-  GList *templates;
+  const GList *templates;
 
   g_return_val_if_fail (factory != NULL, FALSE);
   g_return_val_if_fail (caps != NULL, FALSE);
 
-  templates = factory->staticpadtemplates;
+  templates = gst_element_factory_get_static_pad_templates (factory);
 
   while (templates) {
     GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
@@ -1441,12 +1441,12 @@ static gboolean
 gst_element_factory_can_accept_any_caps_in_direction (GstElementFactory *
     factory, const GstCaps * caps, GstPadDirection direction)
 {
-  GList *templates;
+  const GList *templates;
 
   g_return_val_if_fail (factory != NULL, FALSE);
   g_return_val_if_fail (caps != NULL, FALSE);
 
-  templates = factory->staticpadtemplates;
+  templates = gst_element_factory_get_static_pad_templates (factory);
 
   while (templates) {
     GstStaticPadTemplate *template = (GstStaticPadTemplate *) templates->data;
@@ -111,7 +111,9 @@
  * this, some functions like gst_adapter_available_fast() are provided to help
  * speed up such cases should you want to. To avoid repeated memory allocations,
  * gst_adapter_copy() can be used to copy data into a (statically allocated)
- * user provided buffer.
+ * user provided buffer. Elements that map data across buffer boundaries for
+ * every frame, like parsers, can also enable gst_adapter_set_keep_assembled()
+ * so that merged data is reused after flushing instead of being merged again.
  *
  * #GstAdapter is not MT safe. All operations on an adapter must be serialized by
  * the caller. This is not normally a problem, however, as the normal use case
@@ -151,6 +153,9 @@ struct _GstAdapter
   gpointer assembled_data;
   gsize assembled_size;
   gsize assembled_len;
+  /* start of the assembled data, only non-zero with keep_assembled */
+  gsize assembled_offset;
+  gboolean keep_assembled;
 
   GstClockTime pts;
   guint64 pts_distance;
@@ -269,6 +274,7 @@ gst_adapter_clear (GstAdapter * adapter)
   adapter->size = 0;
   adapter->skip = 0;
   adapter->assembled_len = 0;
+  adapter->assembled_offset = 0;
   adapter->pts = GST_CLOCK_TIME_NONE;
   adapter->pts_distance = 0;
   adapter->dts = GST_CLOCK_TIME_NONE;
@@ -283,6 +289,86 @@ gst_adapter_clear (GstAdapter * adapter)
   adapter->scan_entry_idx = G_MAXUINT;
 }
 
+/**
+ * gst_adapter_set_keep_assembled:
+ * @adapter: a #GstAdapter
+ * @keep_assembled: whether to keep assembled data around after flushing
+ *
+ * When data spanning multiple buffers is mapped, @adapter copies it into an
+ * internal area. By default this data is dropped on the next flush, and
+ * mapping the following bytes copies them again.
+ *
+ * With @keep_assembled, flushing only moves the start of the assembled data
+ * forward, so that it can be mapped again without any copy. Only the missing
+ * bytes are copied at the end and the area is compacted or grown as needed.
+ * Once the area is large enough for the biggest mapping, no more memory is
+ * allocated for mapping data across buffers, and gst_adapter_take() does not
+ * replace the area anymore.
+ *
+ * Since: 1.28
+ */
+void
+gst_adapter_set_keep_assembled (GstAdapter * adapter, gboolean keep_assembled)
+{
+  g_return_if_fail (GST_IS_ADAPTER (adapter));
+
+  if (adapter->keep_assembled == keep_assembled)
+    return;
+
+  /* the rest of the code expects the assembled data at the start */
+  if (!keep_assembled && adapter->assembled_offset > 0) {
+    memmove (adapter->assembled_data,
+        (guint8 *) adapter->assembled_data + adapter->assembled_offset,
+        adapter->assembled_len);
+    adapter->assembled_offset = 0;
+  }
+
+  adapter->keep_assembled = keep_assembled;
+}
+
+/**
+ * gst_adapter_get_keep_assembled:
+ * @adapter: a #GstAdapter
+ *
+ * Returns: whether @adapter keeps assembled data around after flushing,
+ *     see gst_adapter_set_keep_assembled().
+ *
+ * Since: 1.28
+ */
+gboolean
+gst_adapter_get_keep_assembled (GstAdapter * adapter)
+{
+  g_return_val_if_fail (GST_IS_ADAPTER (adapter), FALSE);
+
+  return adapter->keep_assembled;
+}
+
+/* Makes room for @size bytes of assembled data when keeping assembled data
+ * around. The data is moved to the start of the area, which is only replaced
+ * if it is too small. */
+static void
+gst_adapter_reserve_assembled (GstAdapter * adapter, gsize size)
+{
+  guint8 *data = (guint8 *) adapter->assembled_data + adapter->assembled_offset;
+
+  if (G_UNLIKELY (adapter->assembled_size < size)) {
+    gpointer old = adapter->assembled_data;
+
+    while (adapter->assembled_size < size)
+      adapter->assembled_size *= 2;
+    GST_DEBUG_OBJECT (adapter, "resizing internal buffer to %" G_GSIZE_FORMAT,
+        adapter->assembled_size);
+    adapter->assembled_data = g_malloc (adapter->assembled_size);
+    memcpy (adapter->assembled_data, data, adapter->assembled_len);
+    g_free (old);
+  } else if (adapter->assembled_offset + size > adapter->assembled_size) {
+    GST_CAT_LOG_OBJECT (GST_CAT_PERFORMANCE, adapter,
+        "memmove %" G_GSIZE_FORMAT " bytes", adapter->assembled_len);
+    memmove (adapter->assembled_data, data, adapter->assembled_len);
+  }
+  adapter->assembled_offset = 0;
+}
+
 static inline void
 update_timestamps_and_offset (GstAdapter * adapter, GstBuffer * buf)
 {
@@ -502,7 +588,7 @@ gst_adapter_map (GstAdapter * adapter, gsize size)
 
   /* we have enough assembled data, return it */
   if (adapter->assembled_len >= size)
-    return adapter->assembled_data;
+    return (guint8 *) adapter->assembled_data + adapter->assembled_offset;
 
 #if 0
   do {
@@ -529,7 +615,10 @@ gst_adapter_map (GstAdapter * adapter, gsize size)
   tocopy = size - toreuse;
 
   /* Gonna need to copy stuff out */
-  if (G_UNLIKELY (adapter->assembled_size < size)) {
+  if (adapter->keep_assembled) {
+    if (adapter->assembled_offset + size > adapter->assembled_size)
+      gst_adapter_reserve_assembled (adapter, size);
+  } else if (G_UNLIKELY (adapter->assembled_size < size)) {
     adapter->assembled_size = (size / DEFAULT_SIZE + 1) * DEFAULT_SIZE;
     GST_DEBUG_OBJECT (adapter, "resizing internal buffer to %" G_GSIZE_FORMAT,
         adapter->assembled_size);
@@ -549,11 +638,11 @@ gst_adapter_map (GstAdapter * adapter, gsize size)
   }
   GST_CAT_DEBUG (GST_CAT_PERFORMANCE, "copy remaining %" G_GSIZE_FORMAT
       " bytes from adapter", tocopy);
-  data = adapter->assembled_data;
+  data = (guint8 *) adapter->assembled_data + adapter->assembled_offset;
   copy_into_unchecked (adapter, data + toreuse, skip + toreuse, tocopy);
   adapter->assembled_len = size;
 
-  return adapter->assembled_data;
+  return data;
 }
 
 /**
@@ -638,7 +727,14 @@ gst_adapter_flush_unchecked (GstAdapter * adapter, gsize flush)
 
   /* clear state */
   adapter->size -= flush;
-  adapter->assembled_len = 0;
+  if (adapter->keep_assembled && flush < adapter->assembled_len) {
+    /* the rest of the assembled data is still valid */
+    adapter->assembled_offset += flush;
+    adapter->assembled_len -= flush;
+  } else {
+    adapter->assembled_offset = 0;
+    adapter->assembled_len = 0;
+  }
 
   /* take skip into account */
   flush += adapter->skip;
@@ -720,7 +816,19 @@ gst_adapter_get_internal (GstAdapter * adapter, gsize nbytes)
   tocopy = nbytes - toreuse;
 
   /* find memory to return */
-  if (adapter->assembled_size >= nbytes && toreuse > 0) {
+  if (adapter->keep_assembled) {
+    /* the assembled area stays with the adapter, the remaining assembled
+     * data is used again after flushing */
+    GST_LOG_OBJECT (adapter, "allocating %" G_GSIZE_FORMAT " bytes", nbytes);
+    data = g_malloc (nbytes);
+    if (toreuse) {
+      GST_CAT_LOG_OBJECT (GST_CAT_PERFORMANCE, adapter,
+          "memcpy %" G_GSIZE_FORMAT " bytes", toreuse);
+      memcpy (data,
+          (guint8 *) adapter->assembled_data + adapter->assembled_offset,
+          toreuse);
+    }
+  } else if (adapter->assembled_size >= nbytes && toreuse > 0) {
     /* we reuse already allocated memory but only when we're going to reuse
      * something from it because else we are worse than the malloc and copy
      * case below */
@@ -60,6 +60,12 @@ void                    gst_adapter_clear               (GstAdapter *adapter);
 GST_BASE_API
 void                    gst_adapter_push                (GstAdapter *adapter, GstBuffer* buf);
 
+GST_BASE_API
+void                    gst_adapter_set_keep_assembled  (GstAdapter *adapter, gboolean keep_assembled);
+
+GST_BASE_API
+gboolean                gst_adapter_get_keep_assembled  (GstAdapter *adapter);
+
 GST_BASE_API
 gconstpointer           gst_adapter_map                 (GstAdapter *adapter, gsize size);
 
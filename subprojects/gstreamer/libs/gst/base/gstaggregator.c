@@ -40,6 +40,12 @@
  *
  *  * When data is queued on all pads, the aggregate vmethod is called.
  *
+ *  * Per-pad work that does not depend on other pads, like converting the
+ *    input to the output format, can be done in the
+ *    #GstAggregatorPadClass::prepare virtual method. It is called for all
+ *    pads with a new buffer right before the aggregate vmethod, in parallel
+ *    for different pads.
+ *
  *  * One can peek at the data on any given GstAggregatorPad with the
  *    gst_aggregator_pad_peek_buffer() method, and remove it from the pad
  *    with the gst_aggregator_pad_pop_buffer () method. When a buffer
@@ -261,6 +267,8 @@ struct _GstAggregatorPadPrivate
   guint num_buffers;
   guint64 num_bytes;
   GstBuffer *peeked_buffer;
+  /* last buffer GstAggregatorPadClass::prepare was called with */
+  GstBuffer *prepared_buffer;
 
   /* TRUE if the serialized query is in the proccess of handling at some
    * exact moment. This will obligate the sinkpad streaming thread wait
@@ -284,6 +292,10 @@ struct _GstAggregatorPadPrivate
   /* number of queued stream-start */
   gboolean stream_start_pending;
 
+  /* Whether the srcpad thread is waiting for a buffer on this pad, protected
+   * by both the SRC_LOCK and the PAD_LOCK */
+  gboolean waited_on;
+
   GMutex lock;
   GCond event_cond;
   /* This lock prevents a flush start processing happening while
@@ -322,6 +334,7 @@ gst_aggregator_pad_flush (GstAggregatorPad * aggpad, GstAggregator * agg)
 
   PAD_LOCK (aggpad);
   gst_aggregator_pad_reset_unlocked (aggpad);
+  gst_buffer_replace (&aggpad->priv->prepared_buffer, NULL);
   PAD_UNLOCK (aggpad);
 
   if (klass->flush)
@@ -403,6 +416,17 @@ struct _GstAggregatorPrivate
   GMutex src_lock;
   GCond src_cond;
 
+  /* Number of pads the srcpad thread is waiting for a buffer on before it can
+   * aggregate, or -1 if it has to be woken up for every buffer. Protected by
+   * src_lock */
+  gint n_pads_waiting;
+  guint64 n_wakeups;            /* protected by src_lock */
+  guint64 n_spurious_wakeups;   /* protected by src_lock */
+
+  /* Used for running GstAggregatorPadClass::prepare in parallel, only
+   * accessed from the srcpad thread or when it is stopped */
+  GstTaskPool *prepare_pool;
+
   gboolean first_buffer;        /* protected by object lock */
   GstAggregatorStartTimeSelection start_time_selection;
   GstClockTime start_time;
@@ -455,6 +479,7 @@ enum
   PROP_START_TIME_SELECTION,
   PROP_START_TIME,
   PROP_EMIT_SIGNALS,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -481,6 +506,11 @@ gst_aggregator_pad_queue_is_empty (GstAggregatorPad * pad)
  *
  * Only returns TRUE if all non-EOS pads have a buffer available at the top of
  * their queue or a clipped buffer already.
+ *
+ * Also remembers the pads that have no buffer yet, so that only the buffer
+ * making the last of them ready has to wake up the srcpad thread.
+ *
+ * Must be called with SRC_LOCK held.
  */
 static gboolean
 gst_aggregator_check_pads_ready (GstAggregator * self,
@@ -496,6 +526,8 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
 
   GST_OBJECT_LOCK (self);
 
+  self->priv->n_pads_waiting = 0;
+
   sinkpads = GST_ELEMENT_CAST (self)->sinkpads;
   if (sinkpads == NULL)
     goto no_sinkpads;
@@ -505,6 +537,8 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
 
     PAD_LOCK (pad);
 
+    pad->priv->waited_on = FALSE;
+
     /* If there's an event or query at the top of the queue and we don't yet
      * have taken the top buffer out and stored it as clip_buffer, remember
      * that and exit the loop. We first have to handle all events/queries
@@ -539,6 +573,8 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
       if (!pad->priv->eos) {
         GST_LOG_OBJECT (pad, "Have no buffer and not EOS yet");
         have_buffer = FALSE;
+        pad->priv->waited_on = TRUE;
+        self->priv->n_pads_waiting++;
       } else {
         GST_LOG_OBJECT (pad, "Have no buffer and already EOS");
         n_ready++;
@@ -585,6 +621,7 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
 no_sinkpads:
   {
     GST_LOG_OBJECT (self, "pads not ready: no sink pads");
+    self->priv->n_pads_waiting = -1;
     GST_OBJECT_UNLOCK (self);
 
     if (have_event_or_query_ret)
@@ -606,6 +643,7 @@ pad_not_ready_but_event_or_query:
   {
     GST_LOG_OBJECT (self,
         "pad not ready to be aggregated yet, need to handle serialized event or query first");
+    self->priv->n_pads_waiting = -1;
     GST_OBJECT_UNLOCK (self);
 
     if (have_event_or_query_ret)
@@ -615,6 +653,170 @@ pad_not_ready_but_event_or_query:
   }
 }
 
+/* Returns whether queueing a buffer on @aggpad might allow the srcpad thread
+ * to aggregate, and it has to be woken up.
+ *
+ * Must be called with SRC_LOCK, the object lock and PAD_LOCK held.
+ */
+static gboolean
+gst_aggregator_pad_buffer_makes_ready (GstAggregator * self,
+    GstAggregatorPad * aggpad)
+{
+  gboolean waited_on = aggpad->priv->waited_on;
+
+  aggpad->priv->waited_on = FALSE;
+
+  /* Not known which pads the srcpad thread is waiting for */
+  if (self->priv->n_pads_waiting < 0)
+    return TRUE;
+
+  /* Any pad with a buffer can select the start time in live mode */
+  if (self->priv->first_buffer)
+    return TRUE;
+
+  if (!waited_on || self->priv->n_pads_waiting == 0)
+    return FALSE;
+
+  self->priv->n_pads_waiting--;
+  if (self->priv->n_pads_waiting > 0) {
+    GST_LOG_OBJECT (aggpad, "Still waiting for %d pads",
+        self->priv->n_pads_waiting);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static GstStructure *
+gst_aggregator_get_stats (GstAggregator * self)
+{
+  GstStructure *s;
+
+  SRC_LOCK (self);
+  s = gst_structure_new ("application/x-gst-aggregator-stats",
+      "wakeups", G_TYPE_UINT64, self->priv->n_wakeups,
+      "spurious-wakeups", G_TYPE_UINT64, self->priv->n_spurious_wakeups,
+      NULL);
+  SRC_UNLOCK (self);
+
+  return s;
+}
+
+typedef struct
+{
+  GstAggregator *self;
+  GstAggregatorPad *pad;
+  GstBuffer *buffer;
+  GstFlowReturn flow_ret;
+  gpointer task;
+} PreparePadData;
+
+static void
+gst_aggregator_prepare_pad_func (PreparePadData * data)
+{
+  GstAggregatorPadClass *klass = GST_AGGREGATOR_PAD_GET_CLASS (data->pad);
+
+  data->flow_ret = klass->prepare (data->pad, data->self, data->buffer);
+}
+
+/* Calls GstAggregatorPadClass::prepare for all pads that have a buffer it
+ * wasn't called with yet, spreading the pads over a task pool if there are
+ * several of them. Nothing is done when waking up on a timeout without new
+ * data.
+ *
+ * Only called from the srcpad thread.
+ */
+static GstFlowReturn
+gst_aggregator_prepare_pads (GstAggregator * self)
+{
+  GstAggregatorPrivate *priv = self->priv;
+  GstFlowReturn flow_ret = GST_FLOW_OK;
+  PreparePadData *data;
+  GList *l, *pads = NULL;
+  guint n_pads = 0, i;
+
+  GST_OBJECT_LOCK (self);
+  for (l = GST_ELEMENT_CAST (self)->sinkpads; l; l = l->next) {
+    if (GST_AGGREGATOR_PAD_GET_CLASS (l->data)->prepare)
+      pads = g_list_prepend (pads, gst_object_ref (l->data));
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  if (!pads)
+    return GST_FLOW_OK;
+
+  data = g_new0 (PreparePadData, g_list_length (pads));
+  for (l = pads; l; l = l->next) {
+    GstAggregatorPad *pad = l->data;
+    GstBuffer *buffer = gst_aggregator_pad_peek_buffer (pad);
+    gboolean prepared;
+
+    PAD_LOCK (pad);
+    prepared = buffer != NULL && buffer == pad->priv->prepared_buffer;
+    PAD_UNLOCK (pad);
+
+    if (!buffer || prepared) {
+      gst_clear_buffer (&buffer);
+      gst_object_unref (pad);
+      continue;
+    }
+
+    data[n_pads].self = self;
+    data[n_pads].pad = pad;
+    data[n_pads].buffer = buffer;
+    n_pads++;
+  }
+  g_list_free (pads);
+
+  if (n_pads > 1 && !priv->prepare_pool) {
+    priv->prepare_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (priv->prepare_pool), g_get_num_processors ());
+    gst_task_pool_prepare (priv->prepare_pool, NULL);
+  }
+
+  GST_LOG_OBJECT (self, "Preparing %u pads", n_pads);
+
+  /* The first pad is prepared by this thread while the pool handles the
+   * others */
+  for (i = 1; i < n_pads; i++) {
+    GError *err = NULL;
+
+    data[i].task = gst_task_pool_push (priv->prepare_pool,
+        (GstTaskPoolFunction) gst_aggregator_prepare_pad_func, &data[i], &err);
+    if (!data[i].task) {
+      GST_WARNING_OBJECT (self, "Failed to push prepare task: %s",
+          err ? err->message : "unknown error");
+      g_clear_error (&err);
+      gst_aggregator_prepare_pad_func (&data[i]);
+    }
+  }
+  if (n_pads > 0)
+    gst_aggregator_prepare_pad_func (&data[0]);
+
+  for (i = 0; i < n_pads; i++) {
+    if (data[i].task)
+      gst_task_pool_join (priv->prepare_pool, data[i].task);
+
+    if (data[i].flow_ret != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (data[i].pad, "Preparing returned %s",
+          gst_flow_get_name (data[i].flow_ret));
+      if (flow_ret == GST_FLOW_OK)
+        flow_ret = data[i].flow_ret;
+    } else {
+      PAD_LOCK (data[i].pad);
+      gst_buffer_replace (&data[i].pad->priv->prepared_buffer, data[i].buffer);
+      PAD_UNLOCK (data[i].pad);
+    }
+
+    gst_buffer_unref (data[i].buffer);
+    gst_object_unref (data[i].pad);
+  }
+  g_free (data);
+
+  return flow_ret;
+}
+
 static void
 gst_aggregator_reset_flow_values (GstAggregator * self)
 {
@@ -995,6 +1197,8 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
     if (status == GST_CLOCK_OK || status == GST_CLOCK_EARLY) {
       GList *l;
 
+      self->priv->n_wakeups++;
+
       GST_OBJECT_LOCK (self);
       for (l = GST_ELEMENT_CAST (self)->sinkpads; l != NULL; l = l->next) {
         GstAggregatorPad *pad = GST_AGGREGATOR_PAD (l->data);
@@ -1011,7 +1215,13 @@ gst_aggregator_wait_and_check (GstAggregator * self, gboolean * timeout)
     }
   }
 
-  res = gst_aggregator_check_pads_ready (self, NULL);
+  self->priv->n_wakeups++;
+
+  res = gst_aggregator_check_pads_ready (self, &have_event_or_query);
+  if (!res && !have_event_or_query) {
+    GST_LOG_OBJECT (self, "Woken up but pads are not ready yet");
+    self->priv->n_spurious_wakeups++;
+  }
   SRC_UNLOCK (self);
 
   return res;
@@ -1530,8 +1740,14 @@ gst_aggregator_loop (GstAggregator * self)
     }
 
     if (timeout || flow_return >= GST_FLOW_OK) {
-      GST_LOG_OBJECT (self, "Actually aggregating, timeout: %d", timeout);
-      flow_return = klass->aggregate (self, timeout);
+      GstFlowReturn prepare_ret = gst_aggregator_prepare_pads (self);
+
+      if (prepare_ret != GST_FLOW_OK) {
+        flow_return = prepare_ret;
+      } else {
+        GST_LOG_OBJECT (self, "Actually aggregating, timeout: %d", timeout);
+        flow_return = klass->aggregate (self, timeout);
+      }
     }
 
     gst_element_foreach_sink_pad (GST_ELEMENT_CAST (self),
@@ -1642,6 +1858,11 @@ gst_aggregator_start (GstAggregator * self)
 
   self->priv->blocked = TRUE;
 
+  SRC_LOCK (self);
+  self->priv->n_pads_waiting = -1;
+  self->priv->n_wakeups = self->priv->n_spurious_wakeups = 0;
+  SRC_UNLOCK (self);
+
   gst_aggregator_set_allocation (self, NULL, NULL, NULL, NULL);
 
   klass = GST_AGGREGATOR_GET_CLASS (self);
@@ -2100,6 +2321,15 @@ gst_aggregator_stop (GstAggregator * agg)
   agg->priv->posted_latency_msg = FALSE;
   agg->priv->blocked = FALSE;
 
+  GST_DEBUG_OBJECT (agg, "Woken up %" G_GUINT64_FORMAT " times, %"
+      G_GUINT64_FORMAT " of them spuriously", agg->priv->n_wakeups,
+      agg->priv->n_spurious_wakeups);
+
+  if (agg->priv->prepare_pool) {
+    gst_task_pool_cleanup (agg->priv->prepare_pool);
+    gst_clear_object (&agg->priv->prepare_pool);
+  }
+
   gst_aggregator_set_allocation (agg, NULL, NULL, NULL, NULL);
 
   if (agg->priv->running) {
@@ -2198,6 +2428,7 @@ gst_aggregator_release_pad (GstElement * element, GstPad * pad)
   PAD_LOCK (aggpad);
   gst_buffer_replace (&aggpad->priv->peeked_buffer, NULL);
   gst_buffer_replace (&aggpad->priv->clipped_buffer, NULL);
+  gst_buffer_replace (&aggpad->priv->prepared_buffer, NULL);
   PAD_UNLOCK (aggpad);
   gst_element_remove_pad (element, pad);
 
@@ -3032,6 +3263,9 @@ gst_aggregator_get_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       g_value_set_boolean (value, agg->priv->emit_signals);
       break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_aggregator_get_stats (agg));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3138,6 +3372,26 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
           "Send signals", DEFAULT_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAggregator:stats:
+   *
+   * Various #GstAggregator statistics. This property returns a #GstStructure
+   * with name `application/x-gst-aggregator-stats` with the following fields:
+   *
+   * - "wakeups" G_TYPE_UINT64   Number of times the source pad thread was
+   *   woken up while waiting for input or for the aggregation deadline
+   * - "spurious-wakeups" G_TYPE_UINT64   Number of these wakeups after which
+   *   the pads were still not ready to be aggregated
+   *
+   * The counters are reset when going from READY to PAUSED.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Aggregator Statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAggregator::samples-selected:
    * @aggregator: The #GstAggregator that emitted the signal
@@ -3187,6 +3441,7 @@ gst_aggregator_init (GstAggregator * self, GstAggregatorClass * klass)
   g_return_if_fail (pad_template != NULL);
 
   priv->max_padserial = -1;
+  priv->n_pads_waiting = -1;
   priv->ignore_inactive_pads = FALSE;
 
   self->priv->peer_latency_live = FALSE;
@@ -3375,7 +3630,8 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
       aggpad->priv->num_buffers++;
       aggpad->priv->num_bytes += gst_buffer_get_size (buffer);
       buffer = NULL;
-      SRC_BROADCAST (self);
+      if (gst_aggregator_pad_buffer_makes_ready (self, aggpad))
+        SRC_BROADCAST (self);
       break;
     }
 
@@ -3582,6 +3838,7 @@ gst_aggregator_pad_finalize (GObject * object)
   GstAggregatorPad *pad = (GstAggregatorPad *) object;
 
   gst_buffer_replace (&pad->priv->peeked_buffer, NULL);
+  gst_buffer_replace (&pad->priv->prepared_buffer, NULL);
   g_cond_clear (&pad->priv->event_cond);
   g_mutex_clear (&pad->priv->flush_lock);
   g_mutex_clear (&pad->priv->lock);
@@ -85,6 +85,16 @@ struct _GstAggregatorPad
  * @skip_buffer: Optional
  *               Called before input buffers are queued in the pad, return %TRUE
  *               if the buffer should be skipped.
+ * @prepare:     Optional
+ *               Called before #GstAggregatorClass::aggregate with the buffer
+ *               at the head of the pad, to do per-pad work such as format
+ *               conversion. It is called only once for each buffer, even
+ *               if the buffer stays at the head of the pad for several
+ *               aggregations. Implementations for different pads are run in
+ *               parallel on a task pool, so they must only access state of
+ *               their own pad. Returning anything but %GST_FLOW_OK skips
+ *               the aggregation and returns this flow from the srcpad task.
+ *               Since: 1.28
  *
  * Since: 1.14
  */
@@ -95,8 +105,10 @@ struct _GstAggregatorPadClass
   GstFlowReturn (*flush)       (GstAggregatorPad * aggpad, GstAggregator * aggregator);
   gboolean      (*skip_buffer) (GstAggregatorPad * aggpad, GstAggregator * aggregator, GstBuffer * buffer);
 
+  GstFlowReturn (*prepare)     (GstAggregatorPad * aggpad, GstAggregator * aggregator, GstBuffer * buffer);
+
   /*< private >*/
-  gpointer      _gst_reserved[GST_PADDING_LARGE];
+  gpointer      _gst_reserved[GST_PADDING_LARGE - 1];
 };
 
 GST_BASE_API
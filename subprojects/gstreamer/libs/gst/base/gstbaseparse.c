@@ -274,6 +274,27 @@ struct _GstBaseParsePrivate
 
   GstBuffer *cache;
 
+  /* pull mode read ahead of the data following the cache; prefetch_lock
+   * serializes the pulls, prefetch_cookie changes when flushing */
+  gboolean read_ahead;
+  GMutex prefetch_lock;
+  GstTaskPool *prefetch_pool;
+  gpointer prefetch_task;
+  guint prefetch_cookie;
+  guint prefetch_task_cookie;
+  guint64 prefetch_offset;
+  guint prefetch_size;
+  GstBuffer *prefetch_buffer;
+  GArray *prefetch_sync_points;
+
+  /* sync points found in the data read ahead, in parallel on scan_pool.
+   * All sync points from sync_points_start to sync_points_end are known. */
+  GstTaskPool *scan_pool;
+  guint n_scan_chunks;
+  GArray *sync_points;
+  guint64 sync_points_start;
+  guint64 sync_points_end;
+
   /* index entry storage, either ours or provided */
   GstIndex *index;
   gint index_id;
@@ -356,14 +377,32 @@ typedef struct _GstBaseParseSeek
   GstClockTime start_ts;
 } GstBaseParseSeek;
 
+/* a chunk of the data read ahead that is scanned for sync points */
+typedef struct _GstBaseParseScanChunk
+{
+  GstBaseParse *parse;
+  const guint8 *data;
+  gsize size;
+  gsize scan_size;
+  GArray *offsets;
+  gpointer task;
+} GstBaseParseScanChunk;
+
 #define DEFAULT_DISABLE_PASSTHROUGH        FALSE
 #define DEFAULT_DISABLE_CLIP               TRUE
+#define DEFAULT_READ_AHEAD                 FALSE
+
+/* the data read ahead is scanned for sync points in chunks of at least
+ * this size, on at most this many threads */
+#define SCAN_CHUNK_SIZE                    (64 * 1024)
+#define MAX_SCAN_CHUNKS                    8
 
 enum
 {
   PROP_0,
   PROP_DISABLE_PASSTHROUGH,
   PROP_DISABLE_CLIP,
+  PROP_READ_AHEAD,
   PROP_LAST
 };
 
@@ -484,6 +523,8 @@ static gboolean gst_base_parse_is_seekable (GstBaseParse * parse);
 
 static void gst_base_parse_push_pending_events (GstBaseParse * parse);
 
+static void gst_base_parse_prefetch_drop (GstBaseParse * parse);
+
 static void
 gst_base_parse_clear_queues (GstBaseParse * parse, gboolean clear_sticky_events)
 {
@@ -555,6 +596,17 @@ gst_base_parse_finalize (GObject * object)
 
   gst_base_parse_clear_queues (parse, TRUE);
 
+  gst_base_parse_prefetch_drop (parse);
+  if (parse->priv->prefetch_pool) {
+    gst_task_pool_cleanup (parse->priv->prefetch_pool);
+    gst_object_unref (parse->priv->prefetch_pool);
+  }
+  if (parse->priv->scan_pool) {
+    gst_task_pool_cleanup (parse->priv->scan_pool);
+    gst_object_unref (parse->priv->scan_pool);
+  }
+  g_mutex_clear (&parse->priv->prefetch_lock);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -603,6 +655,24 @@ gst_base_parse_class_init (GstBaseParseClass * klass)
           "Disable buffer dropping that are out of segment",
           DEFAULT_DISABLE_CLIP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBaseParse:read-ahead:
+   *
+   * In pull mode, read the data following the current chunk from upstream
+   * on a separate thread while the current chunk is parsed. This lets
+   * reading and parsing overlap when processing whole files, for example
+   * when remuxing or indexing long recordings. If the subclass implements
+   * #GstBaseParseClass::scan_sync_points, the data read ahead is also
+   * scanned for sync points in parallel.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_READ_AHEAD,
+      g_param_spec_boolean ("read-ahead", "Read ahead",
+          "Read the next data from upstream in parallel to parsing "
+          "in pull mode", DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class = (GstElementClass *) klass;
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_base_parse_change_state);
@@ -670,6 +740,9 @@ gst_base_parse_init (GstBaseParse * parse, GstBaseParseClass * bclass)
   parse->priv->pad_mode = GST_PAD_MODE_NONE;
 
   g_mutex_init (&parse->priv->index_lock);
+  g_mutex_init (&parse->priv->prefetch_lock);
+  parse->priv->n_scan_chunks =
+      CLAMP (g_get_num_processors (), 1, MAX_SCAN_CHUNKS);
 
   /* init state */
   gst_base_parse_reset (parse);
@@ -682,6 +755,7 @@ gst_base_parse_init (GstBaseParse * parse, GstBaseParseClass * bclass)
   parse->priv->parser_tags_merge_mode = GST_TAG_MERGE_APPEND;
   parse->priv->disable_passthrough = DEFAULT_DISABLE_PASSTHROUGH;
   parse->priv->disable_clip = DEFAULT_DISABLE_CLIP;
+  parse->priv->read_ahead = DEFAULT_READ_AHEAD;
 }
 
 static void
@@ -697,6 +771,9 @@ gst_base_parse_set_property (GObject * object, guint prop_id,
     case PROP_DISABLE_CLIP:
       parse->priv->disable_clip = g_value_get_boolean (value);
       break;
+    case PROP_READ_AHEAD:
+      parse->priv->read_ahead = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -716,6 +793,9 @@ gst_base_parse_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_DISABLE_CLIP:
       g_value_set_boolean (value, parse->priv->disable_clip);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_boolean (value, parse->priv->read_ahead);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -854,6 +934,8 @@ gst_base_parse_update_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
 static void
 gst_base_parse_reset (GstBaseParse * parse)
 {
+  gst_base_parse_prefetch_drop (parse);
+
   GST_OBJECT_LOCK (parse);
   gst_segment_init (&parse->segment, GST_FORMAT_TIME);
   parse->priv->duration = -1;
@@ -1446,6 +1528,8 @@ gst_base_parse_sink_event_default (GstBaseParse * parse, GstEvent * event)
     case GST_EVENT_FLUSH_START:
       GST_OBJECT_LOCK (parse);
       parse->priv->flushing = TRUE;
+      /* data being read ahead is from before the flush */
+      parse->priv->prefetch_cookie++;
       GST_OBJECT_UNLOCK (parse);
       break;
 
@@ -3410,6 +3494,337 @@ gst_base_parse_get_cached_available (GstBaseParse * parse)
   return 0;
 }
 
+static void
+gst_base_parse_scan_chunk_func (GstBaseParseScanChunk * chunk)
+{
+  GstBaseParseClass *klass = GST_BASE_PARSE_GET_CLASS (chunk->parse);
+
+  klass->scan_sync_points (chunk->parse, chunk->data, chunk->size,
+      chunk->scan_size, chunk->offsets);
+}
+
+/* Finds the sync points in @buffer, which was read from @offset. The buffer
+ * is split into chunks that are scanned in parallel, their results are then
+ * joined in order. */
+static GArray *
+gst_base_parse_scan_sync_points (GstBaseParse * parse, GstBuffer * buffer,
+    guint64 offset)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+  GstBaseParseScanChunk chunks[MAX_SCAN_CHUNKS];
+  GArray *points;
+  GstMapInfo map;
+  gsize chunk_size;
+  guint n_chunks, i, j;
+
+  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+    return NULL;
+
+  n_chunks = CLAMP (map.size / SCAN_CHUNK_SIZE, 1, priv->n_scan_chunks);
+  chunk_size = map.size / n_chunks;
+
+  for (i = 0; i < n_chunks; i++) {
+    GstBaseParseScanChunk *chunk = &chunks[i];
+    gsize start = i * chunk_size;
+
+    /* a chunk may look at the data following it to decide about the sync
+     * points close to its end */
+    chunk->parse = parse;
+    chunk->data = map.data + start;
+    chunk->size = map.size - start;
+    chunk->scan_size = (i == n_chunks - 1) ? chunk->size : chunk_size;
+    chunk->offsets = g_array_new (FALSE, FALSE, sizeof (gsize));
+    chunk->task = NULL;
+
+    /* the last chunk is scanned on this thread */
+    if (priv->scan_pool && i < n_chunks - 1)
+      chunk->task = gst_task_pool_push (priv->scan_pool,
+          (GstTaskPoolFunction) gst_base_parse_scan_chunk_func, chunk, NULL);
+    if (!chunk->task)
+      gst_base_parse_scan_chunk_func (chunk);
+  }
+
+  points = g_array_new (FALSE, FALSE, sizeof (guint64));
+  for (i = 0; i < n_chunks; i++) {
+    GstBaseParseScanChunk *chunk = &chunks[i];
+    guint64 chunk_offset = offset + (chunk->data - map.data);
+
+    if (chunk->task)
+      gst_task_pool_join (priv->scan_pool, chunk->task);
+
+    for (j = 0; j < chunk->offsets->len; j++) {
+      gsize pos = g_array_index (chunk->offsets, gsize, j);
+      guint64 point = chunk_offset + pos;
+
+      if (pos >= chunk->scan_size || (points->len > 0 &&
+              point <= g_array_index (points, guint64, points->len - 1))) {
+        GST_WARNING_OBJECT (parse, "ignoring invalid sync point at offset %"
+            G_GUINT64_FORMAT, point);
+        continue;
+      }
+      g_array_append_val (points, point);
+    }
+    g_array_unref (chunk->offsets);
+  }
+
+  gst_buffer_unmap (buffer, &map);
+
+  GST_LOG_OBJECT (parse, "found %u sync points in %u chunks from offset %"
+      G_GUINT64_FORMAT, points->len, n_chunks, offset);
+
+  return points;
+}
+
+static void
+gst_base_parse_prefetch_func (GstBaseParse * parse)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+  GstBaseParseClass *klass = GST_BASE_PARSE_GET_CLASS (parse);
+  GstFlowReturn ret;
+  guint cookie;
+
+  GST_OBJECT_LOCK (parse);
+  cookie = priv->prefetch_cookie;
+  GST_OBJECT_UNLOCK (parse);
+
+  /* flushing since the read was started, the data would be dropped */
+  if (cookie != priv->prefetch_task_cookie)
+    return;
+
+  g_mutex_lock (&priv->prefetch_lock);
+  ret = gst_pad_pull_range (parse->sinkpad, priv->prefetch_offset,
+      priv->prefetch_size, &priv->prefetch_buffer);
+  g_mutex_unlock (&priv->prefetch_lock);
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (parse, "reading ahead returned %s",
+        gst_flow_get_name (ret));
+    priv->prefetch_buffer = NULL;
+    return;
+  }
+
+  if (klass->scan_sync_points)
+    priv->prefetch_sync_points = gst_base_parse_scan_sync_points (parse,
+        priv->prefetch_buffer, priv->prefetch_offset);
+}
+
+/* Starts reading @size bytes at @offset on the prefetch thread */
+static void
+gst_base_parse_prefetch_start (GstBaseParse * parse, guint64 offset,
+    guint size)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+  GstBaseParseClass *klass = GST_BASE_PARSE_GET_CLASS (parse);
+  GError *err = NULL;
+
+  if (!priv->prefetch_pool) {
+    priv->prefetch_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (priv->prefetch_pool), 1);
+    gst_task_pool_prepare (priv->prefetch_pool, NULL);
+  }
+
+  /* read enough to give every scanning thread a chunk; the prefetch thread
+   * scans the last one itself */
+  if (klass->scan_sync_points) {
+    if (!priv->scan_pool && priv->n_scan_chunks > 1) {
+      priv->scan_pool = gst_shared_task_pool_new ();
+      gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+          (priv->scan_pool), priv->n_scan_chunks - 1);
+      gst_task_pool_prepare (priv->scan_pool, NULL);
+    }
+    size = MAX (size, priv->n_scan_chunks * SCAN_CHUNK_SIZE);
+  }
+
+  GST_LOG_OBJECT (parse, "reading ahead %u bytes from offset %"
+      G_GUINT64_FORMAT, size, offset);
+
+  GST_OBJECT_LOCK (parse);
+  priv->prefetch_task_cookie = priv->prefetch_cookie;
+  GST_OBJECT_UNLOCK (parse);
+
+  priv->prefetch_offset = offset;
+  priv->prefetch_size = size;
+  priv->prefetch_task = gst_task_pool_push (priv->prefetch_pool,
+      (GstTaskPoolFunction) gst_base_parse_prefetch_func, parse, &err);
+  if (!priv->prefetch_task) {
+    GST_WARNING_OBJECT (parse, "Failed to read ahead: %s",
+        err ? err->message : "unknown error");
+    g_clear_error (&err);
+  }
+}
+
+/* Waits until the data read ahead, if any, is available */
+static void
+gst_base_parse_prefetch_join (GstBaseParse * parse)
+{
+  if (parse->priv->prefetch_task) {
+    gst_task_pool_join (parse->priv->prefetch_pool, parse->priv->prefetch_task);
+    parse->priv->prefetch_task = NULL;
+  }
+}
+
+/* Waits for and drops the data read ahead, and forgets about the sync points
+ * found so far */
+static void
+gst_base_parse_prefetch_drop (GstBaseParse * parse)
+{
+  gst_base_parse_prefetch_join (parse);
+  gst_buffer_replace (&parse->priv->prefetch_buffer, NULL);
+  g_clear_pointer (&parse->priv->prefetch_sync_points, g_array_unref);
+  g_clear_pointer (&parse->priv->sync_points, g_array_unref);
+}
+
+/* Forgets about the sync points before @offset */
+static void
+gst_base_parse_trim_sync_points (GstBaseParse * parse, guint64 offset)
+{
+  GArray *points = parse->priv->sync_points;
+  guint i;
+
+  if (offset <= parse->priv->sync_points_start)
+    return;
+
+  for (i = 0; i < points->len; i++) {
+    if (g_array_index (points, guint64, i) >= offset)
+      break;
+  }
+  g_array_remove_range (points, 0, i);
+  parse->priv->sync_points_start = MIN (offset, parse->priv->sync_points_end);
+}
+
+/* Takes the sync points found in the data from @start to @end. They continue
+ * the known ones if those end at @start, or replace them otherwise. */
+static void
+gst_base_parse_add_sync_points (GstBaseParse * parse, GArray * points,
+    guint64 start, guint64 end)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+
+  if (priv->sync_points && priv->sync_points_end == start) {
+    if (priv->offset >= 0)
+      gst_base_parse_trim_sync_points (parse, priv->offset);
+    g_array_append_vals (priv->sync_points, points->data, points->len);
+    g_array_unref (points);
+  } else {
+    if (priv->sync_points)
+      g_array_unref (priv->sync_points);
+    priv->sync_points = points;
+    priv->sync_points_start = start;
+  }
+  priv->sync_points_end = end;
+}
+
+/* After the subclass skipped data to find a frame, skips on to the next
+ * known sync point, since the subclass cannot find a frame before it */
+static void
+gst_base_parse_skip_to_sync_point (GstBaseParse * parse)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+  guint64 offset, next;
+
+  if (!priv->sync_points || priv->offset < 0)
+    return;
+
+  offset = priv->offset;
+  if (offset < priv->sync_points_start || offset >= priv->sync_points_end)
+    return;
+
+  gst_base_parse_trim_sync_points (parse, offset);
+
+  if (priv->sync_points->len > 0)
+    next = g_array_index (priv->sync_points, guint64, 0);
+  else
+    next = priv->sync_points_end;
+
+  if (next > offset) {
+    GST_LOG_OBJECT (parse, "skipping %" G_GUINT64_FORMAT " more bytes to "
+        "the next sync point at offset %" G_GUINT64_FORMAT, next - offset,
+        next);
+    priv->offset = next;
+  }
+}
+
+/* Replaces the cache by one that starts at the current offset, made of the
+ * end of the cache and the data that was read ahead behind it. Returns
+ * %FALSE if these do not contain @size bytes at the current offset, or up to
+ * the end of the stream. */
+static gboolean
+gst_base_parse_prefetch_take (GstBaseParse * parse, guint size)
+{
+  GstBaseParsePrivate *priv = parse->priv;
+  GstBuffer *prefetched, *cache;
+  GArray *points;
+  guint64 prefetch_offset = priv->prefetch_offset;
+  gint64 offset = priv->offset;
+  gsize prefetched_size;
+  guint cookie;
+
+  gst_base_parse_prefetch_join (parse);
+  prefetched = g_steal_pointer (&priv->prefetch_buffer);
+  points = g_steal_pointer (&priv->prefetch_sync_points);
+  if (!prefetched)
+    return FALSE;
+
+  GST_OBJECT_LOCK (parse);
+  cookie = priv->prefetch_cookie;
+  GST_OBJECT_UNLOCK (parse);
+
+  if (cookie != priv->prefetch_task_cookie) {
+    GST_DEBUG_OBJECT (parse, "dropping data read ahead before flushing");
+    goto drop;
+  }
+
+  /* a short read ahead hit the end of the stream, reading again would not
+   * give more data */
+  prefetched_size = gst_buffer_get_size (prefetched);
+  if (offset < 0 || (guint64) offset > prefetch_offset ||
+      ((guint64) offset + size > prefetch_offset + prefetched_size &&
+          prefetched_size == priv->prefetch_size))
+    goto mismatch;
+
+  if (offset == prefetch_offset) {
+    cache = prefetched;
+  } else {
+    gint64 cache_offset;
+
+    if (!priv->cache)
+      goto mismatch;
+
+    /* the data in between has to come from the old cache */
+    cache_offset = GST_BUFFER_OFFSET (priv->cache);
+    if (cache_offset > offset ||
+        cache_offset + gst_buffer_get_size (priv->cache) != prefetch_offset)
+      goto mismatch;
+
+    cache = gst_buffer_copy_region (priv->cache, GST_BUFFER_COPY_ALL,
+        offset - cache_offset, prefetch_offset - offset);
+    cache = gst_buffer_append (cache, prefetched);
+  }
+
+  GST_LOG_OBJECT (parse, "using %" G_GSIZE_FORMAT " bytes read ahead from "
+      "offset %" G_GUINT64_FORMAT, prefetched_size, prefetch_offset);
+
+  gst_buffer_replace (&priv->cache, NULL);
+  priv->cache = cache;
+  GST_BUFFER_OFFSET (priv->cache) = offset;
+
+  if (points)
+    gst_base_parse_add_sync_points (parse, points, prefetch_offset,
+        prefetch_offset + prefetched_size);
+
+  return TRUE;
+
+mismatch:
+  GST_DEBUG_OBJECT (parse, "data read ahead from offset %" G_GUINT64_FORMAT
+      " does not match offset %" G_GINT64_FORMAT, prefetch_offset, offset);
+drop:
+  gst_buffer_unref (prefetched);
+  if (points)
+    g_array_unref (points);
+  return FALSE;
+}
+
 /* pull @size bytes at current offset,
  * i.e. at least try to and possibly return a shorter buffer if near the end */
 static GstFlowReturn
@@ -3417,6 +3832,7 @@ gst_base_parse_pull_range (GstBaseParse * parse, guint size,
     GstBuffer ** buffer)
 {
   GstFlowReturn ret = GST_FLOW_OK;
+  gboolean sequential = FALSE, taken = FALSE;
   guint read_size;
 
   g_return_val_if_fail (buffer != NULL, GST_FLOW_ERROR);
@@ -3437,22 +3853,37 @@ gst_base_parse_pull_range (GstBaseParse * parse, guint size,
           G_GINT64_FORMAT, size, cache_offset);
       return GST_FLOW_OK;
     }
-    /* not enough data in the cache, free cache and get a new one */
-    gst_buffer_unref (parse->priv->cache);
-    parse->priv->cache = NULL;
+
+    /* reading on from within the cache */
+    sequential = cache_offset <= parse->priv->offset &&
+        parse->priv->offset <= cache_offset + cache_size;
   }
 
-  /* refill the cache */
   read_size = MAX (64 * 1024, size);
-  GST_LOG_OBJECT (parse,
-      "Reading cache buffer of %u bytes from offset %" G_GINT64_FORMAT,
-      read_size, parse->priv->offset);
-  ret =
-      gst_pad_pull_range (parse->sinkpad, parse->priv->offset, read_size,
-      &parse->priv->cache);
-  if (ret != GST_FLOW_OK) {
-    parse->priv->cache = NULL;
-    return ret;
+
+  /* not enough data in the cache, continue it with the data read ahead or
+   * free the cache and get a new one. Scanning jumps around the stream
+   * and then returns to the current offset, so the data read ahead is kept
+   * for when parsing goes on. */
+  if (!parse->priv->scanning)
+    taken = gst_base_parse_prefetch_take (parse, size);
+
+  if (!taken) {
+    gst_buffer_replace (&parse->priv->cache, NULL);
+
+    GST_LOG_OBJECT (parse,
+        "Reading cache buffer of %u bytes from offset %" G_GINT64_FORMAT,
+        read_size, parse->priv->offset);
+    /* never pull at the same time as the prefetch thread */
+    g_mutex_lock (&parse->priv->prefetch_lock);
+    ret =
+        gst_pad_pull_range (parse->sinkpad, parse->priv->offset, read_size,
+        &parse->priv->cache);
+    g_mutex_unlock (&parse->priv->prefetch_lock);
+    if (ret != GST_FLOW_OK) {
+      parse->priv->cache = NULL;
+      return ret;
+    }
   }
 
   if (gst_buffer_get_size (parse->priv->cache) < size) {
@@ -3468,6 +3899,15 @@ gst_base_parse_pull_range (GstBaseParse * parse, guint size,
 
   GST_BUFFER_OFFSET (parse->priv->cache) = parse->priv->offset;
 
+  /* the next cache continues where this one ends, so start reading that
+   * while this one is parsed. Only do so when reading through the stream,
+   * the data would be thrown away after a jump to another offset. */
+  if (parse->priv->read_ahead && parse->segment.rate > 0.0 &&
+      !parse->priv->scanning && (taken || sequential))
+    gst_base_parse_prefetch_start (parse,
+        parse->priv->offset + gst_buffer_get_size (parse->priv->cache),
+        read_size);
+
   *buffer =
       gst_buffer_copy_region (parse->priv->cache, GST_BUFFER_COPY_ALL, 0, size);
   GST_BUFFER_OFFSET (*buffer) = parse->priv->offset;
@@ -3613,6 +4053,11 @@ gst_base_parse_scan_frame (GstBaseParse * parse, GstBaseParseClass * klass)
     parse->priv->offset += parse->priv->skip;
     parse->priv->skip = 0;
 
+    /* the subclass is looking for a frame, go straight to where the next
+     * one can start */
+    if (skip > 0 && parse->segment.rate > 0.0)
+      gst_base_parse_skip_to_sync_point (parse);
+
     /* something flushed means something happened,
      * and we should bail out of this loop so as not to occupy
      * the task thread indefinitely */
@@ -3882,6 +4327,7 @@ gst_base_parse_sink_activate_mode (GstPad * pad, GstObject * parent,
         result = TRUE;
       } else {
         result = gst_pad_stop_task (pad);
+        gst_base_parse_prefetch_drop (parse);
       }
       break;
     default:
@@ -4796,6 +5242,10 @@ gst_base_parse_handle_seek (GstBaseParse * parse, GstEvent * event)
      * with the above flush/pause code */
     GST_PAD_STREAM_LOCK (parse->sinkpad);
 
+    /* wait for any read ahead and drop its data, the stream continues
+     * elsewhere */
+    gst_base_parse_prefetch_drop (parse);
+
     /* save current position */
     last_stop = parse->segment.position;
     GST_DEBUG_OBJECT (parse, "stopped streaming at %" G_GINT64_FORMAT,
@@ -225,6 +225,17 @@ struct _GstBaseParse {
  * @src_query:      Optional.
  *                   Query handler on the source pad. Should chain up to the
  *                   parent to let the default handler run (Since: 1.2)
+ * @scan_sync_points: Optional.
+ *                   Appends to @offsets, an array of #gsize, in increasing
+ *                   order every offset below @scan_size in @data at which
+ *                   @handle_frame might find the start of a frame. @size
+ *                   bytes of @data are available to decide about an offset;
+ *                   when they are not enough, the offset has to be appended.
+ *                   Must not use or change any state, as it is called from
+ *                   several threads at once on the data read ahead in pull
+ *                   mode. Baseparse then skips straight to the next of these
+ *                   offsets when @handle_frame asks to skip data.
+ *                   (Since: 1.28)
  *
  * Subclasses can override any of the available virtual methods or not, as
  * needed. At minimum @handle_frame needs to be overridden.
@@ -288,8 +299,14 @@ struct _GstBaseParseClass {
   gboolean      (*src_query)          (GstBaseParse * parse,
                                        GstQuery     * query);
 
+  void          (*scan_sync_points)   (GstBaseParse * parse,
+                                       const guint8 * data,
+                                       gsize          size,
+                                       gsize          scan_size,
+                                       GArray       * offsets);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE - 2];
+  gpointer       _gst_reserved[GST_PADDING_LARGE - 3];
 };
 
 GST_BASE_API
@@ -277,6 +277,9 @@ struct _GstBaseSinkPrivate
   gsize rc_accumulated;
 
   gboolean drop_out_of_segment;
+
+  /* objects due within this time are rendered without waiting */
+  GstClockTime sync_tolerance;
 };
 
 #define DO_RUNNING_AVG(avg,val,size) (((val) + ((size)-1) * (avg)) / (size))
@@ -307,6 +310,7 @@ struct _GstBaseSinkPrivate
 #define DEFAULT_MAX_BITRATE         0
 #define DEFAULT_DROP_OUT_OF_SEGMENT TRUE
 #define DEFAULT_PROCESSING_DEADLINE (20 * GST_MSECOND)
+#define DEFAULT_SYNC_TOLERANCE      0
 
 enum
 {
@@ -324,6 +328,7 @@ enum
   PROP_MAX_BITRATE,
   PROP_PROCESSING_DEADLINE,
   PROP_STATS,
+  PROP_SYNC_TOLERANCE,
   PROP_LAST
 };
 
@@ -591,6 +596,35 @@ gst_base_sink_class_init (GstBaseSinkClass * klass)
           "Sink Statistics", GST_TYPE_STRUCTURE,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBaseSink:sync-tolerance:
+   *
+   * Objects that are due within this amount of time (in nanoseconds) of
+   * the current clock time are rendered right away instead of waiting on
+   * the clock. Buffer lists are split into groups of buffers whose running
+   * times are within the tolerance of the first buffer of the group, and
+   * each group is synchronised once and rendered with a single
+   * #GstBaseSinkClass::render_list call.
+   *
+   * This avoids a clock wait per buffer for bursts of buffers with nearly
+   * identical timestamps, such as packets arriving at a network sink.
+   * A value of 0 disables grouping.
+   *
+   * A list that fits within the tolerance is still synchronised once. A list
+   * spread over more than the tolerance waits once per group that is not
+   * due yet, where without a tolerance the whole list is rendered at the
+   * time of its first buffer. This trades extra clock waits for rendering
+   * the later buffers on time.
+   *
+   * Since: 1.28
+   */
+  g_object_class_install_property (gobject_class, PROP_SYNC_TOLERANCE,
+      g_param_spec_uint64 ("sync-tolerance", "Sync tolerance",
+          "Render objects due within this time without waiting on the clock "
+          "and group buffer lists by it (0 = disabled)", 0,
+          G_MAXUINT64, DEFAULT_SYNC_TOLERANCE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_base_sink_change_state);
   gstelement_class->send_event = GST_DEBUG_FUNCPTR (gst_base_sink_send_event);
@@ -724,6 +758,7 @@ gst_base_sink_init (GstBaseSink * basesink, gpointer g_class)
   priv->max_bitrate = DEFAULT_MAX_BITRATE;
 
   priv->drop_out_of_segment = DEFAULT_DROP_OUT_OF_SEGMENT;
+  priv->sync_tolerance = DEFAULT_SYNC_TOLERANCE;
 
   GST_OBJECT_FLAG_SET (basesink, GST_ELEMENT_FLAG_SINK);
 }
@@ -1557,6 +1592,54 @@ gst_base_sink_get_processing_deadline (GstBaseSink * sink)
   return res;
 }
 
+/**
+ * gst_base_sink_set_sync_tolerance:
+ * @sink: a #GstBaseSink
+ * @tolerance: the sync tolerance in nanoseconds
+ *
+ * Set the time window within which objects are rendered without waiting
+ * on the clock and buffers of a buffer list are grouped for rendering.
+ * See #GstBaseSink:sync-tolerance. A value of 0 disables grouping.
+ *
+ * Since: 1.28
+ */
+void
+gst_base_sink_set_sync_tolerance (GstBaseSink * sink, GstClockTime tolerance)
+{
+  g_return_if_fail (GST_IS_BASE_SINK (sink));
+  g_return_if_fail (GST_CLOCK_TIME_IS_VALID (tolerance));
+
+  GST_OBJECT_LOCK (sink);
+  sink->priv->sync_tolerance = tolerance;
+  GST_LOG_OBJECT (sink, "set sync tolerance to %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (tolerance));
+  GST_OBJECT_UNLOCK (sink);
+}
+
+/**
+ * gst_base_sink_get_sync_tolerance:
+ * @sink: a #GstBaseSink
+ *
+ * Get the sync tolerance of @sink. See gst_base_sink_set_sync_tolerance().
+ *
+ * Returns: the sync tolerance in nanoseconds
+ *
+ * Since: 1.28
+ */
+GstClockTime
+gst_base_sink_get_sync_tolerance (GstBaseSink * sink)
+{
+  GstClockTime res;
+
+  g_return_val_if_fail (GST_IS_BASE_SINK (sink), 0);
+
+  GST_OBJECT_LOCK (sink);
+  res = sink->priv->sync_tolerance;
+  GST_OBJECT_UNLOCK (sink);
+
+  return res;
+}
+
 static void
 gst_base_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -1597,6 +1680,9 @@ gst_base_sink_set_property (GObject * object, guint prop_id,
     case PROP_PROCESSING_DEADLINE:
       gst_base_sink_set_processing_deadline (sink, g_value_get_uint64 (value));
       break;
+    case PROP_SYNC_TOLERANCE:
+      gst_base_sink_set_sync_tolerance (sink, g_value_get_uint64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1649,6 +1735,9 @@ gst_base_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_STATS:
       g_value_take_boxed (value, gst_base_sink_get_stats (sink));
       break;
+    case PROP_SYNC_TOLERANCE:
+      g_value_set_uint64 (value, gst_base_sink_get_sync_tolerance (sink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2639,6 +2728,46 @@ flushing:
   }
 }
 
+/* Checks if the running time @time is due within the sync tolerance of
+ * the current clock time, in which case the object can be rendered without
+ * waiting on the clock. @jitter is set like gst_clock_id_wait() would.
+ *
+ * Called with the PREROLL_LOCK. */
+static gboolean
+gst_base_sink_is_within_tolerance (GstBaseSink * sink, GstClockTime time,
+    GstClockTimeDiff * jitter)
+{
+  GstClock *clock;
+  GstClockTime base_time, now;
+  GstClockTimeDiff diff;
+
+  if (!GST_CLOCK_TIME_IS_VALID (time))
+    return FALSE;
+
+  GST_OBJECT_LOCK (sink);
+  if (!sink->sync || sink->priv->sync_tolerance == 0
+      || (clock = GST_ELEMENT_CLOCK (sink)) == NULL) {
+    GST_OBJECT_UNLOCK (sink);
+    return FALSE;
+  }
+
+  base_time = GST_ELEMENT_CAST (sink)->base_time;
+  now = gst_clock_get_time (clock);
+  diff = GST_CLOCK_DIFF (time + base_time, now);
+  if (diff < 0 && -diff > sink->priv->sync_tolerance) {
+    GST_OBJECT_UNLOCK (sink);
+    return FALSE;
+  }
+  GST_OBJECT_UNLOCK (sink);
+
+  GST_LOG_OBJECT (sink, "time %" GST_TIME_FORMAT " within tolerance, "
+      "jitter %" GST_STIME_FORMAT, GST_TIME_ARGS (time), GST_STIME_ARGS (diff));
+
+  *jitter = diff;
+
+  return TRUE;
+}
+
 /* with STREAM_LOCK, PREROLL_LOCK
  *
  * Make sure we are in PLAYING and synchronize an object to the clock.
@@ -2787,9 +2916,15 @@ again:
       GST_TIME_FORMAT ", adjusted %" GST_TIME_FORMAT,
       GST_TIME_ARGS (rstart), GST_TIME_ARGS (stime));
 
-  /* This function will return immediately if start == -1, no clock
+  /* objects that are (nearly) due already are rendered without a clock
+   * wait, which saves a wait per buffer for bursts of buffers. Otherwise
+   * this function will return immediately if start == -1, no clock
    * or sync is disabled with GST_CLOCK_BADTIME. */
-  status = gst_base_sink_wait_clock (basesink, stime, &jitter);
+  if (priv->sync_tolerance > 0 &&
+      gst_base_sink_is_within_tolerance (basesink, stime, &jitter))
+    status = (jitter > 0 ? GST_CLOCK_EARLY : GST_CLOCK_OK);
+  else
+    status = gst_base_sink_wait_clock (basesink, stime, &jitter);
 
   GST_DEBUG_OBJECT (basesink, "clock returned %d, jitter %c%" GST_TIME_FORMAT,
       status, (jitter < 0 ? '-' : ' '), GST_TIME_ARGS (ABS (jitter)));
@@ -4119,6 +4254,81 @@ gst_base_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return gst_base_sink_chain_main (basesink, pad, buf, FALSE);
 }
 
+static GstClockTime
+gst_base_sink_get_list_buffer_time (GstBaseSink * basesink, GstBuffer * buffer)
+{
+  GstClockTime timestamp;
+
+  timestamp = GST_BUFFER_DTS_OR_PTS (buffer);
+  if (!GST_CLOCK_TIME_IS_VALID (timestamp))
+    return GST_CLOCK_TIME_NONE;
+
+  return gst_segment_to_running_time (&basesink->segment, GST_FORMAT_TIME,
+      timestamp);
+}
+
+/* Splits @list in groups of buffers whose running time is within @tolerance
+ * of the first buffer of the group. Every group is synchronised once and
+ * passed to render_list as a whole. Buffers without a timestamp join the
+ * current group. A list that is a single group is passed on unchanged, so
+ * it costs one clock wait like without a tolerance.
+ *
+ * with STREAM_LOCK
+ */
+static GstFlowReturn
+gst_base_sink_chain_list_grouped (GstBaseSink * basesink, GstPad * pad,
+    GstBufferList * list, GstClockTime tolerance)
+{
+  GstFlowReturn result = GST_FLOW_OK;
+  GstClockTime group_time = GST_CLOCK_TIME_NONE;
+  guint i, len, group_start = 0;
+
+  len = gst_buffer_list_length (list);
+
+  if (basesink->segment.format != GST_FORMAT_TIME || len < 2)
+    return gst_base_sink_chain_main (basesink, pad, list, TRUE);
+
+  for (i = 0; i <= len; i++) {
+    GstClockTime time = GST_CLOCK_TIME_NONE;
+    GstBufferList *group;
+    guint j;
+
+    if (i < len) {
+      time = gst_base_sink_get_list_buffer_time (basesink,
+          gst_buffer_list_get (list, i));
+
+      if (!GST_CLOCK_TIME_IS_VALID (group_time))
+        group_time = time;
+
+      if (!GST_CLOCK_TIME_IS_VALID (time) ||
+          ABS (GST_CLOCK_DIFF (group_time, time)) <= tolerance)
+        continue;
+    }
+
+    /* the whole list is one group, push it as-is */
+    if (group_start == 0 && i == len)
+      return gst_base_sink_chain_main (basesink, pad, list, TRUE);
+
+    GST_LOG_OBJECT (basesink, "rendering buffers %u-%u of list as one group",
+        group_start, i - 1);
+
+    group = gst_buffer_list_new_sized (i - group_start);
+    for (j = group_start; j < i; j++)
+      gst_buffer_list_add (group, gst_buffer_ref (gst_buffer_list_get (list,
+                  j)));
+
+    result = gst_base_sink_chain_main (basesink, pad, group, TRUE);
+    if (result != GST_FLOW_OK)
+      break;
+
+    group_start = i;
+    group_time = time;
+  }
+  gst_buffer_list_unref (list);
+
+  return result;
+}
+
 static GstFlowReturn
 gst_base_sink_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * list)
@@ -4131,7 +4341,17 @@ gst_base_sink_chain_list (GstPad * pad, GstObject * parent,
   bclass = GST_BASE_SINK_GET_CLASS (basesink);
 
   if (G_LIKELY (bclass->render_list)) {
-    result = gst_base_sink_chain_main (basesink, pad, list, TRUE);
+    GstClockTime tolerance;
+
+    GST_OBJECT_LOCK (basesink);
+    tolerance = basesink->priv->sync_tolerance;
+    GST_OBJECT_UNLOCK (basesink);
+
+    if (tolerance > 0)
+      result = gst_base_sink_chain_list_grouped (basesink, pad, list,
+          tolerance);
+    else
+      result = gst_base_sink_chain_main (basesink, pad, list, TRUE);
   } else {
     guint i, len;
     GstBuffer *buffer;
@@ -1,7 +1,7 @@
 /* GStreamer
  * Copyright (C) 2005 Andy Wingo <wingo@pobox.com>
  *
- * caps.c: benchmark for caps creation and destruction
+ * caps.c: benchmark for caps creation, destruction and intersection
  *
  * This library is free software; you can redistribute it and/or
  * modify it under the terms of the GNU Library General Public
@@ -45,7 +45,7 @@ gint
 main (gint argc, gchar * argv[])
 {
   GstCaps **capses;
-  GstCaps *protocaps;
+  GstCaps *protocaps, *fixedcaps;
   GstClockTime start, end;
   gint i;
 
@@ -69,6 +69,32 @@ main (gint argc, gchar * argv[])
       GST_TIME_ARGS (end - start), i);
 
   g_free (capses);
+
+  fixedcaps = gst_caps_from_string ("audio/x-raw, format = (string) F32LE, "
+      "rate = (int) 48000, channels = (int) 2");
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    GstCaps *res = gst_caps_intersect (protocaps, fixedcaps);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - intersecting %d caps\n",
+      GST_TIME_ARGS (end - start), i);
+
+  protocaps = gst_caps_intern (protocaps);
+  fixedcaps = gst_caps_intern (fixedcaps);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_CAPS; i++) {
+    GstCaps *res = gst_caps_intersect (protocaps, fixedcaps);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%" GST_TIME_FORMAT " - intersecting %d interned caps\n",
+      GST_TIME_ARGS (end - start), i);
+
+  gst_caps_unref (fixedcaps);
   gst_caps_unref (protocaps);
 
   return 0;
@@ -23,9 +23,11 @@
 #include <gst/glib-compat-private.h>
 
 #define MAX_THREADS  100
+#define MAX_ASYNC_IDS  100000
 
 static gboolean running = TRUE;
 static gint count = 0;
+static gint async_count = 0;
 
 static void *
 run_test (void *user_data)
@@ -43,18 +45,30 @@ run_test (void *user_data)
   return NULL;
 }
 
+static gboolean
+async_cb (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  g_atomic_int_inc (&async_count);
+  return TRUE;
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
   GThread *threads[MAX_THREADS];
-  gint num_threads;
+  GstClockID *async_ids = NULL;
+  gint num_threads, num_async_ids = 0;
+  guint64 tolerance = 0;
   gint t;
   GstClock *sysclock;
+  GstClockTime base;
 
   gst_init (&argc, &argv);
 
-  if (argc != 2) {
-    g_print ("usage: %s <num_threads>\n", argv[0]);
+  if (argc < 2 || argc > 4) {
+    g_print ("usage: %s <num_threads> [<num_async_ids> [<tolerance_us>]]\n",
+        argv[0]);
     exit (-1);
   }
 
@@ -65,7 +79,36 @@ main (gint argc, gchar * argv[])
     exit (-2);
   }
 
+  if (argc > 2) {
+    num_async_ids = atoi (argv[2]);
+
+    if (num_async_ids < 0 || num_async_ids > MAX_ASYNC_IDS) {
+      g_print ("number of async ids must be between 0 and %d\n",
+          MAX_ASYNC_IDS);
+      exit (-2);
+    }
+  }
+
+  if (argc > 3)
+    tolerance = g_ascii_strtoull (argv[3], NULL, 10) * GST_USECOND;
+
   sysclock = gst_system_clock_obtain ();
+  g_object_set (sysclock, "wakeup-tolerance", tolerance, NULL);
+
+  /* periodic ids with intervals between 5 and 50ms, like RTCP timers or
+   * aggregator timeouts of many independent pipelines would create */
+  base = gst_clock_get_time (sysclock);
+  if (num_async_ids > 0)
+    async_ids = g_new0 (GstClockID, num_async_ids);
+  for (t = 0; t < num_async_ids; t++) {
+    GstClockTime interval = g_random_int_range (5, 51) * GST_MSECOND;
+
+    async_ids[t] = gst_clock_new_periodic_id (sysclock,
+        base + g_random_int_range (0, 50) * GST_MSECOND, interval);
+    gst_clock_id_wait_async (async_ids[t], async_cb, NULL, NULL);
+  }
+  if (num_async_ids > 0)
+    printf ("main(): Scheduled %d periodic async ids.\n", num_async_ids);
 
   for (t = 0; t < num_threads; t++) {
     GError *error = NULL;
@@ -92,7 +135,15 @@ main (gint argc, gchar * argv[])
     g_thread_join (threads[t]);
   }
 
+  for (t = 0; t < num_async_ids; t++) {
+    gst_clock_id_unschedule (async_ids[t]);
+    gst_clock_id_unref (async_ids[t]);
+  }
+  g_free (async_ids);
+
   g_print ("performed %d get_time operations\n", count);
+  if (num_async_ids > 0)
+    g_print ("fired %d async callbacks\n", g_atomic_int_get (&async_count));
 
   gst_object_unref (sysclock);
 
@@ -26,12 +26,22 @@
  * grep "log_gst_structure" trace.log >tracerserialize.gststructure.log
  * grep "log_g_variant" trace.log >tracerserialize.gvariant.log
  *
+ * to compare the GstTracerRecord text log against the binary log run:
+ *
+ * GST_DEBUG="GST_TRACER:7" GST_DEBUG_FILE=trace.log ./tracerserialize
+ * GST_TRACER_BINARY_FILE=trace.bin ./tracerserialize
  */
 
 #include <gst/gst.h>
 
 #define NUM_LOOPS 100000
 
+/* The binary log drops records when a thread's ring buffer is full. Log
+ * GstTracerRecords in batches that fit into it and give the log time to
+ * drain between them, so that only successful writes are measured */
+#define BINLOG_BATCH 4096
+#define BINLOG_DRAIN_TIME (150 * G_TIME_SPAN_MILLISECOND)
+
 static void
 log_gst_structure (const gchar * name, const gchar * first, ...)
 {
@@ -77,11 +87,19 @@ log_g_variant (const gchar * format, ...)
   va_end (var_args);
 }
 
+static GstStructure *
+value_spec (GType type)
+{
+  return gst_structure_new ("value", "type", G_TYPE_GTYPE, type, NULL);
+}
+
 gint
 main (gint argc, gchar * argv[])
 {
-  GstClockTime start, end;
-  gint i;
+  GstClockTime start, end, elapsed;
+  GstTracerRecord *tr;
+  gboolean binlog;
+  gint i, j;
 
   gst_init (&argc, &argv);
 
@@ -115,5 +133,29 @@ main (gint argc, gchar * argv[])
   end = gst_util_get_timestamp ();
   g_print ("%" GST_TIME_FORMAT ": GVariant\n", GST_TIME_ARGS (end - start));
 
+  tr = gst_tracer_record_new ("name.class",
+      "ts", GST_TYPE_STRUCTURE, value_spec (G_TYPE_UINT64),
+      "index", GST_TYPE_STRUCTURE, value_spec (G_TYPE_UINT),
+      "test", GST_TYPE_STRUCTURE, value_spec (G_TYPE_STRING),
+      "bool", GST_TYPE_STRUCTURE, value_spec (G_TYPE_BOOLEAN),
+      "flag", GST_TYPE_STRUCTURE, value_spec (GST_TYPE_PAD_DIRECTION), NULL);
+
+  binlog = g_getenv ("GST_TRACER_BINARY_FILE") != NULL;
+  elapsed = 0;
+  for (i = 0; i < NUM_LOOPS; i += BINLOG_BATCH) {
+    start = gst_util_get_timestamp ();
+    for (j = i; j < MIN (i + BINLOG_BATCH, NUM_LOOPS); j++) {
+      gst_tracer_record_log (tr, (guint64) 0, 10, "hallo", TRUE, GST_PAD_SRC);
+    }
+    end = gst_util_get_timestamp ();
+    elapsed += end - start;
+
+    if (binlog)
+      g_usleep (BINLOG_DRAIN_TIME);
+  }
+  g_print ("%" GST_TIME_FORMAT ": GstTracerRecord\n", GST_TIME_ARGS (elapsed));
+
+  gst_object_unref (tr);
+
   return 0;
 }
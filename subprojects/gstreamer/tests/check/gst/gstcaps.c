@@ -2030,6 +2030,73 @@ GST_START_TEST (test_array_subset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_intern)
+{
+  GstCaps *templ, *templ2, *fixed, *other, *res, *res2, *expected;
+
+  templ = gst_caps_intern (gst_caps_from_string ("audio/x-raw, "
+          "format = (string) { S16LE, F32LE }, rate = (int) [ 1, MAX ]; "
+          "audio/x-alaw, rate = (int) 8000"));
+  fail_if (gst_caps_is_writable (templ));
+
+  /* strictly equal caps intern to the same instance */
+  templ2 = gst_caps_intern (gst_caps_from_string ("audio/x-raw, "
+          "rate = (int) [ 1, MAX ], format = (string) { S16LE, F32LE }; "
+          "audio/x-alaw, rate = (int) 8000"));
+  fail_unless (templ2 == templ);
+  gst_caps_unref (templ2);
+
+  /* interning interned caps is a no-op */
+  templ2 = gst_caps_intern (gst_caps_ref (templ));
+  fail_unless (templ2 == templ);
+  gst_caps_unref (templ2);
+
+  fixed = gst_caps_intern (gst_caps_from_string ("audio/x-raw, "
+          "format = (string) F32LE, rate = (int) 48000"));
+  other = gst_caps_intern (gst_caps_from_string ("video/x-raw"));
+  fail_if (fixed == templ);
+
+  /* the cached results must match the uncached ones, twice */
+  expected = gst_caps_from_string ("audio/x-raw, "
+      "format = (string) F32LE, rate = (int) 48000");
+  res = gst_caps_intersect (templ, fixed);
+  fail_unless (gst_caps_is_equal (res, expected));
+  res2 = gst_caps_intersect (templ, fixed);
+  fail_unless (gst_caps_is_equal (res2, expected));
+  fail_unless (res2 == res);
+  gst_caps_unref (res2);
+  gst_caps_unref (res);
+
+  res = gst_caps_intersect_full (fixed, templ, GST_CAPS_INTERSECT_FIRST);
+  fail_unless (gst_caps_is_equal (res, expected));
+  gst_caps_unref (res);
+  gst_caps_unref (expected);
+
+  res = gst_caps_intersect (templ, other);
+  fail_unless (gst_caps_is_empty (res));
+  gst_caps_unref (res);
+
+  fail_unless (gst_caps_can_intersect (templ, fixed));
+  fail_unless (gst_caps_can_intersect (templ, fixed));
+  fail_if (gst_caps_can_intersect (templ, other));
+  fail_if (gst_caps_can_intersect (templ, other));
+
+  fail_unless (gst_caps_is_subset (fixed, templ));
+  fail_unless (gst_caps_is_subset (fixed, templ));
+  fail_if (gst_caps_is_subset (templ, fixed));
+  fail_if (gst_caps_is_subset (templ, fixed));
+
+  /* copies are not interned and writable again */
+  res = gst_caps_copy (templ);
+  fail_unless (gst_caps_is_writable (res));
+  gst_caps_unref (res);
+
+  gst_caps_unref (other);
+  gst_caps_unref (fixed);
+  gst_caps_unref (templ);
+}
+
+GST_END_TEST;
 
 static Suite *
 gst_caps_suite (void)
@@ -2071,6 +2138,7 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_fixed);
   tcase_add_test (tc_chain, test_nested);
   tcase_add_test (tc_chain, test_array_subset);
+  tcase_add_test (tc_chain, test_intern);
 
   return s;
 }
@@ -27,6 +27,11 @@
 
 #include <string.h>
 
+#ifdef G_OS_UNIX
+#include <unistd.h>
+#include <glib/gstdio.h>
+#endif
+
 #ifndef GST_DISABLE_GST_DEBUG
 
 static GList *messages;         /* NULL */
@@ -862,6 +867,184 @@ GST_START_TEST (gst_debug_pad_name_stress)
 
 GST_END_TEST;
 
+#if !defined (GST_DISABLE_GST_DEBUG) && defined (G_OS_UNIX)
+typedef void (*DeferredLogFunc) (void);
+
+static GList *deferred_expected;        /* NULL */
+
+/* Logs the message and remembers how it has to look like */
+#define DEFERRED_LOG(...) G_STMT_START {                              \
+  GST_LOG (__VA_ARGS__);                                               \
+  deferred_expected = g_list_append (deferred_expected,               \
+      gst_info_strdup_printf (__VA_ARGS__));                          \
+} G_STMT_END
+
+/* Runs @func with a deferred logger, dumps it and returns the lines of
+ * the "deferred:" messages. The logger writes to stderr, so that is
+ * redirected to a temporary file meanwhile. */
+static gchar **
+deferred_logger_capture (guint size, GstClockTime window,
+    DeferredLogFunc func)
+{
+  gchar *path, *contents, **lines, **l;
+  GPtrArray *result;
+  gint fd, saved_stderr;
+
+  fd = g_file_open_tmp ("gstinfo-deferred-XXXXXX", &path, NULL);
+  fail_unless (fd >= 0);
+
+  fflush (stderr);
+  saved_stderr = dup (2);
+  fail_unless (dup2 (fd, 2) == 2);
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_set_threshold_for_name ("check", GST_LEVEL_LOG);
+  gst_debug_add_deferred_logger (size, window);
+
+  func ();
+
+  gst_debug_deferred_logger_dump ();
+  gst_debug_remove_deferred_logger ();
+  gst_debug_unset_threshold_for_name ("check");
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+
+  fflush (stderr);
+  dup2 (saved_stderr, 2);
+  close (saved_stderr);
+  close (fd);
+
+  fail_unless (g_file_get_contents (path, &contents, NULL, NULL));
+  g_unlink (path);
+  g_free (path);
+
+  result = g_ptr_array_new ();
+  lines = g_strsplit (contents, "\n", -1);
+  for (l = lines; *l; l++) {
+    if (strstr (*l, "deferred:"))
+      g_ptr_array_add (result, g_strdup (*l));
+  }
+  g_ptr_array_add (result, NULL);
+  g_strfreev (lines);
+  g_free (contents);
+
+  return (gchar **) g_ptr_array_free (result, FALSE);
+}
+
+static void
+deferred_log_formats (void)
+{
+  GstCaps *caps = gst_caps_new_empty_simple ("video/x-raw");
+  GstSegment segment;
+  long double ld = 2.5;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  segment.stop = 5 * GST_SECOND;
+
+  DEFERRED_LOG ("deferred: int %d %u %x %ld %" G_GINT64_FORMAT " %c", -5, 7u,
+      255, -123456789L, G_GINT64_CONSTANT (1) << 40, 'z');
+  DEFERRED_LOG ("deferred: width [%*d] [%-*d]", 6, 42, 5, -1);
+  DEFERRED_LOG ("deferred: precision [%.*s] [%.3s] [%.*f]", 3, "abcdef",
+      "xyzzy", 2, 3.14159);
+  DEFERRED_LOG ("deferred: percent 100%% %s", "done");
+  DEFERRED_LOG ("deferred: null string %s", (gchar *) NULL);
+  DEFERRED_LOG ("deferred: caps %" GST_PTR_FORMAT, caps);
+  DEFERRED_LOG ("deferred: segment %" GST_SEGMENT_FORMAT, &segment);
+  /* these can't be captured and are formatted right away */
+  DEFERRED_LOG ("deferred: positional %2$s %1$s", "world", "hello");
+  DEFERRED_LOG ("deferred: long double %Lf", ld);
+
+  gst_caps_unref (caps);
+}
+
+static void
+check_deferred_expected (gchar ** lines)
+{
+  GList *l;
+  guint i = 0;
+
+  for (l = deferred_expected; l; l = l->next, i++) {
+    fail_unless (lines[i] != NULL, "missing message '%s'",
+        (gchar *) l->data);
+    fail_unless (g_str_has_suffix (lines[i], l->data),
+        "'%s' doesn't end with '%s'", lines[i], (gchar *) l->data);
+  }
+  fail_unless (lines[i] == NULL, "unexpected message '%s'", lines[i]);
+
+  g_list_free_full (deferred_expected, g_free);
+  deferred_expected = NULL;
+}
+
+GST_START_TEST (info_deferred_logger_format)
+{
+  gchar **lines;
+
+  /* streaming mode */
+  lines = deferred_logger_capture (64 * 1024, GST_CLOCK_TIME_NONE,
+      deferred_log_formats);
+  check_deferred_expected (lines);
+  g_strfreev (lines);
+
+  /* flight recorder */
+  lines = deferred_logger_capture (64 * 1024, 3600 * GST_SECOND,
+      deferred_log_formats);
+  check_deferred_expected (lines);
+  g_strfreev (lines);
+}
+
+GST_END_TEST;
+
+#define N_WRAP_MESSAGES 1000
+
+static void
+deferred_log_wrap (void)
+{
+  gint i;
+
+  for (i = 0; i < N_WRAP_MESSAGES; i++)
+    GST_LOG ("deferred: wrap %d", i);
+}
+
+static void
+deferred_log_window (void)
+{
+  GST_LOG ("deferred: old");
+  g_usleep (300 * G_TIME_SPAN_MILLISECOND);
+  GST_LOG ("deferred: new");
+}
+
+GST_START_TEST (info_deferred_logger_flight_recorder)
+{
+  gchar **lines;
+  guint n, i;
+  gint first;
+
+  /* the smallest buffer only keeps the most recent messages */
+  lines = deferred_logger_capture (4096, 3600 * GST_SECOND,
+      deferred_log_wrap);
+  n = g_strv_length (lines);
+  fail_unless (n > 0 && n < N_WRAP_MESSAGES, "got %u messages", n);
+
+  first = N_WRAP_MESSAGES - n;
+  for (i = 0; i < n; i++) {
+    gchar *expected = g_strdup_printf ("deferred: wrap %d", first + i);
+
+    fail_unless (g_str_has_suffix (lines[i], expected),
+        "'%s' doesn't end with '%s'", lines[i], expected);
+    g_free (expected);
+  }
+  g_strfreev (lines);
+
+  /* only the messages of the window are dumped */
+  lines = deferred_logger_capture (64 * 1024, 100 * GST_MSECOND,
+      deferred_log_window);
+  fail_unless_equals_int (g_strv_length (lines), 1);
+  fail_unless (g_str_has_suffix (lines[0], "deferred: new"));
+  g_strfreev (lines);
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 gst_info_suite (void)
 {
@@ -892,6 +1075,10 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_context_log_static);
   tcase_add_test (tc_chain, info_context_log_flags);
 #endif
+#if !defined (GST_DISABLE_GST_DEBUG) && defined (G_OS_UNIX)
+  tcase_add_test (tc_chain, info_deferred_logger_format);
+  tcase_add_test (tc_chain, info_deferred_logger_flight_recorder);
+#endif
 
 #if defined (__GNUC__)
   tcase_add_test (tc_chain, gst_debug_pad_name_stress);
@@ -203,6 +203,73 @@ GST_START_TEST (test_registry_update)
 
 GST_END_TEST;
 
+/* Returns the plugin files and then the feature names in registry order */
+static GList *
+scan_plugin_path (const gchar * path, const gchar * jobs)
+{
+  GstRegistry *registry;
+  GList *plugins, *features, *l, *names = NULL;
+
+  g_setenv ("GST_PLUGIN_SCANNER_JOBS", jobs, TRUE);
+
+  registry = gst_object_ref_sink (g_object_new (GST_TYPE_REGISTRY, NULL));
+  fail_unless (gst_registry_scan_path (registry, path));
+
+  plugins = gst_registry_get_plugin_list (registry);
+  for (l = plugins; l != NULL; l = l->next) {
+    names = g_list_prepend (names,
+        g_strdup (gst_plugin_get_filename (GST_PLUGIN (l->data))));
+  }
+  gst_plugin_list_free (plugins);
+
+  features = gst_registry_get_feature_list (registry, GST_TYPE_PLUGIN_FEATURE);
+  for (l = features; l != NULL; l = l->next) {
+    names = g_list_prepend (names,
+        g_strdup (GST_OBJECT_NAME (GST_PLUGIN_FEATURE (l->data))));
+  }
+  gst_plugin_feature_list_free (features);
+
+  gst_object_unref (registry);
+  g_unsetenv ("GST_PLUGIN_SCANNER_JOBS");
+
+  return g_list_reverse (names);
+}
+
+static void
+assert_same_names (GList * a, GList * b)
+{
+  fail_unless_equals_int (g_list_length (a), g_list_length (b));
+  for (; a != NULL && b != NULL; a = a->next, b = b->next)
+    fail_unless_equals_string (a->data, b->data);
+}
+
+GST_START_TEST (test_registry_scan_jobs)
+{
+  const gchar *path = g_getenv ("GST_PLUGIN_PATH_1_0");
+  GList *serial, *parallel;
+  gint i;
+
+  if (path == NULL || *path == '\0') {
+    GST_INFO ("No plugin path set, skipping test");
+    return;
+  }
+
+  /* The registry has to end up the same no matter how many scanner helpers
+   * there are and in which order they answer */
+  serial = scan_plugin_path (path, "1");
+  fail_unless (serial != NULL);
+
+  for (i = 0; i < 3; i++) {
+    parallel = scan_plugin_path (path, "4");
+    assert_same_names (serial, parallel);
+    g_list_free_full (parallel, g_free);
+  }
+
+  g_list_free_full (serial, g_free);
+}
+
+GST_END_TEST;
+
 static Suite *
 registry_suite (void)
 {
@@ -212,6 +279,7 @@ registry_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_registry_update);
+  tcase_add_test (tc_chain, test_registry_scan_jobs);
 
   return s;
 }
@@ -197,6 +197,159 @@ GST_START_TEST (test_async_full)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GArray *times;                /* requested times in firing order */
+  GArray *fired_at;             /* clock time when each one fired */
+} AsyncOrderData;
+
+static gboolean
+async_order_callback (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  AsyncOrderData *data = user_data;
+  GstClockTime now = gst_clock_get_time (clock);
+
+  g_mutex_lock (&data->lock);
+  g_array_append_val (data->times, time);
+  g_array_append_val (data->fired_at, now);
+  g_cond_signal (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  return TRUE;
+}
+
+/* schedules @n single shot ids at @base + k * @step, with k going through
+ * 0..n-1 out of order */
+static void
+schedule_out_of_order (GstClock * clock, AsyncOrderData * data,
+    GstClockTime base, GstClockTime step, GstClockID * ids, guint n)
+{
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    guint k = (i * 7) % n;
+
+    ids[k] = gst_clock_new_single_shot_id (clock, base + k * step);
+    fail_unless_equals_int (gst_clock_id_wait_async (ids[k],
+            async_order_callback, data, NULL), GST_CLOCK_OK);
+  }
+}
+
+static void
+wait_for_fired (AsyncOrderData * data, guint n)
+{
+  g_mutex_lock (&data->lock);
+  while (data->times->len < n)
+    g_cond_wait (&data->cond, &data->lock);
+  g_mutex_unlock (&data->lock);
+}
+
+#define N_ORDER_IDS 16
+
+GST_START_TEST (test_async_order)
+{
+  AsyncOrderData data;
+  GstClockID ids[N_ORDER_IDS];
+  GstClockTime base, step = 5 * GST_MSECOND;
+  GstClock *clock;
+  guint i, j;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.times = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  data.fired_at = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  clock = g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "TestOrderClock", NULL);
+  gst_object_ref_sink (clock);
+
+  base = gst_clock_get_time (clock) + 50 * GST_MSECOND;
+  schedule_out_of_order (clock, &data, base, step, ids, N_ORDER_IDS);
+
+  /* unscheduled ids are dropped and must not fire */
+  for (i = 3; i < N_ORDER_IDS; i += 4)
+    gst_clock_id_unschedule (ids[i]);
+
+  wait_for_fired (&data, N_ORDER_IDS - N_ORDER_IDS / 4);
+
+  /* give a wrongly kept unscheduled id the chance to fire */
+  g_usleep (20 * 1000);
+
+  g_mutex_lock (&data.lock);
+  fail_unless_equals_int (data.times->len, N_ORDER_IDS - N_ORDER_IDS / 4);
+  for (i = 0, j = 0; i < N_ORDER_IDS; i++) {
+    if (i % 4 == 3)
+      continue;
+    fail_unless_equals_uint64 (g_array_index (data.times, GstClockTime, j),
+        base + i * step);
+    j++;
+  }
+  g_mutex_unlock (&data.lock);
+
+  for (i = 0; i < N_ORDER_IDS; i++)
+    gst_clock_id_unref (ids[i]);
+  gst_object_unref (clock);
+
+  g_array_unref (data.times);
+  g_array_unref (data.fired_at);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
+#define N_TOLERANCE_IDS 8
+
+GST_START_TEST (test_async_wakeup_tolerance)
+{
+  AsyncOrderData data;
+  GstClockID ids[N_TOLERANCE_IDS];
+  GstClockTime base, step = 5 * GST_MSECOND;
+  GstClock *clock;
+  guint i;
+
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.times = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+  data.fired_at = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  clock = g_object_new (GST_TYPE_SYSTEM_CLOCK, "name", "TestToleranceClock",
+      "wakeup-tolerance", 100 * GST_MSECOND, NULL);
+  gst_object_ref_sink (clock);
+
+  /* all ids expire within 35ms of each other, well inside the tolerance */
+  base = gst_clock_get_time (clock) + 200 * GST_MSECOND;
+  schedule_out_of_order (clock, &data, base, step, ids, N_TOLERANCE_IDS);
+
+  wait_for_fired (&data, N_TOLERANCE_IDS);
+
+  /* they still fire in order, and all of them in the wakeup for the first
+   * one: even the last id fired before the first one was due */
+  g_mutex_lock (&data.lock);
+  for (i = 0; i < N_TOLERANCE_IDS; i++) {
+    fail_unless_equals_uint64 (g_array_index (data.times, GstClockTime, i),
+        base + i * step);
+    fail_unless (g_array_index (data.fired_at, GstClockTime, i) < base,
+        "id %u fired at %" GST_TIME_FORMAT ", after %" GST_TIME_FORMAT, i,
+        GST_TIME_ARGS (g_array_index (data.fired_at, GstClockTime, i)),
+        GST_TIME_ARGS (base));
+  }
+  g_mutex_unlock (&data.lock);
+
+  for (i = 0; i < N_TOLERANCE_IDS; i++)
+    gst_clock_id_unref (ids[i]);
+  gst_object_unref (clock);
+
+  g_array_unref (data.times);
+  g_array_unref (data.fired_at);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_resolution)
 {
   GstClock *clock;
@@ -398,6 +551,8 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_async_full);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
+  tcase_add_test (tc_chain, test_async_order);
+  tcase_add_test (tc_chain, test_async_wakeup_tolerance);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
   tcase_add_test (tc_chain, test_stress_reschedule);
 
@@ -25,9 +25,12 @@
 
 #include <gst/check/gstcheck.h>
 #include <gst/gsttracerrecord.h>
+#include <glib/gstdio.h>
+#include <string.h>
 
 static GList *messages;         /* NULL */
 static gboolean save_messages;  /* FALSE */
+static gchar *test_binary;
 
 static void
 tracer_log_func (GstDebugCategory * category,
@@ -152,6 +155,149 @@ GST_START_TEST (serialize_static_record)
 
 GST_END_TEST;
 
+/* The binary log can only be enabled when initializing GStreamer, so the
+ * record is written by a child process started with GST_TRACER_BINARY_FILE
+ * set */
+static gint
+write_binary_record (void)
+{
+  GstTracerRecord *tr;
+
+  gst_init (NULL, NULL);
+
+  /* *INDENT-OFF* */
+  tr = gst_tracer_record_new ("test.class",
+      "string", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_STRING,
+          NULL),
+      "int", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_INT,
+          NULL),
+      "bool", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_BOOLEAN,
+          NULL),
+      "enum", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, GST_TYPE_PAD_DIRECTION,
+          NULL),
+      NULL);
+  /* *INDENT-ON* */
+
+  gst_tracer_record_log (tr, "test", 1, TRUE, GST_PAD_SRC);
+  gst_object_unref (tr);
+
+  /* drains the ring buffers and closes the file */
+  gst_deinit ();
+
+  return 0;
+}
+
+static guint32
+read_uint32 (const gchar * data)
+{
+  guint32 v;
+
+  memcpy (&v, data, 4);
+  return v;
+}
+
+static guint64
+read_uint64 (const gchar * data)
+{
+  guint64 v;
+
+  memcpy (&v, data, 8);
+  return v;
+}
+
+GST_START_TEST (serialize_binary_record)
+{
+  gchar *argv[] = { test_binary, (gchar *) "--write-binary-record", NULL };
+  gchar **envp;
+  gchar *filename, *data;
+  const gchar *block, *event;
+  GError *err = NULL;
+  GstClockTime start, elapsed;
+  gsize size, pos, offset;
+  guint32 record_id = G_MAXUINT32;
+  guint n_events = 0;
+  gint fd, status;
+
+  fd = g_file_open_tmp ("gsttracerrecord-XXXXXX.bin", &filename, &err);
+  fail_unless (fd != -1, "could not create temporary file: %s",
+      err ? err->message : "");
+  g_close (fd, NULL);
+
+  envp = g_environ_setenv (g_get_environ (), "GST_TRACER_BINARY_FILE",
+      filename, TRUE);
+  start = gst_util_get_timestamp ();
+  fail_unless (g_spawn_sync (NULL, argv, envp, G_SPAWN_DEFAULT, NULL, NULL,
+          NULL, NULL, &status, &err), "could not run %s: %s", test_binary,
+      err ? err->message : "");
+  elapsed = gst_util_get_timestamp () - start;
+#if GLIB_CHECK_VERSION (2, 70, 0)
+  fail_unless (g_spawn_check_wait_status (status, NULL));
+#else
+  fail_unless (g_spawn_check_exit_status (status, NULL));
+#endif
+  g_strfreev (envp);
+
+  fail_unless (g_file_get_contents (filename, &data, &size, NULL));
+  fail_unless (size >= 16);
+  fail_unless (memcmp (data, "GSTTRBIN", 8) == 0);
+  fail_unless_equals_int (read_uint32 (data + 8), 1);
+  fail_unless_equals_int (read_uint32 (data + 12), 0x01020304);
+
+  for (pos = 16; pos + 8 <= size; pos += 8 + read_uint32 (data + pos + 4)) {
+    guint32 type = read_uint32 (data + pos);
+    guint32 len = read_uint32 (data + pos + 4);
+
+    fail_unless (pos + 8 + len <= size);
+    block = data + pos + 8;
+
+    if (type == 1 && g_str_equal (block + 4, "test")) {
+      const gchar *spec = block + 4 + strlen ("test") + 1;
+      const gchar *fields = spec + strlen (spec) + 1;
+      const gchar *layout = fields + strlen (fields) + 1;
+
+      record_id = read_uint32 (block);
+      fail_unless_equals_string (fields,
+          "string=(string),int=(int),bool=(boolean),enum=(GstPadDirection)");
+      fail_unless_equals_string (layout, "siii");
+    } else if (type == 2) {
+      /* nothing must have been dropped */
+      fail_unless_equals_int (read_uint32 (block + 8), 0);
+
+      for (offset = 12; offset + 16 <= len;
+          offset += 16 + read_uint32 (block + offset + 4)) {
+        event = block + offset;
+        if (read_uint32 (event) != record_id)
+          continue;
+
+        /* time since gst_init() in the child */
+        fail_unless (read_uint64 (event + 8) <= elapsed);
+
+        fail_unless_equals_int (read_uint32 (event + 4), 4 + 4 + 3 * 4);
+        fail_unless_equals_int (read_uint32 (event + 16), 4);
+        fail_unless (memcmp (event + 20, "test", 4) == 0);
+        fail_unless_equals_int (read_uint32 (event + 24), 1);
+        fail_unless_equals_int (read_uint32 (event + 28), TRUE);
+        fail_unless_equals_int (read_uint32 (event + 32), GST_PAD_SRC);
+        n_events++;
+      }
+      fail_unless_equals_int (offset, len);
+    }
+  }
+  fail_unless_equals_int (pos, size);
+  fail_unless (record_id != G_MAXUINT32);
+  fail_unless_equals_int (n_events, 1);
+
+  g_free (data);
+  g_unlink (filename);
+  g_free (filename);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gst_tracer_record_suite (void)
@@ -163,10 +309,24 @@ gst_tracer_record_suite (void)
   tcase_add_checked_fixture (tc_chain, setup, cleanup);
   tcase_add_test (tc_chain, serialize_message_logging);
   tcase_add_test (tc_chain, serialize_static_record);
+  tcase_add_test (tc_chain, serialize_binary_record);
 
   /* FIXME: add more tests, e.g. enums, pointer types and optional fields */
 
   return s;
 }
 
-GST_CHECK_MAIN (gst_tracer_record);
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  if (argc == 2 && g_str_equal (argv[1], "--write-binary-record"))
+    return write_binary_record ();
+
+  test_binary = argv[0];
+
+  gst_check_init (&argc, &argv);
+  s = gst_tracer_record_suite ();
+  return gst_check_run_suite (s, "gst_tracer_record", __FILE__);
+}
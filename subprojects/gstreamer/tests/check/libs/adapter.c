@@ -1448,6 +1448,163 @@ GST_START_TEST (test_take_buffer_fast)
 
 GST_END_TEST;
 
+/* pushes @n_buffers buffers of @size bytes, the bytes count up from *@value */
+static void
+push_counting_buffers (GstAdapter * adapter, guint n_buffers, gsize size,
+    guint * value)
+{
+  GstBuffer *buffer;
+  GstMapInfo info;
+  guint i;
+  gsize j;
+
+  for (i = 0; i < n_buffers; i++) {
+    buffer = gst_buffer_new_and_alloc (size);
+    fail_unless (gst_buffer_map (buffer, &info, GST_MAP_WRITE));
+    for (j = 0; j < size; j++)
+      info.data[j] = (*value)++;
+    gst_buffer_unmap (buffer, &info);
+    gst_adapter_push (adapter, buffer);
+  }
+}
+
+static void
+check_counting_data (const guint8 * data, gsize size, guint value)
+{
+  gsize i;
+
+  fail_unless (data != NULL);
+  for (i = 0; i < size; i++)
+    fail_unless_equals_int (data[i], (guint8) (value + i));
+}
+
+GST_START_TEST (test_keep_assembled)
+{
+  GstAdapter *adapter;
+  const guint8 *data, *data2;
+  guint8 *taken;
+  guint value = 0;
+
+  adapter = gst_adapter_new ();
+  fail_if (gst_adapter_get_keep_assembled (adapter));
+  gst_adapter_set_keep_assembled (adapter, TRUE);
+  fail_unless (gst_adapter_get_keep_assembled (adapter));
+
+  push_counting_buffers (adapter, 10, 100, &value);
+  fail_unless_equals_int (gst_adapter_available (adapter), 1000);
+
+  /* spans two buffers and gets assembled */
+  data = gst_adapter_map (adapter, 150);
+  check_counting_data (data, 150, 0);
+  gst_adapter_unmap (adapter);
+
+  /* the rest of the assembled data stays available without copying */
+  gst_adapter_flush (adapter, 50);
+  fail_unless_equals_int (gst_adapter_available_fast (adapter), 100);
+  data2 = gst_adapter_map (adapter, 100);
+  fail_unless (data2 == data + 50);
+  check_counting_data (data2, 100, 50);
+  gst_adapter_unmap (adapter);
+
+  /* only the missing bytes are added */
+  data = gst_adapter_map (adapter, 250);
+  check_counting_data (data, 250, 50);
+  gst_adapter_unmap (adapter);
+
+  taken = gst_adapter_take (adapter, 120);
+  check_counting_data (taken, 120, 50);
+  g_free (taken);
+  fail_unless_equals_int (gst_adapter_available_fast (adapter), 130);
+  data = gst_adapter_map (adapter, 130);
+  check_counting_data (data, 130, 170);
+  gst_adapter_unmap (adapter);
+
+  /* growing the area keeps the assembled data */
+  data = gst_adapter_map (adapter, 700);
+  check_counting_data (data, 700, 170);
+  gst_adapter_unmap (adapter);
+
+  push_counting_buffers (adapter, 100, 100, &value);
+  data = gst_adapter_map (adapter, 5000);
+  check_counting_data (data, 5000, 170);
+  gst_adapter_unmap (adapter);
+
+  /* flushing past the assembled data */
+  gst_adapter_flush (adapter, 6000);
+  data = gst_adapter_map (adapter, 150);
+  check_counting_data (data, 150, 6170);
+  gst_adapter_unmap (adapter);
+
+  /* switching back moves the assembled data to the start again */
+  gst_adapter_flush (adapter, 10);
+  gst_adapter_set_keep_assembled (adapter, FALSE);
+  fail_unless_equals_int (gst_adapter_available_fast (adapter), 140);
+  data = gst_adapter_map (adapter, 140);
+  check_counting_data (data, 140, 6180);
+  gst_adapter_unmap (adapter);
+
+  gst_adapter_clear (adapter);
+  fail_unless_equals_int (gst_adapter_available (adapter), 0);
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
+#define TIME 0.05
+#define SPEED_BUFFER_SIZE 1316
+#define SPEED_MAP_SIZE 4096
+#define SPEED_FLUSH_SIZE 188
+
+/* a parser looking at a window of the data and consuming small frames */
+GST_START_TEST (test_keep_assembled_speed)
+{
+  GTimer *timer;
+  gdouble rate[2];
+  gint keep;
+
+  timer = g_timer_new ();
+
+  for (keep = 0; keep < 2; keep++) {
+    GstAdapter *adapter = gst_adapter_new ();
+    guint value = 0;
+    guint64 bytes = 0;
+    gdouble elapsed;
+
+    gst_adapter_set_keep_assembled (adapter, keep);
+
+    g_timer_start (timer);
+    while (TRUE) {
+      const guint8 *data;
+
+      if (gst_adapter_available (adapter) < SPEED_MAP_SIZE)
+        push_counting_buffers (adapter, 4, SPEED_BUFFER_SIZE, &value);
+
+      data = gst_adapter_map (adapter, SPEED_MAP_SIZE);
+      fail_unless (data != NULL);
+      gst_adapter_unmap (adapter);
+      gst_adapter_flush (adapter, SPEED_FLUSH_SIZE);
+      bytes += SPEED_FLUSH_SIZE;
+
+      elapsed = g_timer_elapsed (timer, NULL);
+      if (elapsed >= TIME)
+        break;
+    }
+    rate[keep] = bytes / elapsed;
+
+    g_object_unref (adapter);
+  }
+
+  GST_DEBUG ("%f bytes/sec keeping assembled data, %f without (%.1fx)",
+      rate[1], rate[0], rate[1] / rate[0]);
+
+  g_timer_destroy (timer);
+}
+
+GST_END_TEST;
+
+#undef TIME
+
 static Suite *
 gst_adapter_suite (void)
 {
@@ -1472,6 +1629,8 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_merge);
   tcase_add_test (tc_chain, test_take_buffer_fast);
   tcase_add_test (tc_chain, test_offset);
+  tcase_add_test (tc_chain, test_keep_assembled);
+  tcase_add_test (tc_chain, test_keep_assembled_speed);
 
   return s;
 }
@@ -62,6 +62,7 @@ struct _GstTestAggregator
   gboolean gap_expected;
   gboolean do_flush_on_aggregate;
   gboolean do_remove_pad_on_aggregate;
+  gboolean do_keep_buffers_on_aggregate;
 };
 
 struct _GstTestAggregatorClass
@@ -69,6 +70,55 @@ struct _GstTestAggregatorClass
   GstAggregatorClass parent_class;
 };
 
+/* sink pad counting how often it is prepared */
+
+#define GST_TYPE_TEST_AGGREGATOR_PAD        (gst_test_aggregator_pad_get_type ())
+#define GST_TEST_AGGREGATOR_PAD(obj)        (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_TEST_AGGREGATOR_PAD, GstTestAggregatorPad))
+
+typedef struct _GstTestAggregatorPad
+{
+  GstAggregatorPad parent;
+
+  gint n_prepared;
+  GstBuffer *last_prepared;     /* not reffed, only compared */
+} GstTestAggregatorPad;
+
+typedef struct _GstTestAggregatorPadClass
+{
+  GstAggregatorPadClass parent_class;
+} GstTestAggregatorPadClass;
+
+static GType gst_test_aggregator_pad_get_type (void);
+G_DEFINE_TYPE (GstTestAggregatorPad, gst_test_aggregator_pad,
+    GST_TYPE_AGGREGATOR_PAD);
+
+static GstFlowReturn
+gst_test_aggregator_pad_prepare (GstAggregatorPad * aggpad,
+    GstAggregator * aggregator, GstBuffer * buffer)
+{
+  GstTestAggregatorPad *pad = GST_TEST_AGGREGATOR_PAD (aggpad);
+
+  /* every buffer is prepared once, also if aggregate doesn't consume it */
+  fail_if (buffer == pad->last_prepared);
+  pad->last_prepared = buffer;
+  g_atomic_int_inc (&pad->n_prepared);
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_test_aggregator_pad_class_init (GstTestAggregatorPadClass * klass)
+{
+  GstAggregatorPadClass *aggpad_class = (GstAggregatorPadClass *) klass;
+
+  aggpad_class->prepare = gst_test_aggregator_pad_prepare;
+}
+
+static void
+gst_test_aggregator_pad_init (GstTestAggregatorPad * pad)
+{
+}
+
 static GstFlowReturn
 gst_test_aggregator_aggregate (GstAggregator * aggregator, gboolean timeout)
 {
@@ -124,7 +174,7 @@ gst_test_aggregator_aggregate (GstAggregator * aggregator, gboolean timeout)
           gst_buffer_unref (buf);
           gst_element_release_request_pad (GST_ELEMENT (aggregator),
               GST_PAD (pad));
-        } else {
+        } else if (!testagg->do_keep_buffers_on_aggregate) {
           gst_aggregator_pad_drop_buffer (pad);
         }
 
@@ -202,7 +252,7 @@ gst_test_aggregator_class_init (GstTestAggregatorClass * klass)
       &_src_template, GST_TYPE_AGGREGATOR_PAD);
 
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
-      &_sink_template, GST_TYPE_AGGREGATOR_PAD);
+      &_sink_template, GST_TYPE_TEST_AGGREGATOR_PAD);
 
   gst_element_class_set_static_metadata (gstelement_class, "Aggregator",
       "Testing", "Combine N buffers", "Stefan Sauer <ensonic@users.sf.net>");
@@ -546,6 +596,78 @@ GST_START_TEST (test_aggregate)
 
 GST_END_TEST;
 
+static void
+get_wakeup_stats (GstElement * agg, guint64 * wakeups, guint64 * spurious)
+{
+  GstStructure *stats;
+
+  g_object_get (agg, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-gst-aggregator-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "wakeups", wakeups));
+  fail_unless (gst_structure_get_uint64 (stats, "spurious-wakeups",
+          spurious));
+  gst_structure_free (stats);
+}
+
+GST_START_TEST (test_aggregate_stats)
+{
+  GstElement *agg;
+  GstHarness *h1, *h2, *h3;
+  guint64 wakeups, spurious, wakeups_before, spurious_before;
+
+  agg = gst_check_setup_element ("testaggregator");
+  g_object_set (agg, "latency", GST_USECOND, NULL);
+  gst_aggregator_set_force_live (GST_AGGREGATOR (agg), TRUE);
+  h1 = gst_harness_new_with_element (agg, "sink_%u", "src");
+  h2 = gst_harness_new_with_element (agg, "sink_%u", NULL);
+  h3 = gst_harness_new_with_element (agg, "sink_%u", NULL);
+
+  gst_harness_play (h1);
+  gst_harness_set_src_caps_str (h1, "foo/x-bar");
+  gst_harness_set_src_caps_str (h2, "foo/x-bar");
+  gst_harness_set_src_caps_str (h3, "foo/x-bar");
+
+  /* The first buffers wake up the srcpad thread to select the start time, so
+   * get them out of the way. The test clock doesn't move, so this is
+   * aggregated once all pads have a buffer */
+  gst_harness_push (h1, gst_buffer_new ());
+  gst_harness_push (h2, gst_buffer_new ());
+  gst_harness_push (h3, gst_buffer_new ());
+  gst_buffer_unref (gst_harness_pull (h1));
+
+  /* Wait until the srcpad thread waits for the next deadline with all pads
+   * empty */
+  fail_unless (gst_harness_wait_for_clock_id_waits (h1, 1, 60));
+  get_wakeup_stats (agg, &wakeups_before, &spurious_before);
+
+  /* Buffers on two of the three pads don't wake it up, only the deadline
+   * does */
+  gst_harness_push (h1, gst_buffer_new ());
+  gst_harness_push (h2, gst_buffer_new ());
+  gst_harness_crank_single_clock_wait (h1);
+  gst_buffer_unref (gst_harness_pull (h1));
+
+  /* Only the buffer on the last empty pad wakes it up */
+  fail_unless (gst_harness_wait_for_clock_id_waits (h1, 1, 60));
+  gst_harness_push (h1, gst_buffer_new ());
+  gst_harness_push (h2, gst_buffer_new ());
+  gst_harness_push (h3, gst_buffer_new ());
+  gst_buffer_unref (gst_harness_pull (h1));
+
+  fail_unless (gst_harness_wait_for_clock_id_waits (h1, 1, 60));
+  get_wakeup_stats (agg, &wakeups, &spurious);
+  fail_unless_equals_uint64 (wakeups - wakeups_before, 2);
+  fail_unless_equals_uint64 (spurious - spurious_before, 0);
+
+  gst_harness_teardown (h3);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h1);
+  gst_object_unref (agg);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_aggregate_eos)
 {
   GThread *thread1, *thread2;
@@ -1452,6 +1574,44 @@ GST_START_TEST (test_force_live)
 
 GST_END_TEST;
 
+GST_START_TEST (test_prepare_once_per_buffer)
+{
+  GstElement *agg;
+  GstHarness *h, *h2;
+  GstTestAggregatorPad *pad, *pad2;
+  gint i;
+
+  agg = gst_check_setup_element ("testaggregator");
+  g_object_set (agg, "latency", GST_USECOND, NULL);
+  gst_aggregator_set_force_live (GST_AGGREGATOR (agg), TRUE);
+  ((GstTestAggregator *) agg)->do_keep_buffers_on_aggregate = TRUE;
+  h = gst_harness_new_with_element (agg, "sink_%u", "src");
+  h2 = gst_harness_new_with_element (agg, "sink_%u", NULL);
+  pad = GST_TEST_AGGREGATOR_PAD (GST_PAD_PEER (h->srcpad));
+  pad2 = GST_TEST_AGGREGATOR_PAD (GST_PAD_PEER (h2->srcpad));
+
+  gst_harness_play (h);
+  gst_harness_set_src_caps_str (h, "foo/x-bar");
+  gst_harness_set_src_caps_str (h2, "foo/x-bar");
+
+  /* Only the first pad has data, so every aggregation is on a timeout and
+   * the buffer stays queued */
+  gst_harness_push (h, gst_buffer_new ());
+  for (i = 0; i < 3; i++) {
+    gst_harness_crank_single_clock_wait (h);
+    gst_buffer_unref (gst_harness_pull (h));
+  }
+
+  fail_unless_equals_int (g_atomic_int_get (&pad->n_prepared), 1);
+  fail_unless_equals_int (g_atomic_int_get (&pad2->n_prepared), 0);
+
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+  gst_object_unref (agg);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_aggregator_suite (void)
 {
@@ -1465,6 +1625,7 @@ gst_aggregator_suite (void)
   general = tcase_create ("general");
   suite_add_tcase (suite, general);
   tcase_add_test (general, test_aggregate);
+  tcase_add_test (general, test_aggregate_stats);
   tcase_add_test (general, test_aggregate_eos);
   tcase_add_test (general, test_aggregate_gap);
   tcase_add_test (general, test_aggregate_handle_events);
@@ -1483,6 +1644,7 @@ gst_aggregator_suite (void)
   tcase_add_test (general, test_flush_on_aggregate);
   tcase_add_test (general, test_remove_pad_on_aggregate);
   tcase_add_test (general, test_force_live);
+  tcase_add_test (general, test_prepare_once_per_buffer);
 
   return suite;
 }
@@ -178,7 +178,7 @@ gst_parser_tester_init (GstParserTester * tester)
 }
 
 static void
-setup_parsertester (void)
+setup_parsertester_of_type (GType type)
 {
   static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
       GST_PAD_SINK,
@@ -191,13 +191,19 @@ setup_parsertester (void)
       GST_STATIC_CAPS ("video/x-test-custom")
       );
 
-  parsetest = g_object_new (GST_PARSER_TESTER_TYPE, NULL);
+  parsetest = g_object_new (type, NULL);
   mysrcpad = gst_check_setup_src_pad (parsetest, &srctemplate);
   mysinkpad = gst_check_setup_sink_pad (parsetest, &sinktemplate);
   bus = gst_bus_new ();
   gst_element_set_bus (parsetest, bus);
 }
 
+static void
+setup_parsertester (void)
+{
+  setup_parsertester_of_type (GST_PARSER_TESTER_TYPE);
+}
+
 static void
 cleanup_parsertest (void)
 {
@@ -680,6 +686,379 @@ GST_START_TEST (parser_pull_frame_growth)
 
 GST_END_TEST;
 
+/* parser_pull_read_ahead test */
+
+/* Frames do not divide the 64KB cache buffers evenly, so that caches are
+ * also continued in the middle of a frame */
+#define READ_AHEAD_FRAME_SIZE 24
+#define READ_AHEAD_N_FRAMES 20000
+#define READ_AHEAD_FILE_SIZE (READ_AHEAD_FRAME_SIZE * READ_AHEAD_N_FRAMES)
+#define READ_AHEAD_BYTE(pos) ((guint8) ((pos) * 7 + (pos) / 251))
+#define READ_AHEAD_CACHE_SIZE (64 * 1024)
+
+typedef struct
+{
+  guint64 offset;
+  guint length;
+  gsize size;
+  GThread *thread;
+} PullRecord;
+
+static GMutex pulls_lock;
+static GArray *pulls;
+static GThread *streaming_thread;
+
+static GstFlowReturn
+_sink_chain_pull_read_ahead (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  guint64 pos = (guint64) buffer_count * READ_AHEAD_FRAME_SIZE;
+  GstMapInfo map;
+  gsize i;
+
+  streaming_thread = g_thread_self ();
+
+  /* frames have to arrive in order and with the right data */
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, READ_AHEAD_FRAME_SIZE);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], READ_AHEAD_BYTE (pos + i));
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  have_data = TRUE;
+  buffer_count++;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+_src_getrange_read_ahead (GstPad * pad, GstObject * parent, guint64 offset,
+    guint length, GstBuffer ** buffer)
+{
+  PullRecord pull = { offset, length, 0, g_thread_self () };
+  GstMapInfo map;
+  guint i;
+
+  if (offset < READ_AHEAD_FILE_SIZE)
+    pull.size = MIN (length, READ_AHEAD_FILE_SIZE - offset);
+
+  g_mutex_lock (&pulls_lock);
+  g_array_append_val (pulls, pull);
+  g_mutex_unlock (&pulls_lock);
+
+  if (offset >= READ_AHEAD_FILE_SIZE)
+    return GST_FLOW_EOS;
+
+  *buffer = gst_buffer_new_and_alloc (pull.size);
+  gst_buffer_map (*buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < pull.size; i++)
+    map.data[i] = READ_AHEAD_BYTE (offset + i);
+  gst_buffer_unmap (*buffer, &map);
+
+  return GST_FLOW_OK;
+}
+
+/* Test that reading ahead in pull mode keeps the data in order, reads each
+ * following cache buffer in one go and that the data read ahead is used */
+GST_START_TEST (parser_pull_read_ahead)
+{
+  guint64 read_ahead_end = 0;
+  gboolean read_ahead;
+  guint i, j, n_read_ahead = 0;
+  PullRecord *pull;
+
+  have_eos = FALSE;
+  have_data = FALSE;
+  loop = g_main_loop_new (NULL, FALSE);
+  pulls = g_array_new (FALSE, FALSE, sizeof (PullRecord));
+  streaming_thread = NULL;
+
+  setup_parsertester ();
+  buffer_count = 0;
+
+  ((GstParserTester *) (parsetest))->min_frame_size = READ_AHEAD_FRAME_SIZE;
+  g_object_set (parsetest, "read-ahead", TRUE, NULL);
+  g_object_get (parsetest, "read-ahead", &read_ahead, NULL);
+  fail_unless (read_ahead);
+
+  gst_pad_set_getrange_function (mysrcpad, _src_getrange_read_ahead);
+  gst_pad_set_query_function (mysrcpad, _src_query);
+  gst_pad_set_chain_function (mysinkpad, _sink_chain_pull_read_ahead);
+  gst_pad_set_event_function (mysinkpad, _sink_event);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  gst_element_set_state (parsetest, GST_STATE_PLAYING);
+
+  g_main_loop_run (loop);
+  fail_unless (have_eos == TRUE);
+  fail_unless (have_data == TRUE);
+  fail_unless_equals_int (buffer_count, READ_AHEAD_N_FRAMES);
+
+  gst_element_set_state (parsetest, GST_STATE_NULL);
+
+  /* the first cache buffer is not read ahead */
+  fail_unless (pulls->len > 0);
+  pull = &g_array_index (pulls, PullRecord, 0);
+  fail_unless_equals_uint64 (pull->offset, 0);
+  fail_unless (pull->thread == streaming_thread);
+
+  /* reading ahead requests whole cache buffers, each one following the
+   * previous one */
+  for (i = 0; i < pulls->len; i++) {
+    pull = &g_array_index (pulls, PullRecord, i);
+    if (pull->thread == streaming_thread)
+      continue;
+
+    fail_unless_equals_int (pull->length, READ_AHEAD_CACHE_SIZE);
+    if (n_read_ahead > 0)
+      fail_unless_equals_uint64 (pull->offset, read_ahead_end);
+    read_ahead_end = pull->offset + pull->length;
+    n_read_ahead++;
+  }
+  fail_unless (n_read_ahead >= READ_AHEAD_FILE_SIZE / READ_AHEAD_CACHE_SIZE
+      - 2);
+
+  /* the streaming thread never pulls data again that was read ahead, it
+   * takes it from the data read ahead */
+  for (i = 0; i < pulls->len; i++) {
+    PullRecord *a = &g_array_index (pulls, PullRecord, i);
+
+    if (a->thread != streaming_thread)
+      continue;
+
+    for (j = 0; j < pulls->len; j++) {
+      PullRecord *b = &g_array_index (pulls, PullRecord, j);
+
+      if (b->thread == streaming_thread)
+        continue;
+
+      fail_if (a->offset < b->offset + b->size &&
+          b->offset < a->offset + a->size,
+          "offset %" G_GUINT64_FORMAT " was read ahead and pulled again",
+          MAX (a->offset, b->offset));
+    }
+  }
+
+  check_no_error_received ();
+  cleanup_parsertest ();
+
+  g_array_unref (pulls);
+  pulls = NULL;
+  g_main_loop_unref (loop);
+  loop = NULL;
+}
+
+GST_END_TEST;
+
+/* parser_pull_scan_sync_points test */
+
+/* Frames start with a two byte sync word and carry their index. The junk in
+ * between the frames never contains the sync word. */
+#define SYNC_WORD_0 0xa5
+#define SYNC_WORD_1 0x5a
+#define SYNC_FRAME_SIZE 24
+#define SYNC_N_FRAMES 4000
+#define SYNC_JUNK_SIZE(i) (((i) % 5) * 50)
+
+#define GST_SYNC_PARSER_TESTER_TYPE gst_sync_parser_tester_get_type()
+static GType gst_sync_parser_tester_get_type (void);
+
+typedef GstBaseParse GstSyncParserTester;
+typedef GstBaseParseClass GstSyncParserTesterClass;
+
+G_DEFINE_TYPE (GstSyncParserTester, gst_sync_parser_tester,
+    GST_TYPE_BASE_PARSE);
+
+static guint8 *sync_data;
+static gsize sync_data_size;
+static gint sync_skip_count;
+
+static gboolean
+gst_sync_parser_tester_start (GstBaseParse * parse)
+{
+  gst_base_parse_set_min_frame_size (parse, SYNC_FRAME_SIZE);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_sync_parser_tester_handle_frame (GstBaseParse * parse,
+    GstBaseParseFrame * frame, gint * skipsize)
+{
+  GstMapInfo map;
+  gboolean synced;
+  gsize size;
+
+  if (!gst_pad_has_current_caps (GST_BASE_PARSE_SRC_PAD (parse))) {
+    GstCaps *caps = gst_caps_new_empty_simple ("video/x-test-custom");
+
+    gst_pad_set_caps (GST_BASE_PARSE_SRC_PAD (parse), caps);
+    gst_caps_unref (caps);
+  }
+
+  fail_unless (gst_buffer_map (frame->buffer, &map, GST_MAP_READ));
+  size = map.size;
+  synced = size >= 2 && map.data[0] == SYNC_WORD_0
+      && map.data[1] == SYNC_WORD_1;
+  gst_buffer_unmap (frame->buffer, &map);
+
+  if (size < SYNC_FRAME_SIZE) {
+    *skipsize = 0;
+    return GST_FLOW_OK;
+  }
+
+  /* look for the sync word one byte further on */
+  if (!synced) {
+    g_atomic_int_inc (&sync_skip_count);
+    *skipsize = 1;
+    return GST_FLOW_OK;
+  }
+
+  return gst_base_parse_finish_frame (parse, frame, SYNC_FRAME_SIZE);
+}
+
+static void
+gst_sync_parser_tester_scan_sync_points (GstBaseParse * parse,
+    const guint8 * data, gsize size, gsize scan_size, GArray * offsets)
+{
+  gsize i;
+
+  for (i = 0; i < scan_size; i++) {
+    if (data[i] == SYNC_WORD_0 && (i + 1 == size ||
+            data[i + 1] == SYNC_WORD_1))
+      g_array_append_val (offsets, i);
+  }
+}
+
+static void
+gst_sync_parser_tester_class_init (GstSyncParserTesterClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseParseClass *baseparse_class = GST_BASE_PARSE_CLASS (klass);
+
+  static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-test-custom"));
+
+  static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC, GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("video/x-test-custom"));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_templ);
+  gst_element_class_add_static_pad_template (element_class, &src_templ);
+
+  gst_element_class_set_metadata (element_class,
+      "SyncParserTester", "Parser/Video", "yep", "me");
+
+  baseparse_class->start = gst_sync_parser_tester_start;
+  baseparse_class->handle_frame = gst_sync_parser_tester_handle_frame;
+  baseparse_class->scan_sync_points = gst_sync_parser_tester_scan_sync_points;
+}
+
+static void
+gst_sync_parser_tester_init (GstSyncParserTester * tester)
+{
+}
+
+static GstFlowReturn
+_sink_chain_pull_sync (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstMapInfo map;
+
+  /* every frame is found, in order */
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, SYNC_FRAME_SIZE);
+  fail_unless_equals_int (map.data[0], SYNC_WORD_0);
+  fail_unless_equals_int (map.data[1], SYNC_WORD_1);
+  fail_unless_equals_int (GST_READ_UINT32_LE (map.data + 2), buffer_count);
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  have_data = TRUE;
+  buffer_count++;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+_src_getrange_sync (GstPad * pad, GstObject * parent, guint64 offset,
+    guint length, GstBuffer ** buffer)
+{
+  if (offset >= sync_data_size)
+    return GST_FLOW_EOS;
+
+  length = MIN (length, sync_data_size - offset);
+  *buffer = gst_buffer_new_memdup (sync_data + offset, length);
+
+  return GST_FLOW_OK;
+}
+
+/* Test that the sync points found while reading ahead let baseparse skip
+ * the junk between frames without changing which frames are found */
+GST_START_TEST (parser_pull_scan_sync_points)
+{
+  gsize junk_size = 0, pos = 0;
+  guint i;
+
+  for (i = 0; i < SYNC_N_FRAMES; i++)
+    junk_size += SYNC_JUNK_SIZE (i);
+  sync_data_size = junk_size + SYNC_N_FRAMES * SYNC_FRAME_SIZE;
+  sync_data = g_malloc (sync_data_size);
+
+  for (i = 0; i < SYNC_N_FRAMES; i++) {
+    memset (sync_data + pos, 0, SYNC_JUNK_SIZE (i));
+    pos += SYNC_JUNK_SIZE (i);
+    memset (sync_data + pos, 0x11, SYNC_FRAME_SIZE);
+    sync_data[pos] = SYNC_WORD_0;
+    sync_data[pos + 1] = SYNC_WORD_1;
+    GST_WRITE_UINT32_LE (sync_data + pos + 2, i);
+    pos += SYNC_FRAME_SIZE;
+  }
+  fail_unless_equals_uint64 (pos, sync_data_size);
+
+  have_eos = FALSE;
+  have_data = FALSE;
+  buffer_count = 0;
+  sync_skip_count = 0;
+  loop = g_main_loop_new (NULL, FALSE);
+
+  setup_parsertester_of_type (GST_SYNC_PARSER_TESTER_TYPE);
+  g_object_set (parsetest, "read-ahead", TRUE, NULL);
+
+  gst_pad_set_getrange_function (mysrcpad, _src_getrange_sync);
+  gst_pad_set_query_function (mysrcpad, _src_query);
+  gst_pad_set_chain_function (mysinkpad, _sink_chain_pull_sync);
+  gst_pad_set_event_function (mysinkpad, _sink_event);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_pad_set_active (mysinkpad, TRUE);
+  gst_element_set_state (parsetest, GST_STATE_PLAYING);
+
+  g_main_loop_run (loop);
+  fail_unless (have_eos == TRUE);
+  fail_unless_equals_int (buffer_count, SYNC_N_FRAMES);
+
+  /* without the sync points, every byte of junk would be skipped on its own;
+   * only the junk before the first data read ahead is */
+  GST_INFO ("skipped %d times for %" G_GSIZE_FORMAT " bytes of junk",
+      sync_skip_count, junk_size);
+  fail_unless ((gsize) sync_skip_count < junk_size / 2);
+
+  gst_element_set_state (parsetest, GST_STATE_NULL);
+
+  check_no_error_received ();
+  cleanup_parsertest ();
+
+  g_main_loop_unref (loop);
+  loop = NULL;
+  g_free (sync_data);
+  sync_data = NULL;
+}
+
+GST_END_TEST;
+
 GST_START_TEST (parser_initial_gap_prefer_upstream_caps)
 {
   GstHarness *h;
@@ -835,6 +1214,8 @@ gst_baseparse_suite (void)
   tcase_add_test (tc, parser_reverse_playback);
   tcase_add_test (tc, parser_pull_short_read);
   tcase_add_test (tc, parser_pull_frame_growth);
+  tcase_add_test (tc, parser_pull_read_ahead);
+  tcase_add_test (tc, parser_pull_scan_sync_points);
   tcase_add_test (tc, parser_initial_gap_prefer_upstream_caps);
   tcase_add_test (tc, parser_convert_duration);
   tcase_add_test (tc, parser_sticky_events_after_flush);
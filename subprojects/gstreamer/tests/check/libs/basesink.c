@@ -23,6 +23,7 @@
 #endif
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gsttestclock.h>
 #include <gst/base/gstbasesink.h>
 
 GST_START_TEST (basesink_last_sample_enabled)
@@ -345,6 +346,238 @@ GST_START_TEST (basesink_stream_start_after_eos)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GstBaseSink parent;
+  GArray *list_lengths;
+  guint n_buffers;
+} ListSink;
+
+typedef GstBaseSinkClass ListSinkClass;
+
+static GType list_sink_get_type (void);
+
+G_DEFINE_TYPE (ListSink, list_sink, GST_TYPE_BASE_SINK);
+
+static GstFlowReturn
+list_sink_render (GstBaseSink * bsink, GstBuffer * buffer)
+{
+  ListSink *sink = (ListSink *) bsink;
+
+  sink->n_buffers++;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+list_sink_render_list (GstBaseSink * bsink, GstBufferList * list)
+{
+  ListSink *sink = (ListSink *) bsink;
+  guint len = gst_buffer_list_length (list);
+
+  g_array_append_val (sink->list_lengths, len);
+
+  return GST_FLOW_OK;
+}
+
+static void
+list_sink_finalize (GObject * object)
+{
+  ListSink *sink = (ListSink *) object;
+
+  g_array_unref (sink->list_lengths);
+
+  G_OBJECT_CLASS (list_sink_parent_class)->finalize (object);
+}
+
+static void
+list_sink_class_init (ListSinkClass * klass)
+{
+  static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+  G_OBJECT_CLASS (klass)->finalize = list_sink_finalize;
+  gst_element_class_add_static_pad_template (GST_ELEMENT_CLASS (klass),
+      &sink_template);
+  klass->render = list_sink_render;
+  klass->render_list = list_sink_render_list;
+}
+
+static void
+list_sink_init (ListSink * sink)
+{
+  sink->list_lengths = g_array_new (FALSE, FALSE, sizeof (guint));
+}
+
+static GstBuffer *
+new_timestamped_buffer (GstClockTime pts)
+{
+  GstBuffer *buf = gst_buffer_new ();
+
+  GST_BUFFER_PTS (buf) = pts;
+
+  return buf;
+}
+
+static gpointer
+push_grouped_data (gpointer data)
+{
+  GstPad *pad = data;
+  GstBufferList *list;
+
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, new_timestamped_buffer (10 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (11 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (12 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (100 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (101 * GST_MSECOND));
+  fail_unless_equals_int (gst_pad_chain_list (pad, list), GST_FLOW_OK);
+
+  fail_unless_equals_int (gst_pad_chain (pad,
+          new_timestamped_buffer (200 * GST_MSECOND)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_pad_chain (pad,
+          new_timestamped_buffer (201 * GST_MSECOND)), GST_FLOW_OK);
+
+  return NULL;
+}
+
+GST_START_TEST (basesink_sync_tolerance)
+{
+  const GstClockTime waits[] =
+      { 10 * GST_MSECOND, 100 * GST_MSECOND, 200 * GST_MSECOND };
+  GstElement *sink;
+  GstClock *clock;
+  GstClockID id;
+  GstStructure *stats;
+  GstSegment segment;
+  GThread *thread;
+  GstPad *pad;
+  ListSink *lsink;
+  guint64 rendered, dropped;
+  guint i;
+
+  sink = g_object_new (list_sink_get_type (), NULL);
+  lsink = (ListSink *) sink;
+  g_object_set (sink, "async", FALSE, "sync", TRUE, "sync-tolerance",
+      5 * GST_MSECOND, NULL);
+  fail_unless_equals_uint64 (gst_base_sink_get_sync_tolerance (GST_BASE_SINK
+          (sink)), 5 * GST_MSECOND);
+
+  clock = gst_test_clock_new ();
+  gst_element_set_clock (sink, clock);
+  gst_element_set_base_time (sink, 0);
+  fail_unless_equals_int (gst_element_set_state (sink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  pad = gst_element_get_static_pad (sink, "sink");
+  fail_unless (gst_pad_send_event (pad, gst_event_new_stream_start ("test")));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_send_event (pad, gst_event_new_segment (&segment)));
+
+  thread = g_thread_new ("push-thread", push_grouped_data, pad);
+
+  /* one wait per group of the list and one for the first single buffer,
+   * the second single buffer is due within the tolerance */
+  for (i = 0; i < G_N_ELEMENTS (waits); i++) {
+    gst_test_clock_wait_for_next_pending_id (GST_TEST_CLOCK (clock), &id);
+    fail_unless_equals_uint64 (gst_clock_id_get_time (id), waits[i]);
+    gst_clock_id_unref (id);
+    fail_unless (gst_test_clock_crank (GST_TEST_CLOCK (clock)));
+  }
+
+  g_thread_join (thread);
+
+  fail_unless_equals_int (gst_test_clock_peek_id_count (GST_TEST_CLOCK
+          (clock)), 0);
+  fail_unless_equals_int (lsink->list_lengths->len, 2);
+  fail_unless_equals_int (g_array_index (lsink->list_lengths, guint, 0), 3);
+  fail_unless_equals_int (g_array_index (lsink->list_lengths, guint, 1), 2);
+  fail_unless_equals_int (lsink->n_buffers, 2);
+
+  stats = gst_base_sink_get_stats (GST_BASE_SINK (sink));
+  fail_unless (gst_structure_get_uint64 (stats, "rendered", &rendered));
+  fail_unless (gst_structure_get_uint64 (stats, "dropped", &dropped));
+  fail_unless_equals_uint64 (rendered, 4);
+  fail_unless_equals_uint64 (dropped, 0);
+  gst_structure_free (stats);
+
+  fail_unless_equals_int (gst_element_set_state (sink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pad);
+  gst_object_unref (clock);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
+static gpointer
+push_burst_data (gpointer data)
+{
+  GstPad *pad = data;
+  GstBufferList *list;
+
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, new_timestamped_buffer (10 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (11 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (13 * GST_MSECOND));
+  gst_buffer_list_add (list, new_timestamped_buffer (15 * GST_MSECOND));
+  fail_unless_equals_int (gst_pad_chain_list (pad, list), GST_FLOW_OK);
+
+  return NULL;
+}
+
+/* a list that fits within the tolerance is not split and costs a single
+ * clock wait, the same as without a tolerance */
+GST_START_TEST (basesink_sync_tolerance_single_wait)
+{
+  GstElement *sink;
+  GstClock *clock;
+  GstClockID id;
+  GstSegment segment;
+  GThread *thread;
+  GstPad *pad;
+  ListSink *lsink;
+
+  sink = g_object_new (list_sink_get_type (), NULL);
+  lsink = (ListSink *) sink;
+  g_object_set (sink, "async", FALSE, "sync", TRUE, "sync-tolerance",
+      5 * GST_MSECOND, NULL);
+
+  clock = gst_test_clock_new ();
+  gst_element_set_clock (sink, clock);
+  gst_element_set_base_time (sink, 0);
+  fail_unless_equals_int (gst_element_set_state (sink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  pad = gst_element_get_static_pad (sink, "sink");
+  fail_unless (gst_pad_send_event (pad, gst_event_new_stream_start ("test")));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_send_event (pad, gst_event_new_segment (&segment)));
+
+  thread = g_thread_new ("push-thread", push_burst_data, pad);
+
+  gst_test_clock_wait_for_next_pending_id (GST_TEST_CLOCK (clock), &id);
+  fail_unless_equals_uint64 (gst_clock_id_get_time (id), 10 * GST_MSECOND);
+  gst_clock_id_unref (id);
+  fail_unless (gst_test_clock_crank (GST_TEST_CLOCK (clock)));
+
+  g_thread_join (thread);
+
+  fail_unless_equals_int (gst_test_clock_peek_id_count (GST_TEST_CLOCK
+          (clock)), 0);
+  fail_unless_equals_int (lsink->list_lengths->len, 1);
+  fail_unless_equals_int (g_array_index (lsink->list_lengths, guint, 0), 4);
+  fail_unless_equals_int (lsink->n_buffers, 0);
+
+  fail_unless_equals_int (gst_element_set_state (sink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pad);
+  gst_object_unref (clock);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_basesrc_suite (void)
 {
@@ -358,6 +591,8 @@ gst_basesrc_suite (void)
   tcase_add_test (tc, basesink_test_eos_after_playing);
   tcase_add_test (tc, basesink_position_query_handles_segment_offset);
   tcase_add_test (tc, basesink_stream_start_after_eos);
+  tcase_add_test (tc, basesink_sync_tolerance);
+  tcase_add_test (tc, basesink_sync_tolerance_single_wait);
 
   return s;
 }